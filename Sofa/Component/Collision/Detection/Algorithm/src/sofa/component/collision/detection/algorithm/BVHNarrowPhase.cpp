@@ -318,15 +318,25 @@ void BVHNarrowPhase::finalCollisionPairs(const TestPair& pair,
     const core::CollisionElementIterator begin2 = pair.second.first;
     const core::CollisionElementIterator end2 = pair.second.second;
 
+    // The final collision pairs are given together to the intersector, so that it can process them as a batch.
+    // The buffer is reused from one call to the next, and is per thread as the cells can be processed in parallel.
+    thread_local core::collision::ElementIntersector::CandidatePairs pairs;
+    pairs.clear();
+
     for (auto it1 = begin1; it1 != end1; ++it1)
     {
         for (auto it2 = begin2; it2 != end2; ++it2)
         {
             // Final collision pair
             if (!selfCollision || it1.canCollideWith(it2))
-                intersector->intersect(it1, it2, outputs, currentIntersection);
+                pairs.emplace_back(it1.getIndex(), it2.getIndex());
         }
     }
+
+    if (!pairs.empty())
+    {
+        intersector->intersectPairs(begin1.getCollisionModel(), begin2.getCollisionModel(), pairs, outputs, currentIntersection);
+    }
 }
 
 std::pair<core::CollisionModel*, core::CollisionModel*> BVHNarrowPhase::getCollisionModelsFromTestPair(const TestPair& pair)
@@ -50,23 +50,19 @@ void RayTraceNarrowPhase::findPairsVolume (CubeCollisionModel * cm1, CubeCollisi
         return;
 
 
-    /*construct the octree of both models, when it still doesn't exisits */
-    if (!tm1->octreeRoot)
+    /*construct the hierarchies of both models, when they still don't exist */
+    if (!tm1->isBVHBuilt())
     {
-
-        tm1->buildOctree ();
+        tm1->buildBVH ();
     }
 
-    if (!tm2->octreeRoot)
+    if (!tm2->isBVHBuilt())
     {
-
-        tm2->buildOctree ();
-
+        tm2->buildBVH ();
     }
 
     /* get the output vector for a TriangleOctreeModel, TriangleOctreeModel Collision*/
     /*Get the cube representing the bounding box of both Models */
-    // sofa::core::collision::DetectionOutputVector *& contacts=outputsMap[std::make_pair(tm1, tm2)];
     core::collision::DetectionOutputVector*& contacts = this->getDetectionOutputs(tm1, tm2);
 
 
@@ -86,7 +82,6 @@ void RayTraceNarrowPhase::findPairsVolume (CubeCollisionModel * cm1, CubeCollisi
             static_cast < TDetectionOutputVector < TriangleOctreeModel,
             TriangleOctreeModel > *>(contacts);
 
-    Cube cube1 (cm1, 0);
     const Cube cube2 (cm2, 0);
 
 
@@ -94,36 +89,26 @@ void RayTraceNarrowPhase::findPairsVolume (CubeCollisionModel * cm1, CubeCollisi
     const auto& maxVect2 = cube2.maxVect ();
     const int size = tm1->getSize ();
 
+    /* gather the rays of all the tested points, so that they are traced by packets */
+    m_queries.clear();
+    m_rayOrigins.clear();
+    m_rayDirections.clear();
+
     for (int j = 0; j < size; j++)
     {
-
         /*creates a Triangle for each object being tested */
         Triangle tri1 (tm1, j);
 
-
-        /*cosAngle will store the angle between the triangle from t1 and his corresponding in t2 */
-        double cosAngle;
-        /*cosAngle will store the angle between the triangle from t1 and another triangle on t1 that is crossed by the -normal of tri1*/
-        double cosAngle2;
-        /*resTriangle and resTriangle2 will store the triangle result from the trace method */
-        int resTriangle = -1;
-        int resTriangle2 = -1;
-        sofa::type::Vec3 trianglePoints[4];
-        //bool found = false;
+        sofa::type::Vec3 trianglePoints[3];
         int nPoints = 0;
         sofa::type::Vec3 normau[3];
-        /*if it fails to find a correspondence between the triangles it tries the raytracing procedure */
-        /*test if this triangle was tested before */
-
-        /*set the triangle as tested */
-        const int flags = tri1.flags();
 
         /*test only the points related to this triangle */
+        const int flags = tri1.flags();
         if (flags & TriangleCollisionModel<sofa::defaulttype::Vec3Types>::FLAG_P1)
         {
             normau[nPoints] = tm1->pNorms[tri1.p1Index ()];
             trianglePoints[nPoints++] = tri1.p1 ();
-
         }
         if (flags & TriangleCollisionModel<sofa::defaulttype::Vec3Types>::FLAG_P2)
         {
@@ -138,7 +123,6 @@ void RayTraceNarrowPhase::findPairsVolume (CubeCollisionModel * cm1, CubeCollisi
 
         for (int t = 0; t < nPoints; t++)
         {
-
             const auto& point = trianglePoints[t];
 
             if ((point[0] < (minVect2[0]))
@@ -148,65 +132,78 @@ void RayTraceNarrowPhase::findPairsVolume (CubeCollisionModel * cm1, CubeCollisi
                 || (point[2] < minVect2[2] )
                 || (point[2] > maxVect2[2] ))
                 continue;
-            /*res and res2 will store the point of intercection and the distance from the point */
-            TriangleOctree::traceResult res, res2;
-            /*search a triangle on t2 */
-            resTriangle =
-                    tm2->octreeRoot->
-                            trace (point /*+ normau[t] * (contactDistance / 2) */ ,
-                                   -normau[t], res);
-            if (resTriangle == -1)
-                continue;
-            Triangle triang2 (tm2, resTriangle);
-            cosAngle = dot (tri1.n (), triang2.n ());
-            if (cosAngle > 0)
-                continue;
-            /*search a triangle on t1, to be sure that the triangle found on t2 isn't outside the t1 object */
-
-            /*if there is no triangle in t1  that is crossed by the tri1 normal (resTriangle2==-1), it means that t1 is not an object with a closed volume, so we can't continue.
-              If the distance from the  point to the triangle on t1 is less than the distance to the triangle on t2 it means that the corresponding point is outside t1, and is not a good point */
-            resTriangle2 =
-                    tm1->octreeRoot->trace (point, -normau[t], res2);
-
 
+            m_queries.push_back({ static_cast<sofa::Index>(j), t });
+            m_rayOrigins.push_back(point);
+            m_rayDirections.push_back(-normau[t]);
+        }
+    }
 
-            if (resTriangle2 == -1 || res2.t < res.t)
-            {
+    /*search a triangle on t2 */
+    m_traceResults.resize(m_queries.size());
+    tm2->getBVH().tracePacket(m_rayOrigins.data(), m_rayDirections.data(), m_queries.size(), m_traceResults.data());
 
-                continue;
-            }
+    /*keep only the rays reaching a triangle of t2 facing tri1 */
+    std::size_t nbQueries = 0;
+    for (std::size_t q = 0; q < m_queries.size(); ++q)
+    {
+        const TriangleOctree::traceResult& res = m_traceResults[q];
+        if (res.tid == -1)
+            continue;
+
+        const Triangle tri1 (tm1, m_queries[q].triangle);
+        const Triangle triang2 (tm2, res.tid);
+        if (dot (tri1.n (), triang2.n ()) > 0)
+            continue;
+
+        m_queries[nbQueries] = m_queries[q];
+        m_rayOrigins[nbQueries] = m_rayOrigins[q];
+        m_rayDirections[nbQueries] = m_rayDirections[q];
+        m_traceResults[nbQueries] = res;
+        ++nbQueries;
+    }
 
+    /*search a triangle on t1, to be sure that the triangle found on t2 isn't outside the t1 object */
+    m_backTraceResults.resize(nbQueries);
+    tm1->getBVH().tracePacket(m_rayOrigins.data(), m_rayDirections.data(), nbQueries, m_backTraceResults.data());
 
-            Triangle tri3 (tm1, resTriangle2);
-            cosAngle2 = dot (tri1.n (), tri3.n ());
-            if (cosAngle2 > 0)
-                continue;
+    for (std::size_t q = 0; q < nbQueries; ++q)
+    {
+        const TriangleOctree::traceResult& res = m_traceResults[q];
+        const TriangleOctree::traceResult& res2 = m_backTraceResults[q];
 
-            const sofa::type::Vec3 Q =
-                    (triang2.p1 () * (1.0 - res.u - res.v)) +
-                    (triang2.p2 () * res.u) + (triang2.p3 () * res.v);
+        /*if there is no triangle in t1  that is crossed by the tri1 normal (resTriangle2==-1), it means that t1 is not an object with a closed volume, so we can't continue.
+          If the distance from the  point to the triangle on t1 is less than the distance to the triangle on t2 it means that the corresponding point is outside t1, and is not a good point */
+        if (res2.tid == -1 || res2.t < res.t)
+            continue;
 
-            outputs->resize (outputs->size () + 1);
-            sofa::core::collision::DetectionOutput *detection = &*(outputs->end () - 1);
+        const Triangle tri1 (tm1, m_queries[q].triangle);
+        const Triangle tri3 (tm1, res2.tid);
+        if (dot (tri1.n (), tri3.n ()) > 0)
+            continue;
 
+        const Triangle triang2 (tm2, res.tid);
+        const sofa::type::Vec3 Q =
+                (triang2.p1 () * (1.0 - res.u - res.v)) +
+                (triang2.p2 () * res.u) + (triang2.p3 () * res.v);
 
-            detection->elem =
-                    std::pair <
-                            core::CollisionElementIterator,
-                            core::CollisionElementIterator > (tri1, triang2);
-            detection->point[0] = point;
+        outputs->resize (outputs->size () + 1);
+        sofa::core::collision::DetectionOutput *detection = &*(outputs->end () - 1);
 
-            detection->point[1] = Q;
 
-            detection->normal = normau[t];
+        detection->elem =
+                std::pair <
+                        core::CollisionElementIterator,
+                        core::CollisionElementIterator > (tri1, triang2);
+        detection->point[0] = m_rayOrigins[q];
 
-            detection->value = -(res.t);
+        detection->point[1] = Q;
 
-            detection->id = tri1.getIndex()*3+t;
-            //found = true;
+        detection->normal = -m_rayDirections[q];
 
-        }
+        detection->value = -(res.t);
 
+        detection->id = tri1.getIndex()*3+m_queries[q].point;
     }
 
 }
@@ -24,6 +24,7 @@
 #include <sofa/component/collision/detection/algorithm/config.h>
 
 #include <sofa/core/collision/NarrowPhaseDetection.h>
+#include <sofa/helper/TriangleOctree.h>
 
 namespace sofa::component::collision::geometry
 {
@@ -37,7 +38,8 @@ namespace sofa::component::collision::detection::algorithm
  *
  *   For each point in one object, we trace a ray following the oposite of the point's normal
  *   up to find a triangle in the other object. Both triangles are tested to evaluate if they are in
- *   colliding state. It must be used with a TriangleOctreeModel,as an octree is used to traverse the object.
+ *   colliding state. It must be used with a TriangleOctreeModel, as its bounding volume hierarchy is used to traverse the object.
+ *   The rays of all the points are gathered and traced by packets.
  */
 class SOFA_COMPONENT_COLLISION_DETECTION_ALGORITHM_API RayTraceNarrowPhase : public core::collision::NarrowPhaseDetection
 {
@@ -57,6 +59,20 @@ public:
 
     void findPairsVolume (collision::geometry::CubeCollisionModel * cm1, collision::geometry::CubeCollisionModel* cm2);
 
+protected:
+    /// A ray traced from a point of a triangle, following the opposite of the point normal
+    struct RayQuery
+    {
+        sofa::Index triangle;
+        int point; ///< index of the point among the tested points of the triangle
+    };
+
+    /// buffers reused from one call to findPairsVolume to the other
+    sofa::type::vector<RayQuery> m_queries;
+    sofa::type::vector<sofa::type::Vec3> m_rayOrigins;
+    sofa::type::vector<sofa::type::Vec3> m_rayDirections;
+    sofa::type::vector<sofa::helper::TriangleOctree::traceResult> m_traceResults;
+    sofa::type::vector<sofa::helper::TriangleOctree::traceResult> m_backTraceResults;
 };
 
 }
@@ -21,6 +21,7 @@
 ******************************************************************************/
 #define SOFA_COMPONENT_COLLISION_LOCALMINDISTANCE_CPP
 #include <sofa/component/collision/detection/intersection/LocalMinDistance.h>
+#include <sofa/component/collision/detection/intersection/ProximityCulling.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/collision/Intersection.inl>
 #include <sofa/core/visual/VisualParams.h>
@@ -428,6 +429,30 @@ int LocalMinDistance::computeIntersection(Triangle& e2, Point& e1, OutputVector*
 }
 
 
+int LocalMinDistance::computeIntersection(TriangleCollisionModel<Vec3Types>* model1, PointCollisionModel<Vec3Types>* model2, const ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity();
+
+    // the cone filters are only applied on the pairs which are not culled
+    return ProximityCulling::cullTrianglePointPairs(model1, model2, pairs, begin, end, alarmDist, 0.000001,
+        [this, contacts, currentIntersection](Triangle& e2, Point& e1)
+        {
+            return computeIntersection(e2, e1, contacts, currentIntersection);
+        });
+}
+
+int LocalMinDistance::computeIntersection(LineCollisionModel<Vec3Types>* model1, LineCollisionModel<Vec3Types>* model2, const ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity();
+
+    // the cone filters are only applied on the pairs which are not culled
+    return ProximityCulling::cullLineLinePairs(model1, model2, pairs, begin, end, alarmDist, 1e-15, 1.0e-30,
+        [this, contacts, currentIntersection](Line& e1, Line& e2)
+        {
+            return computeIntersection(e1, e2, contacts, currentIntersection);
+        });
+}
+
 bool LocalMinDistance::testIntersection(Triangle& e2, Sphere& e1, const core::collision::Intersection* currentIntersection)
 {
     if (!e1.isActive(e2.getCollisionModel()))
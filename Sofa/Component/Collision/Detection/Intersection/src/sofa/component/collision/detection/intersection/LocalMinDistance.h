@@ -112,6 +112,13 @@ public:
     int computeIntersection(collision::geometry::Ray&, collision::geometry::Sphere&, OutputVector*, const core::collision::Intersection* currentIntersection);
     int computeIntersection(collision::geometry::Ray&, collision::geometry::Triangle&, OutputVector*, const core::collision::Intersection* currentIntersection);
 
+    /// Intersections of a list of candidate pairs of elements of two models. The pairs [begin, end) of the list are
+    /// culled by packets (see ProximityCulling) before the pair by pair tests above. The contacts are the same, in the
+    /// same order, as the ones of the pair by pair tests: disjoint ranges of the list can be computed by different
+    /// threads, and their contacts concatenated.
+    int computeIntersection(collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector*, const core::collision::Intersection* currentIntersection);
+    int computeIntersection(collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector*, const core::collision::Intersection* currentIntersection);
+
     /// These methods check the validity of a found intersection.
     /// According to the local configuration around the found intersected primitive,
     /// we build a "Region Of Interest" geometric cone.
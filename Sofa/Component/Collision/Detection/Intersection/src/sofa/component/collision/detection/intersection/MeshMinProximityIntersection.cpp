@@ -22,6 +22,7 @@
 #include <sofa/component/collision/detection/intersection/MeshMinProximityIntersection.h>
 
 #include <sofa/component/collision/detection/intersection/DiscreteIntersection.h>
+#include <sofa/component/collision/detection/intersection/ProximityCulling.h>
 #include <sofa/core/collision/Intersection.inl>
 #include <sofa/core/collision/IntersectorFactory.h>
 
@@ -356,6 +357,28 @@ int MeshMinProximityIntersection::computeIntersection(Triangle& e2, Point& e1, O
     return 1;
 }
 
+int MeshMinProximityIntersection::computeIntersection(TriangleCollisionModel<Vec3Types>* model1, PointCollisionModel<Vec3Types>* model2, const ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity();
+
+    return ProximityCulling::cullTrianglePointPairs(model1, model2, pairs, begin, end, alarmDist, 0.000001,
+        [this, contacts, currentIntersection](Triangle& e2, Point& e1)
+        {
+            return computeIntersection(e2, e1, contacts, currentIntersection);
+        });
+}
+
+int MeshMinProximityIntersection::computeIntersection(LineCollisionModel<Vec3Types>* model1, LineCollisionModel<Vec3Types>* model2, const ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    const SReal alarmDist = currentIntersection->getAlarmDistance() + model1->getProximity() + model2->getProximity();
+
+    return ProximityCulling::cullLineLinePairs(model1, model2, pairs, begin, end, alarmDist, 0.000001, 1.0e-15,
+        [this, contacts, currentIntersection](Line& e1, Line& e2)
+        {
+            return computeIntersection(e1, e2, contacts, currentIntersection);
+        });
+}
+
 bool MeshMinProximityIntersection::testIntersection(Line& e2, Point& e1, const core::collision::Intersection* currentIntersection)
 {
     const SReal alarmDist = currentIntersection->getAlarmDistance() + e1.getProximity() + e2.getProximity();
@@ -56,6 +56,13 @@ public:
     int computeIntersection(collision::geometry::Triangle&, collision::geometry::Point&, OutputVector*, const core::collision::Intersection* currentIntersection);
     template<class T> int computeIntersection(collision::geometry::Triangle&, collision::geometry::TSphere<T>&, OutputVector*, const core::collision::Intersection* currentIntersection);
 
+    /// Intersections of a list of candidate pairs of elements of two models. The pairs [begin, end) of the list are
+    /// culled by packets (see ProximityCulling) before the pair by pair tests above. The contacts are the same, in the
+    /// same order, as the ones of the pair by pair tests: disjoint ranges of the list can be computed by different
+    /// threads, and their contacts concatenated.
+    int computeIntersection(collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector*, const core::collision::Intersection* currentIntersection);
+    int computeIntersection(collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>*, const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end, OutputVector*, const core::collision::Intersection* currentIntersection);
+
 
     SOFA_ATTRIBUTE_DISABLED__COLLISION_DETECTION_INTERSECTION_AS_PARAMETER()
     bool testIntersection(collision::geometry::Point&, collision::geometry::Point&) = delete;
@@ -0,0 +1,142 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/detection/intersection/ProximityCulling.h>
+
+namespace sofa::component::collision::detection::intersection
+{
+
+namespace
+{
+/// Margin on the barycentric coordinates and on the relative squared distances, covering the
+/// differences of rounding between the packet computations and the exact tests
+constexpr ProximityCulling::Real cullingTolerance = 1e-6;
+
+/// A lane is tested only if the determinant of its 2x2 system is larger than this ratio of the
+/// product of its diagonal terms, i.e. if the system is well conditioned
+constexpr ProximityCulling::Real minDeterminantRatio = 1e-6;
+}
+
+void ProximityCulling::TrianglePointPacket::set(std::size_t lane, const type::Vec3& a, const type::Vec3& b, const type::Vec3& c, const type::Vec3& p)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        this->a[i][lane] = a[i];
+        this->ab[i][lane] = b[i] - a[i];
+        this->ac[i][lane] = c[i] - a[i];
+        this->p[i][lane] = p[i];
+    }
+}
+
+void ProximityCulling::LineLinePacket::set(std::size_t lane, const type::Vec3& a, const type::Vec3& b, const type::Vec3& c, const type::Vec3& d)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        this->a[i][lane] = a[i];
+        this->ab[i][lane] = b[i] - a[i];
+        this->c[i][lane] = c[i];
+        this->cd[i][lane] = d[i] - c[i];
+    }
+}
+
+void ProximityCulling::cullTrianglePoint(const TrianglePointPacket& packet, Real alarmDist, Real minBarycentric, int* culled)
+{
+    const Real alarmDist2 = alarmDist * alarmDist;
+    const Real minCoord = minBarycentric - cullingTolerance;
+    const Real maxSum = 1 - minBarycentric + cullingTolerance;
+
+    for (std::size_t l = 0; l < PacketSize; ++l)
+    {
+        Real ap[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            ap[i] = packet.p[i][l] - packet.a[i][l];
+        }
+
+        const Real a00 = packet.ab[0][l] * packet.ab[0][l] + packet.ab[1][l] * packet.ab[1][l] + packet.ab[2][l] * packet.ab[2][l];
+        const Real a11 = packet.ac[0][l] * packet.ac[0][l] + packet.ac[1][l] * packet.ac[1][l] + packet.ac[2][l] * packet.ac[2][l];
+        const Real a01 = packet.ab[0][l] * packet.ac[0][l] + packet.ab[1][l] * packet.ac[1][l] + packet.ab[2][l] * packet.ac[2][l];
+        const Real b0 = ap[0] * packet.ab[0][l] + ap[1] * packet.ab[1][l] + ap[2] * packet.ab[2][l];
+        const Real b1 = ap[0] * packet.ac[0][l] + ap[1] * packet.ac[1][l] + ap[2] * packet.ac[2][l];
+        const Real ap2 = ap[0] * ap[0] + ap[1] * ap[1] + ap[2] * ap[2];
+
+        const Real det = a00 * a11 - a01 * a01;
+        const bool wellConditioned = det > minDeterminantRatio * a00 * a11;
+        const Real invDet = 1 / (wellConditioned ? det : Real(1));
+
+        const Real alpha = (b0 * a11 - b1 * a01) * invDet;
+        const Real beta = (b1 * a00 - b0 * a01) * invDet;
+
+        Real dist2 = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            const Real pq = packet.ab[i][l] * alpha + packet.ac[i][l] * beta - ap[i];
+            dist2 += pq * pq;
+        }
+
+        const bool outside = (alpha < minCoord) | (beta < minCoord) | (alpha + beta > maxSum);
+        const bool far = dist2 > alarmDist2 + cullingTolerance * (alarmDist2 + ap2);
+        culled[l] = wellConditioned & (outside | far);
+    }
+}
+
+void ProximityCulling::cullLineLine(const LineLinePacket& packet, Real alarmDist, Real minBarycentric, Real minDeterminant, int* culled)
+{
+    const Real alarmDist2 = alarmDist * alarmDist;
+    const Real minCoord = minBarycentric - cullingTolerance;
+    const Real maxCoord = 1 - minBarycentric + cullingTolerance;
+
+    for (std::size_t l = 0; l < PacketSize; ++l)
+    {
+        Real ac[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            ac[i] = packet.c[i][l] - packet.a[i][l];
+        }
+
+        const Real a00 = packet.ab[0][l] * packet.ab[0][l] + packet.ab[1][l] * packet.ab[1][l] + packet.ab[2][l] * packet.ab[2][l];
+        const Real a11 = packet.cd[0][l] * packet.cd[0][l] + packet.cd[1][l] * packet.cd[1][l] + packet.cd[2][l] * packet.cd[2][l];
+        const Real a01 = -(packet.ab[0][l] * packet.cd[0][l] + packet.ab[1][l] * packet.cd[1][l] + packet.ab[2][l] * packet.cd[2][l]);
+        const Real b0 = ac[0] * packet.ab[0][l] + ac[1] * packet.ab[1][l] + ac[2] * packet.ab[2][l];
+        const Real b1 = -(ac[0] * packet.cd[0][l] + ac[1] * packet.cd[1][l] + ac[2] * packet.cd[2][l]);
+        const Real ac2 = ac[0] * ac[0] + ac[1] * ac[1] + ac[2] * ac[2];
+
+        const Real det = a00 * a11 - a01 * a01;
+        const bool wellConditioned = (det > minDeterminantRatio * a00 * a11) & (det > 2 * minDeterminant);
+        const Real invDet = 1 / (wellConditioned ? det : Real(1));
+
+        const Real alpha = (b0 * a11 - b1 * a01) * invDet;
+        const Real beta = (b1 * a00 - b0 * a01) * invDet;
+
+        Real dist2 = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            const Real pq = ac[i] + packet.cd[i][l] * beta - packet.ab[i][l] * alpha;
+            dist2 += pq * pq;
+        }
+
+        const bool outside = (alpha < minCoord) | (alpha > maxCoord) | (beta < minCoord) | (beta > maxCoord);
+        const bool far = dist2 > alarmDist2 + cullingTolerance * (alarmDist2 + ac2 + a00 + a11);
+        culled[l] = wellConditioned & (outside | far);
+    }
+}
+
+} // namespace sofa::component::collision::detection::intersection
@@ -0,0 +1,157 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/collision/detection/intersection/config.h>
+
+#include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/collision/Intersection.h>
+#include <sofa/type/Vec.h>
+
+#include <algorithm>
+
+namespace sofa::component::collision::detection::intersection
+{
+
+/**
+ * Conservative culling of candidate pairs of primitives before their exact proximity test.
+ * The pairs are evaluated by packets of PacketSize pairs, stored as structure of arrays, with
+ * loops on the lanes written without branches so that they are vectorized by the compiler.
+ * The closest points are computed as in the exact tests, and a lane is culled only if the exact
+ * test would reject it by a clear margin: the lanes close to the limits, and the lanes with
+ * degenerate primitives, are kept and given to the exact test.
+ */
+class SOFA_COMPONENT_COLLISION_DETECTION_INTERSECTION_API ProximityCulling
+{
+public:
+    using Real = SReal;
+
+    static constexpr std::size_t PacketSize = 8;
+
+    /// Triangles (a, b, c) and points p
+    struct TrianglePointPacket
+    {
+        Real a[3][PacketSize] {};
+        Real ab[3][PacketSize] {};
+        Real ac[3][PacketSize] {};
+        Real p[3][PacketSize] {};
+
+        void set(std::size_t lane, const type::Vec3& a, const type::Vec3& b, const type::Vec3& c, const type::Vec3& p);
+    };
+
+    /// Segments (a, b) and segments (c, d)
+    struct LineLinePacket
+    {
+        Real a[3][PacketSize] {};
+        Real ab[3][PacketSize] {};
+        Real c[3][PacketSize] {};
+        Real cd[3][PacketSize] {};
+
+        void set(std::size_t lane, const type::Vec3& a, const type::Vec3& b, const type::Vec3& c, const type::Vec3& d);
+    };
+
+    /// Sets culled[lane] to a non-zero value if the projection of the point on the plane of the triangle is
+    /// outside of the triangle (a barycentric coordinate lower than minBarycentric), or if it is further
+    /// than alarmDist from the point.
+    static void cullTrianglePoint(const TrianglePointPacket& packet, Real alarmDist, Real minBarycentric, int* culled);
+
+    /// Sets culled[lane] to a non-zero value if the closest points of the lines supporting the segments are
+    /// outside of the segments (a parameter outside of [minBarycentric, 1 - minBarycentric]), or if they are
+    /// further than alarmDist from each other.
+    /// Lines for which the determinant of the system giving the closest points is lower than minDeterminant
+    /// are considered as parallel and are never culled.
+    static void cullLineLine(const LineLinePacket& packet, Real alarmDist, Real minBarycentric, Real minDeterminant, int* culled);
+
+    /// Culls the (triangle, point) candidate pairs [begin, end) by packets and calls exactTest(triangle, point)
+    /// on the remaining ones, in the order of the pairs. Returns the sum of the values returned by exactTest.
+    template<class TriangleModel, class PointModel, class ExactTest>
+    static int cullTrianglePointPairs(TriangleModel* triangleModel, PointModel* pointModel,
+                                      const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end,
+                                      Real alarmDist, Real minBarycentric, ExactTest exactTest)
+    {
+        const auto& x1 = triangleModel->getMechanicalState()->read(core::ConstVecCoordId::position())->getValue();
+        const auto& x2 = pointModel->getMechanicalState()->read(core::ConstVecCoordId::position())->getValue();
+
+        int nbContacts = 0;
+        TrianglePointPacket packet;
+        int culled[PacketSize];
+        for (std::size_t first = begin; first < end; first += PacketSize)
+        {
+            const std::size_t last = std::min(end, first + PacketSize);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const typename TriangleModel::Element t(triangleModel, pairs[i].first);
+                packet.set(i - first, x1[t.p1Index()], x1[t.p2Index()], x1[t.p3Index()], x2[pairs[i].second]);
+            }
+            cullTrianglePoint(packet, alarmDist, minBarycentric, culled);
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (culled[i - first])
+                    continue;
+
+                typename TriangleModel::Element t(triangleModel, pairs[i].first);
+                typename PointModel::Element p(pointModel, pairs[i].second);
+                nbContacts += exactTest(t, p);
+            }
+        }
+        return nbContacts;
+    }
+
+    /// Culls the (line, line) candidate pairs [begin, end) by packets and calls exactTest(line1, line2)
+    /// on the remaining ones, in the order of the pairs. Returns the sum of the values returned by exactTest.
+    template<class LineModel, class ExactTest>
+    static int cullLineLinePairs(LineModel* lineModel1, LineModel* lineModel2,
+                                 const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end,
+                                 Real alarmDist, Real minBarycentric, Real minDeterminant, ExactTest exactTest)
+    {
+        const auto& x1 = lineModel1->getMechanicalState()->read(core::ConstVecCoordId::position())->getValue();
+        const auto& x2 = lineModel2->getMechanicalState()->read(core::ConstVecCoordId::position())->getValue();
+
+        int nbContacts = 0;
+        LineLinePacket packet;
+        int culled[PacketSize];
+        for (std::size_t first = begin; first < end; first += PacketSize)
+        {
+            const std::size_t last = std::min(end, first + PacketSize);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const typename LineModel::Element l1(lineModel1, pairs[i].first);
+                const typename LineModel::Element l2(lineModel2, pairs[i].second);
+                packet.set(i - first, x1[l1.i1()], x1[l1.i2()], x2[l2.i1()], x2[l2.i2()]);
+            }
+            cullLineLine(packet, alarmDist, minBarycentric, minDeterminant, culled);
+
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (culled[i - first])
+                    continue;
+
+                typename LineModel::Element l1(lineModel1, pairs[i].first);
+                typename LineModel::Element l2(lineModel2, pairs[i].second);
+                nbContacts += exactTest(l1, l2);
+            }
+        }
+        return nbContacts;
+    }
+};
+
+} // namespace sofa::component::collision::detection::intersection
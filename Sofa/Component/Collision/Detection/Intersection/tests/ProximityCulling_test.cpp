@@ -0,0 +1,187 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <sofa/component/collision/detection/intersection/ProximityCulling.h>
+using sofa::component::collision::detection::intersection::ProximityCulling;
+
+#include <sofa/helper/random.h>
+#include <sofa/type/Mat.h>
+
+namespace
+{
+
+using sofa::type::Vec3;
+using Real = ProximityCulling::Real;
+
+Vec3 randomPosition(Real extent)
+{
+    return Vec3(sofa::helper::drand(extent), sofa::helper::drand(extent), sofa::helper::drand(extent));
+}
+
+/// Same computation as MeshMinProximityIntersection::computeIntersection(Triangle&, Point&, ...)
+bool isTrianglePointAccepted(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& p, Real alarmDist)
+{
+    const Vec3 AB = b - a;
+    const Vec3 AC = c - a;
+    const Vec3 AP = p - a;
+    sofa::type::Mat<2, 2, Real> A;
+    A[0][0] = AB * AB;
+    A[1][1] = AC * AC;
+    A[0][1] = A[1][0] = AB * AC;
+    const Real b0 = AP * AB;
+    const Real b1 = AP * AC;
+    const Real det = sofa::type::determinant(A);
+    const Real alpha = (b0 * A[1][1] - b1 * A[0][1]) / det;
+    const Real beta = (b1 * A[0][0] - b0 * A[1][0]) / det;
+    if (alpha < 0.000001 || beta < 0.000001 || alpha + beta > 0.999999)
+        return false;
+    const Vec3 QP = p - (a + AB * alpha + AC * beta);
+    return QP.norm2() < alarmDist * alarmDist;
+}
+
+/// Same computation as LocalMinDistance::computeIntersection(Line&, Line&, ...), without the cone filters
+bool isLineLineAccepted(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d, Real alarmDist)
+{
+    const Vec3 AB = b - a;
+    const Vec3 CD = d - c;
+    const Vec3 AC = c - a;
+    sofa::type::Mat<2, 2, Real> A;
+    A[0][0] = AB * AB;
+    A[1][1] = CD * CD;
+    A[0][1] = A[1][0] = -CD * AB;
+    const Real b0 = AB * AC;
+    const Real b1 = -CD * AC;
+    const Real det = sofa::type::determinant(A);
+    Real alpha = 0.5;
+    Real beta = 0.5;
+    if (det < -1.0e-30 || det > 1.0e-30)
+    {
+        alpha = (b0 * A[1][1] - b1 * A[0][1]) / det;
+        beta = (b1 * A[0][0] - b0 * A[1][0]) / det;
+        if (alpha < 1e-15 || alpha > (1.0 - 1e-15) || beta < 1e-15 || beta > (1.0 - 1e-15))
+            return false;
+    }
+    const Vec3 PQ = AC + CD * beta - AB * alpha;
+    return PQ.norm2() < alarmDist * alarmDist;
+}
+
+TEST(ProximityCulling_test, trianglePointIsConservative)
+{
+    const Real alarmDist = 0.1;
+    std::size_t nbCulled = 0;
+    std::size_t nbRejected = 0;
+
+    for (unsigned int packetId = 0; packetId < 200; ++packetId)
+    {
+        ProximityCulling::TrianglePointPacket packet;
+        bool accepted[ProximityCulling::PacketSize];
+        for (std::size_t l = 0; l < ProximityCulling::PacketSize; ++l)
+        {
+            const Vec3 a = randomPosition(1);
+            const Vec3 b = randomPosition(1);
+            const Vec3 c = randomPosition(1);
+
+            // half of the points are close to the plane of the triangle
+            Vec3 p = randomPosition(1);
+            if (l % 2)
+            {
+                Vec3 n = (b - a).cross(c - a);
+                n.normalize();
+                p -= n * (n * (p - a)) + n * sofa::helper::drand(alarmDist);
+            }
+
+            packet.set(l, a, b, c, p);
+            accepted[l] = isTrianglePointAccepted(a, b, c, p, alarmDist);
+        }
+
+        int culled[ProximityCulling::PacketSize];
+        ProximityCulling::cullTrianglePoint(packet, alarmDist, 0.000001, culled);
+
+        for (std::size_t l = 0; l < ProximityCulling::PacketSize; ++l)
+        {
+            EXPECT_FALSE(accepted[l] && culled[l]) << "an accepted pair is culled in lane " << l << " of packet " << packetId;
+            nbCulled += (culled[l] != 0);
+            nbRejected += !accepted[l];
+        }
+    }
+
+    // almost all the rejected pairs are culled
+    EXPECT_GT(nbCulled, nbRejected * 9 / 10);
+}
+
+TEST(ProximityCulling_test, lineLineIsConservative)
+{
+    const Real alarmDist = 0.1;
+    std::size_t nbCulled = 0;
+    std::size_t nbRejected = 0;
+
+    for (unsigned int packetId = 0; packetId < 200; ++packetId)
+    {
+        ProximityCulling::LineLinePacket packet;
+        bool accepted[ProximityCulling::PacketSize];
+        for (std::size_t l = 0; l < ProximityCulling::PacketSize; ++l)
+        {
+            const Vec3 a = randomPosition(1);
+            const Vec3 b = randomPosition(1);
+
+            // some lanes have crossing or parallel segments
+            Vec3 c = randomPosition(1);
+            Vec3 d = randomPosition(1);
+            if (l % 4 == 1)
+            {
+                const Vec3 middle = (a + b) * 0.5 + randomPosition(alarmDist);
+                c = middle + randomPosition(0.5);
+                d = middle * 2 - c;
+            }
+            else if (l % 4 == 2)
+            {
+                c = a + randomPosition(alarmDist);
+                d = c + (b - a) * 0.5;
+            }
+
+            packet.set(l, a, b, c, d);
+            accepted[l] = isLineLineAccepted(a, b, c, d, alarmDist);
+        }
+
+        int culled[ProximityCulling::PacketSize];
+        ProximityCulling::cullLineLine(packet, alarmDist, 1e-15, 1.0e-30, culled);
+
+        for (std::size_t l = 0; l < ProximityCulling::PacketSize; ++l)
+        {
+            EXPECT_FALSE(accepted[l] && culled[l]) << "an accepted pair is culled in lane " << l << " of packet " << packetId;
+
+            // the parallel segments are never culled
+            if (l % 4 != 2)
+            {
+                nbCulled += (culled[l] != 0);
+                nbRejected += !accepted[l];
+            }
+        }
+    }
+
+    // almost all the rejected pairs are culled
+    EXPECT_GT(nbCulled, nbRejected * 9 / 10);
+}
+
+}
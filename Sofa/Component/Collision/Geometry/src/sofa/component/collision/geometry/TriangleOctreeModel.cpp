@@ -24,6 +24,8 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/component/collision/geometry/CubeModel.h>
 #include <sofa/core/ObjectFactory.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa::component::topology
 {
@@ -37,9 +39,25 @@ namespace sofa::component::collision::geometry
 int TriangleOctreeModelClass =	core::RegisterObject ("collision model using a triangular mesh mapped to an Octree").add <	TriangleOctreeModel > ().addAlias ("TriangleOctree");
 
 TriangleOctreeModel::TriangleOctreeModel ()
+    : d_parallelBuild(initData(&d_parallelBuild, false, "parallelBuild", "If true, build the bounding volume hierarchy in parallel"))
 {
 }
 
+void TriangleOctreeModel::init()
+{
+    TriangleCollisionModel<sofa::defaulttype::Vec3Types>::init();
+
+    if (d_parallelBuild.getValue())
+    {
+        auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+    }
+}
+
 void TriangleOctreeModel::draw (const core::visual::VisualParams* vparams)
 {
     const auto stateLifeCycle = vparams->drawTool()->makeStateLifeCycle();
@@ -57,6 +75,8 @@ void TriangleOctreeModel::draw (const core::visual::VisualParams* vparams)
 
         if(octreeRoot)
             octreeRoot->draw(vparams->drawTool());
+        else
+            m_bvh.draw(vparams->drawTool());
 
         vparams->drawTool()->disableLighting();
         if (vparams->displayFlags().getShowWireFrame ())
@@ -74,6 +94,7 @@ void TriangleOctreeModel::computeBoundingTree(int maxDepth)
         delete octreeRoot;
         octreeRoot=nullptr;
     }
+    m_bvh.clear();
 
     CubeCollisionModel* cubeModel = createPrevious<CubeCollisionModel>();
     updateFromTopology();
@@ -138,4 +159,23 @@ void TriangleOctreeModel::buildOctree()
     TriangleOctreeRoot::buildOctree();
 }
 
+void TriangleOctreeModel::buildBVH()
+{
+    helper::TriangleBVH::ParallelForRange parallelFor;
+    if (d_parallelBuild.getValue())
+    {
+        auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        parallelFor = [taskScheduler](std::size_t size, const helper::TriangleBVH::RangeTask& task)
+        {
+            simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+                [&task](const auto& range)
+                {
+                    task(range.start, range.end);
+                });
+        };
+    }
+
+    m_bvh.build(this->getTriangles(), this->getX(), parallelFor);
+}
+
 } // namespace sofa::component::collision::geometry
@@ -27,6 +27,7 @@
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/defaulttype/VecTypes.h>
 #include <sofa/helper/TriangleOctree.h>
+#include <sofa/helper/TriangleBVH.h>
 #include <sofa/component/collision/geometry/TriangleModel.h>
 
 
@@ -43,11 +44,23 @@ public:
 
     /// the normals for each point
     type::vector<type::Vec3> pNorms;
+
+    Data<bool> d_parallelBuild; ///< If true, build the bounding volume hierarchy in parallel
+
+    void init() override;
     void draw(const core::visual::VisualParams* vparams) override;
     void computeBoundingTree(int maxDepth=0) override;
     void computeContinuousBoundingTree(SReal dt, int maxDepth=0) override;
     /// init the octree creation
     void buildOctree ();
+
+    /// build the flat bounding volume hierarchy used for the ray tracing queries
+    void buildBVH();
+    bool isBVHBuilt() const { return !m_bvh.empty(); }
+    const helper::TriangleBVH& getBVH() const { return m_bvh; }
+
+protected:
+    helper::TriangleBVH m_bvh;
 };
 
 } // namespace sofa::component::collision::geometry
@@ -27,9 +27,21 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/core/collision/Pipeline.h>
 
+#include <algorithm>
+
 namespace sofa::component::collision::response::contact
 {
 
+namespace
+{
+/// Root of the scene graph containing the object, or nullptr if the object was removed from its node
+const core::objectmodel::BaseContext* getSceneRoot(const core::objectmodel::BaseObject* object)
+{
+    const core::objectmodel::BaseContext* context = object->getContext();
+    return context ? context->getRootContext() : nullptr;
+}
+}
+
 int CollisionResponseClass = core::RegisterObject("Default class to create reactions to the collisions")
         .add< CollisionResponse >()
         .addAlias("DefaultContactManager")
@@ -38,9 +50,17 @@ int CollisionResponseClass = core::RegisterObject("Default class to create react
 CollisionResponse::CollisionResponse()
     : d_response(initData(&d_response, "response", "contact response class"))
     , d_responseParams(initData(&d_responseParams, "responseParams", "contact response parameters (syntax: name1=value1&name2=value2&...)"))
+    , d_contactPoolSize(initData(&d_contactPoolSize, 0u, "contactPoolSize", "Maximum number of inactive contacts kept to be reused, with their mappers, if the same pair of models collides again. 0 means that the inactive contacts are destroyed"))
+    , d_nbCreatedContacts(initData(&d_nbCreatedContacts, 0u, "nbCreatedContacts", "Number of contacts created during the last time step"))
+    , d_nbReusedContacts(initData(&d_nbReusedContacts, 0u, "nbReusedContacts", "Number of contacts taken from the pool of inactive contacts during the last time step"))
+    , d_nbDestroyedContacts(initData(&d_nbDestroyedContacts, 0u, "nbDestroyedContacts", "Number of contacts destroyed during the last time step"))
 {
     response.setOriginalData(&d_response);
     responseParams.setOriginalData(&d_responseParams);
+
+    d_nbCreatedContacts.setReadOnly(true);
+    d_nbReusedContacts.setReadOnly(true);
+    d_nbDestroyedContacts.setReadOnly(true);
 }
 
 sofa::helper::OptionsGroup CollisionResponse::initializeResponseOptions(sofa::core::objectmodel::BaseContext *context)
@@ -89,6 +109,8 @@ void CollisionResponse::cleanup()
     }
     contacts.clear();
     contactMap.clear();
+
+    trimContactPool(0);
 }
 
 void CollisionResponse::reset()
@@ -139,6 +161,15 @@ void CollisionResponse::createContacts(const DetectionOutputMap& outputsMap)
 
     // notify each collision model how many contacts has been detected on it
     setNumberOfContacts();
+
+    d_nbCreatedContacts.setValue(m_nbCreatedContacts);
+    d_nbReusedContacts.setValue(m_nbReusedContacts);
+    d_nbDestroyedContacts.setValue(m_nbDestroyedContacts);
+
+    // the contacts removed after the collision response (e.g. by a topological change) are counted in the next time step
+    m_nbCreatedContacts = 0;
+    m_nbReusedContacts = 0;
+    m_nbDestroyedContacts = 0;
 }
 
 void CollisionResponse::createNewContacts(const core::collision::ContactManager::DetectionOutputMap &outputsMap,
@@ -160,6 +191,16 @@ void CollisionResponse::createNewContacts(const core::collision::ContactManager:
 
             std::string responseUsed = getContactResponse(model1, model2);
 
+            if (auto pooledContact = takeFromContactPool(models, responseUsed))
+            {
+                // the pair of models was in contact previously: its contact and mappers are reused
+                contactIt->second = pooledContact;
+                pooledContact->setDetectionOutputs(output);
+                ++m_nbReusedContacts;
+                ++nbContact;
+                continue;
+            }
+
             // We can create rules in order to not respond to specific collisions
             if (!responseUsed.compare("nullptr"))
             {
@@ -184,6 +225,7 @@ void CollisionResponse::createNewContacts(const core::collision::ContactManager:
                     contact->f_printLog.setValue(notMuted());
                     contact->init();
                     contact->setDetectionOutputs(output);
+                    ++m_nbCreatedContacts;
                     ++nbContact;
                 }
             }
@@ -222,9 +264,7 @@ CollisionResponse::removeInactiveContacts(const core::collision::ContactManager:
             }
             else
             {
-                contact->removeResponse();
-                contact->cleanup();
-                contact.reset();
+                releaseContact(contactIt->first, contact);
                 contactIt = contactMap.erase(contactIt);
             }
         }
@@ -233,6 +273,84 @@ CollisionResponse::removeInactiveContacts(const core::collision::ContactManager:
             ++contactIt;
         }
     }
+
+    purgeRemovedModelsFromContactPool();
+    trimContactPool(d_contactPoolSize.getValue());
+}
+
+core::collision::Contact::SPtr CollisionResponse::takeFromContactPool(const std::pair<core::CollisionModel*, core::CollisionModel*>& models, const std::string& response)
+{
+    const auto indexed = contactPoolIndex.find(models);
+    if (indexed == contactPoolIndex.end())
+    {
+        return nullptr;
+    }
+
+    const ContactPool::iterator pooled = indexed->second;
+    if (pooled->response != response)
+    {
+        // the response of the pair has changed: the pooled contact cannot be reused
+        destroyPooledContact(pooled);
+        return nullptr;
+    }
+
+    core::collision::Contact::SPtr contact = pooled->contact;
+    contactPoolIndex.erase(indexed);
+    contactPool.erase(pooled);
+    return contact;
+}
+
+void CollisionResponse::releaseContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models, core::collision::Contact::SPtr contact)
+{
+    contact->removeResponse();
+    if (d_contactPoolSize.getValue() > 0)
+    {
+        const auto indexed = contactPoolIndex.find(models);
+        if (indexed != contactPoolIndex.end())
+        {
+            destroyPooledContact(indexed->second);
+        }
+        contactPool.push_front({ {models.first, models.second}, getContactResponse(models.first, models.second), contact });
+        contactPoolIndex.emplace(models, contactPool.begin());
+    }
+    else
+    {
+        contact->cleanup();
+        ++m_nbDestroyedContacts;
+    }
+}
+
+CollisionResponse::ContactPool::iterator CollisionResponse::destroyPooledContact(const ContactPool::iterator pooled)
+{
+    pooled->contact->cleanup();
+    contactPoolIndex.erase({ pooled->models.first.get(), pooled->models.second.get() });
+    ++m_nbDestroyedContacts;
+    return contactPool.erase(pooled);
+}
+
+void CollisionResponse::trimContactPool(const unsigned int poolSize)
+{
+    while (contactPool.size() > poolSize)
+    {
+        destroyPooledContact(std::prev(contactPool.end()));
+    }
+}
+
+void CollisionResponse::purgeRemovedModelsFromContactPool()
+{
+    const core::objectmodel::BaseContext* root = getSceneRoot(this);
+    for (auto it = contactPool.begin(); it != contactPool.end();)
+    {
+        const auto& [model1, model2] = it->models;
+        if (getSceneRoot(model1.get()) != root || getSceneRoot(model2.get()) != root)
+        {
+            it = destroyPooledContact(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 void
@@ -343,12 +461,23 @@ void CollisionResponse::removeContacts(const ContactVector &c)
                 (*it)->cleanup();
                 it->reset();
                 contacts.erase(it);
+                ++m_nbDestroyedContacts;
                 break;
             }
 
             ++it;
         }
 
+        // Inactive contacts kept for reuse
+        for (auto pool_it = contactPool.begin(); pool_it != contactPool.end(); ++pool_it)
+        {
+            if (pool_it->contact == *remove_it)
+            {
+                destroyPooledContact(pool_it);
+                break;
+            }
+        }
+
         // Stored contacts (keeping alive)
         map_it = contactMap.begin();
         map_itEnd = contactMap.end();
@@ -29,6 +29,8 @@
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
+#include <list>
+
 namespace sofa::component::collision::response::contact
 {
 
@@ -46,6 +48,10 @@ public :
 
     Data<sofa::helper::OptionsGroup> d_response; ///< contact response class
     Data<std::string> d_responseParams; ///< contact response parameters (syntax: name1=value1&name2=value2&...)
+    Data<unsigned int> d_contactPoolSize; ///< Maximum number of inactive contacts kept to be reused
+    Data<unsigned int> d_nbCreatedContacts; ///< Number of contacts created during the last time step
+    Data<unsigned int> d_nbReusedContacts; ///< Number of contacts taken from the pool of inactive contacts during the last time step
+    Data<unsigned int> d_nbDestroyedContacts; ///< Number of contacts destroyed during the last time step
 
     /// outputsVec fixes the reproducibility problems by storing contacts in the collision detection saved order
     /// if not given, it is still working but with eventual reproducibility problems
@@ -123,6 +129,24 @@ protected:
     ContactMap contactMap;
     std::map<Instance,ContactMap> storedContactMap;
 
+    /// Inactive contact, with the response of its pair of models when it was released
+    struct PooledContact
+    {
+        std::pair<core::CollisionModel::SPtr, core::CollisionModel::SPtr> models;
+        std::string response;
+        core::collision::Contact::SPtr contact;
+    };
+    using ContactPool = std::list<PooledContact>;
+
+    /// Inactive contacts, most recently used first. Their response is removed from the scene graph, but
+    /// their mappers are kept, so that they are reused without any allocation if the same pair of models
+    /// collides again with the same response. The models are referenced, so that the address of a removed
+    /// model cannot be reused by a new model while its contact is in the pool.
+    ContactPool contactPool;
+
+    /// Entries of contactPool, indexed by their pair of models
+    std::map< std::pair<core::CollisionModel*, core::CollisionModel*>, ContactPool::iterator > contactPoolIndex;
+
     void changeInstance(Instance inst) override ;
 
     static sofa::helper::OptionsGroup initializeResponseOptions(sofa::core::objectmodel::BaseContext *pipeline);
@@ -139,6 +163,27 @@ protected:
 
     void removeInactiveContacts(const DetectionOutputMap &outputsMap, Size& nbContact);
 
+    /// Returns the contact of the pool created for the given pair of models, and removes it from the pool.
+    /// A pooled contact whose response differs from the given one is destroyed, and nullptr is returned.
+    core::collision::Contact::SPtr takeFromContactPool(const std::pair<core::CollisionModel*, core::CollisionModel*>& models, const std::string& response);
+
+    /// Keeps an inactive contact in the pool, or destroys it if the pool is disabled
+    void releaseContact(const std::pair<core::CollisionModel*, core::CollisionModel*>& models, core::collision::Contact::SPtr contact);
+
+    /// Destroys the least recently used contacts of the pool until its size does not exceed contactPoolSize
+    void trimContactPool(unsigned int poolSize);
+
+    /// Destroys the contacts of the pool whose models are no longer in the scene graph of this component
+    void purgeRemovedModelsFromContactPool();
+
+    /// Destroys a contact of the pool, and returns the next entry
+    ContactPool::iterator destroyPooledContact(ContactPool::iterator pooled);
+
+    /// Number of contacts created, reused and destroyed since the last collision response
+    unsigned int m_nbCreatedContacts { 0 };
+    unsigned int m_nbReusedContacts { 0 };
+    unsigned int m_nbDestroyedContacts { 0 };
+
     /// compute and set the number of contacts attached to each collision model
     /// The number of contacts corresponds to the number of collision models
     /// currently in contact with a collision model.
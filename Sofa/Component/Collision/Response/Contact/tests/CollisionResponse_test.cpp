@@ -0,0 +1,196 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/collision/response/contact/CollisionResponse.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/common/SceneLoaderXML.h>
+#include <sofa/testing/BaseSimulationTest.h>
+
+#include <sstream>
+
+namespace sofa
+{
+
+using sofa::component::collision::response::contact::CollisionResponse;
+using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<sofa::defaulttype::Vec3Types>;
+
+/**
+ * A fixed sphere and a sphere which is moved in and out of contact with it, to check the pool of inactive contacts
+ */
+struct CollisionResponse_test : public sofa::testing::BaseSimulationTest
+{
+    simulation::Node::SPtr root;
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    void createScene(unsigned int contactPoolSize)
+    {
+        std::stringstream scene;
+        scene << "<?xml version='1.0'?>"
+                 "<Node name='root' dt='0.01' gravity='0 0 0'>"
+                 "  <RequiredPlugin name='Sofa.Component.Collision'/>"
+                 "  <RequiredPlugin name='Sofa.Component.StateContainer'/>"
+                 "  <DefaultAnimationLoop/>"
+                 "  <CollisionPipeline/>"
+                 "  <BruteForceBroadPhase/>"
+                 "  <BVHNarrowPhase/>"
+                 "  <NewProximityIntersection alarmDistance='0.5' contactDistance='0.1'/>"
+                 "  <CollisionResponse name='response' response='PenalityContactForceField' contactPoolSize='" << contactPoolSize << "'/>"
+                 "  <Node name='fixed'>"
+                 "    <MechanicalObject template='Vec3d' position='0 0 0'/>"
+                 "    <SphereCollisionModel radius='1' moving='0' simulated='0'/>"
+                 "  </Node>"
+                 "  <Node name='moving'>"
+                 "    <MechanicalObject name='dofs' template='Vec3d' position='10 0 0'/>"
+                 "    <SphereCollisionModel name='sphere' radius='1'/>"
+                 "  </Node>"
+                 "</Node>";
+
+        root = simulation::SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        ASSERT_NE(root, nullptr);
+        sofa::simulation::node::initRoot(root.get());
+    }
+
+    /// Moves the sphere at the given distance from the fixed one, and performs a time step
+    void stepAt(SReal x)
+    {
+        auto* dofs = dynamic_cast<MechanicalObject3*>(root->getChild("moving")->getObject("dofs"));
+        ASSERT_NE(dofs, nullptr);
+        {
+            auto positions = sofa::helper::getWriteAccessor(*dofs->write(core::VecCoordId::position()));
+            positions[0] = type::Vec3(x, 0, 0);
+        }
+        sofa::simulation::node::animate(root.get(), root->getDt());
+    }
+
+    /// Numbers of contacts created, reused and destroyed during the last time step
+    void checkContacts(unsigned int nbCreated, unsigned int nbReused, unsigned int nbDestroyed) const
+    {
+        const auto* response = dynamic_cast<CollisionResponse*>(root->getObject("response"));
+        ASSERT_NE(response, nullptr);
+        EXPECT_EQ(response->d_nbCreatedContacts.getValue(), nbCreated);
+        EXPECT_EQ(response->d_nbReusedContacts.getValue(), nbReused);
+        EXPECT_EQ(response->d_nbDestroyedContacts.getValue(), nbDestroyed);
+    }
+};
+
+TEST_F(CollisionResponse_test, withoutPool)
+{
+    createScene(0);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+
+    stepAt(10);
+    checkContacts(0, 0, 1);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+}
+
+TEST_F(CollisionResponse_test, reuseInactiveContact)
+{
+    createScene(4);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+
+    // the contact is kept in the pool
+    stepAt(10);
+    checkContacts(0, 0, 0);
+
+    // and reused when the spheres collide again
+    stepAt(1.5);
+    checkContacts(0, 1, 0);
+
+    stepAt(1.5);
+    checkContacts(0, 0, 0);
+}
+
+TEST_F(CollisionResponse_test, pooledContactWithAnotherResponseIsNotReused)
+{
+    createScene(4);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+
+    stepAt(10);
+    checkContacts(0, 0, 0);
+
+    // the pair of models no longer responds to the collisions: the pooled contact is destroyed instead of being reused
+    root->getChild("moving")->getObject("sphere")->findData("contactResponse")->read("nullptr");
+
+    stepAt(1.5);
+    checkContacts(0, 0, 1);
+}
+
+TEST_F(CollisionResponse_test, removedPooledContactIsCounted)
+{
+    createScene(4);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+    auto* response = dynamic_cast<CollisionResponse*>(root->getObject("response"));
+    ASSERT_NE(response, nullptr);
+    const CollisionResponse::ContactVector contacts = response->getContacts();
+    ASSERT_EQ(contacts.size(), 1u);
+
+    stepAt(10);
+    checkContacts(0, 0, 0);
+
+    // the contact removed from the pool is counted at the next collision response, and is no longer reused
+    response->removeContacts(contacts);
+
+    stepAt(10);
+    checkContacts(0, 0, 1);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+}
+
+TEST_F(CollisionResponse_test, removedModelIsPurgedFromPool)
+{
+    createScene(4);
+
+    stepAt(1.5);
+    checkContacts(1, 0, 0);
+
+    stepAt(10);
+    checkContacts(0, 0, 0);
+
+    // the pooled contact refers to a model which is no longer in the scene graph: it is destroyed at the next time
+    // step, although the pool is not full
+    simulation::Node* moving = root->getChild("moving");
+    moving->removeObject(moving->getObject("sphere"));
+
+    stepAt(1.5);
+    checkContacts(0, 0, 1);
+}
+
+}
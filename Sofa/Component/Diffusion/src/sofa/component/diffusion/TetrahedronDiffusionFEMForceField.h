@@ -29,6 +29,7 @@
 #include <sofa/type/Mat.h>
 #include <sofa/core/topology/TopologyData.h>
 #include <sofa/core/behavior/MechanicalState.h>
+#include <sofa/core/DataTracker.h>
 
 namespace sofa::component::diffusion
 {
@@ -111,6 +112,8 @@ public:
       Data<std::string> d_tagMeshMechanics;
       /// Boolean enabling to visualize the different diffusion coefficient
       Data <bool> d_drawConduc;
+      /// Boolean enabling the parallel computation of the diffusion forces and their derivatives
+      Data <bool> d_parallelComputation;
 
       /// Link to be set to the topology container in the component graph. 
       SingleLink<TetrahedronDiffusionFEMForceField<DataTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -120,8 +123,35 @@ protected:
       /// Function computing the edge diffusion coefficient from tetrahedral information
       void computeEdgeDiffusionCoefficient();
 
+      /// Recompute the edge diffusion coefficients if the diffusivity, the geometry or the topology changed since their last computation
+      void updateEdgeDiffusionCoefficient();
+
+      /// Function building the edge adjacency from the edge diffusion coefficients
+      void computeEdgeAdjacency();
+
+      /// Apply the function f(begin, end) on the ranges of vertices, in parallel if requested
+      template<class F>
+      void forEachVertexRange(std::size_t nbVertices, const F& f);
+
       /// Vector saving the edge diffusion coefficients
       sofa::type::vector<Real> edgeDiffusionCoefficient;
+
+      /// Edges around each vertex, in compressed sparse row format, with their diffusion coefficients.
+      /// The neighbors of a vertex are sorted, so that the rows of the system are traversed (and computed in
+      /// parallel) without scattering over the edges, and in the order of the columns.
+      struct EdgeAdjacency
+      {
+          sofa::type::vector<sofa::Index> rowBegin; ///< the edges around the vertex i are in [rowBegin[i], rowBegin[i+1])
+          sofa::type::vector<sofa::Index> neighbors; ///< the other vertex of each edge
+          sofa::type::vector<Real> coefficients; ///< the diffusion coefficient of each edge
+          sofa::type::vector<Real> diagonal; ///< sum of the diffusion coefficients of the edges around each vertex
+      };
+      EdgeAdjacency m_edgeAdjacency;
+
+      /// Tracking of the Data the edge diffusion coefficients are computed from
+      core::DataTracker m_dataTracker;
+      /// Revision of the topology when the edge diffusion coefficients were computed
+      int m_topologyRevision;
       /// Pointer to mechanical mechanicalObject
       typename MechObject::SPtr mechanicalObject;
       /// Pointer to topology
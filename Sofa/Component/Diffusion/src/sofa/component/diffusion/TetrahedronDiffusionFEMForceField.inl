@@ -28,6 +28,11 @@
 #include <sofa/core/behavior/MultiMatrixAccessor.h>
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
+#include <numeric>
 
 
 namespace sofa::component::diffusion
@@ -113,6 +118,109 @@ void TetrahedronDiffusionFEMForceField<DataTypes>::computeEdgeDiffusionCoefficie
             }
         }
     }
+
+    this->computeEdgeAdjacency();
+
+    m_dataTracker.clean();
+    m_topologyRevision = m_topology->getRevision();
+}
+
+
+template< class DataTypes>
+void TetrahedronDiffusionFEMForceField<DataTypes>::computeEdgeAdjacency()
+{
+    const auto nbPoints = m_topology->getNbPoints();
+    const auto& edges = m_topology->getEdges();
+
+    auto& rowBegin = m_edgeAdjacency.rowBegin;
+    auto& neighbors = m_edgeAdjacency.neighbors;
+    auto& coefficients = m_edgeAdjacency.coefficients;
+    auto& diagonal = m_edgeAdjacency.diagonal;
+
+    // count the edges around each vertex
+    rowBegin.assign(nbPoints + 1, 0);
+    for (sofa::Index i = 0; i < nbEdges; ++i)
+    {
+        ++rowBegin[edges[i][0] + 1];
+        ++rowBegin[edges[i][1] + 1];
+    }
+    std::partial_sum(rowBegin.begin(), rowBegin.end(), rowBegin.begin());
+
+    sofa::type::vector<std::pair<sofa::Index, Real> > row(2 * nbEdges);
+    sofa::type::vector<sofa::Index> next(rowBegin.begin(), rowBegin.end() - 1);
+    for (sofa::Index i = 0; i < nbEdges; ++i)
+    {
+        const auto v0 = edges[i][0];
+        const auto v1 = edges[i][1];
+        row[next[v0]++] = { v1, edgeDiffusionCoefficient[i] };
+        row[next[v1]++] = { v0, edgeDiffusionCoefficient[i] };
+    }
+
+    neighbors.resize(2 * nbEdges);
+    coefficients.resize(2 * nbEdges);
+    diagonal.assign(nbPoints, 0);
+    for (sofa::Index v = 0; v < nbPoints; ++v)
+    {
+        std::sort(row.begin() + rowBegin[v], row.begin() + rowBegin[v + 1],
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+        {
+            neighbors[k] = row[k].first;
+            coefficients[k] = row[k].second;
+            diagonal[v] += row[k].second;
+        }
+    }
+}
+
+
+template< class DataTypes>
+void TetrahedronDiffusionFEMForceField<DataTypes>::updateEdgeDiffusionCoefficient()
+{
+    if (m_topology == nullptr || mechanicalObject == nullptr)
+        return;
+
+    if (!m_dataTracker.hasChanged() && m_topologyRevision == m_topology->getRevision())
+        return;
+
+    if (d_tetraDiffusionCoefficient.getValue().size() != m_topology->getNbTetrahedra())
+    {
+        msg_error() << "Wrong size of the tetrahedral diffusion coefficients: " << d_tetraDiffusionCoefficient.getValue().size()
+                    << " instead of " << m_topology->getNbTetrahedra() << ". No diffusion is computed until they are fixed.";
+
+        // the adjacency may refer to vertices which do not exist anymore: it is emptied, so that no force is computed,
+        // and the error is reported again only if the coefficients or the topology change
+        m_edgeAdjacency = EdgeAdjacency();
+        m_dataTracker.clean();
+        m_topologyRevision = m_topology->getRevision();
+        return;
+    }
+
+    nbEdges = m_topology->getNbEdges();
+    this->computeEdgeDiffusionCoefficient();
+}
+
+
+template< class DataTypes>
+template<class F>
+void TetrahedronDiffusionFEMForceField<DataTypes>::forEachVertexRange(const std::size_t nbVertices, const F& f)
+{
+    if (d_parallelComputation.getValue())
+    {
+        simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+
+        simulation::parallelForEachRange(*taskScheduler, std::size_t(0), nbVertices,
+            [&f](const auto& range) { f(range.start, range.end); });
+    }
+    else
+    {
+        f(std::size_t(0), nbVertices);
+    }
 }
 
 
@@ -126,9 +234,11 @@ TetrahedronDiffusionFEMForceField<DataTypes>::TetrahedronDiffusionFEMForceField(
       d_transverseAnisotropyRatio(initData(&d_transverseAnisotropyRatio, (Real)1.0, "anisotropyRatio","Anisotropy ratio (r²>1).\n Default is 1.0 = isotropy.")),
       d_transverseAnisotropyDirectionArray(initData(&d_transverseAnisotropyDirectionArray, "transverseAnisotropyArray","Data to handle topology on tetrahedra")),
       d_tagMeshMechanics(initData(&d_tagMeshMechanics, std::string("meca"),"tagMechanics","Tag of the Mechanical Object.")),
-      d_drawConduc( initData(&d_drawConduc, (bool)false, "drawConduc","To display conductivity map."))
+      d_drawConduc( initData(&d_drawConduc, (bool)false, "drawConduc","To display conductivity map.")),
+      d_parallelComputation( initData(&d_parallelComputation, false, "parallelComputation","If true, the diffusion forces and their derivatives are computed in parallel."))
     , l_topology(initLink("topology", "link to the topology container"))
     , m_topology(nullptr)
+    , m_topologyRevision(-1)
 {
     this->f_listening.setValue(true);
 }
@@ -215,6 +325,16 @@ void TetrahedronDiffusionFEMForceField<DataTypes>::init()
         msg_info() << "isotropic diffusion.";
     }
 
+    // The edge diffusion coefficients are recomputed when the diffusivity or the geometry change
+    m_dataTracker.trackData(d_tetraDiffusionCoefficient);
+    m_dataTracker.trackData(d_transverseAnisotropyRatio);
+    m_dataTracker.trackData(d_transverseAnisotropyDirectionArray);
+    const core::objectmodel::BaseData* geometry = mechanicalObject->baseRead(core::ConstVecCoordId::position());
+    if (geometry != nullptr && geometry != this->mstate->baseRead(core::ConstVecCoordId::position()))
+    {
+        m_dataTracker.trackData(*geometry);
+    }
+
     // prepare to store info in the edge array
     this->computeEdgeDiffusionCoefficient();
 }
@@ -311,23 +431,30 @@ void TetrahedronDiffusionFEMForceField<DataTypes>::addForce (const core::Mechani
 {
     SCOPED_TIMER("addForceDiffusion");
 
+    this->updateEdgeDiffusionCoefficient();
+
     auto f = sofa::helper::getWriteOnlyAccessor(dataf);
     const VecCoord& x = datax.getValue();
 
-    sofa::Index v0,v1;
+    const auto& rowBegin = m_edgeAdjacency.rowBegin;
+    const auto& neighbors = m_edgeAdjacency.neighbors;
+    const auto& coefficients = m_edgeAdjacency.coefficients;
+    const auto& diagonal = m_edgeAdjacency.diagonal;
 
-    Coord dp;
-    const auto& edges = m_topology->getEdges();
-    for (sofa::Index i = 0; i < nbEdges; i++)
+    // each vertex only writes its own row of the force
+    const std::size_t nbVertices = std::min(diagonal.size(), x.size());
+    forEachVertexRange(nbVertices, [&](const std::size_t begin, const std::size_t end)
     {
-        v0 = edges[i][0];
-        v1 = edges[i][1];
-
-        dp = (x[v1] - x[v0]) * edgeDiffusionCoefficient[i];
-
-        f[v1] += dp;
-        f[v0] -= dp;
-    }
+        for (std::size_t v = begin; v < end; ++v)
+        {
+            Coord dp;
+            for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+            {
+                dp += (x[v] - x[neighbors[k]]) * coefficients[k];
+            }
+            f[v] += dp;
+        }
+    });
 }
 
 
@@ -335,24 +462,32 @@ template <class DataTypes>
 void TetrahedronDiffusionFEMForceField<DataTypes>::addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv&   datadF , const DataVecDeriv&   datadX)
 {
     SCOPED_TIMER("addDForceDiffusion");
+
+    this->updateEdgeDiffusionCoefficient();
+
     auto df = sofa::helper::getWriteOnlyAccessor(datadF);
     const VecDeriv& dx=datadX.getValue();
     Real kFactor = mparams->kFactor();
 
-    sofa::Index v0,v1;
+    const auto& rowBegin = m_edgeAdjacency.rowBegin;
+    const auto& neighbors = m_edgeAdjacency.neighbors;
+    const auto& coefficients = m_edgeAdjacency.coefficients;
+    const auto& diagonal = m_edgeAdjacency.diagonal;
 
-    Coord dp;
-    const auto& edges = m_topology->getEdges();
-    for(sofa::Index i=0; i<nbEdges; i++ )
+    // each vertex only writes its own row of the force derivative
+    const std::size_t nbVertices = std::min(diagonal.size(), dx.size());
+    forEachVertexRange(nbVertices, [&](const std::size_t begin, const std::size_t end)
     {
-        v0 = edges[i][0];
-        v1 = edges[i][1];
-
-        dp = (dx[v1]-dx[v0]) * edgeDiffusionCoefficient[i] * kFactor;
-
-        df[v1]+=dp;
-        df[v0]-=dp;
-    }
+        for (std::size_t v = begin; v < end; ++v)
+        {
+            Deriv dp;
+            for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+            {
+                dp += (dx[v] - dx[neighbors[k]]) * coefficients[k] * kFactor;
+            }
+            df[v] += dp;
+        }
+    });
 }
 
 
@@ -360,6 +495,9 @@ template <class DataTypes>
 void TetrahedronDiffusionFEMForceField<DataTypes>::addKToMatrix(const core::MechanicalParams* mparams, const sofa::core::behavior::MultiMatrixAccessor* matrix)
 {
     SCOPED_TIMER("addKToMatrix");
+
+    this->updateEdgeDiffusionCoefficient();
+
     const auto N = defaulttype::DataTypeInfo<Deriv>::size();
     sofa::core::behavior::MultiMatrixAccessor::MatrixRef r = matrix->getMatrix(this->mstate);
     sofa::linearalgebra::BaseMatrix* mat = r.matrix;
@@ -373,18 +511,54 @@ void TetrahedronDiffusionFEMForceField<DataTypes>::addKToMatrix(const core::Mech
     Real kFactor = mparams->kFactor();
     unsigned int &offset = r.offset;
 
-    sofa::Index v0,v1;
+    const auto& rowBegin = m_edgeAdjacency.rowBegin;
+    const auto& neighbors = m_edgeAdjacency.neighbors;
+    const auto& coefficients = m_edgeAdjacency.coefficients;
+    const auto& diagonal = m_edgeAdjacency.diagonal;
+    const auto nbVertices = static_cast<sofa::Index>(diagonal.size());
 
-    const auto& edges = m_topology->getEdges();
-    for(sofa::Index i=0; i<nbEdges; i++ )
+    using CRSMatrix = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+    if (auto* crs = dynamic_cast<CRSMatrix*>(mat))
     {
-        v0 = edges[i][0];
-        v1 = edges[i][1];
+        // Direct assembly: the rows are filled in order, each one by increasing column indices. The position of an
+        // entry in the compressed storage is then the hint for the position of the next one, avoiding the searches.
+        typename CRSMatrix::Index rowId = 0, colId = 0;
+        const auto addEntry = [&](const sofa::Index row, const sofa::Index col, const SReal value)
+        {
+            *crs->wblock(row, col, rowId, colId, true) += value;
+            ++colId;
+        };
 
-        mat->add(offset+N*v1, offset+N*v0, -kFactor * edgeDiffusionCoefficient[i]);
-        mat->add(offset+N*v0, offset+N*v1, -kFactor * edgeDiffusionCoefficient[i]);
-        mat->add(offset+N*v0, offset+N*v0, kFactor * edgeDiffusionCoefficient[i]);
-        mat->add(offset+N*v1, offset+N*v1, kFactor * edgeDiffusionCoefficient[i]);
+        for (sofa::Index v = 0; v < nbVertices; ++v)
+        {
+            const auto row = offset + N * v;
+            bool isDiagonalAdded = false;
+            for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+            {
+                if (!isDiagonalAdded && neighbors[k] > v)
+                {
+                    addEntry(row, row, kFactor * diagonal[v]);
+                    isDiagonalAdded = true;
+                }
+                addEntry(row, offset + N * neighbors[k], -kFactor * coefficients[k]);
+            }
+            if (!isDiagonalAdded)
+            {
+                addEntry(row, row, kFactor * diagonal[v]);
+            }
+            ++rowId;
+        }
+    }
+    else
+    {
+        for (sofa::Index v = 0; v < nbVertices; ++v)
+        {
+            mat->add(offset + N * v, offset + N * v, kFactor * diagonal[v]);
+            for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+            {
+                mat->add(offset + N * v, offset + N * neighbors[k], -kFactor * coefficients[k]);
+            }
+        }
     }
 }
 
@@ -394,22 +568,23 @@ void TetrahedronDiffusionFEMForceField<DataTypes>::buildStiffnessMatrix(
 {
     constexpr auto N = DataTypes::deriv_total_size;
 
+    this->updateEdgeDiffusionCoefficient();
+
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
                        .withRespectToPositionsIn(this->mstate);
 
-    const auto& edges = m_topology->getEdges();
-    std::size_t edgeId {};
-    for (const auto& edge : edges)
-    {
-        const auto v0 = edge[0];
-        const auto v1 = edge[1];
-
-        dfdx(N * v1, N * v0) += -edgeDiffusionCoefficient[edgeId];
-        dfdx(N * v0, N * v1) += -edgeDiffusionCoefficient[edgeId];
-        dfdx(N * v0, N * v0) += edgeDiffusionCoefficient[edgeId];
-        dfdx(N * v1, N * v1) += edgeDiffusionCoefficient[edgeId];
+    const auto& rowBegin = m_edgeAdjacency.rowBegin;
+    const auto& neighbors = m_edgeAdjacency.neighbors;
+    const auto& coefficients = m_edgeAdjacency.coefficients;
+    const auto& diagonal = m_edgeAdjacency.diagonal;
 
-        ++edgeId;
+    for (sofa::Index v = 0; v < static_cast<sofa::Index>(diagonal.size()); ++v)
+    {
+        dfdx(N * v, N * v) += diagonal[v];
+        for (sofa::Index k = rowBegin[v]; k < rowBegin[v + 1]; ++k)
+        {
+            dfdx(N * v, N * neighbors[k]) += -coefficients[k];
+        }
     }
 }
 
@@ -28,6 +28,10 @@ using sofa::testing::BaseSimulationTest;
 #include <sofa/component/topology/container/grid/RegularGridTopology.h>
 #include <sofa/component/diffusion/TetrahedronDiffusionFEMForceField.h>
 #include <sofa/component/mass/DiagonalMass.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/core/behavior/SingleMatrixAccessor.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/linearalgebra/FullMatrix.h>
 
 #include <sofa/type/Vec.h>
 
@@ -207,6 +211,183 @@ TYPED_TEST( TetrahedronDiffusionFEMForceField_test , extension )
     this->run_test_theoretical_diffusion();
 }
 
+// test case: same diffusion, with the forces and their derivatives computed in parallel
+TYPED_TEST( TetrahedronDiffusionFEMForceField_test , parallelExtension )
+{
+    EXPECT_MSG_NOEMIT(Error) ;
+    this->debug = false;
+
+    // run test
+    this->init_scene();
+
+    typename TestFixture::TetrahedronDiffusionFEMForceField::SPtr diffusionFF =
+        this->temperatureNode->template get<typename TestFixture::TetrahedronDiffusionFEMForceField>(this->temperatureNode->SearchDown);
+    ASSERT_NE(diffusionFF, nullptr);
+    diffusionFF->d_parallelComputation.setValue(true);
+
+    this->animate_scene();
+    this->compute_theory();
+
+    this->run_test_theoretical_diffusion();
+}
+
+
+/// Small diffusion scene: the temperatures diffuse on a tetrahedral mesh built from a 3x3x3 grid
+struct TetrahedronDiffusionFEMForceField_matrix_test : public BaseSimulationTest
+{
+    typedef defaulttype::Vec1Types DataTypes;
+    typedef DataTypes::VecCoord VecCoord;
+    typedef DataTypes::VecDeriv VecDeriv;
+    typedef component::diffusion::TetrahedronDiffusionFEMForceField<DataTypes> TetrahedronDiffusionFEMForceField;
+    typedef component::statecontainer::MechanicalObject<defaulttype::Vec3Types> GeometryDOF;
+
+    static constexpr sofa::Size nbPoints = 27;
+
+    simulation::Node::SPtr root;
+    TetrahedronDiffusionFEMForceField* diffusionFF { nullptr };
+    GeometryDOF* geometry { nullptr };
+
+    void onSetUp() override
+    {
+        std::string temperatures;
+        for (sofa::Size i = 0; i < nbPoints; ++i)
+        {
+            temperatures += std::to_string(0.1 * i * (i % 4)) + " ";
+        }
+
+        const std::string scene =
+            "<?xml version='1.0'?>"
+            "<Node name='root' gravity='0 0 0' >"
+            "    <RequiredPlugin name='Sofa.Component.Diffusion'/>"
+            "    <RequiredPlugin name='Sofa.Component.StateContainer'/>"
+            "    <RequiredPlugin name='Sofa.Component.Topology.Container.Dynamic'/>"
+            "    <RequiredPlugin name='Sofa.Component.Topology.Container.Grid'/>"
+            "    <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>"
+            "    <DefaultAnimationLoop />"
+            "    <RegularGridTopology name='grid' n='3 3 3' p0='0 0 0' min='0 0 0' max='1 1 1' tags='geom'/>"
+            "    <MechanicalObject template='Vec3d' name='gridDOFs' tags='geom' />"
+            "    <Node name='Tetra' >"
+            "        <TetrahedronSetTopologyContainer name='Container' />"
+            "        <TetrahedronSetTopologyModifier name='Modifier' />"
+            "        <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />"
+            "        <Hexa2TetraTopologicalMapping input='@../grid' output='@Container' />"
+            "        <Node name='Temperature' >"
+            "            <MechanicalObject template='Vec1d' name='gridTemperature' position='" + temperatures + "' />"
+            "            <TetrahedronDiffusionFEMForceField template='Vec1d' name='DiffusionForceField' constantDiffusionCoefficient='2.0' tagMechanics='geom' topology='@../Container'/>"
+            "        </Node>"
+            "    </Node>"
+            "</Node>";
+
+        SceneInstance instance("xml", scene);
+        root = instance.root;
+        ASSERT_NE(root, nullptr);
+        sofa::simulation::node::initRoot(root.get());
+
+        diffusionFF = root->getTreeObject<TetrahedronDiffusionFEMForceField>();
+        ASSERT_NE(diffusionFF, nullptr);
+        geometry = root->getTreeObject<GeometryDOF>();
+        ASSERT_NE(geometry, nullptr);
+    }
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    VecDeriv computeForce()
+    {
+        core::MechanicalParams mparams;
+        const auto* temperature = diffusionFF->getMState();
+        core::objectmodel::Data<VecDeriv> f(VecDeriv(temperature->getSize()));
+        core::objectmodel::Data<VecDeriv> v(VecDeriv(temperature->getSize()));
+        diffusionFF->addForce(&mparams, f, *temperature->read(core::ConstVecCoordId::position()), v);
+        return f.getValue();
+    }
+};
+
+// test case: the direct assembly in a compressed row sparse matrix gives the same matrix as the generic assembly
+TEST_F(TetrahedronDiffusionFEMForceField_matrix_test, compressedRowSparseAssembly)
+{
+    EXPECT_MSG_NOEMIT(Error);
+
+    core::MechanicalParams mparams;
+    mparams.setKFactor(-0.5);
+
+    linearalgebra::CompressedRowSparseMatrix<SReal> crs;
+    crs.resize(nbPoints, nbPoints);
+    core::behavior::SingleMatrixAccessor crsAccessor(&crs);
+    diffusionFF->addKToMatrix(&mparams, &crsAccessor);
+
+    linearalgebra::FullMatrix<SReal> full(nbPoints, nbPoints);
+    full.clear();
+    core::behavior::SingleMatrixAccessor fullAccessor(&full);
+    diffusionFF->addKToMatrix(&mparams, &fullAccessor);
+
+    crs.compress();
+    unsigned int nbNonZeros = 0;
+    for (sofa::Index i = 0; i < nbPoints; ++i)
+    {
+        for (sofa::Index j = 0; j < nbPoints; ++j)
+        {
+            EXPECT_NEAR(crs.element(i, j), full.element(i, j), 1e-12) << "(" << i << ", " << j << ")";
+            if (full.element(i, j) != 0)
+            {
+                ++nbNonZeros;
+            }
+        }
+    }
+    EXPECT_GT(nbNonZeros, nbPoints);
+}
+
+// test case: the diffusion coefficients are recomputed when the geometry moves
+TEST_F(TetrahedronDiffusionFEMForceField_matrix_test, coefficientsFollowTheGeometry)
+{
+    EXPECT_MSG_NOEMIT(Error);
+
+    const VecDeriv initialForce = computeForce();
+
+    // the volumes are scaled by 8 and the gradients of the shape functions by 1/2: the coefficients double
+    {
+        auto x = geometry->writePositions();
+        for (auto& p : x)
+        {
+            p *= 2;
+        }
+    }
+    const VecDeriv scaledForce = computeForce();
+
+    ASSERT_EQ(initialForce.size(), scaledForce.size());
+    SReal norm = 0;
+    for (std::size_t i = 0; i < initialForce.size(); ++i)
+    {
+        EXPECT_NEAR(scaledForce[i][0], 2 * initialForce[i][0], 1e-10) << i;
+        norm += std::abs(initialForce[i][0]);
+    }
+    EXPECT_GT(norm, 0);
+}
+
+// test case: a wrong number of tetrahedral coefficients is reported once, and no force is computed
+TEST_F(TetrahedronDiffusionFEMForceField_matrix_test, wrongSizeOfCoefficients)
+{
+    diffusionFF->d_tetraDiffusionCoefficient.setValue(sofa::type::vector<SReal>(1, 1.0));
+
+    {
+        EXPECT_MSG_EMIT(Error);
+        computeForce();
+    }
+    {
+        EXPECT_MSG_NOEMIT(Error);
+        const VecDeriv f = computeForce();
+        for (const auto& fi : f)
+        {
+            EXPECT_EQ(fi[0], 0);
+        }
+    }
+}
+
 
 } // namespace sofa
 
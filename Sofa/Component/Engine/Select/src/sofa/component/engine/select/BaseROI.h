@@ -28,9 +28,12 @@
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/defaulttype/RigidTypes.h>
+#include <sofa/type/BoundingBox.h>
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
+#include <algorithm>
+
 namespace sofa::component::engine::select
 {
 
@@ -126,6 +129,8 @@ public:
     Data<bool> d_drawHexahedra; ///< Draw Tetrahedra. (default = false)
     Data<float> d_drawSize; ///< rendering size for ROI and topological elements
     Data<bool> d_doUpdate; ///< If true, updates the selection at the beginning of simulation steps. (default = true)
+    Data<bool> d_spatialIndexing; ///< If true, the primitives of the ROI (e.g. boxes, spheres) are indexed in a uniform grid, and each point is only tested against the primitives close to it. (default = true)
+    Data<bool> d_parallelEvaluation; ///< If true, the points and the elements are tested in parallel. (default = false)
 
     SOFA_ATTRIBUTE_DEPRECATED__RENAME_DATA_IN_ENGINE_SELECT()
     sofa::core::objectmodel::RenamedData<VecCoord> d_X0;
@@ -135,6 +140,41 @@ protected:
 
     bool isPointIn(const PointID pid) const;
 
+    /// The ROI of a subclass can be described as a union of primitives (e.g. boxes, spheres).
+    /// Returns the number of primitives, or 0 if the ROI is not described by primitives.
+    virtual sofa::Size getNbPrimitives() const { return 0; }
+    /// Bounding box of a primitive, in the first (up to 3) coordinates of the points
+    virtual type::BoundingBox getPrimitiveBoundingBox(sofa::Index /*primitiveId*/) const { return {}; }
+    virtual bool isPointInPrimitive(const CPos& /*p*/, sofa::Index /*primitiveId*/) const { return false; }
+
+    /// Returns true if the point is in one of the primitives, only testing the primitives
+    /// of its cell if the spatial index is built
+    bool isPointInPrimitives(const CPos& p) const;
+
+    /// Uniform grid of the bounding boxes of the primitives, rebuilt at each update.
+    /// The update is not incremental: when only the primitives move, all the points are still tested again.
+    /// A primitive can change without changing its bounding box (e.g. a rotated oriented box), so the points
+    /// to test again cannot be deduced from the bounding boxes, and all the output lists are rebuilt anyway.
+    struct PrimitiveGrid
+    {
+        static constexpr int NbDimensions = std::min<int>(3, DataTypes::spatial_dimensions);
+
+        bool built { false };
+        type::Vec3 origin;
+        type::Vec3 cellSize;
+        type::Vec<3, int> resolution { 1, 1, 1 };
+        type::vector<sofa::Index> cellBegin; ///< the primitives of the cell c are primitives[cellBegin[c]..cellBegin[c+1]]
+        type::vector<sofa::Index> primitives;
+        type::vector<type::BoundingBox> bounds; ///< slightly enlarged bounding boxes of the primitives
+    };
+    PrimitiveGrid m_primitiveGrid;
+
+    void buildPrimitiveGrid();
+
+    /// Result of the point test for each position, computed at the beginning of the update and
+    /// used by the strict tests of the elements
+    type::vector<char> m_isPointInROI;
+
     template <typename Element>
     bool isInROI(const Element & e) const;
     
@@ -27,6 +27,9 @@
 #include <sofa/core/topology/BaseTopology.h>
 #include <sofa/core/loader/MeshLoader.h>
 #include <sofa/helper/accessor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <cmath>
 
 namespace sofa::component::engine::select
 {
@@ -91,6 +94,8 @@ BaseROI<DataTypes>::BaseROI()
     , d_drawHexahedra( initData(&d_drawHexahedra,false,"drawHexahedra","Draw Tetrahedra.") )
     , d_drawSize(initData(&d_drawSize, 1.0f, "drawSize", "rendering size for ROI and topological elements"))
     , d_doUpdate( initData(&d_doUpdate,(bool)true,"doUpdate","If true, updates the selection at the beginning of simulation steps.") )
+    , d_spatialIndexing( initData(&d_spatialIndexing, true, "spatialIndexing", "If true, the primitives of the ROI (e.g. boxes, spheres) are indexed in a uniform grid, and each point is only tested against the primitives close to it.") )
+    , d_parallelEvaluation( initData(&d_parallelEvaluation, false, "parallelEvaluation", "If true, the points and the elements are tested in parallel.") )
 {
     sofa::helper::getWriteOnlyAccessor(d_indices).push_back(0);
 
@@ -274,6 +279,165 @@ bool BaseROI<DataTypes>::isPointIn(const PointID pid) const
     return isPointInROI(p);
 }
 
+template <class DataTypes>
+void BaseROI<DataTypes>::buildPrimitiveGrid()
+{
+    constexpr int nbDimensions = PrimitiveGrid::NbDimensions;
+    PrimitiveGrid& grid = m_primitiveGrid;
+    grid.built = false;
+
+    const sofa::Size nbPrimitives = getNbPrimitives();
+    if (nbPrimitives == 0)
+    {
+        return;
+    }
+
+    // The bounding boxes are enlarged, so that the rounding errors of the exact tests cannot select
+    // a point outside of the bounding box of its primitive
+    type::BoundingBox gridBounds;
+    grid.bounds.resize(nbPrimitives);
+    for (sofa::Index i = 0; i < nbPrimitives; ++i)
+    {
+        type::BoundingBox bounds = getPrimitiveBoundingBox(i);
+        if (!bounds.isValid())
+        {
+            return;
+        }
+        const SReal margin = (bounds.maxBBox() - bounds.minBBox()).norm() * 1e-6 + std::numeric_limits<SReal>::epsilon();
+        bounds.inflate(margin);
+        grid.bounds[i] = bounds;
+        gridBounds.include(bounds);
+    }
+
+    // about 4 cells per primitive, with cells as cubic as possible
+    const type::Vec3 extent = gridBounds.maxBBox() - gridBounds.minBBox();
+    SReal maxExtent = 0;
+    for (int d = 0; d < nbDimensions; ++d)
+    {
+        maxExtent = std::max(maxExtent, extent[d]);
+    }
+    const SReal minExtent = std::max(maxExtent * static_cast<SReal>(1e-3), std::numeric_limits<SReal>::min());
+    const SReal nbCells = std::min<SReal>(4 * static_cast<SReal>(nbPrimitives), 1 << 18);
+    SReal volume = 1;
+    for (int d = 0; d < nbDimensions; ++d)
+    {
+        volume *= std::max(extent[d], minExtent);
+    }
+    const SReal cellLength = std::pow(volume / nbCells, static_cast<SReal>(1) / nbDimensions);
+
+    grid.origin = gridBounds.minBBox();
+    grid.resolution = { 1, 1, 1 };
+    for (int d = 0; d < nbDimensions; ++d)
+    {
+        grid.resolution[d] = std::clamp(static_cast<int>(std::ceil(std::max(extent[d], minExtent) / cellLength)), 1, 128);
+        grid.cellSize[d] = std::max(extent[d], minExtent) / grid.resolution[d];
+    }
+
+    const auto cellRange = [&grid](const type::BoundingBox& bounds, int d)
+    {
+        const int first = static_cast<int>(std::floor((bounds.minBBox()[d] - grid.origin[d]) / grid.cellSize[d]));
+        const int last = static_cast<int>(std::floor((bounds.maxBBox()[d] - grid.origin[d]) / grid.cellSize[d]));
+        return std::make_pair(std::clamp(first, 0, grid.resolution[d] - 1), std::clamp(last, 0, grid.resolution[d] - 1));
+    };
+
+    // counting sort of the primitives in the cells they overlap
+    const std::size_t totalNbCells = static_cast<std::size_t>(grid.resolution[0]) * grid.resolution[1] * grid.resolution[2];
+    grid.cellBegin.assign(totalNbCells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        if (pass == 1)
+        {
+            for (std::size_t c = 0; c < totalNbCells; ++c)
+            {
+                grid.cellBegin[c + 1] += grid.cellBegin[c];
+            }
+            grid.primitives.resize(grid.cellBegin.back());
+        }
+        type::vector<sofa::Index> next;
+        if (pass == 1)
+        {
+            next.assign(grid.cellBegin.begin(), grid.cellBegin.end() - 1);
+        }
+
+        for (sofa::Index i = 0; i < nbPrimitives; ++i)
+        {
+            std::pair<int, int> range[3] { {0, 0}, {0, 0}, {0, 0} };
+            for (int d = 0; d < nbDimensions; ++d)
+            {
+                range[d] = cellRange(grid.bounds[i], d);
+            }
+            for (int z = range[2].first; z <= range[2].second; ++z)
+            {
+                for (int y = range[1].first; y <= range[1].second; ++y)
+                {
+                    for (int x = range[0].first; x <= range[0].second; ++x)
+                    {
+                        const std::size_t c = (static_cast<std::size_t>(z) * grid.resolution[1] + y) * grid.resolution[0] + x;
+                        if (pass == 0)
+                        {
+                            ++grid.cellBegin[c + 1];
+                        }
+                        else
+                        {
+                            grid.primitives[next[c]++] = i;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    grid.built = true;
+}
+
+template <class DataTypes>
+bool BaseROI<DataTypes>::isPointInPrimitives(const CPos& p) const
+{
+    const PrimitiveGrid& grid = m_primitiveGrid;
+    if (!grid.built)
+    {
+        const sofa::Size nbPrimitives = getNbPrimitives();
+        for (sofa::Index i = 0; i < nbPrimitives; ++i)
+        {
+            if (isPointInPrimitive(p, i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr int nbDimensions = PrimitiveGrid::NbDimensions;
+    int cell[3] { 0, 0, 0 };
+    for (int d = 0; d < nbDimensions; ++d)
+    {
+        const SReal x = (static_cast<SReal>(p[d]) - grid.origin[d]) / grid.cellSize[d];
+        if (!(x >= 0) || x > grid.resolution[d])
+        {
+            // outside of all the bounding boxes
+            return false;
+        }
+        cell[d] = std::min(static_cast<int>(x), grid.resolution[d] - 1);
+    }
+
+    const std::size_t c = (static_cast<std::size_t>(cell[2]) * grid.resolution[1] + cell[1]) * grid.resolution[0] + cell[0];
+    for (sofa::Index j = grid.cellBegin[c]; j < grid.cellBegin[c + 1]; ++j)
+    {
+        const sofa::Index i = grid.primitives[j];
+        const type::BoundingBox& bounds = grid.bounds[i];
+        bool inBounds = true;
+        for (int d = 0; d < nbDimensions; ++d)
+        {
+            inBounds &= (p[d] >= bounds.minBBox()[d] && p[d] <= bounds.maxBBox()[d]);
+        }
+        if (inBounds && isPointInPrimitive(p, i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 // The update method is called when the engine is marked as dirty.
 template <class DataTypes>
 void BaseROI<DataTypes>::doUpdate()
@@ -359,6 +523,49 @@ void BaseROI<DataTypes>::doUpdate()
             return;
         }
 
+        // the grid costs O(#primitives) and all the points are tested again, so that moving primitives are handled
+        if (d_spatialIndexing.getValue())
+        {
+            buildPrimitiveGrid();
+        }
+        else
+        {
+            m_primitiveGrid.built = false;
+        }
+
+        // The points and the elements are first tested (in parallel if required), then gathered in order
+        simulation::TaskScheduler* taskScheduler = nullptr;
+        if (d_parallelEvaluation.getValue())
+        {
+            taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            assert(taskScheduler != nullptr);
+            if (taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+            }
+        }
+
+        const auto evaluate = [taskScheduler](const std::size_t size, type::vector<char>& isIn, const auto& predicate)
+        {
+            isIn.resize(size);
+            const auto task = [&isIn, &predicate](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    isIn[i] = predicate(i);
+                }
+            };
+            if (taskScheduler)
+            {
+                simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+                    [&task](const auto& range) { task(range.start, range.end); });
+            }
+            else
+            {
+                task(0, size);
+            }
+        };
+
         // Read accessor for input topology
         const ReadAccessor< Data<vector<Edge> > > edges = d_edges;
         const ReadAccessor< Data<vector<Triangle> > > triangles = d_triangles;
@@ -369,9 +576,12 @@ void BaseROI<DataTypes>::doUpdate()
         const VecCoord& positions = d_positions.getValue();
 
         //Points
+        m_isPointInROI.clear();
+        type::vector<char> isPointInROI;
+        evaluate(positions.size(), isPointInROI, [this](std::size_t i) { return isPointIn(static_cast<PointID>(i)); });
         for( unsigned i=0; i<positions.size(); ++i )
         {
-            if (isPointIn(i))
+            if (isPointInROI[i])
             {
                 indices.push_back(i);
                 pointsInROI.push_back(positions[i]);
@@ -383,14 +593,21 @@ void BaseROI<DataTypes>::doUpdate()
             }
         }
 
+        // the strict tests of the elements use the results of the points
+        m_isPointInROI.swap(isPointInROI);
+
+        type::vector<char> isElementInROI;
         auto testROI = [&](const auto& elements, const auto& predicate, const auto& strictPredicate, bool strict, 
             auto& inIndices, auto& inROI, auto& outIndices, auto& outROI)
             {
+                evaluate(elements.size(), isElementInROI, [&](std::size_t i)
+                {
+                    return (strict) ? strictPredicate(elements[i]) : predicate(elements[i]);
+                });
                 for (std::size_t i = 0; i < elements.size(); i++)
                 {
                     const auto& e = elements[i];
-                    const bool isInROI = (strict) ? strictPredicate(e) : predicate(e);
-                    if (isInROI)
+                    if (isElementInROI[i])
                     {
                         inIndices.push_back(static_cast<sofa::Index>(i));
                         inROI.push_back(e);
@@ -445,6 +662,7 @@ void BaseROI<DataTypes>::doUpdate()
         }
 
         d_nbIndices.setValue(sofa::Size(indices.size()));
+        m_isPointInROI.clear();
     }
 }
 
@@ -674,6 +892,11 @@ bool BaseROI<DataTypes>::isInStrictROI(const Element& e) const
 {
     const VecCoord& positions = d_positions.getValue();
 
+    if (m_isPointInROI.size() == positions.size())
+    {
+        return std::all_of(e.cbegin(), e.cend(), [this](const auto eid) { return m_isPointInROI[eid] != 0; });
+    }
+
     return isElementInStrictROI<DataTypes, Element>(e, positions, [this](auto&& x) {
         return isPointInROI(std::forward<decltype(x)>(x));
         });
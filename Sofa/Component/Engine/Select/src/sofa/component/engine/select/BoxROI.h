@@ -102,6 +102,11 @@ protected:
     void getPointsFromOrientedBox(const Vec10& box, type::vector<type::Vec3> &points) const;
 
     bool isPointInROI(const CPos& p) const override;
+
+    /// The primitives are the aligned boxes, followed by the oriented boxes
+    sofa::Size getNbPrimitives() const override;
+    type::BoundingBox getPrimitiveBoundingBox(sofa::Index primitiveId) const override;
+    bool isPointInPrimitive(const CPos& p, sofa::Index primitiveId) const override;
 };
 
 #if !defined(SOFA_COMPONENT_ENGINE_BOXROI_CPP)
@@ -110,9 +110,6 @@ void BoxROI<DataTypes>::computeOrientedBoxes()
 
     const vector<Vec10>& orientedBoxes = d_orientedBoxes.getValue();
 
-    if(orientedBoxes.empty())
-        return;
-
     m_orientedBoxes.resize(orientedBoxes.size());
 
     for(unsigned int i=0; i<orientedBoxes.size(); i++)
@@ -204,25 +201,57 @@ bool BoxROI<DataTypes>::isPointInAlignedBox(const typename DataTypes::CPos& p, c
 template <class DataTypes>
 bool BoxROI<DataTypes>::isPointInROI(const CPos& p) const
 {
-    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
-
-    for (unsigned int i=0; i<alignedBoxes.size(); ++i)
-        if (isPointInAlignedBox(p, alignedBoxes[i]))
-            return true;
+    return this->isPointInPrimitives(p);
+}
 
+template <class DataTypes>
+sofa::Size BoxROI<DataTypes>::getNbPrimitives() const
+{
+    sofa::Size nbPrimitives = d_alignedBoxes.getValue().size();
     if constexpr (DataTypes::spatial_dimensions == 3)
     {
-        for (unsigned int i=0; i<m_orientedBoxes.size(); ++i)
-            if (isPointInOrientedBox(p, m_orientedBoxes[i]))
-                return true;
+        nbPrimitives += m_orientedBoxes.size();
     }
+    return nbPrimitives;
+}
 
-    return false;
+template <class DataTypes>
+type::BoundingBox BoxROI<DataTypes>::getPrimitiveBoundingBox(sofa::Index primitiveId) const
+{
+    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
+    if (primitiveId < alignedBoxes.size())
+    {
+        const type::Vec6& box = alignedBoxes[primitiveId];
+        return type::BoundingBox(type::Vec3(box[0], box[1], box[2]), type::Vec3(box[3], box[4], box[5]));
+    }
+
+    vector<type::Vec3> points;
+    getPointsFromOrientedBox(d_orientedBoxes.getValue()[primitiveId - alignedBoxes.size()], points);
+    type::BoundingBox bbox;
+    for (const auto& point : points)
+    {
+        bbox.include(point);
+    }
+    return bbox;
+}
+
+template <class DataTypes>
+bool BoxROI<DataTypes>::isPointInPrimitive(const CPos& p, sofa::Index primitiveId) const
+{
+    const vector<type::Vec6>& alignedBoxes = d_alignedBoxes.getValue();
+    if (primitiveId < alignedBoxes.size())
+    {
+        return isPointInAlignedBox(p, alignedBoxes[primitiveId]);
+    }
+    return isPointInOrientedBox(p, m_orientedBoxes[primitiveId - alignedBoxes.size()]);
 }
 
 template <class DataTypes>
 bool BoxROI<DataTypes>::roiDoUpdate()
 {
+    // the oriented boxes may have changed since the last update
+    computeOrientedBoxes();
+
     return !d_alignedBoxes.getValue().empty() || !d_orientedBoxes.getValue().empty();
 }
 
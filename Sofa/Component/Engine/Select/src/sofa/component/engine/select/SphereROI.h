@@ -70,6 +70,10 @@ protected:
     bool isTriangleInROI(const Triangle& t) const override;
     bool isTriangleInStrictROI(const Triangle& t) const override;
 
+    sofa::Size getNbPrimitives() const override;
+    type::BoundingBox getPrimitiveBoundingBox(sofa::Index primitiveId) const override;
+    bool isPointInPrimitive(const CPos& p, sofa::Index primitiveId) const override;
+
 public:
     //Input
     Data< type::vector<CPos> > d_centers; ///< Center(s) of the sphere(s)
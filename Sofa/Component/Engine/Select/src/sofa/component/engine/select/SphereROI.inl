@@ -62,20 +62,27 @@ bool SphereROI<DataTypes>::isPointInSphere(const CPos& c, const Real& r, const C
 template <class DataTypes>
 bool SphereROI<DataTypes>::isPointInROI(const CPos& p) const
 {
-    bool isInSpheres = false;
+    return this->isPointInPrimitives(p);
+}
 
-    const auto& centers = (d_centers.getValue());
-    const auto& radii = (d_radii.getValue());
+template <class DataTypes>
+sofa::Size SphereROI<DataTypes>::getNbPrimitives() const
+{
+    return std::min(d_centers.getValue().size(), d_radii.getValue().size());
+}
 
-    for (unsigned int j = 0; j < centers.size(); ++j)
-    {
-        if (isPointInSphere(centers[j], radii[j], p))
-        {
-            isInSpheres = true;
-            break;
-        }
-    }
-    return isInSpheres;
+template <class DataTypes>
+type::BoundingBox SphereROI<DataTypes>::getPrimitiveBoundingBox(sofa::Index primitiveId) const
+{
+    const CPos& c = d_centers.getValue()[primitiveId];
+    const SReal r = d_radii.getValue()[primitiveId];
+    return type::BoundingBox(type::Vec3(c[0] - r, c[1] - r, c[2] - r), type::Vec3(c[0] + r, c[1] + r, c[2] + r));
+}
+
+template <class DataTypes>
+bool SphereROI<DataTypes>::isPointInPrimitive(const CPos& p, sofa::Index primitiveId) const
+{
+    return isPointInSphere(d_centers.getValue()[primitiveId], d_radii.getValue()[primitiveId], p);
 }
 
 template <class DataTypes>
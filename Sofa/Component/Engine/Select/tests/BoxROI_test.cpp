@@ -24,6 +24,7 @@
 using std::vector;
 
 #include <string>
+#include <sstream>
 using std::string;
 
 #include <gtest/gtest.h>
@@ -341,6 +342,55 @@ struct BoxROITest :  public sofa::testing::BaseTest
         EXPECT_EQ(m_boxroi->f_bbox.getValue().maxBBox(), Vec3(2,2,1));
     }
 
+    /// Test that the spatial indexing and the parallel evaluation select the same points and elements
+    /// as the exhaustive evaluation, with many aligned and oriented boxes
+    void spatialIndexingTest()
+    {
+        std::ostringstream boxes, orientedBoxes, positions, triangles;
+        for (int i = 0; i < 40; ++i)
+        {
+            const double x = 0.5 * (i % 7);
+            const double y = 0.3 * (i % 5);
+            const double z = 0.2 * i;
+            boxes << x << " " << y << " " << z << " " << x + 0.4 << " " << y + 0.25 << " " << z + 0.15 << " ";
+            orientedBoxes << x << " " << z << " " << y << "  " << x + 0.3 << " " << z + 0.3 << " " << y << "  "
+                          << x + 0.1 << " " << z + 0.5 << " " << y << "  0.2 ";
+        }
+        constexpr int nbPoints = 4000;
+        for (int i = 0; i < nbPoints; ++i)
+        {
+            positions << 3.5 * ((i * 37) % 101) / 101. << " " << 8.5 * ((i * 53) % 97) / 97. << " " << 8.5 * ((i * 71) % 89) / 89. << " ";
+        }
+        for (int i = 0; i + 2 < nbPoints; i += 3)
+        {
+            triangles << i << " " << i + 1 << " " << i + 2 << " ";
+        }
+
+        std::string indices[3], triangleIndices[3];
+        for (int run = 0; run < 3; ++run)
+        {
+            typename TheBoxROI::SPtr boxroi = New<TheBoxROI>();
+            m_node->addObject(boxroi);
+            boxroi->findData("box")->read(boxes.str());
+            boxroi->findData("orientedBox")->read(orientedBoxes.str());
+            boxroi->findData("position")->read(positions.str());
+            boxroi->findData("triangles")->read(triangles.str());
+            boxroi->findData("strict")->read("true");
+            boxroi->findData("spatialIndexing")->read(run == 0 ? "false" : "true");
+            boxroi->findData("parallelEvaluation")->read(run == 2 ? "true" : "false");
+            boxroi->init();
+
+            indices[run] = boxroi->findData("indices")->getValueString();
+            triangleIndices[run] = boxroi->findData("triangleIndices")->getValueString();
+        }
+
+        EXPECT_FALSE(indices[0].empty());
+        EXPECT_EQ(indices[1], indices[0]);
+        EXPECT_EQ(indices[2], indices[0]);
+        EXPECT_EQ(triangleIndices[1], triangleIndices[0]);
+        EXPECT_EQ(triangleIndices[2], triangleIndices[0]);
+    }
+
 };
 
 
@@ -416,3 +466,6 @@ TYPED_TEST(BoxROITest, computeBBoxTest) {
     ASSERT_NO_THROW(this->computeBBoxTest());
 }
 
+TYPED_TEST(BoxROITest, spatialIndexingTest) {
+    ASSERT_NO_THROW(this->spatialIndexingTest());
+}
@@ -25,6 +25,7 @@
 #include <sofa/component/haptics/MechanicalStateForceFeedback.h>
 #include <sofa/core/behavior/MechanicalState.h>
 #include <sofa/helper/system/thread/CTime.h>
+#include <atomic>
 #include <mutex>
 
 #include <sofa/component/constraint/lagrangian/solver/ConstraintSolverImpl.h>
@@ -81,6 +82,12 @@ public:
     // Enable/disable constraint haptic influence from all frames
     Data< bool > d_localHapticConstraintAllFrames; ///< Flag to enable/disable constraint haptic influence from all frames
 
+    Data< double > d_hapticFrequency; ///< Frequency of the haptic loop (Hz), over the last second
+    Data< double > d_hapticPeriodJitter; ///< Standard deviation of the period of the haptic loop (ms), over the last second
+    Data< double > d_snapshotLatency; ///< Mean age of the constraint problem used by the haptic loop (ms), over the last second
+    Data< double > d_maxSnapshotLatency; ///< Maximum age of the constraint problem used by the haptic loop (ms), over the last second
+    Data< unsigned int > d_nbLockedComputations; ///< Number of force computations which returned the last forces because the computation was locked with setLock
+
     void computeForce(SReal x, SReal y, SReal z,
                       SReal u, SReal v, SReal w,
                       SReal q, SReal& fx, SReal& fy, SReal& fz) override;
@@ -97,6 +104,7 @@ protected:
     }
 
     virtual void updateStats();
+    /// Takes the last constraint problem published by the simulation thread, if any. Called by the haptic thread, never blocks.
     virtual bool updateConstraintProblem();
     virtual void doComputeForce(const  VecCoord& state,  VecDeriv& forces);
 
@@ -119,18 +127,29 @@ public:
     }
 
     /// Overide method to lock or unlock the force feedback computation. According to parameter, value == true (resp. false) will lock (resp. unlock) mutex @sa lockForce
+    /// While locked, computeForce does not wait: it returns the last computed forces.
     void setLock(bool value) override;
 
 protected:
     core::behavior::MechanicalState<DataTypes> *mState; ///< The device try to follow this mechanical state.
+
+    /// Triple buffer of the constraint problems exchanged with the haptic thread. At any time, one buffer is
+    /// used by the haptic thread (mCurBufferId), one is written by the simulation thread (mBackBufferId), and the
+    /// last one is the shared buffer, exchanged atomically by the two threads (mSharedBufferState).
+    /// A published buffer is not modified until the haptic thread has released it.
     VecCoord mVal[3];
     MatrixDeriv mConstraints[3];
     std::vector<int> mId_buf[3];
     component::constraint::lagrangian::solver::ConstraintProblem* mCP[3];
+    sofa::type::vector<SReal> mDfree[3]; ///< free violations of the constraint problem, as published
+    helper::system::thread::ctime_t mPublicationTime[3];
 
-    unsigned char mNextBufferId; // Next buffer id to be use
-    unsigned char mCurBufferId; // Current buffer id in use
-    bool mIsCuBufferInUse; // Is current buffer currently in use right now
+    static constexpr unsigned char s_bufferIdMask = 0x3;
+    static constexpr unsigned char s_freshBufferFlag = 0x4; ///< set when the shared buffer has not been taken by the haptic thread yet
+
+    unsigned char mCurBufferId; ///< Buffer used by the haptic thread
+    unsigned char mBackBufferId; ///< Buffer written by the simulation thread
+    std::atomic<unsigned char> mSharedBufferState; ///< Id of the shared buffer, and s_freshBufferFlag
 
     sofa::component::constraint::lagrangian::solver::ConstraintSolverImpl* constraintSolver;
 
@@ -143,6 +162,28 @@ protected:
 
     /// mutex used in method @doComputeForce which can be touched from outside using method @sa setLock if components are modified in another thread.
     std::mutex lockForce;
+
+    /// forces returned while the computation is locked
+    VecDeriv mLastForces;
+    /// mutex protecting mLastForces, only held for the copies: the computation may be locked by setLock
+    /// while another haptic thread reads the last forces
+    std::mutex mLastForcesMutex;
+
+    /// statistics of the haptic loop, accumulated by the haptic thread over one second
+    helper::system::thread::ctime_t mLastComputationTime;
+    double mPeriodSum;
+    double mSquaredPeriodSum;
+    unsigned int mNbPeriods;
+    double mLatencySum;
+    double mMaxLatency;
+    unsigned int mNbLatencies;
+
+    /// statistics published by the haptic thread, copied in the Data by the simulation thread
+    std::atomic<double> mPublishedFrequency;
+    std::atomic<double> mPublishedPeriodJitter;
+    std::atomic<double> mPublishedLatency;
+    std::atomic<double> mPublishedMaxLatency;
+    std::atomic<unsigned int> mNbLockedComputations;
 };
 
 #if !defined(SOFA_COMPONENT_CONTROLLER_LCPFORCEFEEDBACK_CPP)
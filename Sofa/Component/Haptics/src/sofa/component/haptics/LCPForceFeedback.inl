@@ -28,6 +28,7 @@
 #include <sofa/simulation/AnimateEndEvent.h>
 
 #include <algorithm>
+#include <cmath>
 #include <mutex>
 
 namespace
@@ -126,21 +127,39 @@ LCPForceFeedback<DataTypes>::LCPForceFeedback()
     , d_solverMaxIt(initData(&d_solverMaxIt, 100, "solverMaxIt", "max iteration to spend solving constraints"))
     , d_derivRotations(initData(&d_derivRotations, false, "derivRotations", "if true, deriv the rotations when updating the violations"))
     , d_localHapticConstraintAllFrames(initData(&d_localHapticConstraintAllFrames, false, "localHapticConstraintAllFrames", "Flag to enable/disable constraint haptic influence from all frames"))
+    , d_hapticFrequency(initData(&d_hapticFrequency, 0.0, "hapticFrequency", "Frequency of the haptic loop (Hz), over the last second"))
+    , d_hapticPeriodJitter(initData(&d_hapticPeriodJitter, 0.0, "hapticPeriodJitter", "Standard deviation of the period of the haptic loop (ms), over the last second"))
+    , d_snapshotLatency(initData(&d_snapshotLatency, 0.0, "snapshotLatency", "Mean age of the constraint problem used by the haptic loop (ms), over the last second"))
+    , d_maxSnapshotLatency(initData(&d_maxSnapshotLatency, 0.0, "maxSnapshotLatency", "Maximum age of the constraint problem used by the haptic loop (ms), over the last second"))
+    , d_nbLockedComputations(initData(&d_nbLockedComputations, 0u, "nbLockedComputations", "Number of force computations which returned the last forces because the computation was locked with setLock"))
     , mState(nullptr)
-    , mNextBufferId(0)
     , mCurBufferId(0)
-    , mIsCuBufferInUse(false)
+    , mBackBufferId(2)
+    , mSharedBufferState(1)
     , constraintSolver(nullptr)
     , _timer(nullptr)
     , time_buf(0)
     , timer_iterations(0)
     , haptic_freq(0.0)
     , num_constraints(0)
+    , mLastComputationTime(0)
+    , mPeriodSum(0.0)
+    , mSquaredPeriodSum(0.0)
+    , mNbPeriods(0)
+    , mLatencySum(0.0)
+    , mMaxLatency(0.0)
+    , mNbLatencies(0)
+    , mPublishedFrequency(0.0)
+    , mPublishedPeriodJitter(0.0)
+    , mPublishedLatency(0.0)
+    , mPublishedMaxLatency(0.0)
+    , mNbLockedComputations(0)
 {
     this->f_listening.setValue(true);
     mCP[0] = nullptr;
     mCP[1] = nullptr;
     mCP[2] = nullptr;
+    mPublicationTime[0] = mPublicationTime[1] = mPublicationTime[2] = 0;
     _timer = new helper::system::thread::CTime();
     time_buf = _timer->getTime();
     timer_iterations = 0;
@@ -148,6 +167,12 @@ LCPForceFeedback<DataTypes>::LCPForceFeedback()
     forceCoef.setOriginalData(&d_forceCoef);
     solverTimeout.setOriginalData(&d_solverTimeout);
 
+    d_hapticFrequency.setReadOnly(true);
+    d_hapticPeriodJitter.setReadOnly(true);
+    d_snapshotLatency.setReadOnly(true);
+    d_maxSnapshotLatency.setReadOnly(true);
+    d_nbLockedComputations.setReadOnly(true);
+
 }
 
 
@@ -197,9 +222,36 @@ void LCPForceFeedback<DataTypes>::computeForce(const VecCoord& state,  VecDeriv&
     }
     updateStats();
 
-    lockForce.lock(); // check if computation has not been locked using setLock method.
+    // check if computation has not been locked using setLock method. The haptic thread does not wait:
+    // the forces of the last computation are returned.
+    if (!lockForce.try_lock())
+    {
+        ++mNbLockedComputations;
+        std::lock_guard<std::mutex> lastForcesGuard(mLastForcesMutex);
+        if (mLastForces.size() == state.size())
+        {
+            forces = mLastForces;
+        }
+        else
+        {
+            forces.assign(state.size(), Deriv());
+        }
+        return;
+    }
+
     updateConstraintProblem();
+    if (mCP[mCurBufferId])
+    {
+        const double latency = sofa::helper::system::thread::CTime::toSecond(sofa::helper::system::thread::CTime::getTime() - mPublicationTime[mCurBufferId]) * 1000.0;
+        mLatencySum += latency;
+        mMaxLatency = std::max(mMaxLatency, latency);
+        ++mNbLatencies;
+    }
     doComputeForce(state, forces);
+    {
+        std::lock_guard<std::mutex> lastForcesGuard(mLastForcesMutex);
+        mLastForces = forces;
+    }
     lockForce.unlock();
 }
 template <class DataTypes>
@@ -208,40 +260,57 @@ void LCPForceFeedback<DataTypes>::updateStats()
     using namespace helper::system::thread;
 
     const ctime_t actualTime = _timer->getTime();
+    if (mLastComputationTime != 0)
+    {
+        const double period = CTime::toSecond(actualTime - mLastComputationTime) * 1000.0;
+        mPeriodSum += period;
+        mSquaredPeriodSum += period * period;
+        ++mNbPeriods;
+    }
+    mLastComputationTime = actualTime;
+
     ++timer_iterations;
     if (actualTime - time_buf >= sofa::helper::system::thread::CTime::getTicksPerSec())
     {
         haptic_freq = (double)(timer_iterations*sofa::helper::system::thread::CTime::getTicksPerSec())/ (double)( actualTime - time_buf) ;
         time_buf = actualTime;
         timer_iterations = 0;
+
+        mPublishedFrequency.store(haptic_freq, std::memory_order_relaxed);
+        if (mNbPeriods > 0)
+        {
+            const double meanPeriod = mPeriodSum / mNbPeriods;
+            const double variance = std::max(0.0, mSquaredPeriodSum / mNbPeriods - meanPeriod * meanPeriod);
+            mPublishedPeriodJitter.store(std::sqrt(variance), std::memory_order_relaxed);
+        }
+        if (mNbLatencies > 0)
+        {
+            mPublishedLatency.store(mLatencySum / mNbLatencies, std::memory_order_relaxed);
+            mPublishedMaxLatency.store(mMaxLatency, std::memory_order_relaxed);
+        }
+        mPeriodSum = mSquaredPeriodSum = 0.0;
+        mNbPeriods = 0;
+        mLatencySum = mMaxLatency = 0.0;
+        mNbLatencies = 0;
     }
 }
 
 template <class DataTypes>
 bool LCPForceFeedback<DataTypes>::updateConstraintProblem()
 {
-    const int prevId = mCurBufferId;
-
     //
     // Retrieve the last LCP and constraints computed by the Sofa thread.
     //
-    mIsCuBufferInUse = true;
-
+    if (!(mSharedBufferState.load(std::memory_order_relaxed) & s_freshBufferFlag))
     {
-        // TODO: Lock and/or memory barrier HERE
-        mCurBufferId = mNextBufferId;
+        return false;
     }
 
-    const bool changed = (prevId != mCurBufferId);
-
-    const sofa::component::constraint::lagrangian::solver::ConstraintProblem* cp = mCP[mCurBufferId];
+    // the buffer in use is released as the shared buffer, and the published buffer is taken
+    const unsigned char sharedBufferState = mSharedBufferState.exchange(mCurBufferId, std::memory_order_acq_rel);
+    mCurBufferId = sharedBufferState & s_bufferIdMask;
 
-    if(!cp)
-    {
-        mIsCuBufferInUse = false;
-    }
-
-    return changed;
+    return true;
 }
 
 template <class DataTypes>
@@ -273,37 +342,30 @@ void LCPForceFeedback<DataTypes>::doComputeForce(const VecCoord& state,  VecDeri
         derivVectors< DataTypes >(val, state, dx, d_derivRotations.getValue());
 
         const bool localHapticConstraintAllFrames = d_localHapticConstraintAllFrames.getValue();
+        const sofa::type::vector<SReal>& dFree = mDfree[mCurBufferId];
 
-        // Modify Dfree
         MatrixDerivRowConstIterator rowItEnd = constraints.end();
         num_constraints = constraints.size();
 
+        // only contended when several haptic loops use the same constraint problem
+        s_mtx.lock();
+
+        // Modify Dfree, from the published violations
+        SReal* cpDfree = cp->getDfree();
+        std::copy(dFree.begin(), dFree.end(), cpDfree);
         for (MatrixDerivRowConstIterator rowIt = constraints.begin(); rowIt != rowItEnd; ++rowIt)
         {
             MatrixDerivColConstIterator colItEnd = rowIt.end();
 
             for (MatrixDerivColConstIterator colIt = rowIt.begin(); colIt != colItEnd; ++colIt)
             {
-                cp->getDfree()[rowIt.index()] += computeDot<DataTypes>(colIt.val(), dx[localHapticConstraintAllFrames ? 0 : colIt.index()]);
+                cpDfree[rowIt.index()] += computeDot<DataTypes>(colIt.val(), dx[localHapticConstraintAllFrames ? 0 : colIt.index()]);
             }
         }
 
-        s_mtx.lock();
-
         // Solving constraints
         cp->solveTimed(cp->tolerance * 0.001, d_solverMaxIt.getValue(), d_solverTimeout.getValue());	// d_tol, maxIt, timeout
 
-        // Restore Dfree
-        for (MatrixDerivRowConstIterator rowIt = constraints.begin(); rowIt != rowItEnd; ++rowIt)
-        {
-            MatrixDerivColConstIterator colItEnd = rowIt.end();
-
-            for (MatrixDerivColConstIterator colIt = rowIt.begin(); colIt != colItEnd; ++colIt)
-            {
-                cp->getDfree()[rowIt.index()] -= computeDot<DataTypes>(colIt.val(), dx[localHapticConstraintAllFrames ? 0 : colIt.index()]);
-            }
-        }
-
         s_mtx.unlock();
 
         VecDeriv tempForces;
@@ -336,6 +398,12 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     if (!sofa::simulation::AnimateEndEvent::checkEventType(event))
         return;
 
+    d_hapticFrequency.setValue(mPublishedFrequency.load(std::memory_order_relaxed));
+    d_hapticPeriodJitter.setValue(mPublishedPeriodJitter.load(std::memory_order_relaxed));
+    d_snapshotLatency.setValue(mPublishedLatency.load(std::memory_order_relaxed));
+    d_maxSnapshotLatency.setValue(mPublishedMaxLatency.load(std::memory_order_relaxed));
+    d_nbLockedComputations.setValue(mNbLockedComputations.load(std::memory_order_relaxed));
+
     if (!constraintSolver)
         return;
 
@@ -347,18 +415,8 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     if (!new_cp)
         return;
 
-    // Find available buffer
-
-    unsigned char buf_index=0;
-    const unsigned char cbuf_index=mCurBufferId;
-    const unsigned char nbuf_index=mNextBufferId;
-
-    if (buf_index == cbuf_index || buf_index == nbuf_index)
-    {
-        buf_index++;
-        if (buf_index == cbuf_index || buf_index == nbuf_index)
-            buf_index++;
-    }
+    // The back buffer is used neither by the haptic thread nor as shared buffer
+    const unsigned char buf_index = mBackBufferId;
 
     // Compute constraints, id_buf lcp and val for the current lcp.
 
@@ -389,18 +447,20 @@ void LCPForceFeedback<DataTypes>::handleEvent(sofa::core::objectmodel::Event *ev
     // make sure the MatrixDeriv has been compressed
     constraints.compress();
 
-    // valid buffer
+    // Update Dfree: the violations are updated by the haptic thread from this copy
+    mDfree[buf_index].assign(new_cp->getDfree(), new_cp->getDfree() + new_cp->getDimension());
 
-    {
-        // TODO: Lock and/or memory barrier HERE
-        mNextBufferId = buf_index;
-    }
+    mPublicationTime[buf_index] = sofa::helper::system::thread::CTime::getTime();
+
+    // valid buffer: it becomes the shared buffer, and the previous shared buffer, whether it has been
+    // taken by the haptic thread or not, becomes the back buffer
+    const unsigned char sharedBufferState = mSharedBufferState.exchange(buf_index | s_freshBufferFlag, std::memory_order_acq_rel);
+    mBackBufferId = sharedBufferState & s_bufferIdMask;
 
-    // Lock lcp to prevent its use by the SOFA thread while it is used by haptic thread
-    if(mIsCuBufferInUse)
-        constraintSolver->lockConstraintProblem(this, mCP[mCurBufferId], mCP[mNextBufferId]);
-    else
-        constraintSolver->lockConstraintProblem(this, mCP[mNextBufferId]);
+    // Lock lcp to prevent its use by the SOFA thread while it is used by haptic thread: the haptic thread
+    // only uses the shared buffer and the buffer it currently holds, i.e. the two buffers other than the back buffer
+    const unsigned char hapticBufferId = static_cast<unsigned char>(3 - buf_index - mBackBufferId);
+    constraintSolver->lockConstraintProblem(this, mCP[hapticBufferId], mCP[buf_index]);
 }
 
 
@@ -26,6 +26,7 @@
 
 #include <sofa/component/statecontainer/MechanicalObject.h>
 #include <sofa/component/haptics/LCPForceFeedback.h>
+#include <future>
 #include <thread>
 #include <sofa/simulation/Node.h>
 
@@ -57,6 +58,10 @@ public:
 
     bool test_multiThread();
 
+    bool test_lockedComputation();
+
+    bool test_statistics();
+
     /// General Haptic thread methods
     static void HapticsThread(std::atomic<bool>& terminate, void * p_this);
 
@@ -397,6 +402,85 @@ bool LCPForceFeedback_test::test_multiThread()
 }
 
 
+bool LCPForceFeedback_test::test_lockedComputation()
+{
+    loadTestScene("ToolvsFloorCollision_test.scn");
+
+    const simulation::Node::SPtr instruNode = m_root->getChild("Instrument");
+    EXPECT_NE(instruNode, nullptr);
+    m_LCPFFBack = instruNode->get<LCPRig>(instruNode->SearchDown);
+    EXPECT_NE(m_LCPFFBack, nullptr);
+
+    for (int step = 0; step < 10; step++)
+    {
+        sofa::simulation::node::animate(m_root.get());
+    }
+
+    // the emulated device must not wait while the computation is locked
+    m_LCPFFBack->setLock(true);
+    constexpr int nbComputations = 100;
+    auto device = std::async(std::launch::async, [this]()
+    {
+        for (int i = 0; i < nbComputations; ++i)
+        {
+            sofa::type::Vec3 force;
+            m_LCPFFBack->computeForce(0, -1.0, 0, 0, 0, 0, 0, force[0], force[1], force[2]);
+        }
+    });
+    const bool finished = device.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+    m_LCPFFBack->setLock(false);
+    device.wait();
+    EXPECT_TRUE(finished);
+
+    sofa::simulation::node::animate(m_root.get());
+    EXPECT_EQ(m_LCPFFBack->d_nbLockedComputations.getValue(), static_cast<unsigned int>(nbComputations));
+
+    return true;
+}
+
+
+bool LCPForceFeedback_test::test_statistics()
+{
+    loadTestScene("ToolvsFloorCollision_test.scn");
+
+    const simulation::Node::SPtr instruNode = m_root->getChild("Instrument");
+    EXPECT_NE(instruNode, nullptr);
+    const MecaRig::SPtr meca = instruNode->get<MecaRig>(instruNode->SearchDown);
+    m_LCPFFBack = instruNode->get<LCPRig>(instruNode->SearchDown);
+    EXPECT_NE(meca, nullptr);
+    EXPECT_NE(m_LCPFFBack, nullptr);
+    m_LCPFFBack->d_solverMaxIt.setValue(2);
+
+    m_terminate = false;
+    haptic_thread = std::thread(HapticsThread, std::ref(this->m_terminate), this);
+
+    // the statistics are computed over one second of the haptic loop
+    const ctime_t endTime = CTime::getRefTime() + 2 * CTime::getRefTicksPerSec();
+    while (CTime::getRefTime() < endTime)
+    {
+        sofa::simulation::node::animate(m_root.get());
+
+        const VecCoord& coords = meca->x.getValue();
+        mtxPosition.lock();
+        m_currentPosition[0] = coords[0][0];
+        m_currentPosition[1] = coords[0][1];
+        m_currentPosition[2] = coords[0][2];
+        mtxPosition.unlock();
+        CTime::sleep(0.001);
+    }
+
+    m_terminate = true;
+    haptic_thread.join();
+
+    EXPECT_GT(m_LCPFFBack->d_hapticFrequency.getValue(), 0.0);
+    EXPECT_GE(m_LCPFFBack->d_hapticPeriodJitter.getValue(), 0.0);
+    EXPECT_GT(m_LCPFFBack->d_snapshotLatency.getValue(), 0.0);
+    EXPECT_GE(m_LCPFFBack->d_maxSnapshotLatency.getValue(), m_LCPFFBack->d_snapshotLatency.getValue());
+    EXPECT_EQ(m_LCPFFBack->d_nbLockedComputations.getValue(), 0u);
+
+    return true;
+}
+
 
 TEST_F(LCPForceFeedback_test, test_InitScene)
 {
@@ -418,5 +502,15 @@ TEST_F(LCPForceFeedback_test, test_multiThread)
     ASSERT_TRUE(test_multiThread());
 }
 
+TEST_F(LCPForceFeedback_test, test_lockedComputation)
+{
+    ASSERT_TRUE(test_lockedComputation());
+}
+
+TEST_F(LCPForceFeedback_test, test_statistics)
+{
+    ASSERT_TRUE(test_statistics());
+}
+
 
 } // namespace sofa
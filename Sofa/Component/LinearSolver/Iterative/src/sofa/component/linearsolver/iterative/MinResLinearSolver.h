@@ -62,18 +62,23 @@ public:
     void solve (Matrix& M, Vector& x, Vector& b) override;
 
     void parse(core::objectmodel::BaseObjectDescription *arg) override;
+
+protected:
+
+    /// Dot product of two vectors, used for all the reductions of the algorithm
+    virtual SReal computeDot(Vector& a, Vector& b);
 };
 
 #if !defined(SOFA_COMPONENT_LINEARSOLVER_MINRESLINEARSOLVER_CPP)
 extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< GraphScatteredMatrix, GraphScatteredVector >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< FullMatrix<SRreal>, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< SparseMatrix<SRreal>, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<SRreal>, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<type::Mat<2,2,SRreal> >, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<type::Mat<3,3,SRreal> >, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<type::Mat<4,4,SRreal> >, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<type::Mat<6,6,SRreal> >, FullVector<SRreal> >;
-extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< CompressedRowSparseMatrix<type::Mat<8,8,SRreal> >, FullVector<SRreal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::FullMatrix<SReal>, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::SparseMatrix<SReal>, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<SReal>, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<type::Mat<2,2,SReal> >, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<type::Mat<3,3,SReal> >, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<type::Mat<4,4,SReal> >, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<type::Mat<6,6,SReal> >, linearalgebra::FullVector<SReal> >;
+extern template class SOFA_COMPONENT_LINEARSOLVER_ITERATIVE_API MinResLinearSolver< linearalgebra::CompressedRowSparseMatrix<type::Mat<8,8,SReal> >, linearalgebra::FullVector<SReal> >;
 #endif
 
 } //namespace sofa::component::linearsolver::iterative
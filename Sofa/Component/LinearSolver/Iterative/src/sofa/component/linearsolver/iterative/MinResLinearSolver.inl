@@ -104,7 +104,7 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     r1->eq( b, *r1, -1.0 );   //  r1 = b - r1;
 
 
-    SReal beta1 = r1->dot( *r1 );
+    SReal beta1 = computeDot( *r1, *r1 );
 
     // Test for an indefined preconditioner
     // If b = 0 exactly stop with x = x0.
@@ -161,13 +161,13 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
             y = A * v;
             if(itn) y.peq( *r1, -beta/oldb );
 
-            alpha = v.dot( y );	// alphak
+            alpha = computeDot( v, y );	// alphak
             y.peq( *r2, -alpha/beta ); // y += -a/b * r2
 
             std::swap( r1, r2 ); // save a copy by swaping pointers
 
             oldb = beta; //oldb = betak
-            beta = y.dot( y );
+            beta = computeDot( y, y );
 
             if(beta < 0) break;
 
@@ -214,7 +214,7 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
 
             // Estimate various norms
             Anorm = sqrt( tnorm2 );
-            ynorm = sqrt( x.dot( x ) );
+            ynorm = sqrt( computeDot( x, x ) );
 
             SReal test1 = phibar / (Anorm*ynorm); // ||r||/(||A|| ||x||)
             graph_error.push_back(test1);
@@ -256,6 +256,12 @@ void MinResLinearSolver<TMatrix,TVector>::solve(Matrix& A, Vector& x, Vector& b)
     vtmp.deleteTempVector(&v);
 }
 
+template <class TMatrix, class TVector>
+SReal MinResLinearSolver<TMatrix, TVector>::computeDot(Vector& a, Vector& b)
+{
+    return a.dot(b);
+}
+
 template <class TMatrix, class TVector>
 void MinResLinearSolver<TMatrix, TVector>::parse(core::objectmodel::BaseObjectDescription* arg)
 {
@@ -22,12 +22,17 @@
 #pragma once
 #include <sofa/component/linearsystem/MatrixProjectionMethod.h>
 #include <sofa/simulation/ParallelSparseMatrixProduct.h>
+#include <map>
 
 namespace sofa::component::linearsystem
 {
 
 /**
  * Matrix prjection method computing the matrix projection taking advantage of the constant sparsity pattern
+ *
+ * The symbolic phase of the sparse matrix products (intersection) is computed once, and only the numeric phase is
+ * computed in the following time steps. If the sparsity pattern of the mapped matrix or of a mapping jacobian changes,
+ * the change is detected and the symbolic phase is computed again.
  */
 template<class TMatrix>
 class ConstantSparsityProjectionMethod : public MatrixProjectionMethod<TMatrix>
@@ -59,6 +64,36 @@ protected:
 
     std::unique_ptr<linearalgebra::SparseMatrixProduct< K_Type, J_Type, KJ_Type> > m_matrixProductKJ;
     std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, KJ_Type, JTKJ_Type> > m_matrixProductJTKJ;
+    std::unique_ptr<linearalgebra::SparseMatrixProduct< JT_Type, K_Type, JTKJ_Type> > m_matrixProductJTK;
+
+    /**
+     * Locations of the entries of a projected matrix in the values array of the compressed global matrix.
+     * It is built the first time the projected matrix is added into a compressed global matrix (search in the
+     * compressed rows), then it is reused as long as both sparsity patterns are unchanged (direct indexed stores).
+     */
+    struct ScatterMap
+    {
+        /// Copy of the sparsity pattern of the projected matrix, used to detect a change
+        sofa::type::vector<typename JTKJ_Type::StorageIndex> outerIndex;
+        sofa::type::vector<typename JTKJ_Type::StorageIndex> innerIndex;
+
+        /// Location in the values array of the global matrix of each non-zero value of the projected matrix
+        sofa::type::vector<std::size_t> valueIds;
+
+        std::size_t globalMatrixNbValues {};
+        type::Vec2u positionInGlobalMatrix;
+    };
+
+    std::map<std::pair<core::behavior::BaseMechanicalState*, core::behavior::BaseMechanicalState*>, ScatterMap> m_scatterMaps;
+
+    void addProjectedMatrixToGlobalMatrix(
+        const sofa::type::fixed_array<core::behavior::BaseMechanicalState*, 2>& topMostStates,
+        const Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J,
+        const type::Vec2u& positionInGlobalMatrix,
+        linearalgebra::BaseMatrix* globalMatrix) override;
+
+    static bool isScatterMapValid(const ScatterMap& scatterMap, const JTKJ_Type& JT_K_J, const TMatrix& globalMatrix, const type::Vec2u& positionInGlobalMatrix);
+    static bool buildScatterMap(ScatterMap& scatterMap, const JTKJ_Type& JT_K_J, TMatrix& globalMatrix, const type::Vec2u& positionInGlobalMatrix);
 };
 
 #if !defined(SOFA_COMPONENT_LINEARSYSTEM_CONSTANTSPARSITYPROJECTIONMETHOD_CPP)
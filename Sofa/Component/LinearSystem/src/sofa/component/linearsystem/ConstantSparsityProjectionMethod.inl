@@ -65,6 +65,15 @@ void ConstantSparsityProjectionMethod<TMatrix>::init()
             JT_Type, KJ_Type, JTKJ_Type>>(matrixPrductJTKJ);
 
         matrixPrductJTKJ->taskScheduler = taskScheduler;
+
+
+        auto* matrixPrductJTK = new sofa::simulation::ParallelSparseMatrixProduct<
+            JT_Type, K_Type, JTKJ_Type>();
+
+        m_matrixProductJTK = std::unique_ptr<sofa::simulation::ParallelSparseMatrixProduct<
+            JT_Type, K_Type, JTKJ_Type>>(matrixPrductJTK);
+
+        matrixPrductJTK->taskScheduler = taskScheduler;
     }
     else
     {
@@ -73,6 +82,9 @@ void ConstantSparsityProjectionMethod<TMatrix>::init()
 
         m_matrixProductJTKJ = std::make_unique<sofa::linearalgebra::SparseMatrixProduct<
             JT_Type, KJ_Type, JTKJ_Type>>();
+
+        m_matrixProductJTK = std::make_unique<sofa::linearalgebra::SparseMatrixProduct<
+            JT_Type, K_Type, JTKJ_Type>>();
     }
 }
 
@@ -84,6 +96,8 @@ void ConstantSparsityProjectionMethod<TMatrix>::reinit()
     //cached products are invalidated
     m_matrixProductKJ->invalidateIntersection();
     m_matrixProductJTKJ->invalidateIntersection();
+    m_matrixProductJTK->invalidateIntersection();
+    m_scatterMaps.clear();
 }
 
 template <class TMatrix>
@@ -111,7 +125,13 @@ void ConstantSparsityProjectionMethod<TMatrix>::computeProjection(
     else if (J[0] && !J[1])
     {
         const auto JMap0 = this->makeEigenMap(*J[0]);
-        JT_K_J = JMap0.transpose() * KMap;
+
+        const JT_Type JMap0T = JMap0.transpose();
+        m_matrixProductJTK->m_lhs = &JMap0T;
+        m_matrixProductJTK->m_rhs = &KMap;
+        m_matrixProductJTK->computeProduct();
+
+        JT_K_J = m_matrixProductJTK->getProductResult();
     }
     else if (!J[0] && J[1])
     {
@@ -131,4 +151,94 @@ void ConstantSparsityProjectionMethod<TMatrix>::computeProjection(
 }
 
 
+template <class TMatrix>
+void ConstantSparsityProjectionMethod<TMatrix>::addProjectedMatrixToGlobalMatrix(
+    const sofa::type::fixed_array<core::behavior::BaseMechanicalState*, 2>& topMostStates,
+    const Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J,
+    const type::Vec2u& positionInGlobalMatrix,
+    linearalgebra::BaseMatrix* globalMatrix)
+{
+    auto* crs = dynamic_cast<TMatrix*>(globalMatrix);
+
+    // The locations in the values array are meaningful only if the global matrix is compressed.
+    // It is not the case during the first assembly.
+    const bool isGlobalMatrixCompressed = crs && crs->btemp.empty() && !crs->colsValue.empty();
+    if (!isGlobalMatrixCompressed || !JT_K_J.isCompressed())
+    {
+        Inherit1::addProjectedMatrixToGlobalMatrix(topMostStates, JT_K_J, positionInGlobalMatrix, globalMatrix);
+        return;
+    }
+
+    auto& scatterMap = m_scatterMaps[{topMostStates[0], topMostStates[1]}];
+    if (!isScatterMapValid(scatterMap, JT_K_J, *crs, positionInGlobalMatrix))
+    {
+        SCOPED_TIMER("buildScatterMap");
+        if (!buildScatterMap(scatterMap, JT_K_J, *crs, positionInGlobalMatrix))
+        {
+            // at least one entry of the projected matrix is not in the sparsity pattern of the global matrix
+            m_scatterMaps.erase({topMostStates[0], topMostStates[1]});
+            Inherit1::addProjectedMatrixToGlobalMatrix(topMostStates, JT_K_J, positionInGlobalMatrix, globalMatrix);
+            return;
+        }
+    }
+
+    const Block* projectedValues = JT_K_J.valuePtr();
+    Block* globalValues = crs->colsValue.data();
+    const auto nbValues = scatterMap.valueIds.size();
+    for (std::size_t i = 0; i < nbValues; ++i)
+    {
+        globalValues[scatterMap.valueIds[i]] += projectedValues[i];
+    }
+}
+
+template <class TMatrix>
+bool ConstantSparsityProjectionMethod<TMatrix>::isScatterMapValid(
+    const ScatterMap& scatterMap, const JTKJ_Type& JT_K_J, const TMatrix& globalMatrix,
+    const type::Vec2u& positionInGlobalMatrix)
+{
+    if (scatterMap.globalMatrixNbValues != globalMatrix.colsValue.size()
+        || scatterMap.positionInGlobalMatrix != positionInGlobalMatrix
+        || scatterMap.valueIds.size() != static_cast<std::size_t>(JT_K_J.nonZeros()))
+    {
+        return false;
+    }
+
+    const auto* outerBegin = JT_K_J.outerIndexPtr();
+    const auto* innerBegin = JT_K_J.innerIndexPtr();
+    return std::equal(scatterMap.outerIndex.begin(), scatterMap.outerIndex.end(), outerBegin, outerBegin + JT_K_J.outerSize() + 1)
+        && std::equal(scatterMap.innerIndex.begin(), scatterMap.innerIndex.end(), innerBegin, innerBegin + JT_K_J.nonZeros());
+}
+
+template <class TMatrix>
+bool ConstantSparsityProjectionMethod<TMatrix>::buildScatterMap(
+    ScatterMap& scatterMap, const JTKJ_Type& JT_K_J, TMatrix& globalMatrix,
+    const type::Vec2u& positionInGlobalMatrix)
+{
+    scatterMap.valueIds.clear();
+    scatterMap.valueIds.reserve(JT_K_J.nonZeros());
+
+    for (int k = 0; k < JT_K_J.outerSize(); ++k)
+    {
+        for (typename JTKJ_Type::InnerIterator it(JT_K_J, k); it; ++it)
+        {
+            const auto* block = globalMatrix.wblock(
+                it.row() + positionInGlobalMatrix[0], it.col() + positionInGlobalMatrix[1], false);
+            if (!block)
+            {
+                return false;
+            }
+            scatterMap.valueIds.push_back(static_cast<std::size_t>(block - globalMatrix.colsValue.data()));
+        }
+    }
+
+    const auto* outerBegin = JT_K_J.outerIndexPtr();
+    const auto* innerBegin = JT_K_J.innerIndexPtr();
+    scatterMap.outerIndex.assign(outerBegin, outerBegin + JT_K_J.outerSize() + 1);
+    scatterMap.innerIndex.assign(innerBegin, innerBegin + JT_K_J.nonZeros());
+    scatterMap.globalMatrixNbValues = globalMatrix.colsValue.size();
+    scatterMap.positionInGlobalMatrix = positionInGlobalMatrix;
+
+    return true;
+}
+
 }
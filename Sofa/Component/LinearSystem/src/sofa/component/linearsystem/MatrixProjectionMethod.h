@@ -98,6 +98,16 @@ protected:
         const sofa::type::fixed_array<std::shared_ptr<TMatrix>, 2> J,
         Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J);
 
+    /**
+     * Add the projected matrix J0^T * K * J1 into the global matrix, at the position associated to the pair of top most
+     * mechanical states.
+     */
+    virtual void addProjectedMatrixToGlobalMatrix(
+        const sofa::type::fixed_array<core::behavior::BaseMechanicalState*, 2>& topMostStates,
+        const Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J,
+        const type::Vec2u& positionInGlobalMatrix,
+        linearalgebra::BaseMatrix* globalMatrix);
+
     Data<bool> d_areJacobiansConstant; ///< True if mapping jacobians are considered constant over time. They are computed only the first time.
 
     std::optional<sofa::type::fixed_array<MappingJacobians<TMatrix>, 2>> m_mappingJacobians;
@@ -64,7 +64,7 @@ void computeProjection(
     Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J);
 
 template <class BlockType>
-void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, Eigen::SparseMatrix<BlockType, Eigen::RowMajor> JT_K_J, const type::Vec2u positionInGlobalMatrix);
+void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, const Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J, const type::Vec2u positionInGlobalMatrix);
 
 template <class TMatrix>
 void MatrixProjectionMethod<TMatrix>::addMappedMatrixToGlobalMatrixEigen(
@@ -143,10 +143,21 @@ void MatrixProjectionMethod<TMatrix>::addMappedMatrixToGlobalMatrixEigen(
 
         const type::Vec2u positionInGlobalMatrix = mappingGraph.getPositionInGlobalMatrix(a, b);
 
-        addToGlobalMatrix<Block>(globalMatrix, JT_K_J, positionInGlobalMatrix);
+        addProjectedMatrixToGlobalMatrix({a, b}, JT_K_J, positionInGlobalMatrix, globalMatrix);
     }
 }
 
+template <class TMatrix>
+void MatrixProjectionMethod<TMatrix>::addProjectedMatrixToGlobalMatrix(
+    const sofa::type::fixed_array<core::behavior::BaseMechanicalState*, 2>& topMostStates,
+    const Eigen::SparseMatrix<Block, Eigen::RowMajor>& JT_K_J,
+    const type::Vec2u& positionInGlobalMatrix,
+    linearalgebra::BaseMatrix* globalMatrix)
+{
+    SOFA_UNUSED(topMostStates);
+    addToGlobalMatrix<Block>(globalMatrix, JT_K_J, positionInGlobalMatrix);
+}
+
 template <class TMatrix>
 Eigen::Map<Eigen::SparseMatrix<typename MatrixProjectionMethod<TMatrix>::Block,
 Eigen::RowMajor>> MatrixProjectionMethod<TMatrix>::makeEigenMap(const TMatrix& matrix)
@@ -190,7 +201,7 @@ void MatrixProjectionMethod<TMatrix>::computeProjection(
 }
 
 template <class BlockType>
-void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, Eigen::SparseMatrix<BlockType, Eigen::RowMajor> JT_K_J, const type::Vec2u positionInGlobalMatrix)
+void addToGlobalMatrix(linearalgebra::BaseMatrix* globalMatrix, const Eigen::SparseMatrix<BlockType, Eigen::RowMajor>& JT_K_J, const type::Vec2u positionInGlobalMatrix)
 {
     for (int k = 0; k < JT_K_J.outerSize(); ++k)
     {
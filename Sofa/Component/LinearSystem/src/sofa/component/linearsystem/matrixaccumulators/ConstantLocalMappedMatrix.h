@@ -70,26 +70,18 @@ template <core::matrixaccumulator::Contribution c, class TBlockType>
 void ConstantLocalMappedMatrix<c, TBlockType>::add(const no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col,
     const sofa::type::Mat<3, 3, float>& value)
 {
-    for (sofa::SignedIndex i = 0; i < 3; ++i)
-    {
-        for (sofa::SignedIndex j = 0; j < 3; ++j)
-        {
-            this->add(row + i, col + j, value(i, j));
-        }
-    }
+    SOFA_UNUSED(row);
+    SOFA_UNUSED(col);
+    this->addBlockInInsertionOrder(this->m_mappedMatrix->colsValue, value);
 }
 
 template <core::matrixaccumulator::Contribution c, class TBlockType>
 void ConstantLocalMappedMatrix<c, TBlockType>::add(const no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col,
     const sofa::type::Mat<3, 3, double>& value)
 {
-    for (sofa::SignedIndex i = 0; i < 3; ++i)
-    {
-        for (sofa::SignedIndex j = 0; j < 3; ++j)
-        {
-            this->add(row + i, col + j, value(i, j));
-        }
-    }
+    SOFA_UNUSED(row);
+    SOFA_UNUSED(col);
+    this->addBlockInInsertionOrder(this->m_mappedMatrix->colsValue, value);
 }
 
 }
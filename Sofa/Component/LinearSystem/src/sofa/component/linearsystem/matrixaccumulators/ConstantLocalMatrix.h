@@ -51,6 +51,24 @@ protected:
     void add(const core::matrixaccumulator::no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col, const sofa::type::Mat<3, 3, float>& value) override;
     void add(const core::matrixaccumulator::no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col, const sofa::type::Mat<3, 3, double>& value) override;
 
+    /**
+     * Add the 9 scalar values of a 3x3 block directly into the compressed values.
+     * During the first assembly, the block has been recorded as 9 consecutive scalar insertions (row-major order).
+     * Therefore, the 9 locations are read contiguously in the list of indices, without any search nor virtual call.
+     */
+    template<class TValues, class TReal>
+    void addBlockInInsertionOrder(TValues& values, const sofa::type::Mat<3, 3, TReal>& value)
+    {
+        const std::size_t* id = compressedInsertionOrderList.data() + currentId;
+        for (sofa::Size i = 0; i < 3; ++i)
+        {
+            for (sofa::Size j = 0; j < 3; ++j)
+            {
+                values[*id++] += this->m_cachedFactor * value(i, j);
+            }
+        }
+        currentId += 9;
+    }
 };
 
 template <class TMatrix, core::matrixaccumulator::Contribution c, class TStrategy>
@@ -75,26 +93,18 @@ template <class TMatrix, core::matrixaccumulator::Contribution c, class TStrateg
 void ConstantLocalMatrix<TMatrix, c, TStrategy>::add(const core::matrixaccumulator::no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col,
     const sofa::type::Mat<3, 3, float>& value)
 {
-    for (sofa::SignedIndex i = 0; i < 3; ++i)
-    {
-        for (sofa::SignedIndex j = 0; j < 3; ++j)
-        {
-            this->add(core::matrixaccumulator::no_check, row + i, col + j, value(i, j));
-        }
-    }
+    SOFA_UNUSED(row);
+    SOFA_UNUSED(col);
+    addBlockInInsertionOrder(static_cast<TMatrix*>(this->m_globalMatrix)->colsValue, value);
 }
 
 template <class TMatrix, core::matrixaccumulator::Contribution c, class TStrategy>
 void ConstantLocalMatrix<TMatrix, c, TStrategy>::add(const core::matrixaccumulator::no_check_policy&, sofa::SignedIndex row, sofa::SignedIndex col,
     const sofa::type::Mat<3, 3, double>& value)
 {
-    for (sofa::SignedIndex i = 0; i < 3; ++i)
-    {
-        for (sofa::SignedIndex j = 0; j < 3; ++j)
-        {
-            this->add(core::matrixaccumulator::no_check, row + i, col + j, value(i, j));
-        }
-    }
+    SOFA_UNUSED(row);
+    SOFA_UNUSED(col);
+    addBlockInInsertionOrder(static_cast<TMatrix*>(this->m_globalMatrix)->colsValue, value);
 }
 
 
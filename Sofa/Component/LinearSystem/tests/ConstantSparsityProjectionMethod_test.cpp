@@ -0,0 +1,131 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseTest.h>
+#include <sofa/component/linearsystem/ConstantSparsityProjectionMethod.inl>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+
+namespace
+{
+
+using MatrixType = sofa::linearalgebra::CompressedRowSparseMatrix<SReal>;
+using ProjectedMatrix = Eigen::SparseMatrix<SReal, Eigen::RowMajor>;
+
+/// Gives access to the addition of the projected matrix into the global matrix, and to the scatter maps
+class ConstantSparsityProjectionMethodTester : public sofa::component::linearsystem::ConstantSparsityProjectionMethod<MatrixType>
+{
+public:
+    SOFA_CLASS(ConstantSparsityProjectionMethodTester, sofa::component::linearsystem::ConstantSparsityProjectionMethod<MatrixType>);
+
+    using States = sofa::type::fixed_array<sofa::core::behavior::BaseMechanicalState*, 2>;
+
+    void addWithScatterMap(const ProjectedMatrix& JT_K_J, const sofa::type::Vec2u& position, MatrixType& globalMatrix)
+    {
+        this->addProjectedMatrixToGlobalMatrix(States{}, JT_K_J, position, &globalMatrix);
+    }
+
+    void addGeneric(const ProjectedMatrix& JT_K_J, const sofa::type::Vec2u& position, MatrixType& globalMatrix)
+    {
+        sofa::component::linearsystem::MatrixProjectionMethod<MatrixType>::addProjectedMatrixToGlobalMatrix(States{}, JT_K_J, position, &globalMatrix);
+    }
+
+    std::size_t nbScatterMaps() const { return m_scatterMaps.size(); }
+
+    bool isScatterMapBuiltFrom(const ProjectedMatrix& JT_K_J) const
+    {
+        if (m_scatterMaps.size() != 1)
+            return false;
+        const auto& scatterMap = m_scatterMaps.begin()->second;
+        return std::equal(scatterMap.innerIndex.begin(), scatterMap.innerIndex.end(),
+                          JT_K_J.innerIndexPtr(), JT_K_J.innerIndexPtr() + JT_K_J.nonZeros())
+            && std::equal(scatterMap.outerIndex.begin(), scatterMap.outerIndex.end(),
+                          JT_K_J.outerIndexPtr(), JT_K_J.outerIndexPtr() + JT_K_J.outerSize() + 1);
+    }
+};
+
+/// A compressed 6x6 global matrix with a band sparsity pattern
+void createGlobalMatrix(MatrixType& matrix)
+{
+    matrix.resize(6, 6);
+    for (int i = 0; i < 6; ++i)
+    {
+        for (int j = std::max(0, i - 2); j < std::min(6, i + 3); ++j)
+        {
+            matrix.add(i, j, 1 + i + 10 * j);
+        }
+    }
+    matrix.compress();
+}
+
+ProjectedMatrix createProjectedMatrix(const std::vector<Eigen::Triplet<SReal> >& entries)
+{
+    ProjectedMatrix m(4, 4);
+    m.setFromTriplets(entries.begin(), entries.end());
+    m.makeCompressed();
+    return m;
+}
+
+void expectSameMatrices(const MatrixType& a, const MatrixType& b)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        for (int j = 0; j < 6; ++j)
+        {
+            EXPECT_EQ(a.element(i, j), b.element(i, j)) << "entry (" << i << ", " << j << ")";
+        }
+    }
+}
+
+}
+
+TEST(ConstantSparsityProjectionMethod, scatterMapFollowsSparsityPattern)
+{
+    const auto method = sofa::core::objectmodel::New<ConstantSparsityProjectionMethodTester>();
+    const sofa::type::Vec2u position(1, 1);
+
+    MatrixType withScatterMap, generic;
+    createGlobalMatrix(withScatterMap);
+    createGlobalMatrix(generic);
+
+    // first pattern: the scatter map is built, and the result is the same as the generic projection
+    const auto first = createProjectedMatrix({{0, 0, 1.5}, {0, 1, -2.}, {1, 1, 3.}, {2, 3, 4.}, {3, 3, 5.}});
+    method->addWithScatterMap(first, position, withScatterMap);
+    method->addGeneric(first, position, generic);
+    EXPECT_EQ(method->nbScatterMaps(), 1u);
+    EXPECT_TRUE(method->isScatterMapBuiltFrom(first));
+    expectSameMatrices(withScatterMap, generic);
+
+    // same pattern, different values: the scatter map is reused
+    const auto firstNewValues = createProjectedMatrix({{0, 0, 0.5}, {0, 1, 7.}, {1, 1, -1.}, {2, 3, 2.}, {3, 3, 8.}});
+    method->addWithScatterMap(firstNewValues, position, withScatterMap);
+    method->addGeneric(firstNewValues, position, generic);
+    EXPECT_TRUE(method->isScatterMapBuiltFrom(first));
+    expectSameMatrices(withScatterMap, generic);
+
+    // different pattern with the same number of non-zeros: the scatter map is rebuilt
+    const auto second = createProjectedMatrix({{0, 2, 1.}, {1, 0, 2.}, {2, 2, 3.}, {3, 1, 4.}, {3, 2, 5.}});
+    ASSERT_EQ(second.nonZeros(), first.nonZeros());
+    method->addWithScatterMap(second, position, withScatterMap);
+    method->addGeneric(second, position, generic);
+    EXPECT_EQ(method->nbScatterMaps(), 1u);
+    EXPECT_TRUE(method->isScatterMapBuiltFrom(second));
+    expectSameMatrices(withScatterMap, generic);
+}
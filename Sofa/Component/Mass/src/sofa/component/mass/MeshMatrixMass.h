@@ -108,6 +108,8 @@ public:
     /// if specific mass information should be outputed
     Data< bool >         d_printMass; ///< Boolean to print the mass
     Data< std::map < std::string, sofa::type::vector<double> > > f_graph; ///< Graph of the controlled potential
+    /// if the masses of the whole mesh and the products with the mass matrix should be computed in parallel
+    Data< bool >         d_parallelComputation;
 
     /// Link to be set to the topology container in the component graph.
     SingleLink<MeshMatrixMass<DataTypes, GeometricalTypes>, sofa::core::topology::BaseMeshTopology, BaseLink::FLAG_STOREPATH | BaseLink::FLAG_STRONGLINK> l_topology;
@@ -120,6 +122,31 @@ protected:
     sofa::geometry::ElementType m_massTopologyType;
     Real m_massLumpingCoeff;
 
+    /// Edges around each vertex, in compressed sparse row format, so that the rows of the mass matrix
+    /// can be traversed (and computed in parallel) without scattering over the edges
+    struct EdgeAdjacency
+    {
+        bool isValid { false };
+        int topologyRevision { -1 }; ///< revision of the topology the adjacency has been built from
+        sofa::type::vector<Index> rowBegin; ///< the edges around the vertex i are in [rowBegin[i], rowBegin[i+1])
+        sofa::type::vector<Index> neighbors; ///< the other vertex of each edge
+        sofa::type::vector<Index> edges; ///< the index of each edge
+    };
+    EdgeAdjacency m_edgeAdjacency;
+
+    /// Builds @sa m_edgeAdjacency from the edges of the topology, if it has been invalidated or if the topology changed
+    /// since it was built (renumberings included)
+    void updateEdgeAdjacency();
+
+    /** Computes the masses on the vertices (and on the edges if not lumped) from all the elements of the mesh, in parallel.
+    * The mass of each element is computed first, then the masses of each vertex (resp. edge) are summed over the
+    * elements around it, in the order of the elements so that the result is the same as the sequential computation.
+    */
+    template <class Element, class ComputeElementMeasure, class GetEdgesInElement>
+    void computeMassInParallel(const sofa::type::vector<Element>& elements, sofa::Size nbEdgesPerElement,
+        const GetEdgesInElement& getEdgesInElement, const ComputeElementMeasure& computeElementMeasure,
+        Real vertexMassDivisor, Real edgeMassDivisor);
+
     MeshMatrixMass();
     ~MeshMatrixMass() override;
 
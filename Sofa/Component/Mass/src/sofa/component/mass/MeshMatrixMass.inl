@@ -32,6 +32,8 @@
 #include <sofa/type/vector.h>
 #include <sofa/simulation/AnimateEndEvent.h>
 #include <sofa/core/behavior/MultiMatrixAccessor.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 #include <numeric>
 
 #include <sofa/core/behavior/BaseLocalMassMatrix.h>
@@ -54,6 +56,7 @@ MeshMatrixMass<DataTypes, GeometricalTypes>::MeshMatrixMass()
     , d_lumping( initData(&d_lumping, false, "lumping","If true, the mass matrix is lumped, meaning the mass matrix becomes diagonal (summing all mass values of a line on the diagonal)") )
     , d_printMass( initData(&d_printMass, false, "printMass","boolean if you want to check the mass conservation") )
     , f_graph( initData(&f_graph,"graph","Graph of the controlled potential") )
+    , d_parallelComputation( initData(&d_parallelComputation, false, "parallelComputation", "If true, the masses are computed in parallel when computed from the whole mesh, as well as the products with the mass matrix") )
     , l_topology(initLink("topology", "link to the topology container"))
     , l_geometryState(initLink("geometryState", "link to the MechanicalObject associated with the geometry"))
     , m_massTopologyType(geometry::ElementType::UNKNOWN)
@@ -74,6 +77,7 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::applyVertexMassCreation(Index,
     const sofa::type::vector< SReal >&)
 {
     VertexMass = 0;
+    m_edgeAdjacency.isValid = false;
 }
 
 template <class DataTypes, class GeometricalTypes>
@@ -83,6 +87,7 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::applyEdgeMassCreation(Index, M
     const sofa::type::vector< SReal >&)
 {
     EdgeMass = 0;
+    m_edgeAdjacency.isValid = false;
 }
 
 
@@ -92,6 +97,7 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::applyVertexMassDestruction(Ind
     SOFA_UNUSED(id);
     auto totalMass = sofa::helper::getWriteOnlyAccessor(d_totalMass);
     totalMass -= VertexMass;
+    m_edgeAdjacency.isValid = false;
 }
 
 
@@ -104,6 +110,7 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::applyEdgeMassDestruction(Index
         auto totalMass = sofa::helper::getWriteOnlyAccessor(d_totalMass);
         totalMass -= EdgeMass;
     }
+    m_edgeAdjacency.isValid = false;
 }
 
 
@@ -1440,12 +1447,25 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::computeMass()
                 quadsAdded.push_back(i);
 
             m_massLumpingCoeff = 2.0;
-            if (!isLumped())
+            if (d_parallelComputation.getValue() && getMassDensity().size() >= n)
             {
-                applyEdgeMassQuadCreation(quadsAdded, l_topology->getQuads(), emptyAncestors, emptyCoefficients);
+                computeMassInParallel(l_topology->getQuads(), 4,
+                    [this](Index i) -> const auto& { return l_topology->getEdgesInQuad(i); },
+                    [](const auto& q, const auto& positions)
+                    {
+                        return sofa::geometry::Quad::area(GeometricalTypes::getCPos(positions[q[0]]), GeometricalTypes::getCPos(positions[q[1]]),
+                                                          GeometricalTypes::getCPos(positions[q[2]]), GeometricalTypes::getCPos(positions[q[3]]));
+                    }, Real(8.0), Real(16.0));
             }
+            else
+            {
+                if (!isLumped())
+                {
+                    applyEdgeMassQuadCreation(quadsAdded, l_topology->getQuads(), emptyAncestors, emptyCoefficients);
+                }
 
-            applyVertexMassQuadCreation(quadsAdded, l_topology->getQuads(), emptyAncestors, emptyCoefficients);
+                applyVertexMassQuadCreation(quadsAdded, l_topology->getQuads(), emptyAncestors, emptyCoefficients);
+            }
         }
 
         if (getMassTopologyType() == geometry::ElementType::TRIANGLE)
@@ -1458,12 +1478,25 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::computeMass()
                 trianglesAdded.push_back(i);
 
             m_massLumpingCoeff = 2.0;
-            if (!isLumped())
+            if (d_parallelComputation.getValue() && getMassDensity().size() >= n)
             {
-                applyEdgeMassTriangleCreation(trianglesAdded, l_topology->getTriangles(), emptyAncestors, emptyCoefficients);
+                computeMassInParallel(l_topology->getTriangles(), 3,
+                    [this](Index i) -> const auto& { return l_topology->getEdgesInTriangle(i); },
+                    [](const auto& t, const auto& positions)
+                    {
+                        return sofa::geometry::Triangle::area(GeometricalTypes::getCPos(positions[t[0]]), GeometricalTypes::getCPos(positions[t[1]]),
+                                                              GeometricalTypes::getCPos(positions[t[2]]));
+                    }, Real(6.0), Real(12.0));
             }
+            else
+            {
+                if (!isLumped())
+                {
+                    applyEdgeMassTriangleCreation(trianglesAdded, l_topology->getTriangles(), emptyAncestors, emptyCoefficients);
+                }
 
-            applyVertexMassTriangleCreation(trianglesAdded, l_topology->getTriangles(), emptyAncestors, emptyCoefficients);
+                applyVertexMassTriangleCreation(trianglesAdded, l_topology->getTriangles(), emptyAncestors, emptyCoefficients);
+            }
         }
     }
 
@@ -1478,12 +1511,28 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::computeMass()
                 hexahedraAdded.push_back(i);
 
             m_massLumpingCoeff = 2.5;
-            if (!isLumped())
+            if (d_parallelComputation.getValue() && getMassDensity().size() >= n)
             {
-                applyEdgeMassHexahedronCreation(hexahedraAdded, l_topology->getHexahedra(), emptyAncestors, emptyCoefficients);
+                computeMassInParallel(l_topology->getHexahedra(), 12,
+                    [this](Index i) -> const auto& { return l_topology->getEdgesInHexahedron(i); },
+                    [](const auto& h, const auto& positions)
+                    {
+                        return sofa::geometry::Hexahedron::volume(
+                            GeometricalTypes::getCPos(positions[h[0]]), GeometricalTypes::getCPos(positions[h[1]]),
+                            GeometricalTypes::getCPos(positions[h[2]]), GeometricalTypes::getCPos(positions[h[3]]),
+                            GeometricalTypes::getCPos(positions[h[4]]), GeometricalTypes::getCPos(positions[h[5]]),
+                            GeometricalTypes::getCPos(positions[h[6]]), GeometricalTypes::getCPos(positions[h[7]]));
+                    }, Real(20.0), Real(40.0));
             }
+            else
+            {
+                if (!isLumped())
+                {
+                    applyEdgeMassHexahedronCreation(hexahedraAdded, l_topology->getHexahedra(), emptyAncestors, emptyCoefficients);
+                }
 
-            applyVertexMassHexahedronCreation(hexahedraAdded, l_topology->getHexahedra(), emptyAncestors, emptyCoefficients);
+                applyVertexMassHexahedronCreation(hexahedraAdded, l_topology->getHexahedra(), emptyAncestors, emptyCoefficients);
+            }
         }
 
         if (getMassTopologyType() == geometry::ElementType::TETRAHEDRON)
@@ -1496,14 +1545,185 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::computeMass()
                 tetrahedraAdded.push_back(i);
 
             m_massLumpingCoeff = 2.5;
-            if (!isLumped())
+            if (d_parallelComputation.getValue() && getMassDensity().size() >= n)
+            {
+                computeMassInParallel(l_topology->getTetrahedra(), 6,
+                    [this](Index i) -> const auto& { return l_topology->getEdgesInTetrahedron(i); },
+                    [](const auto& t, const auto& positions)
+                    {
+                        return sofa::geometry::Tetrahedron::volume(GeometricalTypes::getCPos(positions[t[0]]), GeometricalTypes::getCPos(positions[t[1]]),
+                                                                   GeometricalTypes::getCPos(positions[t[2]]), GeometricalTypes::getCPos(positions[t[3]]));
+                    }, Real(10.0), Real(20.0));
+            }
+            else
+            {
+                if (!isLumped())
+                {
+                    applyEdgeMassTetrahedronCreation(tetrahedraAdded, l_topology->getTetrahedra(), emptyAncestors, emptyCoefficients);
+                }
+
+                applyVertexMassTetrahedronCreation(tetrahedraAdded, l_topology->getTetrahedra(), emptyAncestors, emptyCoefficients);
+            }
+        }
+    }
+}
+
+
+template <class DataTypes, class GeometricalTypes>
+template <class Element, class ComputeElementMeasure, class GetEdgesInElement>
+void MeshMatrixMass<DataTypes, GeometricalTypes>::computeMassInParallel(const sofa::type::vector<Element>& elements, sofa::Size nbEdgesPerElement,
+    const GetEdgesInElement& getEdgesInElement, const ComputeElementMeasure& computeElementMeasure,
+    Real vertexMassDivisor, Real edgeMassDivisor)
+{
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+
+    const core::ConstVecCoordId posid = this->d_computeMassOnRest.getValue() ? core::ConstVecCoordId::restPosition() : core::ConstVecCoordId::position();
+    const auto& positions = l_geometryState->read(posid)->getValue();
+    const auto& densityM = getMassDensity();
+    const std::size_t nbElements = elements.size();
+    constexpr sofa::Size nbVerticesPerElement = Element::static_size;
+
+    // density * measure of each element
+    sofa::type::vector<MassType> elementMass(nbElements);
+    simulation::parallelForEachRange(*taskScheduler, std::size_t(0), nbElements,
+        [&](const auto& range)
+        {
+            for (auto i = range.start; i < range.end; ++i)
             {
-                applyEdgeMassTetrahedronCreation(tetrahedraAdded, l_topology->getTetrahedra(), emptyAncestors, emptyCoefficients);
+                elementMass[i] = densityM[i] * computeElementMeasure(elements[i], positions);
             }
+        });
+
+    // The elements around each vertex (resp. edge) are found with a counting sort, then the mass of each
+    // vertex (resp. edge) is only written by the thread summing the contributions of its elements
+    const auto gather = [&](const sofa::Size nbTargetsPerElement, const auto& getTarget, const Real divisor, auto& masses)
+    {
+        sofa::type::vector<Index> begin(masses.size() + 1, 0);
+        for (std::size_t i = 0; i < nbElements; ++i)
+        {
+            for (sofa::Size j = 0; j < nbTargetsPerElement; ++j)
+            {
+                ++begin[getTarget(i, j) + 1];
+            }
+        }
+        std::partial_sum(begin.begin(), begin.end(), begin.begin());
+
+        sofa::type::vector<Index> elementsAround(begin.back());
+        sofa::type::vector<Index> next(begin.begin(), begin.end() - 1);
+        for (std::size_t i = 0; i < nbElements; ++i)
+        {
+            for (sofa::Size j = 0; j < nbTargetsPerElement; ++j)
+            {
+                elementsAround[next[getTarget(i, j)]++] = static_cast<Index>(i);
+            }
+        }
+
+        simulation::parallelForEachRange(*taskScheduler, std::size_t(0), std::size_t(masses.size()),
+            [&](const auto& range)
+            {
+                for (auto t = range.start; t < range.end; ++t)
+                {
+                    for (Index k = begin[t]; k < begin[t + 1]; ++k)
+                    {
+                        masses[t] += elementMass[elementsAround[k]] / divisor;
+                    }
+                }
+            });
+    };
+
+    auto totalMass = sofa::helper::getWriteOnlyAccessor(d_totalMass);
+
+    if (!isLumped())
+    {
+        sofa::type::vector<Index> edgesInElements(nbElements * nbEdgesPerElement);
+        for (std::size_t i = 0; i < nbElements; ++i)
+        {
+            const auto& edgesInElement = getEdgesInElement(static_cast<Index>(i));
+            for (sofa::Size j = 0; j < nbEdgesPerElement; ++j)
+            {
+                edgesInElements[i * nbEdgesPerElement + j] = edgesInElement[j];
+            }
+        }
+
+        auto edgeMass = sofa::helper::getWriteAccessor(d_edgeMass);
+        gather(nbEdgesPerElement, [&edgesInElements, nbEdgesPerElement](std::size_t i, sofa::Size j)
+        {
+            return edgesInElements[i * nbEdgesPerElement + j];
+        }, edgeMassDivisor, edgeMass.wref());
+
+        for (std::size_t i = 0; i < nbElements; ++i)
+        {
+            totalMass += nbEdgesPerElement * (elementMass[i] / edgeMassDivisor) * 2.0; // x 2 because mass is actually splitted over half-edges
+        }
+    }
+
+    auto vertexMass = sofa::helper::getWriteAccessor(d_vertexMass);
+    gather(nbVerticesPerElement, [&elements](std::size_t i, sofa::Size j)
+    {
+        return elements[i][j];
+    }, vertexMassDivisor, vertexMass.wref());
+
+    for (std::size_t i = 0; i < nbElements; ++i)
+    {
+        const Real mass = elementMass[i] / vertexMassDivisor;
+        if (!isLumped())
+        {
+            totalMass += nbVerticesPerElement * mass;
+        }
+        else
+        {
+            totalMass += nbVerticesPerElement * mass * m_massLumpingCoeff;
+        }
+    }
+}
+
+
+template <class DataTypes, class GeometricalTypes>
+void MeshMatrixMass<DataTypes, GeometricalTypes>::updateEdgeAdjacency()
+{
+    const auto& edges = l_topology->getEdges();
+    const std::size_t nbVertices = d_vertexMass.getValue().size();
+    const int topologyRevision = l_topology->getRevision();
+    EdgeAdjacency& adjacency = m_edgeAdjacency;
+
+    // the revision of the topology changes on every topological change, including the renumberings
+    // which keep the sizes but make the rows stale
+    if (adjacency.isValid && adjacency.topologyRevision == topologyRevision
+        && adjacency.rowBegin.size() == nbVertices + 1 && adjacency.edges.size() == 2 * edges.size())
+    {
+        return;
+    }
+
+    adjacency.rowBegin.assign(nbVertices + 1, 0);
+    for (const auto& e : edges)
+    {
+        ++adjacency.rowBegin[e[0] + 1];
+        ++adjacency.rowBegin[e[1] + 1];
+    }
+    std::partial_sum(adjacency.rowBegin.begin(), adjacency.rowBegin.end(), adjacency.rowBegin.begin());
 
-            applyVertexMassTetrahedronCreation(tetrahedraAdded, l_topology->getTetrahedra(), emptyAncestors, emptyCoefficients);
+    // the edges of a row are stored in increasing order of their indices
+    adjacency.neighbors.resize(2 * edges.size());
+    adjacency.edges.resize(2 * edges.size());
+    sofa::type::vector<Index> next(adjacency.rowBegin.begin(), adjacency.rowBegin.end() - 1);
+    for (std::size_t j = 0; j < edges.size(); ++j)
+    {
+        const auto& e = edges[j];
+        for (unsigned int v = 0; v < 2; ++v)
+        {
+            const Index k = next[e[v]]++;
+            adjacency.neighbors[k] = e[1 - v];
+            adjacency.edges[k] = static_cast<Index>(j);
         }
     }
+
+    adjacency.topologyRevision = topologyRevision;
+    adjacency.isValid = true;
 }
 
 
@@ -2006,42 +2226,85 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addMDx(const core::MechanicalP
     helper::WriteAccessor< DataVecDeriv > res = vres;
     helper::ReadAccessor< DataVecDeriv > dx = vdx;
 
+    simulation::TaskScheduler* taskScheduler = nullptr;
+    if (d_parallelComputation.getValue())
+    {
+        taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+    }
+
+    // each vertex only writes its own row of the result
+    const auto forEachVertex = [taskScheduler, nbVertices = dx.size()](const auto& computeRows)
+    {
+        if (taskScheduler)
+        {
+            simulation::parallelForEachRange(*taskScheduler, std::size_t(0), nbVertices,
+                [&computeRows](const auto& range) { computeRows(range.start, range.end); });
+        }
+        else
+        {
+            computeRows(std::size_t(0), nbVertices);
+        }
+    };
+
     SReal massTotal = 0.0;
 
     //using a lumped matrix (default)-----
     if(isLumped())
     {
-        for (size_t i=0; i<dx.size(); i++)
+        forEachVertex([&](const std::size_t begin, const std::size_t end)
         {
-            res[i] += dx[i] * vertexMass[i] * m_massLumpingCoeff * Real(factor);
-            massTotal += vertexMass[i]*m_massLumpingCoeff * Real(factor);
-        }
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                res[i] += dx[i] * vertexMass[i] * m_massLumpingCoeff * Real(factor);
+            }
+        });
 
+        if (d_printMass.getValue())
+        {
+            for (size_t i=0; i<dx.size(); i++)
+            {
+                massTotal += vertexMass[i]*m_massLumpingCoeff * Real(factor);
+            }
+        }
     }
     //using a sparse matrix---------------
     else
     {
-        const size_t nbEdges=l_topology->getNbEdges();
-        const auto& edges = l_topology->getEdges();
+        // The edges are traversed row by row, in the same order as a traversal of the edge array:
+        // the contributions are summed in the same order, without scattering the result
+        updateEdgeAdjacency();
+        const auto& rowBegin = m_edgeAdjacency.rowBegin;
+        const auto& neighbors = m_edgeAdjacency.neighbors;
+        const auto& edges = m_edgeAdjacency.edges;
 
-        for (unsigned int i=0; i<dx.size(); i++)
+        forEachVertex([&](const std::size_t begin, const std::size_t end)
         {
-            res[i] += dx[i] * vertexMass[i] * Real(factor);
-            massTotal += vertexMass[i] * Real(factor);
-        }
-
-        Real tempMass=0.0;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                Deriv& r = res[i];
+                r += dx[i] * vertexMass[i] * Real(factor);
+                for (Index k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+                {
+                    r += dx[neighbors[k]] * (edgeMass[edges[k]] * Real(factor));
+                }
+            }
+        });
 
-        for (unsigned int j=0; j<nbEdges; ++j)
+        if (d_printMass.getValue())
         {
-            const auto& e = edges[j];
-
-            tempMass = edgeMass[j] * Real(factor);
-
-            res[e[0]] += dx[e[1]] * tempMass;
-            res[e[1]] += dx[e[0]] * tempMass;
-
-            massTotal += 2 * tempMass;
+            for (unsigned int i=0; i<dx.size(); i++)
+            {
+                massTotal += vertexMass[i] * Real(factor);
+            }
+            for (const auto& em : edgeMass)
+            {
+                massTotal += 2 * em * Real(factor);
+            }
         }
     }
 
@@ -2195,9 +2458,6 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addMToMatrix(sofa::linearalgeb
     const auto &vertexMass= d_vertexMass.getValue();
     const auto &edgeMass= d_edgeMass.getValue();
 
-    const size_t nbEdges=l_topology->getNbEdges();
-    sofa::Index v0,v1;
-
     static constexpr auto N = Deriv::total_size;
     AddMToMatrixFunctor<Deriv,MassType, sofa::linearalgebra::BaseMatrix> calc;
 
@@ -2233,24 +2493,22 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::addMToMatrix(sofa::linearalgeb
     }
     else
     {
-        unsigned int i {};
-        for (const auto& v : vertexMass)
-        {
-            calc(mat, v, offset + N * i, mFact);
-            massTotal += v;
-            ++i;
-        }
+        // the matrix is filled row by row
+        updateEdgeAdjacency();
+        const auto& rowBegin = m_edgeAdjacency.rowBegin;
+        const auto& neighbors = m_edgeAdjacency.neighbors;
+        const auto& edges = m_edgeAdjacency.edges;
 
-        const auto& edges = l_topology->getEdges();
-        for (size_t j = 0; j < nbEdges; ++j)
+        for (sofa::Index i = 0; i < vertexMass.size(); ++i)
         {
-            v0 = edges[j][0];
-            v1 = edges[j][1];
+            calc(mat, vertexMass[i], offset + N * i, mFact);
+            massTotal += vertexMass[i];
 
-            calc(mat, edgeMass[j], offset + N*v0, offset + N*v1, mFact);
-            calc(mat, edgeMass[j], offset + N*v1, offset + N*v0, mFact);
-
-            massTotal += 2 * edgeMass[j];
+            for (Index k = rowBegin[i]; k < rowBegin[i + 1]; ++k)
+            {
+                calc(mat, edgeMass[edges[k]], offset + N * i, offset + N * neighbors[k], mFact);
+                massTotal += edgeMass[edges[k]];
+            }
         }
 
         if(d_printMass.getValue() && (this->getContext()->getTime()==0.0))
@@ -2289,23 +2547,21 @@ void MeshMatrixMass<DataTypes, GeometricalTypes>::buildMassMatrix(sofa::core::be
     }
     else
     {
+        // the matrix is filled row by row
+        updateEdgeAdjacency();
+        const auto& rowBegin = m_edgeAdjacency.rowBegin;
+        const auto& neighbors = m_edgeAdjacency.neighbors;
+        const auto& edges = m_edgeAdjacency.edges;
+
         for (size_t index=0; index < vertexMass.size(); index++)
         {
             const auto& vm = vertexMass[index];
             calc(matrices, vm, N * index, 1.);
-        }
-
-        const size_t nbEdges = l_topology->getNbEdges();
-        for (size_t j = 0; j < nbEdges; ++j)
-        {
-            const auto e = l_topology->getEdge(j);
-            const sofa::Index v0 = e[0];
-            const sofa::Index v1 = e[1];
-
-            const auto em = edgeMass[j];
 
-            calc(matrices, em, N * v0, N * v1, 1.);
-            calc(matrices, em, N * v1, N * v0, 1.);
+            for (Index k = rowBegin[index]; k < rowBegin[index + 1]; ++k)
+            {
+                calc(matrices, edgeMass[edges[k]], N * index, N * neighbors[k], 1.);
+            }
         }
     }
 }
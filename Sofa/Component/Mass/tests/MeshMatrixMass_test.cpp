@@ -756,6 +756,151 @@ public:
     }
 
 
+    /// The masses and the product with the mass matrix must not depend on the parallel computation
+    void check_ParallelComputation_Tetra(){
+        VecMass vertexMass[2], edgeMass[2];
+        MassType totalMass[2];
+        typename DataTypes::VecDeriv mdx[2];
+
+        for (int parallel = 0; parallel < 2; ++parallel)
+        {
+            const string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>                                       "
+                "    <DefaultAnimationLoop />                                                                       "
+                "    <MechanicalObject />                                                                           "
+                "    <RegularGridTopology name='grid' n='5 4 3' min='0 0 0' max='2 1 1' p0='0 0 0' />               "
+                "    <Node name='Tetra' >                                                                           "
+                "        <MechanicalObject src='@../grid'/>                                                         "
+                "        <TetrahedronSetTopologyContainer name='Container' />                                       "
+                "        <TetrahedronSetTopologyModifier name='Modifier' />                                         "
+                "        <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                      "
+                "        <Hexa2TetraTopologicalMapping name='default28' input='@../grid' output='@Container' />     "
+                "        <MeshMatrixMass name='m_mass' massDensity='3.0' parallelComputation='" + std::to_string(parallel) + "'/> "
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+
+            const Node::SPtr root = SceneLoaderXML::loadFromMemory("loadWithNoParam", scene.c_str());
+            ASSERT_NE(root.get(), nullptr);
+            root->init(sofa::core::execparams::defaultInstance());
+
+            TheMeshMatrixMass* mass = root->getTreeObject<TheMeshMatrixMass>();
+            ASSERT_NE(mass, nullptr);
+
+            vertexMass[parallel] = mass->d_vertexMass.getValue();
+            edgeMass[parallel] = mass->d_edgeMass.getValue();
+            totalMass[parallel] = mass->getTotalMass();
+
+            typename DataTypes::VecDeriv dx(vertexMass[parallel].size());
+            for (std::size_t i = 0; i < dx.size(); ++i)
+            {
+                dx[i] = typename DataTypes::Deriv(Real(i % 3), Real(1) - Real(i % 5), Real(0.5) * i);
+            }
+            core::objectmodel::Data<typename DataTypes::VecDeriv> dataDx(dx);
+            core::objectmodel::Data<typename DataTypes::VecDeriv> dataResult(typename DataTypes::VecDeriv(dx.size()));
+            mass->addMDx(core::mechanicalparams::defaultInstance(), dataResult, dataDx, 2.0);
+            mdx[parallel] = dataResult.getValue();
+
+            sofa::simulation::node::unload(root);
+        }
+
+        EXPECT_FLOATINGPOINT_EQ(totalMass[0], totalMass[1]);
+        ASSERT_EQ(vertexMass[0].size(), vertexMass[1].size());
+        for (std::size_t i = 0; i < vertexMass[0].size(); ++i)
+        {
+            EXPECT_FLOATINGPOINT_EQ(vertexMass[0][i], vertexMass[1][i]);
+        }
+        ASSERT_EQ(edgeMass[0].size(), edgeMass[1].size());
+        for (std::size_t i = 0; i < edgeMass[0].size(); ++i)
+        {
+            EXPECT_FLOATINGPOINT_EQ(edgeMass[0][i], edgeMass[1][i]);
+        }
+        ASSERT_EQ(mdx[0].size(), mdx[1].size());
+        for (std::size_t i = 0; i < mdx[0].size(); ++i)
+        {
+            EXPECT_LT((mdx[0][i] - mdx[1][i]).norm(), 1e-12);
+        }
+    }
+
+    /// Product with the mass matrix, scattered over the edges of the topology
+    typename DataTypes::VecDeriv computeMDxPerEdge(TheMeshMatrixMass* mass, const typename DataTypes::VecDeriv& dx, const Real factor)
+    {
+        const VecMass& vertexMass = mass->d_vertexMass.getValue();
+        const VecMass& edgeMass = mass->d_edgeMass.getValue();
+        const auto& edges = mass->l_topology->getEdges();
+
+        typename DataTypes::VecDeriv res(dx.size());
+        for (std::size_t i = 0; i < dx.size(); ++i)
+        {
+            res[i] += dx[i] * vertexMass[i] * factor;
+        }
+        for (std::size_t j = 0; j < edges.size(); ++j)
+        {
+            res[edges[j][0]] += dx[edges[j][1]] * edgeMass[j] * factor;
+            res[edges[j][1]] += dx[edges[j][0]] * edgeMass[j] * factor;
+        }
+        return res;
+    }
+
+    /// The product with the mass matrix traverses the edges around each vertex: it must give the same result as
+    /// a scatter over the edges, also after the points have been renumbered
+    void check_AddMDx_PerEdge_Tetra(){
+        static const string scene =
+                "<?xml version='1.0'?>                                                                              "
+                "<Node  name='Root' gravity='0 0 0' time='0' animate='0'   >                                        "
+                "    <DefaultAnimationLoop />                                                                       "
+                "    <Node name='Tetra' >                                                                           "
+                "        <TetrahedronSetTopologyContainer name='Container'                                          "
+                "            position='0 0 0  1 0 0  0 1 0  0 0 1  1 1 1' tetrahedra='0 1 2 3  1 2 3 4' />          "
+                "        <MechanicalObject position='@Container.position' />                                        "
+                "        <TetrahedronSetTopologyModifier name='Modifier' />                                         "
+                "        <TetrahedronSetGeometryAlgorithms template='Vec3d' name='GeomAlgo' />                      "
+                "        <MeshMatrixMass name='m_mass' massDensity='3.0' />                                         "
+                "    </Node>                                                                                        "
+                "</Node>                                                                                            ";
+
+        const Node::SPtr root = SceneLoaderXML::loadFromMemory("loadWithNoParam", scene.c_str());
+        ASSERT_NE(root.get(), nullptr);
+        sofa::simulation::node::initRoot(root.get());
+
+        TheMeshMatrixMass* mass = root->getTreeObject<TheMeshMatrixMass>();
+        ASSERT_NE(mass, nullptr);
+        TetrahedronSetTopologyModifier* modifier = root->getTreeObject<TetrahedronSetTopologyModifier>();
+        ASSERT_NE(modifier, nullptr);
+
+        typename DataTypes::VecDeriv dx(5);
+        for (std::size_t i = 0; i < dx.size(); ++i)
+        {
+            dx[i] = typename DataTypes::Deriv(Real(i % 3), Real(1) - Real(i % 5), Real(0.5) * i);
+        }
+
+        const auto checkAddMDx = [&]()
+        {
+            core::objectmodel::Data<typename DataTypes::VecDeriv> dataDx(dx);
+            core::objectmodel::Data<typename DataTypes::VecDeriv> dataResult(typename DataTypes::VecDeriv(dx.size()));
+            mass->addMDx(core::mechanicalparams::defaultInstance(), dataResult, dataDx, 2.0);
+
+            const typename DataTypes::VecDeriv expected = computeMDxPerEdge(mass, dx, 2.0);
+            const typename DataTypes::VecDeriv& mdx = dataResult.getValue();
+            ASSERT_EQ(mdx.size(), expected.size());
+            for (std::size_t i = 0; i < mdx.size(); ++i)
+            {
+                EXPECT_LT((mdx[i] - expected[i]).norm(), 1e-12);
+            }
+        };
+
+        checkAddMDx();
+
+        // the renumbering keeps the number of vertices and edges, only the revision of the topology changes
+        const sofa::type::vector<sofa::Index> index = { 4, 3, 2, 1, 0 };
+        modifier->renumberPoints(index, index);
+        checkAddMDx();
+
+        sofa::simulation::node::unload(root);
+    }
+
+
     void check_MassDensity_Initialization_Tetra(){
         static const string scene =
                 "<?xml version='1.0'?>                                                                              "
@@ -2100,6 +2245,14 @@ TEST_F(MeshMatrixMass3_test, check_TotalMass_Initialization_Tetra){
 }
 
 
+TEST_F(MeshMatrixMass3_test, check_ParallelComputation_Tetra){
+    check_ParallelComputation_Tetra();
+}
+
+TEST_F(MeshMatrixMass3_test, check_AddMDx_PerEdge_Tetra){
+    check_AddMDx_PerEdge_Tetra();
+}
+
 TEST_F(MeshMatrixMass3_test, check_MassDensity_Initialization_Tetra){
     check_MassDensity_Initialization_Tetra();
 }
@@ -24,10 +24,15 @@
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/UpdateContextVisitor.h>
 #include <sofa/helper/AdvancedTimer.h>
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/helper/ScopedAdvancedTimer.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 namespace sofa::component::odesolver::backward
 {
@@ -44,7 +49,19 @@ EulerImplicitSolver::EulerImplicitSolver()
     , d_trapezoidalScheme( initData(&d_trapezoidalScheme,false,"trapezoidalScheme","Boolean to use the trapezoidal scheme instead of the implicit Euler scheme and get second order accuracy in time (false by default)") )
     , d_solveConstraint(initData(&d_solveConstraint, false, "solveConstraint", "Apply ConstraintSolver (requires a ConstraintSolver in the same node as this solver, disabled by by default for now)") )
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_adaptiveTimeStep(initData(&d_adaptiveTimeStep, false, "adaptiveTimeStep", "If true, the time step is integrated with sub-steps of adaptive size, controlled by an estimate of the local error"))
+    , d_errorTolerance(initData(&d_errorTolerance, (SReal)1e-3, "errorTolerance", "Adaptive time step: tolerance on the local error estimate of a sub-step (infinity norm, in position unit)"))
+    , d_minDt(initData(&d_minDt, (SReal)1e-6, "minDt", "Adaptive time step: minimal size of a sub-step. A sub-step of this size is accepted even if its error is larger than the tolerance"))
+    , d_dtGrowthLimit(initData(&d_dtGrowthLimit, (SReal)2.0, "dtGrowthLimit", "Adaptive time step: maximal factor between the size of a sub-step and the next one"))
+    , d_dtShrinkLimit(initData(&d_dtShrinkLimit, (SReal)0.2, "dtShrinkLimit", "Adaptive time step: minimal factor between the size of a sub-step and the next one, or the retry of a rejected one"))
+    , d_safetyFactor(initData(&d_safetyFactor, (SReal)0.9, "safetyFactor", "Adaptive time step: factor applied on the optimal size of the next sub-step"))
+    , d_maxNbRejections(initData(&d_maxNbRejections, 10u, "maxNbRejections", "Adaptive time step: maximal number of successive rejections of a sub-step, after which it is accepted"))
+    , d_dtHistory(initData(&d_dtHistory, "dtHistory", "Adaptive time step: sizes of the sub-steps accepted during the last time step"))
+    , d_nbRejectedSteps(initData(&d_nbRejectedSteps, 0u, "nbRejectedSteps", "Adaptive time step: total number of rejected sub-steps"))
 {
+    d_dtHistory.setReadOnly(true);
+    d_nbRejectedSteps.setReadOnly(true);
+
     f_rayleighStiffness.setOriginalData(&d_rayleighStiffness);
     f_rayleighMass.setOriginalData(&d_rayleighMass);
     f_velocityDamping.setOriginalData(&d_velocityDamping);
@@ -67,6 +84,36 @@ void EulerImplicitSolver::init()
     }
     sofa::core::behavior::OdeSolver::init();
     sofa::core::behavior::LinearSolverAccessor::init();
+
+    reinit();
+}
+
+void EulerImplicitSolver::reinit()
+{
+    sofa::core::behavior::OdeSolver::reinit();
+
+    if (d_dtShrinkLimit.getValue() <= 0 || d_dtShrinkLimit.getValue() > 1)
+    {
+        msg_warning() << "dtShrinkLimit must be in ]0, 1]. Set to 0.2";
+        d_dtShrinkLimit.setValue(0.2);
+    }
+    if (d_dtGrowthLimit.getValue() < 1)
+    {
+        msg_warning() << "dtGrowthLimit must be greater than 1. Set to 2";
+        d_dtGrowthLimit.setValue(2);
+    }
+    if (d_errorTolerance.getValue() <= 0)
+    {
+        msg_warning() << "errorTolerance must be positive. Set to 1e-3";
+        d_errorTolerance.setValue(1e-3);
+    }
+    if (d_adaptiveTimeStep.getValue() && d_trapezoidalScheme.getValue())
+    {
+        // the local error is estimated by the difference between the implicit Euler scheme and the trapezoidal rule
+        msg_warning() << "adaptiveTimeStep estimates the error of the implicit Euler scheme: it cannot be used with "
+                         "trapezoidalScheme. adaptiveTimeStep is set to false";
+        d_adaptiveTimeStep.setValue(false);
+    }
 }
 
 void EulerImplicitSolver::cleanup()
@@ -77,19 +124,145 @@ void EulerImplicitSolver::cleanup()
 }
 
 void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    if (d_adaptiveTimeStep.getValue())
+    {
+        solveAdaptive(params, dt, xResult, vResult);
+    }
+    else
+    {
+        integrate(params, dt, core::VecCoordId::position(), core::VecDerivId::velocity(), xResult, vResult);
+    }
+}
+
+void EulerImplicitSolver::solveAdaptive(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
+{
+    SCOPED_TIMER("AdaptiveTimeStep");
+
+    sofa::simulation::common::VectorOperations vop( params, this->getContext() );
+    sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
+    MultiVecCoord newPos(&vop, xResult );
+    MultiVecDeriv newVel(&vop, vResult );
+
+    // The sub-steps are computed in place in the result vectors.
+    // With FreeMotionAnimationLoop, the result vectors are the free position and velocity,
+    // so the position and the velocity are not modified.
+    if (xResult.hasIdMap() || xResult.getDefaultId() != core::VecCoordId::position())
+    {
+        newPos.eq(core::VecCoordId::position());
+    }
+    if (vResult.hasIdMap() || vResult.getDefaultId() != core::VecDerivId::velocity())
+    {
+        newVel.eq(core::VecDerivId::velocity());
+    }
+
+    // state at the beginning of the sub-step, restored if the sub-step is rejected
+    MultiVecCoord startPos(&vop, true, core::VecIdProperties{"AdaptiveStartPosition", GetClass()->className});
+    MultiVecDeriv startVel(&vop, true, core::VecIdProperties{"AdaptiveStartVelocity", GetClass()->className});
+    MultiVecDeriv velocityChange(&vop, true, core::VecIdProperties{"AdaptiveVelocityChange", GetClass()->className});
+
+    const SReal tolerance = d_errorTolerance.getValue();
+    const SReal minDt = std::min(d_minDt.getValue(), dt);
+    const SReal growthLimit = d_dtGrowthLimit.getValue();
+    const SReal shrinkLimit = d_dtShrinkLimit.getValue();
+    const SReal safetyFactor = d_safetyFactor.getValue();
+
+    // the size of the sub-steps is kept from one time step to the next one
+    if (m_subStepDt <= 0 || m_subStepDt > dt)
+    {
+        m_subStepDt = dt;
+    }
+
+    auto dtHistory = sofa::helper::getWriteOnlyAccessor(d_dtHistory);
+    dtHistory.clear();
+    unsigned int nbRejectedSteps = d_nbRejectedSteps.getValue();
+
+    // The time of the context is moved to the beginning of each sub-step, so that the time-dependent
+    // components are evaluated at the right time. It is restored at the end: the animation loop advances it.
+    simulation::Node* node = dynamic_cast<simulation::Node*>(this->getContext());
+    const SReal startTime = this->getContext()->getTime();
+    const auto setContextTime = [node, params](const SReal time)
+    {
+        if (node != nullptr)
+        {
+            node->setTime(time);
+            node->execute<simulation::UpdateSimulationContextVisitor>(params);
+        }
+    };
+
+    // when the remaining time exceeds the size of the sub-step by less than 10%, the sub-step is stretched
+    // to the end of the time step instead of being followed by a tiny one
+    constexpr SReal lastSubStepStretch = 1.1;
+
+    SReal remainingTime = dt;
+    while (remainingTime > 0)
+    {
+        // the last sub-step ends exactly at the end of the time step
+        SReal h = (remainingTime <= m_subStepDt * lastSubStepStretch) ? remainingTime : m_subStepDt;
+
+        setContextTime(startTime + (dt - remainingTime));
+        startPos.eq(newPos);
+        startVel.eq(newVel);
+
+        for (unsigned int nbRejections = 0; ; ++nbRejections)
+        {
+            mop.propagateXAndV(newPos, newVel);
+            integrate(params, h, xResult, vResult, xResult, vResult);
+
+            // Local error of the backward Euler step, estimated by its difference with the trapezoidal rule:
+            // x_BE - x_TR = h/2 (v_{t+h} - v_t)
+            velocityChange.eq(newVel, startVel, -1);
+            const SReal error = h * 0.5 * velocityChange.norm(0);
+
+            // the local error is in O(h^2)
+            const SReal factor = (error > 0) ? safetyFactor * std::sqrt(tolerance / error) : growthLimit;
+
+            if (error <= tolerance || h <= minDt || nbRejections >= d_maxNbRejections.getValue())
+            {
+                msg_warning_when(error > tolerance) << "The error estimate (" << error << ") of the time step of size " << h
+                    << " is larger than the tolerance (" << tolerance << "), but the step is accepted: "
+                    << (h <= minDt ? "minimal time step size reached" : "maximal number of rejections reached");
+
+                m_lastSubStepDt = h;
+                remainingTime -= h;
+                dtHistory.push_back(h);
+                m_subStepDt = std::clamp(h * std::clamp(factor, shrinkLimit, growthLimit), minDt, dt);
+                break;
+            }
+
+            // the step is rejected: restore the state and retry with a smaller step
+            ++nbRejectedSteps;
+            newPos.eq(startPos);
+            newVel.eq(startVel);
+            h = std::max(h * std::max(factor, shrinkLimit), minDt);
+            m_subStepDt = h;
+        }
+    }
+
+    setContextTime(startTime);
+    d_nbRejectedSteps.setValue(nbRejectedSteps);
+}
+
+void EulerImplicitSolver::integrate(const core::ExecParams* params, SReal dt,
+                                    sofa::core::MultiVecCoordId xStart, sofa::core::MultiVecDerivId vStart,
+                                    sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
 {
 #ifdef SOFA_DUMP_VISITOR_INFO
     sofa::simulation::Visitor::printNode("SolverVectorAllocation");
 #endif
     sofa::simulation::common::VectorOperations vop( params, this->getContext() );
     sofa::simulation::common::MechanicalOperations mop( params, this->getContext() );
-    MultiVecCoord pos(&vop, core::VecCoordId::position() );
-    MultiVecDeriv vel(&vop, core::VecDerivId::velocity() );
+    MultiVecCoord pos(&vop, xStart );
+    MultiVecDeriv vel(&vop, vStart );
     MultiVecDeriv f(&vop, core::VecDerivId::force() );
     MultiVecDeriv b(&vop, true, core::VecIdProperties{"RHS", GetClass()->className});
     MultiVecCoord newPos(&vop, xResult );
     MultiVecDeriv newVel(&vop, vResult );
 
+    // the forces are computed from the state at the beginning of the step
+    mop->setX(xStart);
+    mop->setV(vStart);
+
     /// inform the constraint parameters about the position and velocity id
     mop.cparams.setX(xResult);
     mop.cparams.setV(vResult);
@@ -317,14 +490,25 @@ void EulerImplicitSolver::solve(const core::ExecParams* params, SReal dt, sofa::
 }
 
 
+SReal EulerImplicitSolver::getIntegratedDt() const
+{
+    // With the adaptive time step, the constraint corrections apply on the last sub-step, which is the one
+    // the system matrix has been built with.
+    if (d_adaptiveTimeStep.getValue() && m_lastSubStepDt > 0)
+    {
+        return m_lastSubStepDt;
+    }
+    return getContext()->getDt();
+}
+
 SReal EulerImplicitSolver::getPositionIntegrationFactor() const
 {
-    return getPositionIntegrationFactor(getContext()->getDt());
+    return getPositionIntegrationFactor(getIntegratedDt());
 }
 
 SReal EulerImplicitSolver::getIntegrationFactor(int inputDerivative, int outputDerivative) const
 {
-    return getIntegrationFactor(inputDerivative, outputDerivative, getContext()->getDt());
+    return getIntegrationFactor(inputDerivative, outputDerivative, getIntegratedDt());
 }
 
 SReal EulerImplicitSolver::getIntegrationFactor(int inputDerivative, int outputDerivative, SReal dt) const
@@ -343,7 +527,7 @@ SReal EulerImplicitSolver::getIntegrationFactor(int inputDerivative, int outputD
 
 SReal EulerImplicitSolver::getSolutionIntegrationFactor(int outputDerivative) const
 {
-    return getSolutionIntegrationFactor(outputDerivative, getContext()->getDt());
+    return getSolutionIntegrationFactor(outputDerivative, getIntegratedDt());
 }
 
 SReal EulerImplicitSolver::getSolutionIntegrationFactor(int outputDerivative, SReal dt) const
@@ -26,6 +26,7 @@
 #include <sofa/core/behavior/OdeSolver.h>
 
 #include <sofa/core/objectmodel/RenamedData.h>
+#include <sofa/type/vector.h>
 
 namespace sofa::component::odesolver::backward
 {
@@ -95,6 +96,24 @@ namespace sofa::component::odesolver::backward
  *
  *   \f$ ( M + h/2 K ) v_{t+h} = f_{ext} \f$
  *
+ *** Adaptive time step ***
+ *
+ * If adaptiveTimeStep is true, the time step of the animation loop is integrated with one or several
+ * sub-steps. The local error of a sub-step of size h is estimated by the difference between the positions
+ * given by the backward Euler scheme and the trapezoidal rule:
+ *
+ *   \f$ e = \frac{h}{2} \| v_{t+h} - v_t \|_\infty \f$
+ *
+ * If e is larger than errorTolerance, the sub-step is rejected and computed again with a smaller size.
+ * The size of the next sub-step is \f$ h \cdot safetyFactor \sqrt{errorTolerance / e} \f$, limited by
+ * dtGrowthLimit and dtShrinkLimit, and it is kept from one time step to the next one. The time step of the
+ * scene is then the maximal size of the sub-steps, and the last sub-step is stretched by up to 10% to end
+ * the time step rather than leaving a tiny one. The estimate is only valid for the backward Euler scheme:
+ * adaptiveTimeStep is disabled with trapezoidalScheme. The time of the context is set to the beginning of each
+ * sub-step while it is computed, and restored at the end of the time step.
+ * With FreeMotionAnimationLoop, the sub-steps integrate the free motion, and the constraint correction
+ * is computed with the last sub-step.
+ *
  */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API EulerImplicitSolver :
     public sofa::core::behavior::OdeSolver,
@@ -129,11 +148,23 @@ public:
     Data<bool> d_solveConstraint; ///< Apply ConstraintSolver (requires a ConstraintSolver in the same node as this solver, disabled by by default for now)
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
 
+    Data<bool> d_adaptiveTimeStep; ///< If true, the time step is integrated with sub-steps of adaptive size, controlled by an estimate of the local error
+    Data<SReal> d_errorTolerance; ///< Adaptive time step: tolerance on the local error estimate of a sub-step (infinity norm, in position unit)
+    Data<SReal> d_minDt; ///< Adaptive time step: minimal size of a sub-step. A sub-step of this size is accepted even if its error is larger than the tolerance
+    Data<SReal> d_dtGrowthLimit; ///< Adaptive time step: maximal factor between the size of a sub-step and the next one
+    Data<SReal> d_dtShrinkLimit; ///< Adaptive time step: minimal factor between the size of a sub-step and the next one, or the retry of a rejected one
+    Data<SReal> d_safetyFactor; ///< Adaptive time step: factor applied on the optimal size of the next sub-step
+    Data<unsigned int> d_maxNbRejections; ///< Adaptive time step: maximal number of successive rejections of a sub-step, after which it is accepted
+    Data<type::vector<SReal> > d_dtHistory; ///< Adaptive time step: sizes of the sub-steps accepted during the last time step
+    Data<unsigned int> d_nbRejectedSteps; ///< Adaptive time step: total number of rejected sub-steps
+
 protected:
     EulerImplicitSolver();
 public:
     void init() override;
 
+    void reinit() override;
+
     void cleanup() override;
 
     void solve (const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult) override;
@@ -179,9 +210,26 @@ public:
 
 protected:
 
+    /// Integrates one step of size dt, from the state (xStart, vStart) to the state (xResult, vResult)
+    void integrate(const core::ExecParams* params, SReal dt,
+                   sofa::core::MultiVecCoordId xStart, sofa::core::MultiVecDerivId vStart,
+                   sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    /// Integrates the time step dt with sub-steps of adaptive size
+    void solveAdaptive(const core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult);
+
+    /// Size of the time step integrated by the last call to solve, used for the integration factors
+    SReal getIntegratedDt() const;
+
     /// the solution vector is stored for warm-start
     core::behavior::MultiVecDeriv x;
 
+    /// size of the next sub-step, with the adaptive time step
+    SReal m_subStepDt { 0 };
+
+    /// size of the last accepted sub-step, with the adaptive time step
+    SReal m_lastSubStepDt { 0 };
+
 };
 
 } // namespace sofa::component::odesolver::backward
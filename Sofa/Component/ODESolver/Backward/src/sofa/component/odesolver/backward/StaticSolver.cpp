@@ -28,9 +28,11 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/simulation/mechanicalvisitor/MechanicalPropagateOnlyPositionAndVelocityVisitor.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <chrono>
 #include <memory>
+#include <optional>
 
 using sofa::simulation::mechanicalvisitor::MechanicalPropagateOnlyPositionAndVelocityVisitor;
 
@@ -41,6 +43,69 @@ using sofa::core::VecId;
 using namespace sofa::defaulttype;
 using namespace sofa::core::behavior;
 
+namespace
+{
+
+/// Overrides the "tolerance" data of a supported iterative linear solver during a solve call, and restores its original
+/// value on destruction. The forcing term, a relative tolerance |r|/|b|, is converted to the criterion of the solver:
+/// - CGLinearSolver and MinResLinearSolver stop when |r|/|b| is below their tolerance
+/// - ShewchukPCGLinearSolver stops when |r|²/|b|² (in the norm of its preconditioner) is below its tolerance
+class ScopedLinearSolverTolerance
+{
+public:
+    explicit ScopedLinearSolverTolerance(sofa::core::objectmodel::Base* linearSolver)
+    {
+        const auto* linearSolverClass = linearSolver->getClass();
+        if (linearSolverClass->hasParent("ShewchukPCGLinearSolver"))
+        {
+            m_squaredRatio = true;
+        }
+        else if (!linearSolverClass->hasParent("CGLinearSolver") && !linearSolverClass->hasParent("MinResLinearSolver"))
+        {
+            return;
+        }
+
+        sofa::core::objectmodel::BaseData* tolerance = linearSolver->findData("tolerance");
+        m_doubleTolerance = dynamic_cast<Data<double>*>(tolerance);
+        m_floatTolerance = dynamic_cast<Data<float>*>(tolerance);
+        if (m_doubleTolerance)
+            m_originalValue = m_doubleTolerance->getValue();
+        else if (m_floatTolerance)
+            m_originalValue = m_floatTolerance->getValue();
+    }
+
+    ~ScopedLinearSolverTolerance()
+    {
+        set(m_originalValue);
+    }
+
+    bool isValid() const { return m_doubleTolerance || m_floatTolerance; }
+
+    /// Solves the linear system up to the relative tolerance |r| <= forcingTerm |b|, but never more accurately than
+    /// the original tolerance of the linear solver
+    void setForcingTerm(SReal forcingTerm)
+    {
+        const SReal tolerance = m_squaredRatio ? forcingTerm * forcingTerm : forcingTerm;
+        set(std::max(tolerance, m_originalValue));
+    }
+
+private:
+    void set(SReal value)
+    {
+        if (m_doubleTolerance)
+            m_doubleTolerance->setValue(static_cast<double>(value));
+        else if (m_floatTolerance)
+            m_floatTolerance->setValue(static_cast<float>(value));
+    }
+
+    Data<double>* m_doubleTolerance { nullptr };
+    Data<float>* m_floatTolerance { nullptr };
+    SReal m_originalValue { 0 };
+    bool m_squaredRatio { false };
+};
+
+}
+
 StaticSolver::StaticSolver()
     : d_newton_iterations(initData(&d_newton_iterations,
             (unsigned) 1,
@@ -68,6 +133,44 @@ StaticSolver::StaticSolver()
             false,
             "should_diverge_when_residual_is_growing",
             "Boolean stopping Netwon iterations when the residual is greater than the one from the previous iteration"))
+    , d_reuse_system_matrix( initData(&d_reuse_system_matrix,
+            false,
+            "reuse_system_matrix",
+            "If true, the system matrix (and its factorization or preconditioner) is reused across Newton iterations and "
+            "load increments, and only rebuilt when the convergence rate degrades. The topology must not change."))
+    , d_system_matrix_refresh_rate( initData(&d_system_matrix_refresh_rate,
+            0.5_sreal,
+            "system_matrix_refresh_rate",
+            "When the system matrix is reused, it is rebuilt as soon as the ratio |R_i+1|/|R_i| of two consecutive "
+            "residuals is greater than this rate"))
+    , d_max_system_matrix_reuse( initData(&d_max_system_matrix_reuse,
+            (unsigned) 10,
+            "max_system_matrix_reuse",
+            "When the system matrix is reused, maximal number of Newton iterations solved with the same matrix. "
+            "0 means no limit"))
+    , d_eisenstat_walker_forcing_term( initData(&d_eisenstat_walker_forcing_term,
+            false,
+            "eisenstat_walker_forcing_term",
+            "If true, the tolerance of the iterative linear solver is adapted at each Newton iteration following the "
+            "Eisenstat-Walker forcing terms. Supported linear solvers: CGLinearSolver, MinResLinearSolver and "
+            "ShewchukPCGLinearSolver. The linear systems are solved with the accuracy of any other linear solver"))
+    , d_max_forcing_term( initData(&d_max_forcing_term,
+            0.9_sreal,
+            "max_forcing_term",
+            "Upper bound of the Eisenstat-Walker forcing terms (relative tolerance |r|/|b| of the linear solve)"))
+    , d_line_search( initData(&d_line_search,
+            false,
+            "line_search",
+            "If true, the Newton increment is scaled by a backtracking line search ensuring a sufficient decrease of "
+            "the residual"))
+    , d_line_search_max_iterations( initData(&d_line_search_max_iterations,
+            (unsigned) 10,
+            "line_search_max_iterations",
+            "Maximal number of step length halvings of the line search"))
+    , d_line_search_sufficient_decrease( initData(&d_line_search_sufficient_decrease,
+            1e-4_sreal,
+            "line_search_sufficient_decrease",
+            "Sufficient decrease constant c of the line search: |R(x + a.dx)| <= (1 - c.a) |R(x)|"))
 {}
 
 void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::core::MultiVecCoordId xResult, sofa::core::MultiVecDerivId vResult)
@@ -119,6 +222,14 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     const auto & absolute_residual_tolerance_threshold = d_absolute_residual_tolerance_threshold.getValue();
     const auto & max_number_of_newton_iterations = d_newton_iterations.getValue();
     const auto & should_diverge_when_residual_is_growing = d_should_diverge_when_residual_is_growing.getValue();
+    const auto & reuse_system_matrix = d_reuse_system_matrix.getValue();
+    const auto & system_matrix_refresh_rate = d_system_matrix_refresh_rate.getValue();
+    const auto & max_system_matrix_reuse = d_max_system_matrix_reuse.getValue();
+    const auto & use_forcing_term = d_eisenstat_walker_forcing_term.getValue();
+    const auto max_forcing_term = std::clamp(d_max_forcing_term.getValue(), 0_sreal, 1_sreal);
+    const auto & line_search = d_line_search.getValue();
+    const auto & line_search_max_iterations = d_line_search_max_iterations.getValue();
+    const auto & line_search_sufficient_decrease = d_line_search_sufficient_decrease.getValue();
     const auto & print_log = f_printLog.getValue();
     auto info = MessageDispatcher::info(Message::Runtime, std::make_shared<ComponentInfo>(this->getClassName()), SOFA_FILE_INFO);
 
@@ -132,6 +243,39 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
     bool converged = false, diverged = false;
     steady_clock::time_point t;
 
+    // Inexact Newton: relative tolerance of the linear solve (Eisenstat-Walker forcing term, choice 2)
+    static constexpr SReal forcing_term_gamma = 0.9;
+    SReal forcing_term = max_forcing_term;
+    double R_previous_start_squared_norm = 0;
+    std::optional<ScopedLinearSolverTolerance> linear_solver_tolerance;
+    if (use_forcing_term)
+    {
+        linear_solver_tolerance.emplace(l_linearSolver.get());
+        if (!linear_solver_tolerance->isValid())
+        {
+            msg_warning_when(!p_unsupported_forcing_term_warned) << "The Eisenstat-Walker forcing terms require one of "
+                "the linear solvers CGLinearSolver, MinResLinearSolver or ShewchukPCGLinearSolver: "
+                << l_linearSolver->getClassName() << " will solve the linear systems with its own accuracy.";
+            p_unsupported_forcing_term_warned = true;
+            linear_solver_tolerance.reset();
+        }
+    }
+
+    // Updates the geometry after a modification of the position
+    const auto propagate_positions = [&]()
+    {
+        // Calls "solveConstraint" method of every ConstraintSolver objects found in the current context tree.
+        // todo(jnbrunet): Shouldn't this be done AFTER the position propagation of the mapped nodes?
+        mop.solveConstraint(x, sofa::core::ConstraintOrder::POS);
+
+        // Propagate positions to mapped mechanical objects, for example, identity mappings, barycentric mappings, ...
+        // This will call the methods apply and applyJ on every mechanical mappings.
+        MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(context);
+    };
+
+    // Reset the number of system matrix assemblies for this time step
+    p_number_of_system_matrix_assemblies = 0;
+
     // Reset the list of residual norms for this time step
     p_squared_residual_norms.clear();
     p_squared_residual_norms.reserve(max_number_of_newton_iterations);
@@ -203,7 +347,17 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
         SCOPED_TIMER_VARNAME(step_timer, "NewtonStep");
         t = steady_clock::now();
 
-        // Part I. Assemble the system matrix.
+        // Residual at the beginning of the iteration
+        const double R_start_squared_norm = R_squared_norm;
+
+        // Part I. Assemble the system matrix, unless the previous one is reused.
+        //    When it is reused, the linear solver keeps its factorization (or preconditioner), only the right-hand
+        //    side changes. It is refreshed when the convergence rate obtained with it is too slow.
+        const bool assemble_system_matrix = !reuse_system_matrix
+            || !p_system_matrix_is_assembled
+            || p_system_matrix_must_be_refreshed
+            || (max_system_matrix_reuse > 0 && p_number_of_system_matrix_reuses >= max_system_matrix_reuse);
+        if (assemble_system_matrix)
         {
             SCOPED_TIMER("MBKBuild");
             //    A. For LinearSolver using a GraphScatteredMatrix (ie, non-assembled matrices), nothing appends.
@@ -213,6 +367,42 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             //       FixedProjectiveConstraint. In this case, it will set to 0 every column (_, i) and row (i, _) of the assembled
             //       matrix for the ith degree of freedom.
             mop.setSystemMBKMatrix(0, 0, -1, l_linearSolver.get());
+
+            ++p_number_of_system_matrix_assemblies;
+            p_system_matrix_is_assembled = true;
+            p_system_matrix_must_be_refreshed = false;
+            p_number_of_system_matrix_reuses = 1;
+        }
+        else
+        {
+            ++p_number_of_system_matrix_reuses;
+        }
+
+        // Set the relative tolerance of the linear solve |r| <= eta |b|. The first linear system is solved up to the
+        // maximal forcing term, the following ones depend on the reduction of the residual norm.
+        if (linear_solver_tolerance)
+        {
+            if (n_it > 0 && R_previous_start_squared_norm > epsilon*epsilon)
+            {
+                SReal eta = forcing_term_gamma * static_cast<SReal>(R_start_squared_norm / R_previous_start_squared_norm);
+
+                // Safeguard against a too fast decrease of the forcing term
+                const auto safeguard = forcing_term_gamma * forcing_term * forcing_term;
+                if (safeguard > 0.1)
+                {
+                    eta = std::max(eta, safeguard);
+                }
+
+                // Avoid oversolving when the residual is already close to the absolute threshold
+                if (absolute_residual_tolerance_threshold > 0 && R_start_squared_norm > epsilon*epsilon)
+                {
+                    eta = std::max(eta, 0.5_sreal * absolute_residual_tolerance_threshold / static_cast<SReal>(std::sqrt(R_start_squared_norm)));
+                }
+
+                forcing_term = std::min(eta, max_forcing_term);
+            }
+
+            linear_solver_tolerance->setForcingTerm(forcing_term);
         }
 
         // Part II. Solve the unknown increment.
@@ -230,14 +420,47 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             SCOPED_TIMER("PropagateDx");
             // Updating the geometry
             x.peq(dx); // x := x + dx
+            propagate_positions();
+        }
 
-            // Calls "solveConstraint" method of every ConstraintSolver objects found in the current context tree.
-            // todo(jnbrunet): Shouldn't this be done AFTER the position propagation of the mapped nodes?
-            mop.solveConstraint(x, sofa::core::ConstraintOrder::POS);
+        // Part III bis. Backtracking line search: the step length is halved until the residual decreases enough.
+        SReal step_length = 1;
+        bool force_is_updated = false;
+        if (line_search)
+        {
+            SCOPED_TIMER("LineSearch");
+            const auto R_start_norm = std::sqrt(R_start_squared_norm);
+            unsigned n_ls = 0;
+            bool sufficient_decrease = false;
+            while (true)
+            {
+                mop.computeForce(force);
+                mop.projectResponse(force);
+                R_squared_norm = force.dot(force);
 
-            // Propagate positions to mapped mechanical objects, for example, identity mappings, barycentric mappings, ...
-            // This will call the methods apply and applyJ on every mechanical mappings.
-            MechanicalPropagateOnlyPositionAndVelocityVisitor(&mechanical_parameters).execute(context);
+                sufficient_decrease = std::sqrt(R_squared_norm) <= (1 - line_search_sufficient_decrease * step_length) * R_start_norm;
+                if (sufficient_decrease || n_ls == line_search_max_iterations)
+                {
+                    break;
+                }
+
+                x.peq(dx, -step_length / 2); // x := x - a/2 dx
+                step_length /= 2;
+                propagate_positions();
+                ++n_ls;
+            }
+            force_is_updated = true;
+
+            // The increment is not a descent direction anymore: the system matrix is probably outdated
+            if (!sufficient_decrease)
+            {
+                p_system_matrix_must_be_refreshed = true;
+            }
+
+            if (step_length < 1)
+            {
+                dx.teq(step_length);
+            }
         }
 
         // At this point, we completed one iteration, increment the counter.
@@ -254,7 +477,8 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
             break;
         }
 
-        // Part IV. Update the force vector.
+        // Part IV. Update the force vector (already done by the line search).
+        if (!force_is_updated)
         {
             SCOPED_TIMER("UpdateForce");
 
@@ -277,6 +501,12 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
 
             p_squared_residual_norms.emplace_back(R_squared_norm);
 
+            // Convergence rate obtained with the current system matrix
+            if (reuse_system_matrix && R_squared_norm > system_matrix_refresh_rate*system_matrix_refresh_rate*R_start_squared_norm)
+            {
+                p_system_matrix_must_be_refreshed = true;
+            }
+
             // Displacement norm
             U.peq(dx);
             dx_squared_norm = dx.dot(dx);
@@ -298,6 +528,18 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
                      << "  |du| = "       << std::setw(12) << std::sqrt(dx_squared_norm)
                      << "  |du| / |U| = " << std::setw(12) << (U_squared_norm < epsilon*epsilon  ? 0 : std::sqrt(dx_squared_norm / U_squared_norm))
                      << std::defaultfloat;
+                if (line_search)
+                {
+                    info << "  a = " << step_length;
+                }
+                if (linear_solver_tolerance)
+                {
+                    info << "  eta = " << forcing_term;
+                }
+                if (reuse_system_matrix)
+                {
+                    info << (assemble_system_matrix ? "  [new matrix]" : "  [reused matrix]");
+                }
                 info << "  Time = " << iteration_time / 1000 / 1000 << " ms";
                 info << "\n";
             }
@@ -381,6 +623,9 @@ void StaticSolver::solve(const sofa::core::ExecParams* params, SReal dt, sofa::c
 
         // This is used to detect a rise of residual (divergence test)
         R_previous_squared_norm = R_squared_norm;
+
+        // This is used by the forcing terms
+        R_previous_start_squared_norm = R_start_squared_norm;
     }
 
     n_it--; // Reset to the actual index of the last iteration completed
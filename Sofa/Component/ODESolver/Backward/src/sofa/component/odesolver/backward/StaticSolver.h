@@ -56,6 +56,21 @@ using sofa::core::objectmodel::Data;
  *     \mat{K}(\vec{x}_{n+1}^i) \left [ \Delta \vec{x}_{n+1}^{i+1} \right ] &= - \vec{F}(\vec{x}_{n+1}^i) \\
  *     \vec{x}_{n+1}^{i+1} &= \vec{x}_{n+1}^{i} + \Delta \vec{x}_{n+1}^{i+1}
  * \f}
+ *
+ * Three optional features turn these iterations into an inexact (Newton-Krylov) scheme:
+ *
+ * - <b>System matrix reuse</b> (reuse_system_matrix): the assembled matrix, and therefore the factorization of a direct
+ *   solver (SparseLDLSolver, AsyncSparseLDLSolver, ...) or the preconditioner of an iterative one, is kept across
+ *   Newton iterations and load increments. It is rebuilt only when the residual contraction
+ *   \f$|\vec{F}^{i+1}| / |\vec{F}^{i}|\f$ becomes greater than system_matrix_refresh_rate, when the line search fails,
+ *   or after max_system_matrix_reuse consecutive reuses.
+ * - <b>Eisenstat-Walker forcing terms</b> (eisenstat_walker_forcing_term): the linear system is only solved up to the
+ *   relative tolerance \f$\eta_i = \gamma (|\vec{F}^{i}| / |\vec{F}^{i-1}|)^2\f$ (with \f$\gamma = 0.9\f$ and the
+ *   usual safeguards, bounded by max_forcing_term). The tolerance is set on the "tolerance" data of the linear solver,
+ *   which must be CGLinearSolver, MinResLinearSolver or ShewchukPCGLinearSolver, and restored after the solve.
+ * - <b>Backtracking line search</b> (line_search): the step length \f$\alpha\f$ of
+ *   \f$\vec{x}^{i+1} = \vec{x}^{i} + \alpha \Delta \vec{x}^{i+1}\f$ is halved until the sufficient decrease
+ *   condition \f$|\vec{F}(\vec{x}^{i+1})| \leq (1 - c \alpha) |\vec{F}(\vec{x}^{i})|\f$ is met.
  */
 class SOFA_COMPONENT_ODESOLVER_BACKWARD_API StaticSolver
     : public sofa::core::behavior::OdeSolver
@@ -74,6 +89,9 @@ public:
     /** The list of squared correction increment norms (dx.dot(dx) = ||dx||^2) of every newton iterations of the last solve call. */
     auto squared_increment_norms() const -> const std::vector<SReal> & { return p_squared_increment_norms; }
 
+    /** The number of times the system matrix was assembled (and factorized) during the last solve call. */
+    auto number_of_system_matrix_assemblies() const -> unsigned { return p_number_of_system_matrix_assemblies; }
+
     /// Given a displacement as computed by the linear system inversion, how much will it affect the velocity
     ///
     /// This method is used to compute the compliance for contact corrections
@@ -155,6 +173,14 @@ protected:
     Data<SReal> d_absolute_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the norm of the residual |R| is smaller than this threshold. Use a negative value to disable this criterion.
     Data<SReal> d_relative_residual_tolerance_threshold; ///< Convergence criterion: The newton iterations will stop when the ratio |R|/|R0| is smaller than this threshold. Use a negative value to disable this criterion.
     Data<bool> d_should_diverge_when_residual_is_growing; ///< Divergence criterion: The newton iterations will stop when the residual is greater than the one from the previous iteration.
+    Data<bool> d_reuse_system_matrix; ///< If true, the system matrix (and its factorization or preconditioner) is reused across Newton iterations and load increments until the convergence rate degrades.
+    Data<SReal> d_system_matrix_refresh_rate; ///< When the system matrix is reused, it is rebuilt as soon as the ratio |R_i+1|/|R_i| of two consecutive residuals is greater than this rate.
+    Data<unsigned> d_max_system_matrix_reuse; ///< When the system matrix is reused, maximal number of consecutive Newton iterations solved with the same matrix. 0 means no limit.
+    Data<bool> d_eisenstat_walker_forcing_term; ///< If true, the tolerance of the iterative linear solver is adapted at each Newton iteration following Eisenstat-Walker forcing terms. Supported linear solvers: CGLinearSolver, MinResLinearSolver and ShewchukPCGLinearSolver.
+    Data<SReal> d_max_forcing_term; ///< Upper bound of the Eisenstat-Walker forcing terms (relative tolerance of the linear solve).
+    Data<bool> d_line_search; ///< If true, the Newton increment is scaled by a backtracking line search ensuring a sufficient decrease of the residual.
+    Data<unsigned> d_line_search_max_iterations; ///< Maximal number of step length halvings of the line search.
+    Data<SReal> d_line_search_sufficient_decrease; ///< Sufficient decrease constant c of the line search: |R(x + a.dx)| <= (1 - c.a) |R(x)|.
 
 private:
     /// Sum of displacement increments since the beginning of the time step
@@ -165,6 +191,21 @@ private:
 
     /// List of squared correction increment norms (dx.dot(dx) = ||dx||^2) of every newton iterations of the last solve call.
     std::vector<SReal> p_squared_increment_norms;
+
+    /// Number of system matrix assemblies of the last solve call.
+    unsigned p_number_of_system_matrix_assemblies {0};
+
+    /// True once a system matrix has been assembled and can be reused
+    bool p_system_matrix_is_assembled {false};
+
+    /// True once the linear solver has been reported as not supported by the Eisenstat-Walker forcing terms
+    bool p_unsupported_forcing_term_warned {false};
+
+    /// Set when the convergence rate obtained with the current system matrix is too slow
+    bool p_system_matrix_must_be_refreshed {true};
+
+    /// Number of consecutive Newton iterations solved with the current system matrix
+    unsigned p_number_of_system_matrix_reuses {0};
 };
 
 } // namespace sofa::component::odesolver::backward
@@ -23,6 +23,7 @@
 using sofa::testing::BaseSimulationTest;
 
 #include <sofa/component/odesolver/testing/ODESolverSpringTest.h>
+#include <sofa/component/odesolver/backward/EulerImplicitSolver.h>
 
 #include <sofa/simulation/Node.h>
 #include <sofa/simulation/Simulation.h>
@@ -72,6 +73,65 @@ struct EulerImplicitDynamic_test : public component::odesolver::testing::ODESolv
 
     }
 
+    /// Create the context for the scene, with the adaptive time step
+    void createAdaptiveScene(double K, double m, double l0, double errorTolerance)
+    {
+        this->prepareScene(K, m, l0);
+        simpleapi::createObject(m_si.root, "EulerImplicitSolver", {
+            { "adaptiveTimeStep", "true"},
+            { "errorTolerance", simpleapi::str(errorTolerance)}
+        });
+    }
+
+    /// Simulate with the adaptive time step, and check that the sub-steps accepted during each time step cover it.
+    /// The mass starts at rest at the rest length of the spring: its position is y(t) = 1 - mg/K (1 - cos(sqrt(K/m) t)).
+    void checkAdaptiveSubSteps(double h, double finalTime, double K, double m, double errorTolerance)
+    {
+        m_si.initScene();
+        const auto solver = m_si.root->get<odesolver::backward::EulerImplicitSolver>();
+        ASSERT_NE(solver, nullptr);
+
+        const simulation::Node::SPtr massNode = m_si.root->getChild("MassNode");
+        typename statecontainer::MechanicalObject<_DataTypes>::SPtr dofs = massNode->get<statecontainer::MechanicalObject<_DataTypes>>(m_si.root->SearchDown);
+
+        std::size_t nbSubSteps = 0;
+        std::size_t nbTimeSteps = 0;
+        while (m_si.root->getTime() < finalTime - h * 0.5)
+        {
+            const double startTime = m_si.root->getTime();
+            m_si.simulate(h);
+            ++nbTimeSteps;
+
+            // the history only contains the sub-steps of the last time step
+            const auto& dtHistory = solver->d_dtHistory.getValue();
+            double sum = 0;
+            for (const auto subStep : dtHistory)
+            {
+                EXPECT_GT(subStep, 0);
+                EXPECT_LE(subStep, h * (1 + 1e-12));
+                sum += subStep;
+            }
+            EXPECT_NEAR(sum, h, 1e-12);
+            nbSubSteps += dtHistory.size();
+
+            // the time moved by the sub-steps is restored before the animation loop advances it
+            EXPECT_NEAR(m_si.root->getTime(), startTime + h, 1e-12);
+            EXPECT_NEAR(massNode->getTime(), startTime + h, 1e-12);
+
+            // The global error is bounded by the sum of the local errors of the sub-steps, each one controlled by the
+            // tolerance. The estimate of the local error only measures the position error of the backward Euler step,
+            // the velocity error adds a contribution of the same order: the bound is doubled.
+            const double time = m_si.root->getTime();
+            const double expectedPosition = 1. - m * 10. / K * (1. - std::cos(std::sqrt(K / m) * time));
+            const Coord p0 = dofs->read(sofa::core::ConstVecCoordId::position())->getValue()[0];
+            EXPECT_LT(std::fabs(p0[1] - expectedPosition), 2. * errorTolerance * nbSubSteps) << "at time " << time;
+        }
+
+        // the motion is too fast for the tolerance with the time step of the scene
+        EXPECT_GT(nbSubSteps, nbTimeSteps);
+        EXPECT_GT(solver->d_nbRejectedSteps.getValue(), 0u);
+    }
+
     /// Generate discrete mass position values with euler implicit solver
     void generateDiscreteMassPositions (double h, double K, double m, double z0, double v0,double g, double finalTime, double rm, double rk)
     {
@@ -186,4 +246,32 @@ TYPED_TEST( EulerImplicitDynamic_test , eulerImplicitSolverDynamicTest_small_dt_
    this-> compareSimulatedToTheoreticalPositions(5e-16,0.001);
 }
 
+// Test case: h=0.1 k=100 m =10, with the adaptive time step and a tolerance never reached: a single sub-step per time step
+TYPED_TEST( EulerImplicitDynamic_test , eulerImplicitSolverDynamicTest_adaptive_time_step_large_tolerance)
+{
+   this->createAdaptiveScene(100,10,1,1e6); // k,m,l0,errorTolerance
+   this->generateDiscreteMassPositions (0.1, 100, 10, 1, 0, 10, 2, 0, 0);
+   this-> compareSimulatedToTheoreticalPositions(5e-16,0.1);
+}
+
+// Test case: h=0.1 k=100 m =10, with the adaptive time step and a small tolerance
+TYPED_TEST( EulerImplicitDynamic_test , eulerImplicitSolverDynamicTest_adaptive_time_step_small_tolerance)
+{
+   this->createAdaptiveScene(100,10,1,1e-4); // k,m,l0,errorTolerance
+   this->checkAdaptiveSubSteps(0.1, 1., 100, 10, 1e-4); // h,finalTime,k,m,errorTolerance
+}
+
+// Test case: the error estimate of the adaptive time step is not valid with the trapezoidal scheme
+TYPED_TEST( EulerImplicitDynamic_test , eulerImplicitSolverDynamicTest_adaptive_time_step_trapezoidal_scheme)
+{
+   this->createAdaptiveScene(100,10,1,1e-4); // k,m,l0,errorTolerance
+   const auto solver = this->m_si.root->template get<odesolver::backward::EulerImplicitSolver>();
+   ASSERT_NE(solver, nullptr);
+   solver->d_trapezoidalScheme.setValue(true);
+
+   EXPECT_MSG_EMIT(Warning);
+   this->m_si.initScene();
+   EXPECT_FALSE(solver->d_adaptiveTimeStep.getValue());
+}
+
 } // namespace sofa
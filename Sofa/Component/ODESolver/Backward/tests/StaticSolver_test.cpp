@@ -22,6 +22,8 @@
 #include <sofa/testing/BaseTest.h>
 #include <sofa/simulation/Node.h>
 #include <sofa/component/odesolver/backward/StaticSolver.h>
+#include <sofa/component/linearsolver/iterative/CGLinearSolver.h>
+#include <sofa/helper/logging/MessageHandler.h>
 #include <sofa/simulation/graph/DAGSimulation.h>
 #include <sofa/simpleapi/SimpleApi.h>
 
@@ -34,12 +36,46 @@ using namespace sofa::helper::logging;
 
 using sofa::simulation::graph::DAGSimulation;
 using sofa::component::odesolver::backward::StaticSolver;
+using sofa::component::linearsolver::GraphScatteredMatrix;
+using sofa::component::linearsolver::GraphScatteredVector;
+using sofa::component::linearsolver::iterative::CGLinearSolver;
 
 static constexpr SReal poissonRatio = 0;
 static constexpr SReal youngModulus = 3000;
 static constexpr SReal mu = youngModulus / (2.0 * (1.0 + poissonRatio));
 static constexpr SReal l = youngModulus * poissonRatio / ((1.0 + poissonRatio) * (1.0 - 2.0 * poissonRatio));
 
+/// Conjugate gradient counting its iterations, and recording the tolerance used by each solve
+class CountingCGLinearSolver : public CGLinearSolver<GraphScatteredMatrix, GraphScatteredVector>
+{
+public:
+    SOFA_CLASS(CountingCGLinearSolver, SOFA_TEMPLATE2(CGLinearSolver, GraphScatteredMatrix, GraphScatteredVector));
+
+    void solve(Matrix& A, Vector& x, Vector& b) override
+    {
+        tolerances.push_back(d_tolerance.getValue());
+        Inherit1::solve(A, x, b);
+        // the first value of the error graph is the initial error
+        number_of_iterations += d_graph.getValue().at("Error").size() - 1;
+    }
+
+    std::vector<SReal> tolerances;
+    std::size_t number_of_iterations {0};
+};
+
+/// Counts the warnings about the forcing terms
+class ForcingTermWarningCounter : public sofa::helper::logging::MessageHandler
+{
+public:
+    void process(Message& m) override
+    {
+        if (m.type() == Message::Warning && m.messageAsString().find("Eisenstat-Walker") != std::string::npos)
+            ++count;
+    }
+
+    int count {0};
+};
+
 /**
  * Create a bending rectangular beam simulation using the StaticSolver.
  *
@@ -99,6 +135,29 @@ public:
     }
 
 
+    /// Replaces the direct linear solver by a conjugate gradient, solving the linear systems up to a relative
+    /// tolerance |r|/|b| of 1e-10
+    auto use_conjugate_gradient() -> CountingCGLinearSolver::SPtr {
+        root->removeObject(root->get<sofa::core::behavior::LinearSolver>());
+        auto cg = sofa::core::objectmodel::New<CountingCGLinearSolver>();
+        cg->d_maxIter.setValue(1000);
+        cg->d_tolerance.setValue(1e-10);
+        cg->d_smallDenominatorThreshold.setValue(1e-30);
+        root->addObject(cg);
+        return cg;
+    }
+
+    /// Only keep the relative residual as convergence criterion
+    void use_relative_residual_criterion_only(unsigned newton_iterations = 20) {
+        using namespace sofa::core::objectmodel;
+        dynamic_cast< Data<unsigned> * > ( this->solver->findData("newton_iterations") )->setValue(newton_iterations);
+        dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_correction_tolerance_threshold") )->setValue(-1);
+        dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_correction_tolerance_threshold") )->setValue(-1);
+        dynamic_cast< Data<SReal> *   > ( this->solver->findData("absolute_residual_tolerance_threshold")   )->setValue(-1);
+        dynamic_cast< Data<SReal> *   > ( this->solver->findData("relative_residual_tolerance_threshold")   )->setValue(1e-5);
+        dynamic_cast< Data<bool> *     > ( this->solver->findData("should_diverge_when_residual_is_growing") )->setValue(false);
+    }
+
     NodeSPtr root;
     StaticSolver::SPtr solver;
 };
@@ -239,3 +298,89 @@ TEST_F(StaticSolverTest, AbsoluteIncrements) {
     << "The static ODE solver is supposed to converge after 8 Newton steps when using a relative correction threshold of 1e-5.\n"
     << actual_increment_norms;
 }
+
+TEST_F(StaticSolverTest, ReusedSystemMatrix) {
+    using namespace sofa::core::objectmodel;
+    // Disable all convergence criteria BUT the relative residual, and reuse the factorized system matrix
+    use_relative_residual_criterion_only(50);
+    dynamic_cast< Data<bool> *     > ( this->solver->findData("reuse_system_matrix") )->setValue(true);
+    dynamic_cast< Data<unsigned> * > ( this->solver->findData("max_system_matrix_reuse") )->setValue(0);
+
+    const sofa::type::vector<SReal> actual_force_residual_norms = this->execute().first;
+    ASSERT_FALSE(actual_force_residual_norms.empty());
+    EXPECT_LT(actual_force_residual_norms.back(), 1e-5 * actual_force_residual_norms.front())
+    << "The static ODE solver is supposed to converge when reusing the system matrix.\n"
+    << actual_force_residual_norms;
+    EXPECT_GE(this->solver->number_of_system_matrix_assemblies(), 1u);
+    EXPECT_LT(this->solver->number_of_system_matrix_assemblies(), actual_force_residual_norms.size())
+    << "The system matrix is supposed to be reused for some of the Newton iterations.";
+}
+
+TEST_F(StaticSolverTest, LineSearch) {
+    using namespace sofa::core::objectmodel;
+    // Disable all convergence criteria BUT the relative residual
+    use_relative_residual_criterion_only(10);
+    dynamic_cast< Data<bool> *     > ( this->solver->findData("line_search") )->setValue(true);
+
+    const sofa::type::vector<SReal> actual_force_residual_norms = this->execute().first;
+    ASSERT_FALSE(actual_force_residual_norms.empty());
+    EXPECT_LE(actual_force_residual_norms.size(), 7u)
+    << "The line search is not supposed to slow down the convergence of the Newton iterations.\n"
+    << actual_force_residual_norms;
+    for (std::size_t newton_it = 1; newton_it < actual_force_residual_norms.size(); ++newton_it) {
+        EXPECT_LT(actual_force_residual_norms[newton_it], actual_force_residual_norms[newton_it-1])
+        << "The line search is supposed to decrease the residual at each Newton iteration.\n"
+        << actual_force_residual_norms;
+    }
+}
+
+TEST_F(StaticSolverTest, EisenstatWalkerForcingTerms) {
+    using namespace sofa::core::objectmodel;
+
+    // Reference: every linear system is solved up to the tolerance of the conjugate gradient
+    use_relative_residual_criterion_only();
+    const auto exact_cg = use_conjugate_gradient();
+    const sofa::type::vector<SReal> exact_residual_norms = this->execute().first;
+    ASSERT_FALSE(exact_residual_norms.empty());
+    EXPECT_LT(exact_residual_norms.back(), 1e-5 * exact_residual_norms.front());
+
+    // Same simulation with the forcing terms
+    onTearDown();
+    onSetUp();
+    use_relative_residual_criterion_only();
+    dynamic_cast< Data<bool> * > ( this->solver->findData("eisenstat_walker_forcing_term") )->setValue(true);
+    const auto inexact_cg = use_conjugate_gradient();
+    const sofa::type::vector<SReal> inexact_residual_norms = this->execute().first;
+    ASSERT_FALSE(inexact_residual_norms.empty());
+    EXPECT_LT(inexact_residual_norms.back(), 1e-5 * inexact_residual_norms.front())
+    << "The Newton iterations are supposed to converge with the forcing terms.\n"
+    << inexact_residual_norms;
+
+    EXPECT_LT(inexact_cg->number_of_iterations, exact_cg->number_of_iterations)
+    << "The forcing terms are supposed to save conjugate gradient iterations.";
+
+    // The first linear system is solved up to the maximal forcing term, and the tolerance is restored after the solve
+    ASSERT_FALSE(inexact_cg->tolerances.empty());
+    EXPECT_DOUBLE_EQ(inexact_cg->tolerances.front(), 0.9);
+    for (const auto tolerance : inexact_cg->tolerances) {
+        EXPECT_GE(tolerance, 1e-10);
+    }
+    EXPECT_EQ(inexact_cg->d_tolerance.getValue(), 1e-10);
+}
+
+TEST_F(StaticSolverTest, ForcingTermsUnsupportedLinearSolverWarnsOnce) {
+    using namespace sofa::core::objectmodel;
+    using sofa::helper::logging::MessageDispatcher;
+
+    // SparseLDLSolver is a direct solver: the forcing terms are ignored, with a single warning
+    dynamic_cast< Data<bool> * > ( this->solver->findData("eisenstat_walker_forcing_term") )->setValue(true);
+
+    ForcingTermWarningCounter counter;
+    MessageDispatcher::addHandler(&counter);
+    this->execute();
+    sofa::simulation::node::animate(root.get(), 1_sreal);
+    sofa::simulation::node::animate(root.get(), 1_sreal);
+    MessageDispatcher::rmHandler(&counter);
+
+    EXPECT_EQ(counter.count, 1);
+}
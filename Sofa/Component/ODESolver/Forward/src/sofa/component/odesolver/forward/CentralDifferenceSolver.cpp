@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/odesolver/forward/CentralDifferenceSolver.h>
+#include <sofa/component/odesolver/forward/FusedExplicitStep.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
@@ -35,6 +36,8 @@ using namespace core::behavior;
 CentralDifferenceSolver::CentralDifferenceSolver()
     : d_rayleighMass(initData(&d_rayleighMass, (SReal)0.0, "rayleighMass", "Rayleigh damping coefficient related to mass"))
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_fusedStep(initData(&d_fusedStep, false, "fusedStep", "If true and all the masses are diagonal, the acceleration, velocity and position of each mechanical state are computed in a single pass, instead of one traversal of the scene graph per operation."))
+    , d_parallelFusedStep(initData(&d_parallelFusedStep, false, "parallelFusedStep", "If true, the mechanical states are processed in parallel during the fused step."))
 {
     f_rayleighMass.setOriginalData(&d_rayleighMass);
 }
@@ -86,8 +89,6 @@ void CentralDifferenceSolver::solve(const core::ExecParams* params, SReal dt, so
     MultiVecDeriv dx(&vop, core::VecDerivId::dx()); dx.realloc(&vop, !d_threadSafeVisitor.getValue(), true);
     MultiVecDeriv f  (&vop, core::VecDerivId::force() );
 
-    const SReal r = d_rayleighMass.getValue();
-
     mop.addSeparateGravity(dt);                // v += dt*g . Used if mass wants to added G separately from the other forces to v.
 
     //projectVelocity(vel);                  // initial velocities are projected to the constrained space
@@ -95,66 +96,74 @@ void CentralDifferenceSolver::solve(const core::ExecParams* params, SReal dt, so
     // compute the current force
     mop.computeForce(f);                       // f = P_n - K u_n
 
+    if (d_fusedStep.getValue())
+    {
+        // dx = M^{-1} ( P_n - K u_n ), projected, and new state, in a single pass over each mechanical state
+        const VMultiOp ops = createUpdateOperations(pos2.id(), vel2.id(), pos.id(), vel.id(), dx.id(), dt);
+        if (FusedExplicitStep::apply(&mop.mparams, getContext(), dx.id(), ops, d_parallelFusedStep.getValue()))
+        {
+            mop.solveConstraint(vel2,core::ConstraintOrder::VEL);
+            mop.solveConstraint(pos2,core::ConstraintOrder::POS);
+            return;
+        }
+    }
+
     mop.accFromF(dx, f);                       // dx = M^{-1} ( P_n - K u_n )
     mop.projectResponse(dx);                    // dx is projected to the constrained space
 
     mop.solveConstraint(dx, core::ConstraintOrder::ACC);
     // apply the solution
+#ifdef SOFA_NO_VMULTIOP // unoptimized version
+    const SReal r = d_rayleighMass.getValue();
     if (r==0)
     {
-#ifdef SOFA_NO_VMULTIOP // unoptimized version
         vel2.eq( vel, dx, dt );                  // vel = vel + dt M^{-1} ( P_n - K u_n )
         mop.solveConstraint(vel2,core::ConstraintOrder::VEL);
         pos2.eq( pos, vel2, dt );                    // pos = pos + h vel
         mop.solveConstraint(pos2,core::ConstraintOrder::POS);
-
-#else // single-operation optimization
-
-        typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
-        VMultiOp ops;
-        ops.resize(2);
-        // vel += dx * dt
-        ops[0].first = vel2;
-        ops[0].second.push_back(std::make_pair(vel.id(),1.0));
-        ops[0].second.push_back(std::make_pair(dx.id(),dt));
-        // pos += vel * dt
-        ops[1].first = pos2;
-        ops[1].second.push_back(std::make_pair(pos.id(),1.0));
-        ops[1].second.push_back(std::make_pair(vel2.id(),dt));
-
-        vop.v_multiop(ops);
-
-        mop.solveConstraint(vel2,core::ConstraintOrder::VEL);
-        mop.solveConstraint(pos2,core::ConstraintOrder::POS);
-#endif
     }
     else
     {
-#ifdef SOFA_NO_VMULTIOP // unoptimized version
         vel2.eq( vel, (1/dt - r/2)/(1/dt + r/2) );
         vel2.peq( dx, 1/(1/dt + r/2) );     // vel = \frac{\frac{1}{dt} - \frac{r}{2}}{\frac{1}{dt} + \frac{r}{2}} vel + \frac{1}{\frac{1}{dt} + \frac{r}{2}} M^{-1} ( P_n - K u_n )
         pos2.eq( pos, vel2, dt );                    // pos = pos + h vel
+    }
 #else // single-operation optimization
-        typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
-        VMultiOp ops;
-        ops.resize(2);
-        // vel += dx * dt
-        ops[0].first = vel2;
-        ops[0].second.push_back(std::make_pair(vel.id(),1.0));
-        ops[0].second.push_back(std::make_pair(vel.id(),-1.0 + (1/dt - r/2)/(1/dt + r/2)));
-        ops[0].second.push_back(std::make_pair(dx.id(),1/(1/dt + r/2)));
-        // pos += vel * dt
-        ops[1].first = pos2;
-        ops[1].second.push_back(std::make_pair(pos.id(),1.0));
-        ops[1].second.push_back(std::make_pair(vel2.id(),dt));
-
-        vop.v_multiop(ops);
+    vop.v_multiop(createUpdateOperations(pos2.id(), vel2.id(), pos.id(), vel.id(), dx.id(), dt));
 
-        mop.solveConstraint(vel2,core::ConstraintOrder::VEL);
-        mop.solveConstraint(pos2,core::ConstraintOrder::POS);
+    mop.solveConstraint(vel2,core::ConstraintOrder::VEL);
+    mop.solveConstraint(pos2,core::ConstraintOrder::POS);
 #endif
-    }
+}
+
+auto CentralDifferenceSolver::createUpdateOperations(core::MultiVecCoordId pos2, core::MultiVecDerivId vel2,
+                                                     core::ConstMultiVecCoordId pos, core::ConstMultiVecDerivId vel,
+                                                     core::ConstMultiVecDerivId dx, SReal dt) const -> VMultiOp
+{
+    const SReal r = d_rayleighMass.getValue();
 
+    VMultiOp ops;
+    ops.resize(2);
+    if (r==0)
+    {
+        // vel += dx * dt
+        ops[0].first = vel2;
+        ops[0].second.push_back(std::make_pair(vel,1.0));
+        ops[0].second.push_back(std::make_pair(dx,dt));
+    }
+    else
+    {
+        // vel = \frac{\frac{1}{dt} - \frac{r}{2}}{\frac{1}{dt} + \frac{r}{2}} vel + \frac{1}{\frac{1}{dt} + \frac{r}{2}} dx
+        ops[0].first = vel2;
+        ops[0].second.push_back(std::make_pair(vel,1.0));
+        ops[0].second.push_back(std::make_pair(vel,-1.0 + (1/dt - r/2)/(1/dt + r/2)));
+        ops[0].second.push_back(std::make_pair(dx,1/(1/dt + r/2)));
+    }
+    // pos += vel * dt
+    ops[1].first = pos2;
+    ops[1].second.push_back(std::make_pair(pos,1.0));
+    ops[1].second.push_back(std::make_pair(core::ConstMultiVecDerivId(vel2),dt));
+    return ops;
 }
 
 void registerCentralDifferenceSolver(sofa::core::ObjectFactory* factory)
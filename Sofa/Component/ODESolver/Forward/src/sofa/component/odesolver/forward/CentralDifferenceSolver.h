@@ -23,6 +23,7 @@
 #include <sofa/component/odesolver/forward/config.h>
 
 #include <sofa/core/behavior/OdeSolver.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
@@ -48,6 +49,8 @@ public:
 
     Data<SReal> d_rayleighMass; ///< Rayleigh damping coefficient related to mass
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
+    Data<bool> d_fusedStep; ///< If true and all the masses are diagonal, the acceleration, velocity and position of each mechanical state are computed in a single pass, instead of one traversal of the scene graph per operation.
+    Data<bool> d_parallelFusedStep; ///< If true, the mechanical states are processed in parallel during the fused step.
 
     /// Given an input derivative order (0 for position, 1 for velocity, 2 for acceleration),
     /// how much will it affect the output derivative of the given order.
@@ -78,6 +81,15 @@ public:
         else
             return vect[outputDerivative];
     }
+
+protected:
+
+    using VMultiOp = core::behavior::BaseMechanicalState::VMultiOp;
+
+    /// Linear operations computing the new velocity (with the Rayleigh mass damping) and the new position
+    VMultiOp createUpdateOperations(core::MultiVecCoordId pos2, core::MultiVecDerivId vel2,
+                                    core::ConstMultiVecCoordId pos, core::ConstMultiVecDerivId vel,
+                                    core::ConstMultiVecDerivId dx, SReal dt) const;
 };
 
 } // namespace sofa::component::odesolver::forward
@@ -20,6 +20,7 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <sofa/component/odesolver/forward/EulerSolver.h>
+#include <sofa/component/odesolver/forward/FusedExplicitStep.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/simulation/MechanicalOperations.h>
 #include <sofa/simulation/VectorOperations.h>
@@ -49,6 +50,8 @@ void registerEulerExplicitSolver(sofa::core::ObjectFactory* factory)
 EulerExplicitSolver::EulerExplicitSolver()
     : d_symplectic( initData( &d_symplectic, true, "symplectic", "If true (default), the velocities are updated before the positions and the method is symplectic, more robust. If false, the positions are updated before the velocities (standard Euler, less robust).") )
     , d_threadSafeVisitor(initData(&d_threadSafeVisitor, false, "threadSafeVisitor", "If true, do not use realloc and free visitors in fwdInteractionForceField."))
+    , d_fusedStep(initData(&d_fusedStep, false, "fusedStep", "If true and all the masses are diagonal, the acceleration, velocity and position of each mechanical state are computed in a single pass, instead of one traversal of the scene graph per operation."))
+    , d_parallelFusedStep(initData(&d_parallelFusedStep, false, "parallelFusedStep", "If true, the mechanical states are processed in parallel during the fused step."))
     , l_linearSolver(initLink("linearSolver", "Linear solver used by this component"))
 {
 }
@@ -90,6 +93,12 @@ void EulerExplicitSolver::solve(const core::ExecParams* params,
     // Mass matrix is diagonal, solution can thus be found by computing acc = f/m
     if(nbNonDiagonalMasses == 0.)
     {
+        // acc = M^-1 * f, projected, and new state, in a single pass over each mechanical state
+        if (d_fusedStep.getValue() && fusedStep(&mop, xResult, vResult, acc, dt))
+        {
+            return;
+        }
+
         // acc = M^-1 * f
         computeAcceleration(&mop, acc, f);
         projectResponse(&mop, acc);
@@ -168,46 +177,7 @@ void EulerExplicitSolver::updateState(sofa::simulation::common::VectorOperations
     }
 #else // single-operation optimization
     {
-        typedef core::behavior::BaseMechanicalState::VMultiOp VMultiOp;
-
-        // Create a set of linear operations that will be executed on two vectors
-        // In our case, the operations will be executed to compute the new velocity vector,
-        // and the new position vector. The order of execution is defined by
-        // the symplectic property of the solver.
-        VMultiOp ops(2);
-
-        // Change order of operations depending on the symplectic flag
-        const VMultiOp::size_type posId = d_symplectic.getValue(); // 1 if symplectic, 0 otherwise
-        const VMultiOp::size_type velId = 1 - posId; // 0 if symplectic, 1 otherwise
-
-        // Access the set of operations corresponding to the velocity vector
-        // In case of symplectic solver, these operations are executed first.
-        auto& ops_vel = ops[velId];
-
-        // Associate the new velocity vector as the result to this set of operations
-        ops_vel.first = newVel;
-
-        // The two following operations are actually a unique operation: newVel = vel + dt * acc
-        // The value 1.0 indicates that the first operation is based on the values
-        // in the second pair and, therefore, the second operation is discarded.
-        ops_vel.second.emplace_back(vel.id(), 1.0);
-        ops_vel.second.emplace_back(acc.id(), dt);
-
-        // Access the set of operations corresponding to the position vector
-        // In case of symplectic solver, these operations are executed second.
-        auto& ops_pos = ops[posId];
-
-        // Associate the new position vector as the result to this set of operations
-        ops_pos.first = newPos;
-
-        // The two following operations are actually a unique operation: newPos = pos + dt * v
-        // where v is "newVel" in case of a symplectic solver, and "vel" otherwise.
-        // If symplectic: newPos = pos + dt * newVel, executed after newVel has been computed
-        // If not symplectic: newPos = pos + dt * vel
-        // The value 1.0 indicates that the first operation is based on the values
-        // in the second pair and, therefore, the second operation is discarded.
-        ops_pos.second.emplace_back(pos.id(), 1.0);
-        ops_pos.second.emplace_back(d_symplectic.getValue() ? newVel.id() : vel.id(), dt);
+        const VMultiOp ops = createUpdateOperations(newPos.id(), newVel.id(), pos.id(), vel.id(), acc.id(), dt);
 
         // Execute the defined operations to compute the new velocity vector and
         // the new position vector.
@@ -225,6 +195,74 @@ void EulerExplicitSolver::updateState(sofa::simulation::common::VectorOperations
 #endif
 }
 
+bool EulerExplicitSolver::fusedStep(sofa::simulation::common::MechanicalOperations* mop,
+                                    sofa::core::MultiVecCoordId xResult,
+                                    sofa::core::MultiVecDerivId vResult,
+                                    const sofa::core::behavior::MultiVecDeriv& acc,
+                                    SReal dt)
+{
+    const VMultiOp ops = createUpdateOperations(xResult, vResult,
+        core::VecCoordId::position(), core::VecDerivId::velocity(), acc.id(), dt);
+
+    if (!FusedExplicitStep::apply(&mop->mparams, getContext(), acc.id(), ops, d_parallelFusedStep.getValue()))
+    {
+        return false;
+    }
+
+    mop->solveConstraint(vResult, core::ConstraintOrder::VEL);
+    mop->solveConstraint(xResult, core::ConstraintOrder::POS);
+    return true;
+}
+
+auto EulerExplicitSolver::createUpdateOperations(core::MultiVecCoordId newPos,
+                                                 core::MultiVecDerivId newVel,
+                                                 core::ConstMultiVecCoordId pos,
+                                                 core::ConstMultiVecDerivId vel,
+                                                 core::ConstMultiVecDerivId acc,
+                                                 SReal dt) const -> VMultiOp
+{
+    // Create a set of linear operations that will be executed on two vectors
+    // In our case, the operations will be executed to compute the new velocity vector,
+    // and the new position vector. The order of execution is defined by
+    // the symplectic property of the solver.
+    VMultiOp ops(2);
+
+    // Change order of operations depending on the symplectic flag
+    const VMultiOp::size_type posId = d_symplectic.getValue(); // 1 if symplectic, 0 otherwise
+    const VMultiOp::size_type velId = 1 - posId; // 0 if symplectic, 1 otherwise
+
+    // Access the set of operations corresponding to the velocity vector
+    // In case of symplectic solver, these operations are executed first.
+    auto& ops_vel = ops[velId];
+
+    // Associate the new velocity vector as the result to this set of operations
+    ops_vel.first = newVel;
+
+    // The two following operations are actually a unique operation: newVel = vel + dt * acc
+    // The value 1.0 indicates that the first operation is based on the values
+    // in the second pair and, therefore, the second operation is discarded.
+    ops_vel.second.emplace_back(vel, 1.0);
+    ops_vel.second.emplace_back(acc, dt);
+
+    // Access the set of operations corresponding to the position vector
+    // In case of symplectic solver, these operations are executed second.
+    auto& ops_pos = ops[posId];
+
+    // Associate the new position vector as the result to this set of operations
+    ops_pos.first = newPos;
+
+    // The two following operations are actually a unique operation: newPos = pos + dt * v
+    // where v is "newVel" in case of a symplectic solver, and "vel" otherwise.
+    // If symplectic: newPos = pos + dt * newVel, executed after newVel has been computed
+    // If not symplectic: newPos = pos + dt * vel
+    // The value 1.0 indicates that the first operation is based on the values
+    // in the second pair and, therefore, the second operation is discarded.
+    ops_pos.second.emplace_back(pos, 1.0);
+    ops_pos.second.emplace_back(d_symplectic.getValue() ? core::ConstMultiVecDerivId(newVel) : vel, dt);
+
+    return ops;
+}
+
 SReal EulerExplicitSolver::getIntegrationFactor(int inputDerivative, int outputDerivative) const
 {
     if (inputDerivative >= 3 || outputDerivative >= 3)
@@ -77,6 +77,8 @@ public:
 
     Data<bool> d_symplectic; ///< If true (default), the velocities are updated before the positions and the method is symplectic, more robust. If false, the positions are updated before the velocities (standard Euler, less robust).
     Data<bool> d_threadSafeVisitor; ///< If true, do not use realloc and free visitors in fwdInteractionForceField.
+    Data<bool> d_fusedStep; ///< If true and all the masses are diagonal, the acceleration, velocity and position of each mechanical state are computed in a single pass, instead of one traversal of the scene graph per operation.
+    Data<bool> d_parallelFusedStep; ///< If true, the mechanical states are processed in parallel during the fused step.
 
     SingleLink<EulerExplicitSolver, core::behavior::LinearSolver, BaseLink::FLAG_STRONGLINK> l_linearSolver;
 
@@ -93,6 +95,25 @@ public:
 
 protected:
 
+    using VMultiOp = core::behavior::BaseMechanicalState::VMultiOp;
+
+    /// Linear operations computing the new velocity and the new position from the acceleration,
+    /// in the order defined by the symplectic flag
+    VMultiOp createUpdateOperations(core::MultiVecCoordId newPos,
+                                    core::MultiVecDerivId newVel,
+                                    core::ConstMultiVecCoordId pos,
+                                    core::ConstMultiVecDerivId vel,
+                                    core::ConstMultiVecDerivId acc,
+                                    SReal dt) const;
+
+    /// Computes the acceleration (diagonal masses only) and updates the state with a FusedExplicitStep.
+    /// Returns false if the step cannot be fused, in which case nothing is computed.
+    bool fusedStep(sofa::simulation::common::MechanicalOperations* mop,
+                   sofa::core::MultiVecCoordId xResult,
+                   sofa::core::MultiVecDerivId vResult,
+                   const sofa::core::behavior::MultiVecDeriv& acc,
+                   SReal dt);
+
     /// Update state variable (new position and velocity) based on the computed acceleration
     /// The update takes constraints into account
     void updateState(sofa::simulation::common::VectorOperations* vop,
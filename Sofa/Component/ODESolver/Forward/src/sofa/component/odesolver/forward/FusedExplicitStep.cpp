@@ -0,0 +1,189 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/odesolver/forward/FusedExplicitStep.h>
+
+#include <sofa/core/behavior/BaseMass.h>
+#include <sofa/core/behavior/BaseProjectiveConstraintSet.h>
+#include <sofa/core/behavior/ConstraintSolver.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/helper/ScopedAdvancedTimer.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/MechanicalVisitor.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <algorithm>
+
+namespace sofa::component::odesolver::forward
+{
+
+namespace
+{
+
+/// A mechanical state which is not mapped, with the components acting on its acceleration
+struct IndependentState
+{
+    core::behavior::BaseMechanicalState* state { nullptr };
+    type::vector<core::behavior::BaseMass*> masses;
+    type::vector<core::behavior::BaseProjectiveConstraintSet*> projectiveConstraints;
+};
+
+/// Gather the independent mechanical states, and the masses and projective constraints associated to them
+class GatherIndependentStatesVisitor : public simulation::MechanicalVisitor
+{
+public:
+    explicit GatherIndependentStatesVisitor(const core::MechanicalParams* mparams)
+        : MechanicalVisitor(mparams)
+    {}
+
+    type::vector<IndependentState> m_states;
+    type::vector<core::behavior::BaseMass*> m_masses;
+    type::vector<core::behavior::BaseProjectiveConstraintSet*> m_projectiveConstraints;
+
+    Result fwdMechanicalState(simulation::Node* /*node*/, core::behavior::BaseMechanicalState* mm) override
+    {
+        m_states.emplace_back().state = mm;
+        return RESULT_CONTINUE;
+    }
+
+    Result fwdMass(simulation::Node* /*node*/, core::behavior::BaseMass* mass) override
+    {
+        m_masses.push_back(mass);
+        return RESULT_CONTINUE;
+    }
+
+    Result fwdProjectiveConstraintSet(simulation::Node* /*node*/, core::behavior::BaseProjectiveConstraintSet* c) override
+    {
+        m_projectiveConstraints.push_back(c);
+        return RESULT_CONTINUE;
+    }
+
+    const char* getClassName() const override { return "GatherIndependentStatesVisitor"; }
+
+    /// Associate the gathered masses and projective constraints to the independent states.
+    /// Returns false if a component cannot be associated to a single state, or if a projective
+    /// constraint acts on a mapped state: the fused step only projects the independent states.
+    bool associateComponentsToStates()
+    {
+        const auto findState = [this](core::behavior::StateAccessor* component) -> IndependentState*
+        {
+            const auto& states = component->getMechanicalStates();
+            if (states.size() != 1)
+            {
+                return nullptr;
+            }
+            const auto it = std::find_if(m_states.begin(), m_states.end(),
+                [state = states[0]](const IndependentState& s) { return s.state == state; });
+            return it != m_states.end() ? &*it : nullptr;
+        };
+
+        for (auto* mass : m_masses)
+        {
+            if (mass->getMechanicalStates().size() != 1)
+            {
+                return false;
+            }
+            // masses of mapped states do not contribute to the acceleration of the independent states
+            if (IndependentState* s = findState(mass))
+            {
+                s->masses.push_back(mass);
+            }
+        }
+
+        for (auto* c : m_projectiveConstraints)
+        {
+            if (c->getMechanicalStates().size() != 1)
+            {
+                return false;
+            }
+            IndependentState* s = findState(c);
+            if (s == nullptr)
+            {
+                return false;
+            }
+            s->projectiveConstraints.push_back(c);
+        }
+        return true;
+    }
+};
+
+}
+
+bool FusedExplicitStep::apply(const core::MechanicalParams* mparams,
+                              core::objectmodel::BaseContext* context,
+                              core::MultiVecDerivId acc,
+                              const VMultiOp& ops,
+                              bool parallel)
+{
+    SCOPED_TIMER("FusedExplicitStep");
+
+    // the constraint solvers act on the whole acceleration vector, between the projection and the update of the state
+    type::vector<core::behavior::ConstraintSolver*> constraintSolvers;
+    context->get<core::behavior::ConstraintSolver>(&constraintSolvers, context->getTags(), core::objectmodel::BaseContext::Local);
+    if (!constraintSolvers.empty())
+    {
+        return false;
+    }
+
+    GatherIndependentStatesVisitor gather(mparams);
+    gather.setTags(context->getTags());
+    gather.execute(context);
+    if (!gather.associateComponentsToStates())
+    {
+        return false;
+    }
+
+    const auto step = [mparams, acc, &ops](const IndependentState& s)
+    {
+        // acc = M^-1 * f
+        for (auto* mass : s.masses)
+        {
+            mass->accFromF(mparams, acc);
+        }
+
+        for (auto* c : s.projectiveConstraints)
+        {
+            c->projectResponse(mparams, acc);
+        }
+
+        s.state->vMultiOp(mparams, ops);
+    };
+
+    if (parallel && gather.m_states.size() > 1)
+    {
+        auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+
+        simulation::parallelForEach(*taskScheduler, gather.m_states.begin(), gather.m_states.end(), step);
+    }
+    else
+    {
+        std::for_each(gather.m_states.begin(), gather.m_states.end(), step);
+    }
+
+    return true;
+}
+
+} // namespace sofa::component::odesolver::forward
@@ -0,0 +1,68 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <sofa/component/odesolver/forward/config.h>
+
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/MultiVecId.h>
+
+namespace sofa::core
+{
+class MechanicalParams;
+}
+
+namespace sofa::core::objectmodel
+{
+class BaseContext;
+}
+
+namespace sofa::component::odesolver::forward
+{
+
+/**
+ * Fused explicit integration step, for scenes where all the masses are diagonal.
+ *
+ * The default explicit step traverses the scene graph once per operation: the acceleration
+ * is computed from the force (accFromF), then projected (projectResponse), and finally the
+ * velocity and the position are updated (vMultiOp). Here, the scene graph is traversed once to
+ * gather the independent mechanical states, with their mass and their projective constraints,
+ * and the three operations are applied state by state, while the vectors of the state are still
+ * in cache. The states are independent, so they can be processed in parallel.
+ */
+class SOFA_COMPONENT_ODESOLVER_FORWARD_API FusedExplicitStep
+{
+public:
+    using VMultiOp = core::behavior::BaseMechanicalState::VMultiOp;
+
+    /// For each independent mechanical state in the context:
+    /// acc = M^-1 * f, acc is projected by the projective constraints of the state, and ops are applied on the state.
+    /// Returns false, without computing anything, if the step cannot be fused in this context: constraint
+    /// solvers working on the acceleration, or projective constraints acting on several states or on a
+    /// mapped state. In this case, the regular sequence of visitors must be used.
+    static bool apply(const core::MechanicalParams* mparams,
+                      core::objectmodel::BaseContext* context,
+                      core::MultiVecDerivId acc,
+                      const VMultiOp& ops,
+                      bool parallel);
+};
+
+} // namespace sofa::component::odesolver::forward
@@ -61,12 +61,14 @@ struct CentralDifferenceExplicitSolverDynamic_test : public component::odesolver
     vector<double> accelerationsArray;
     
     /// Create the context for the scene
-    void createScene(double K, double m, double l0,double rm)
+    void createScene(double K, double m, double l0,double rm, bool fusedStep = false, bool parallelFusedStep = false)
     {
         this->prepareScene(K, m, l0);
         // add ODE Solver to test
         simpleapi::createObject(m_si.root, "CentralDifferenceSolver", {
-            { "rayleighMass", simpleapi::str(rm)}
+            { "rayleighMass", simpleapi::str(rm)},
+            { "fusedStep", simpleapi::str(fusedStep)},
+            { "parallelFusedStep", simpleapi::str(parallelFusedStep)}
             });
     }
 
@@ -210,4 +212,20 @@ TYPED_TEST( CentralDifferenceExplicitSolverDynamic_test , rungeKutta2ExplicitSol
    this-> compareSimulatedToTheoreticalPositions(2e-16,0.001);
 }
 
+// Test case: h=0.1 K=1000 m = 10, with the fused step
+TYPED_TEST( CentralDifferenceExplicitSolverDynamic_test , centralDifferenceExplicitSolverDynamicTest_high_dt_with_damping_fusedStep)
+{
+   this->createScene(1000,10,1,0.1,true,false); // k,m,l0,rm,fusedStep,parallelFusedStep
+   this->generateDiscreteMassPositions (0.1, 1000, 10, 1, 0, 10, 2, 0.1);
+   this-> compareSimulatedToTheoreticalPositions(5e-16,0.1);
+}
+
+// Test case: h=0.1 K=1000 m = 10, with the parallel fused step
+TYPED_TEST( CentralDifferenceExplicitSolverDynamic_test , centralDifferenceExplicitSolverDynamicTest_high_dt_with_damping_parallelFusedStep)
+{
+   this->createScene(1000,10,1,0.1,true,true); // k,m,l0,rm,fusedStep,parallelFusedStep
+   this->generateDiscreteMassPositions (0.1, 1000, 10, 1, 0, 10, 2, 0.1);
+   this-> compareSimulatedToTheoreticalPositions(5e-16,0.1);
+}
+
 } // namespace sofa
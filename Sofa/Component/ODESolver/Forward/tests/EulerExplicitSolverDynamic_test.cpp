@@ -65,12 +65,13 @@ struct EulerExplicitDynamic_test : public component::odesolver::testing::ODESolv
 
     
     /// Create the context for the scene
-    void createScene(double K, double m, double l0)
+    void createScene(double K, double m, double l0, bool fusedStep = false, bool parallelFusedStep = false)
     { 
         this->prepareScene(K, m, l0);
         // add ODE Solver to test
         simpleapi::createObject(m_si.root, "EulerExplicitSolver", {
-            { }
+            { "fusedStep", simpleapi::str(fusedStep)},
+            { "parallelFusedStep", simpleapi::str(parallelFusedStep)}
         });
     }
 
@@ -178,4 +179,20 @@ TYPED_TEST( EulerExplicitDynamic_test , eulerExplicitSolverDynamicTest_high_dt)
    this-> compareSimulatedToTheoreticalPositions(5e-16,0.1);
 }
 
+// Test case: h=0.01 k=1000 m=10, with the fused step
+TYPED_TEST( EulerExplicitDynamic_test , eulerExplicitSolverDynamicTest_medium_dt_fusedStep)
+{
+   this->createScene(1000,10,1,true,false); // k,m,l0,fusedStep,parallelFusedStep
+   this->generateDiscreteMassPositions (0.01, 1000, 10,1, 0,10, 2, 0);
+   this-> compareSimulatedToTheoreticalPositions(5e-16,0.01);
+}
+
+// Test case: h=0.01 k=1000 m=10, with the parallel fused step
+TYPED_TEST( EulerExplicitDynamic_test , eulerExplicitSolverDynamicTest_medium_dt_parallelFusedStep)
+{
+   this->createScene(1000,10,1,true,true); // k,m,l0,fusedStep,parallelFusedStep
+   this->generateDiscreteMassPositions (0.01, 1000, 10,1, 0,10, 2, 0);
+   this-> compareSimulatedToTheoreticalPositions(5e-16,0.01);
+}
+
 } // namespace sofa
@@ -0,0 +1,186 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/testing/BaseSimulationTest.h>
+using sofa::testing::BaseSimulationTest;
+
+#include <sofa/component/odesolver/forward/FusedExplicitStep.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/common/SceneLoaderXML.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <sstream>
+
+namespace sofa
+{
+
+namespace
+{
+
+using MechanicalObject3 = component::statecontainer::MechanicalObject<defaulttype::Vec3Types>;
+
+struct FusedExplicitStep_test : public BaseSimulationTest
+{
+    void onSetUp() override
+    {
+        simpleapi::importPlugin("Sofa.Component.AnimationLoop");
+        simpleapi::importPlugin("Sofa.Component.ODESolver.Forward");
+        simpleapi::importPlugin("Sofa.Component.StateContainer");
+        simpleapi::importPlugin("Sofa.Component.Mass");
+        simpleapi::importPlugin("Sofa.Component.SolidMechanics.Spring");
+        simpleapi::importPlugin("Sofa.Component.Constraint.Projective");
+        simpleapi::importPlugin("Sofa.Component.Mapping.Linear");
+    }
+
+    void onTearDown() override
+    {
+        if (m_root)
+        {
+            sofa::simulation::node::unload(m_root);
+            m_root.reset();
+        }
+    }
+
+    /// Several independent bodies, each one with its own mass, springs and fixed point.
+    /// If mappedConstraint is true, the first body also has a mapped state with a projective constraint.
+    void createScene(const std::string& solver, bool fusedStep, bool parallelFusedStep, bool mappedConstraint)
+    {
+        std::stringstream scene;
+        scene << "<?xml version='1.0'?>"
+                 "<Node name='root' gravity='0 -9.81 0' dt='0.01'>"
+                 "  <DefaultAnimationLoop/>"
+                 "  <" << solver << " fusedStep='" << fusedStep << "' parallelFusedStep='" << parallelFusedStep << "'/>";
+        for (int body = 0; body < nbBodies; ++body)
+        {
+            scene << "  <Node name='body" << body << "'>"
+                     "    <MechanicalObject template='Vec3d' position='";
+            for (int i = 0; i < 5; ++i)
+            {
+                scene << i << " " << body << " " << 0.1 * i * body << " ";
+            }
+            scene << "' velocity='";
+            for (int i = 0; i < 5; ++i)
+            {
+                scene << 0.1 * body << " " << 0.2 * i << " " << -0.3 * i * body << " ";
+            }
+            scene << "'/>"
+                     "    <UniformMass totalMass='" << body + 1 << "'/>"
+                     "    <RestShapeSpringsForceField stiffness='" << 50 * (body + 1) << "'/>"
+                     "    <FixedProjectiveConstraint indices='0'/>";
+            if (mappedConstraint && body == 0)
+            {
+                scene << "    <Node name='mapped'>"
+                         "      <MechanicalObject template='Vec3d'/>"
+                         "      <IdentityMapping/>"
+                         "      <FixedProjectiveConstraint indices='1'/>"
+                         "    </Node>";
+            }
+            scene << "  </Node>";
+        }
+        scene << "</Node>";
+
+        m_root = simulation::SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        ASSERT_NE(m_root, nullptr);
+        sofa::simulation::node::initRoot(m_root.get());
+    }
+
+    /// Positions and velocities of all the mechanical states, after nbSteps steps
+    std::vector<SReal> simulate(const std::string& solver, bool fusedStep, bool parallelFusedStep, bool mappedConstraint)
+    {
+        createScene(solver, fusedStep, parallelFusedStep, mappedConstraint);
+        for (int step = 0; step < nbSteps; ++step)
+        {
+            sofa::simulation::node::animate(m_root.get(), m_root->getDt());
+        }
+
+        std::vector<MechanicalObject3*> states;
+        m_root->getTreeObjects<MechanicalObject3>(&states);
+        EXPECT_EQ(states.size(), static_cast<std::size_t>(mappedConstraint ? nbBodies + 1 : nbBodies));
+
+        std::vector<SReal> values;
+        for (const MechanicalObject3* state : states)
+        {
+            for (const auto& x : state->x.getValue())
+            {
+                values.insert(values.end(), x.begin(), x.end());
+            }
+            for (const auto& v : state->v.getValue())
+            {
+                values.insert(values.end(), v.begin(), v.end());
+            }
+        }
+
+        sofa::simulation::node::unload(m_root);
+        m_root.reset();
+        return values;
+    }
+
+    /// The fused steps perform the same arithmetic as the regular step: the results are identical
+    void compareFusedToRegular(const std::string& solver, bool mappedConstraint)
+    {
+        const std::vector<SReal> regular = simulate(solver, false, false, mappedConstraint);
+        const std::vector<SReal> fused = simulate(solver, true, false, mappedConstraint);
+        const std::vector<SReal> parallelFused = simulate(solver, true, true, mappedConstraint);
+
+        ASSERT_FALSE(regular.empty());
+        ASSERT_EQ(regular.size(), fused.size());
+        ASSERT_EQ(regular.size(), parallelFused.size());
+        for (std::size_t i = 0; i < regular.size(); ++i)
+        {
+            EXPECT_EQ(regular[i], fused[i]) << "value " << i;
+            EXPECT_EQ(regular[i], parallelFused[i]) << "value " << i;
+        }
+    }
+
+    static constexpr int nbBodies = 6;
+    static constexpr int nbSteps = 20;
+    simulation::Node::SPtr m_root;
+};
+
+TEST_F(FusedExplicitStep_test, eulerExplicitSeveralStates)
+{
+    compareFusedToRegular("EulerExplicitSolver", false);
+}
+
+TEST_F(FusedExplicitStep_test, centralDifferenceSeveralStates)
+{
+    compareFusedToRegular("CentralDifferenceSolver", false);
+}
+
+TEST_F(FusedExplicitStep_test, eulerExplicitMappedProjectiveConstraint)
+{
+    compareFusedToRegular("EulerExplicitSolver", true);
+}
+
+TEST_F(FusedExplicitStep_test, mappedProjectiveConstraintIsNotFused)
+{
+    createScene("EulerExplicitSolver", true, false, true);
+
+    // the projective constraint of the mapped state would not be applied by the fused step
+    EXPECT_FALSE(component::odesolver::forward::FusedExplicitStep::apply(
+        core::mechanicalparams::defaultInstance(), m_root.get(), core::VecDerivId::dx(), {}, false));
+}
+
+}
+
+} // namespace sofa
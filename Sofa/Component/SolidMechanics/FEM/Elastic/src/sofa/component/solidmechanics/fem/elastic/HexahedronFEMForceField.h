@@ -34,6 +34,9 @@
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
+#include <array>
+#include <map>
+
 namespace sofa::component::solidmechanics::fem::elastic
 {
 
@@ -147,6 +150,7 @@ public:
     Data< sofa::helper::OptionsGroup > d_gatherBsize; ///< number of dof accumulated per threads during the gather operation (Only use in GPU version)
     Data<bool> d_drawing; ///< draw the forcefield if true
     Data<Real> d_drawPercentageOffset; ///< size of the hexa
+    Data<bool> d_shareStiffnessMatrices; ///< store a few reference stiffness matrices shared by the elements of identical shape instead of one stiffness matrix per element
     bool needUpdateTopology;
 
     using Inherit1::l_topology;
@@ -231,6 +235,42 @@ protected:
 
     static void computeForce( Displacement &F, const Displacement &Depl, const ElementStiffness &K );
 
+    /// Compute the forces F = K_i * Depl of the element i, in the frame of the element
+    void computeElementForce( Displacement &F, const Displacement &Depl, sofa::Index i ) const;
+
+    /**
+     * Return the stiffness matrix K_i of the element i, as a matrix and a scale factor: K_i = factor * matrix.
+     * The factor is 1 if the element has its own stiffness matrix, and the element scale (Young modulus and sparse
+     * grid stiffness coefficient) if the stiffness matrices are shared.
+     */
+    const ElementStiffness& getElementStiffness( sofa::Index i, Real& factor ) const;
+
+    /// Return true if the elements use the shared reference stiffness matrices instead of d_elementStiffnesses
+    bool useSharedStiffnessMatrices() const;
+
+    /// Compute the stiffness matrix of the element i from its rotated initial position
+    void initElementStiffness( sofa::Index i );
+
+    static void computeIsotropicMaterialStiffness( MaterialStiffness& materialStiffness, Real youngModulus, Real poissonRatio );
+
+    /**
+     * Elements with the same rest shape in their frame (up to a translation) and the same Poisson ratio have
+     * stiffness matrices that differ only by a scale factor. When d_shareStiffnessMatrices is set, a single
+     * reference matrix (computed for a unit Young modulus) is stored for all of them, instead of one 24x24
+     * matrix per element. On regular and sparse grids, only a handful of reference matrices are needed.
+     */
+    struct SharedElementStiffnesses
+    {
+        VecElementStiffness references; ///< reference stiffness matrices, computed for a unit Young modulus
+        type::vector<sofa::Index> elementReference; ///< index of the reference matrix of each element
+        type::vector<Real> elementFactor; ///< scale factor applied to the reference matrix of each element
+        std::map<std::array<long long, 26>, sofa::Index> referenceIds; ///< quantized rest shape, size and Poisson ratio -> reference matrix
+
+        void clear();
+    };
+    SharedElementStiffnesses m_sharedStiffnesses;
+    bool m_buildSharedStiffnesses { false };
+
 
     ////////////// large displacements method
     type::vector<type::fixed_array<Coord,8> > _rotatedInitialElements;   ///< The initials positions in its frame
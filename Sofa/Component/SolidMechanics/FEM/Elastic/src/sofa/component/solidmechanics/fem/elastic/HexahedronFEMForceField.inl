@@ -28,6 +28,8 @@
 #include <sofa/core/MechanicalParams.h>
 #include <sofa/helper/decompose.h>
 #include <sofa/core/behavior/BaseLocalForceFieldMatrix.h>
+#include <cmath>
+#include <limits>
 
 // WARNING: indices ordering is different than in topology node
 //
@@ -56,6 +58,7 @@ HexahedronFEMForceField<DataTypes>::HexahedronFEMForceField()
     , d_gatherBsize(initData(&d_gatherBsize, "gatherBsize", "number of dof accumulated per threads during the gather operation (Only use in GPU version)"))
     , d_drawing(initData(&d_drawing, true, "drawing", "draw the forcefield if true"))
     , d_drawPercentageOffset(initData(&d_drawPercentageOffset, (Real)0.15, "drawPercentageOffset", "size of the hexa"))
+    , d_shareStiffnessMatrices(initData(&d_shareStiffnessMatrices, false, "shareStiffnessMatrices", "Store a few reference stiffness matrices shared by the elements of identical shape (e.g. on regular or sparse grids), instead of one stiffness matrix per element. Not compatible with updateStiffnessMatrix"))
     , needUpdateTopology(false)
     , d_elementStiffnesses(initData(&d_elementStiffnesses, "stiffnessMatrices", "Stiffness matrices per element (K_i)"))
     , _sparseGrid(nullptr)
@@ -154,6 +157,21 @@ void HexahedronFEMForceField<DataTypes>::reinit()
     else if (d_method.getValue() == "small")
         this->setMethod(SMALL);
 
+    m_sharedStiffnesses.clear();
+    m_buildSharedStiffnesses = d_shareStiffnessMatrices.getValue();
+    if (m_buildSharedStiffnesses && d_updateStiffnessMatrix.getValue())
+    {
+        msg_warning() << "Stiffness matrices cannot be shared if they are updated at each time step. "
+                         "Set 'updateStiffnessMatrix' to false to use shared stiffness matrices.";
+        m_buildSharedStiffnesses = false;
+    }
+    if (m_buildSharedStiffnesses)
+    {
+        sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses).clear();
+        m_sharedStiffnesses.elementReference.resize(this->getIndexedElements()->size());
+        m_sharedStiffnesses.elementFactor.resize(this->getIndexedElements()->size());
+    }
+
     switch(method)
     {
     case LARGE :
@@ -190,6 +208,14 @@ void HexahedronFEMForceField<DataTypes>::reinit()
         break;
     }
     }
+
+    if (m_buildSharedStiffnesses)
+    {
+        msg_info() << m_sharedStiffnesses.references.size() << " reference stiffness matrices are shared by "
+                   << m_sharedStiffnesses.elementReference.size() << " elements";
+        m_sharedStiffnesses.referenceIds.clear();
+        m_buildSharedStiffnesses = false;
+    }
 }
 
 
@@ -287,12 +313,17 @@ void HexahedronFEMForceField<DataTypes>::addDForce (const core::MechanicalParams
             X[w*3+2] = x_2[2];
         }
 
+        // the scale factor of a shared stiffness matrix is applied with kFactor on the 8 nodal forces
+        Real factor;
+        const ElementStiffness& K = getElementStiffness(i, factor);
+
         Displacement F;
-        computeForce(F, X, d_elementStiffnesses.getValue()[i] );
+        computeForce(F, X, K);
 
+        const Real elementKFactor = factor * kFactor;
         for(int w=0; w<8; ++w)
         {
-            _df[(*it)[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * kFactor;
+            _df[(*it)[w]] -= _rotations[i].multTranspose(Deriv(F[w*3], F[w*3+1], F[w*3+2])) * elementKFactor;
         }
     }
 }
@@ -696,19 +727,23 @@ typename HexahedronFEMForceField<DataTypes>::Mat33 HexahedronFEMForceField<DataT
 template<class DataTypes>
 void HexahedronFEMForceField<DataTypes>::computeMaterialStiffness(sofa::Index i)
 {
-    const auto poissonRatio = this->getPoissonRatioInElement(i);
-    _materialsStiffnesses[i][0][0] = _materialsStiffnesses[i][1][1] = _materialsStiffnesses[i][2][2] = 1;
-    _materialsStiffnesses[i][0][1] = _materialsStiffnesses[i][0][2] = _materialsStiffnesses[i][1][0]
-            = _materialsStiffnesses[i][1][2] = _materialsStiffnesses[i][2][0] =
-                    _materialsStiffnesses[i][2][1] = poissonRatio / (1 - poissonRatio);
-    _materialsStiffnesses[i][0][3] = _materialsStiffnesses[i][0][4] =	_materialsStiffnesses[i][0][5] = 0;
-    _materialsStiffnesses[i][1][3] = _materialsStiffnesses[i][1][4] =	_materialsStiffnesses[i][1][5] = 0;
-    _materialsStiffnesses[i][2][3] = _materialsStiffnesses[i][2][4] =	_materialsStiffnesses[i][2][5] = 0;
-    _materialsStiffnesses[i][3][0] = _materialsStiffnesses[i][3][1] = _materialsStiffnesses[i][3][2] = _materialsStiffnesses[i][3][4] =	_materialsStiffnesses[i][3][5] = 0;
-    _materialsStiffnesses[i][4][0] = _materialsStiffnesses[i][4][1] = _materialsStiffnesses[i][4][2] = _materialsStiffnesses[i][4][3] =	_materialsStiffnesses[i][4][5] = 0;
-    _materialsStiffnesses[i][5][0] = _materialsStiffnesses[i][5][1] = _materialsStiffnesses[i][5][2] = _materialsStiffnesses[i][5][3] =	_materialsStiffnesses[i][5][4] = 0;
-    _materialsStiffnesses[i][3][3] = _materialsStiffnesses[i][4][4] = _materialsStiffnesses[i][5][5] = (1- 2 * poissonRatio) / (2 * (1 - poissonRatio));
-    _materialsStiffnesses[i] *= (this->getYoungModulusInElement(i) * (1 - poissonRatio)) / ((1 + poissonRatio) * (1 - 2 * poissonRatio));
+    computeIsotropicMaterialStiffness(_materialsStiffnesses[i], this->getYoungModulusInElement(i), this->getPoissonRatioInElement(i));
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::computeIsotropicMaterialStiffness(MaterialStiffness& materialStiffness, Real youngModulus, Real poissonRatio)
+{
+    MaterialStiffness& m = materialStiffness;
+    m[0][0] = m[1][1] = m[2][2] = 1;
+    m[0][1] = m[0][2] = m[1][0] = m[1][2] = m[2][0] = m[2][1] = poissonRatio / (1 - poissonRatio);
+    m[0][3] = m[0][4] = m[0][5] = 0;
+    m[1][3] = m[1][4] = m[1][5] = 0;
+    m[2][3] = m[2][4] = m[2][5] = 0;
+    m[3][0] = m[3][1] = m[3][2] = m[3][4] = m[3][5] = 0;
+    m[4][0] = m[4][1] = m[4][2] = m[4][3] = m[4][5] = 0;
+    m[5][0] = m[5][1] = m[5][2] = m[5][3] = m[5][4] = 0;
+    m[3][3] = m[4][4] = m[5][5] = (1- 2 * poissonRatio) / (2 * (1 - poissonRatio));
+    m *= (youngModulus * (1 - poissonRatio)) / ((1 + poissonRatio) * (1 - 2 * poissonRatio));
     // S = [ U V V 0 0 0 ]
     //     [ V U V 0 0 0 ]
     //     [ V V U 0 0 0 ]
@@ -726,6 +761,101 @@ void HexahedronFEMForceField<DataTypes>::computeForce( Displacement &F, const Di
     F = K*Depl;
 }
 
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::computeElementForce( Displacement &F, const Displacement &Depl, sofa::Index i ) const
+{
+    Real factor;
+    computeForce(F, Depl, getElementStiffness(i, factor));
+    if (factor != 1)
+    {
+        F *= factor;
+    }
+}
+
+template<class DataTypes>
+bool HexahedronFEMForceField<DataTypes>::useSharedStiffnessMatrices() const
+{
+    // per-element stiffness matrices take precedence, for instance if they are computed by a derived class
+    return !m_sharedStiffnesses.elementReference.empty() && d_elementStiffnesses.getValue().empty();
+}
+
+template<class DataTypes>
+auto HexahedronFEMForceField<DataTypes>::getElementStiffness( sofa::Index i, Real& factor ) const -> const ElementStiffness&
+{
+    if (useSharedStiffnessMatrices())
+    {
+        factor = m_sharedStiffnesses.elementFactor[i];
+        return m_sharedStiffnesses.references[m_sharedStiffnesses.elementReference[i]];
+    }
+    factor = 1;
+    return d_elementStiffnesses.getValue()[i];
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::SharedElementStiffnesses::clear()
+{
+    references.clear();
+    elementReference.clear();
+    elementFactor.clear();
+    referenceIds.clear();
+}
+
+template<class DataTypes>
+void HexahedronFEMForceField<DataTypes>::initElementStiffness(sofa::Index i)
+{
+    const double stiffnessFactor = _sparseGrid ? _sparseGrid->getStiffnessCoef(i) : 1.0;
+    const auto& nodes = _rotatedInitialElements[i];
+
+    if (!m_buildSharedStiffnesses)
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
+        if( stiffnesses.size() <= i )
+        {
+            stiffnesses.resize( i + 1 );
+        }
+
+        computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], nodes, i, stiffnessFactor );
+        return;
+    }
+
+    // The stiffness matrix is linear in the Young modulus and in the stiffness coefficient. The reference matrix
+    // only depends on the rest shape of the element in its frame, and on the Poisson ratio.
+    const Real poissonRatio = this->getPoissonRatioInElement(i);
+
+    Real size = 0;
+    for (int w = 1; w < 8; ++w)
+    {
+        size = std::max(size, (nodes[w] - nodes[0]).norm());
+    }
+    const Real tolerance = (size > 0 ? size : 1) * static_cast<Real>(1e-6);
+
+    // The node coordinates are quantized relatively to the element size, so they only describe the shape of the
+    // element. The stiffness matrix also depends on its scale, which is quantized with the same relative tolerance.
+    std::array<long long, 26> key;
+    for (int w = 0; w < 8; ++w)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            key[w * 3 + c] = std::llround((nodes[w][c] - nodes[0][c]) / tolerance);
+        }
+    }
+    key[24] = std::llround(poissonRatio * 1e6);
+    key[25] = size > 0 ? std::llround(std::log(size) * 1e6) : std::numeric_limits<long long>::min();
+
+    const auto [it, inserted] = m_sharedStiffnesses.referenceIds.emplace(key, static_cast<sofa::Index>(m_sharedStiffnesses.references.size()));
+    if (inserted)
+    {
+        MaterialStiffness unitMaterialStiffness;
+        computeIsotropicMaterialStiffness(unitMaterialStiffness, 1, poissonRatio);
+
+        m_sharedStiffnesses.references.emplace_back();
+        computeElementStiffness( m_sharedStiffnesses.references.back(), unitMaterialStiffness, nodes, i, 1.0 );
+    }
+
+    m_sharedStiffnesses.elementReference[i] = it->second;
+    m_sharedStiffnesses.elementFactor[i] = static_cast<Real>(this->getYoungModulusInElement(i) * stiffnessFactor);
+}
+
 
 /////////////////////////////////////////////////
 /////////////////////////////////////////////////
@@ -742,13 +872,7 @@ void HexahedronFEMForceField<DataTypes>::initSmall(sofa::Index i, const Element
     for(int w=0; w<8; ++w)
         _rotatedInitialElements[i][w] = _rotations[i] * d_initialPoints.getValue()[elem[w]];
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
-    {
-        stiffnesses.resize( i + 1 );
-    }
-
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    initElementStiffness(i);
 }
 
 template<class DataTypes>
@@ -772,12 +896,14 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceSmall ( WDataRefVecDeriv
             D[index+j] = _rotatedInitialElements[i][k][j] - nodes[k][j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
     if(d_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    }
 
     Displacement F; //forces
-    computeForce( F, D, stiffnesses[i] ); // compute force on element
+    computeElementForce( F, D, i ); // compute force on element
 
     for(int w=0; w<8; ++w)
         f[elem[w]] += Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) ;
@@ -816,13 +942,7 @@ void HexahedronFEMForceField<DataTypes>::initLarge(sofa::Index i, const Element
     for(int w=0; w<8; ++w)
         _rotatedInitialElements[i][w] = _rotations[i] * d_initialPoints.getValue()[elem[w]];
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
-    {
-        stiffnesses.resize( i + 1 );
-    }
-
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    initElementStiffness(i);
 }
 
 template<class DataTypes>
@@ -875,12 +995,14 @@ void HexahedronFEMForceField<DataTypes>::accumulateForceLarge( WDataRefVecDeriv
             D[index+j] = _rotatedInitialElements[i][k][j] - deformed[k][j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
     if(d_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0 );
+    }
 
     Displacement F; //forces
-    computeForce(F, D, d_elementStiffnesses.getValue()[i] ); // compute force on element
+    computeElementForce( F, D, i ); // compute force on element
 
     for(int w=0; w<8; ++w)
         f[elem[w]] += _rotations[i].multTranspose( Deriv( F[w*3],  F[w*3+1],   F[w*3+2]  ) );
@@ -916,13 +1038,7 @@ void HexahedronFEMForceField<DataTypes>::initPolar(sofa::Index i, const Element&
         _rotatedInitialElements[i][j] =  _rotations[i] * nodes[j];
     }
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
-    if( stiffnesses.size() <= i )
-    {
-        stiffnesses.resize( i + 1 );
-    }
-
-    computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], _rotatedInitialElements[i], i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0);
+    initElementStiffness(i);
 }
 
 
@@ -1065,13 +1181,15 @@ void HexahedronFEMForceField<DataTypes>::accumulateForcePolar( WDataRefVecDeriv
     //forces
     Displacement F;
 
-    auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
     if(d_updateStiffnessMatrix.getValue())
+    {
+        auto& stiffnesses = *sofa::helper::getWriteOnlyAccessor(d_elementStiffnesses);
         computeElementStiffness( stiffnesses[i], _materialsStiffnesses[i], deformed, i, _sparseGrid?_sparseGrid->getStiffnessCoef(i):1.0);
+    }
 
 
     // compute force on element
-    computeForce(F, D, d_elementStiffnesses.getValue()[i] );
+    computeElementForce( F, D, i );
 
 
     for(int j=0; j<8; ++j)
@@ -1126,13 +1244,14 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseM
 
     sofa::Index e { 0 }; //index of the element in the topology
 
-    const auto& stiffnesses = d_elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        Real factor;
+        const ElementStiffness &Ke = getElementStiffness(e, factor);
         const Transformation Rot = getElementRotation(e);
+        const SReal elementKFact = kFact * factor;
         e++;
 
         // find index of node 1
@@ -1149,7 +1268,7 @@ void HexahedronFEMForceField<DataTypes>::addKToMatrix(sofa::linearalgebra::BaseM
                         Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
                         Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
 
-                matrix->add( offset + 3 * node1, offset + 3 * node2, tmp * (-kFact));
+                matrix->add( offset + 3 * node1, offset + 3 * node2, tmp * (-elementKFact));
             }
         }
     }
@@ -1160,7 +1279,6 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
 {
     sofa::Index e { 0 }; //index of the element in the topology
 
-    const auto& stiffnesses = d_elementStiffnesses.getValue();
     const auto* indexedElements = this->getIndexedElements();
 
     auto dfdx = matrix->getForceDerivativeIn(this->mstate)
@@ -1168,7 +1286,8 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
 
     for (const auto& element : *indexedElements)
     {
-        const ElementStiffness &Ke = stiffnesses[e];
+        Real factor;
+        const ElementStiffness &Ke = getElementStiffness(e, factor);
         const Transformation& Rot = getElementRotation(e);
         e++;
 
@@ -1184,7 +1303,7 @@ void HexahedronFEMForceField<DataTypes>::buildStiffnessMatrix(core::behavior::St
                         Coord(Ke[3*n1+1][3*n2+0],Ke[3*n1+1][3*n2+1],Ke[3*n1+1][3*n2+2]),
                         Coord(Ke[3*n1+2][3*n2+0],Ke[3*n1+2][3*n2+1],Ke[3*n1+2][3*n2+2])) ) * Rot;
 
-                dfdx(3 * node1, 3 * node2) += - tmp;
+                dfdx(3 * node1, 3 * node2) += - tmp * factor;
             }
         }
     }
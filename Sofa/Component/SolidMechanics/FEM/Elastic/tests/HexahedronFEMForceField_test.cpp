@@ -22,6 +22,9 @@
 #include <sofa/component/solidmechanics/fem/elastic/HexahedronFEMForceField.h>
 
 #include <sofa/component/solidmechanics/testing/ForceFieldTestCreation.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <functional>
 
 namespace sofa 
 {
@@ -149,4 +152,109 @@ TYPED_TEST( HexahedronFEMForceField_test, test_computeBBox )
     ASSERT_NO_THROW(this->test_computeBBox()) ;
 }
 
+namespace
+{
+
+/**
+ * Compare the forces computed with shared stiffness matrices to the forces computed with one stiffness matrix per
+ * element. The function createTopology adds the topology of the hexahedra to a node.
+ */
+void checkSharedStiffnessMatrices(const std::function<void(simulation::Node::SPtr)>& createTopology)
+{
+    using DataTypes = defaulttype::Vec3Types;
+    using FEM = component::solidmechanics::fem::elastic::HexahedronFEMForceField<DataTypes>;
+    using DOF = component::statecontainer::MechanicalObject<DataTypes>;
+
+    sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+    sofa::simpleapi::importPlugin("Sofa.Component.Topology.Container.Dynamic");
+    sofa::simpleapi::importPlugin("Sofa.Component.Topology.Container.Grid");
+    sofa::simpleapi::importPlugin("Sofa.Component.SolidMechanics.FEM.Elastic");
+
+    const auto root = sofa::simpleapi::createRootNode(sofa::simulation::getSimulation(), "root");
+
+    std::array<DOF*, 2> dofs {};
+    std::array<FEM*, 2> forceFields {};
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        const auto node = sofa::simpleapi::createChild(root, "node" + std::to_string(i));
+        createTopology(node);
+        dofs[i] = dynamic_cast<DOF*>(sofa::simpleapi::createObject(node, "MechanicalObject", {{"template", "Vec3"}}).get());
+        forceFields[i] = dynamic_cast<FEM*>(sofa::simpleapi::createObject(node, "HexahedronFEMForceField", {
+            {"youngModulus", "1000"}, {"poissonRatio", "0.3"}, {"method", "large"},
+            {"shareStiffnessMatrices", i == 0 ? "false" : "true"}}).get());
+        ASSERT_NE(dofs[i], nullptr);
+        ASSERT_NE(forceFields[i], nullptr);
+    }
+
+    sofa::simulation::node::initRoot(root.get());
+
+    // no stiffness matrix per element is stored when the matrices are shared
+    EXPECT_FALSE(forceFields[0]->findData("stiffnessMatrices")->getValueString().empty());
+    EXPECT_TRUE(forceFields[1]->findData("stiffnessMatrices")->getValueString().empty());
+
+    core::MechanicalParams mparams;
+    mparams.setKFactor(1.);
+
+    std::array<DataTypes::VecDeriv, 2> forces, dforces;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        {
+            auto x = dofs[i]->writePositions();
+            auto dx = sofa::helper::getWriteOnlyAccessor(*dofs[i]->write(core::VecDerivId::dx()));
+            dx.resize(x.size());
+            for (std::size_t j = 0; j < x.size(); ++j)
+            {
+                x[j] += DataTypes::Deriv(0.01 * std::sin(j), 0.02 * std::cos(j), 0.015 * std::sin(2. * j));
+                dx[j] = DataTypes::Deriv(0.1 * std::cos(j), 0.1 * std::sin(3. * j), 0.1);
+            }
+        }
+
+        auto& f = *dofs[i]->write(core::VecDerivId::force());
+        sofa::helper::getWriteOnlyAccessor(f).clear();
+        forceFields[i]->addForce(&mparams, f, *dofs[i]->read(core::ConstVecCoordId::position()), *dofs[i]->read(core::ConstVecDerivId::velocity()));
+        forces[i] = f.getValue();
+
+        auto& df = *dofs[i]->write(core::VecDerivId::force());
+        sofa::helper::getWriteOnlyAccessor(df).clear();
+        forceFields[i]->addDForce(&mparams, df, *dofs[i]->read(core::ConstVecDerivId::dx()));
+        dforces[i] = df.getValue();
+    }
+
+    ASSERT_EQ(forces[0].size(), forces[1].size());
+    ASSERT_EQ(dforces[0].size(), dforces[1].size());
+    for (std::size_t j = 0; j < forces[0].size(); ++j)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(forces[0][j][c], forces[1][j][c], 1e-8);
+            EXPECT_NEAR(dforces[0][j][c], dforces[1][j][c], 1e-8);
+        }
+    }
+}
+
+}
+
+/// On a regular grid, all the elements share the same reference stiffness matrix
+TEST( HexahedronFEMForceField, sharedStiffnessMatrices )
+{
+    checkSharedStiffnessMatrices([](simulation::Node::SPtr node)
+    {
+        sofa::simpleapi::createObject(node, "RegularGridTopology", {{"n", "4 3 5"}, {"min", "0 0 0"}, {"max", "3 2 4"}});
+    });
+}
+
+/// Hexahedra of the same shape but of different sizes have different stiffness matrices, and must not share them
+TEST( HexahedronFEMForceField, sharedStiffnessMatricesDifferentSizes )
+{
+    checkSharedStiffnessMatrices([](simulation::Node::SPtr node)
+    {
+        // a unit cube, a cube of size 2, and a cube of size 1e-3
+        sofa::simpleapi::createObject(node, "HexahedronSetTopologyContainer", {
+            {"position", "0 0 0  1 0 0  1 1 0  0 1 0  0 0 1  1 0 1  1 1 1  0 1 1 "
+                         "3 0 0  5 0 0  5 2 0  3 2 0  3 0 2  5 0 2  5 2 2  3 2 2 "
+                         "7 0 0  7.001 0 0  7.001 0.001 0  7 0.001 0  7 0 0.001  7.001 0 0.001  7.001 0.001 0.001  7 0.001 0.001"},
+            {"hexahedra", "0 1 2 3 4 5 6 7  8 9 10 11 12 13 14 15  16 17 18 19 20 21 22 23"}});
+    });
+}
+
 } // namespace sofa
@@ -190,9 +190,30 @@ protected:
 
     void testDerivatives();
 
-    void updateTangentMatrix();
+    virtual void updateTangentMatrix();
 
     void instantiateMaterial();
+
+    /**
+     * Call the function with the material cast to its concrete type, if its dynamic type is exactly one of the materials
+     * known by this component. The material methods called in the loops over the elements are then statically
+     * dispatched and can be inlined. The function is called with the generic material otherwise, including for
+     * subclasses of the known materials, so that their overrides are called.
+     */
+    template<class Function>
+    void dispatchMaterial(Function&& f);
+
+    /// Compute the deformation and the stress of a tetrahedron, and the forces applied on its 4 vertices
+    template<class Material>
+    void computeTetrahedronForce(Material& material, const Tetrahedron& tetrahedron,
+                                 TetrahedronRestInformation& tetInfo, const VecCoord& x,
+                                 type::fixed_array<Deriv, 4>& tetrahedronForce) const;
+
+    /// Compute the contribution of a tetrahedron to the stiffness matrices of its 6 edges
+    template<class Material>
+    void computeTetrahedronEdgeStiffness(Material& material, Index tetrahedronId,
+                                         TetrahedronRestInformation& tetInfo,
+                                         type::fixed_array<Matrix3, 6>& edgeStiffness) const;
 };
 
 #if !defined(SOFA_COMPONENT_FORCEFIELD_TETRAHEDRONHYPERELASTICITYFEMFORCEFIELD_CPP)
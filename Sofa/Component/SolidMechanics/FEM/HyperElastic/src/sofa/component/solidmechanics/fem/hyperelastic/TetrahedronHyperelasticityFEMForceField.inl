@@ -37,6 +37,7 @@
 #include <sofa/core/ObjectFactory.h>
 #include <sofa/core/behavior/ForceField.inl>
 #include <sofa/core/topology/TopologyData.inl>
+#include <typeinfo>
 
 namespace sofa::component::solidmechanics::fem::hyperelastic
 {
@@ -279,179 +280,260 @@ void TetrahedronHyperelasticityFEMForceField<DataTypes>::createTetrahedronRestIn
     }
 }
 
+template <class DataTypes>
+template <class Function>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::dispatchMaterial(Function&& f)
+{
+    auto* material = m_myMaterial.get();
+
+    // The concrete type must match exactly: a subclass of one of the known materials may override its methods, and
+    // the qualified calls made in the element loops would skip the overrides.
+    const std::type_info& materialType = typeid(*material);
+
+    if (materialType == typeid(StableNeoHookean<DataTypes>))
+    {
+        f(static_cast<StableNeoHookean<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(NeoHookean<DataTypes>))
+    {
+        f(static_cast<NeoHookean<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(MooneyRivlin<DataTypes>))
+    {
+        f(static_cast<MooneyRivlin<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(STVenantKirchhoff<DataTypes>))
+    {
+        f(static_cast<STVenantKirchhoff<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(Ogden<DataTypes>))
+    {
+        f(static_cast<Ogden<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(BoyceAndArruda<DataTypes>))
+    {
+        f(static_cast<BoyceAndArruda<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(VerondaWestman<DataTypes>))
+    {
+        f(static_cast<VerondaWestman<DataTypes>&>(*material));
+    }
+    else if (materialType == typeid(Costa<DataTypes>))
+    {
+        f(static_cast<Costa<DataTypes>&>(*material));
+    }
+    else
+    {
+        f(*material);
+    }
+}
+
+template <class DataTypes>
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeTetrahedronForce(
+    Material& material, const Tetrahedron& ta, TetrahedronRestInformation& tetInfo, const VecCoord& x,
+    type::fixed_array<Deriv, 4>& tetrahedronForce) const
+{
+    Coord dp[3];
+    const Coord& x0 = x[ta[0]];
+
+    // compute the deformation gradient
+    // deformation gradient = sum of tensor product between vertex position and shape vector
+    // optimize by using displacement with first vertex
+    dp[0] = x[ta[1]] - x0;
+    const Coord& sv = tetInfo.m_shapeVector[1];
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+        for (unsigned int l = 0; l < 3; ++l)
+        {
+            tetInfo.m_deformationGradient[k][l] = dp[0][k] * sv[l];
+        }
+    }
+    for (unsigned int j = 1; j < 3; ++j)
+    {
+        dp[j] = x[ta[j + 1]] - x0;
+        const Coord& svj = tetInfo.m_shapeVector[j + 1];
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            for (unsigned int l = 0; l < 3; ++l)
+            {
+                tetInfo.m_deformationGradient[k][l] += dp[j][k] * svj[l];
+            }
+        }
+    }
+
+    /// compute the right Cauchy-Green deformation matrix
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+        for (unsigned int l = k; l < 3; ++l)
+        {
+            tetInfo.deformationTensor(k, l) =
+                tetInfo.m_deformationGradient(0, k) * tetInfo.m_deformationGradient(0, l) +
+                tetInfo.m_deformationGradient(1, k) * tetInfo.m_deformationGradient(1, l) +
+                tetInfo.m_deformationGradient(2, k) * tetInfo.m_deformationGradient(2, l);
+        }
+    }
+
+    if (globalParameters.anisotropyDirection.size() > 0)
+    {
+        tetInfo.m_fiberDirection = globalParameters.anisotropyDirection[0];
+        Coord vectCa = tetInfo.deformationTensor * tetInfo.m_fiberDirection;
+        Real aDotCDota = dot(tetInfo.m_fiberDirection, vectCa);
+        tetInfo.lambda = (Real)sqrt(aDotCDota);
+    }
+    const Coord areaVec = cross( dp[1], dp[2] );
+
+    tetInfo.J = dot(areaVec, dp[0]) * tetInfo.m_volScale;
+    tetInfo.trC = (Real)(tetInfo.deformationTensor(0, 0) + tetInfo.deformationTensor(1, 1) +
+                         tetInfo.deformationTensor(2, 2));
+    tetInfo.m_SPKTensorGeneral.clear();
+
+    if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+    {
+        material.deriveSPKTensor(&tetInfo, globalParameters, tetInfo.m_SPKTensorGeneral);
+    }
+    else
+    {
+        material.Material::deriveSPKTensor(&tetInfo, globalParameters, tetInfo.m_SPKTensorGeneral);
+    }
+
+    for (unsigned int l = 0; l < 4; ++l)
+    {
+        tetrahedronForce[l] = -(tetInfo.m_deformationGradient * (
+            tetInfo.m_SPKTensorGeneral * tetInfo.m_shapeVector[l]) * tetInfo.m_restVolume);
+    }
+}
+
 template <class DataTypes>
 void TetrahedronHyperelasticityFEMForceField<DataTypes>::addForce(const core::MechanicalParams* /* mparams */ /* PARAMS FIRST */, DataVecDeriv& d_f, const DataVecCoord& d_x, const DataVecDeriv& /* d_v */)
 {
     auto f = sofa::helper::getWriteAccessor(d_f);
     const VecCoord& x = d_x.getValue();
 
-    unsigned int j = 0, k = 0, l = 0;
     const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
+    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
 
     auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
 
     assert(this->mstate);
 
-    Coord dp[3], x0, sv;
-
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
+    dispatchMaterial([&](auto& material)
     {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        const Tetrahedron& ta = m_topology->getTetrahedron(i);
-
-        x0 = x[ta[0]];
-
-        // compute the deformation gradient
-        // deformation gradient = sum of tensor product between vertex position and shape vector
-        // optimize by using displacement with first vertex
-        dp[0] = x[ta[1]] - x0;
-        sv = tetInfo->m_shapeVector[1];
-        for (k = 0; k < 3; ++k)
+        type::fixed_array<Deriv, 4> tetrahedronForce;
+        for (unsigned int i = 0; i < nbTetrahedra; i++)
         {
-            for (l = 0; l < 3; ++l)
+            const Tetrahedron& ta = tetrahedronArray[i];
+            computeTetrahedronForce(material, ta, tetrahedronInf[i], x, tetrahedronForce);
+
+            for (unsigned int l = 0; l < 4; ++l)
             {
-                tetInfo->m_deformationGradient[k][l] = dp[0][k] * sv[l];
+                f[ta[l]] += tetrahedronForce[l];
             }
         }
-        for (j = 1; j < 3; ++j)
+    });
+
+    /// indicates that the next call to addDForce will need to update the stiffness matrix
+    m_updateMatrix = true;
+}
+
+template <class DataTypes>
+template <class Material>
+void TetrahedronHyperelasticityFEMForceField<DataTypes>::computeTetrahedronEdgeStiffness(
+    Material& material, Index tetrahedronId, TetrahedronRestInformation& tetInfo,
+    type::fixed_array<Matrix3, 6>& edgeStiffness) const
+{
+    const type::vector<Edge>& edgeArray = m_topology->getEdges();
+    const Matrix3& df = tetInfo.m_deformationGradient;
+    const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(tetrahedronId);
+
+    /// describe the jth vertex index of triangle no i
+    const Tetrahedron& ta = m_topology->getTetrahedron(tetrahedronId);
+    for (unsigned int j = 0; j < 6; j++)
+    {
+        Edge e = m_topology->getLocalEdgesInTetrahedron(j);
+
+        unsigned int k = e[0];
+        unsigned int l = e[1];
+        if (edgeArray[te[j]][0] != ta[k])
         {
-            dp[j] = x[ta[j + 1]] - x0;
-            sv = tetInfo->m_shapeVector[j + 1];
-            for (k = 0; k < 3; ++k)
-            {
-                for (l = 0; l < 3; ++l)
-                {
-                    tetInfo->m_deformationGradient[k][l] += dp[j][k] * sv[l];
-                }
-            }
+            k = e[1];
+            l = e[0];
         }
 
-        /// compute the right Cauchy-Green deformation matrix
-        for (k = 0; k < 3; ++k)
+        const Coord& svl = tetInfo.m_shapeVector[l];
+        const Coord& svk = tetInfo.m_shapeVector[k];
+
+        Matrix3 M, N;
+        MatrixSym outputTensor;
+        N.clear();
+        MatrixSym inputTensor[3];
+        for (int m = 0; m < 3; m++)
         {
-            for (l = k; l < 3; ++l)
+            for (int n = m; n < 3; n++)
             {
-                tetInfo->deformationTensor(k, l) =
-                    tetInfo->m_deformationGradient(0, k) * tetInfo->m_deformationGradient(0, l) +
-                    tetInfo->m_deformationGradient(1, k) * tetInfo->m_deformationGradient(1, l) +
-                    tetInfo->m_deformationGradient(2, k) * tetInfo->m_deformationGradient(2, l);
+                inputTensor[0](m, n) = svl[m] * df[0][n] + df[0][m] * svl[n];
+                inputTensor[1](m, n) = svl[m] * df[1][n] + df[1][m] * svl[n];
+                inputTensor[2](m, n) = svl[m] * df[2][n] + df[2][m] * svl[n];
             }
         }
 
-        if (globalParameters.anisotropyDirection.size() > 0)
-        {
-            tetInfo->m_fiberDirection = globalParameters.anisotropyDirection[0];
-            Coord vectCa = tetInfo->deformationTensor * tetInfo->m_fiberDirection;
-            Real aDotCDota = dot(tetInfo->m_fiberDirection, vectCa);
-            tetInfo->lambda = (Real)sqrt(aDotCDota);
-        }
-        const Coord areaVec = cross( dp[1], dp[2] );
-
-        tetInfo->J = dot(areaVec, dp[0]) * tetInfo->m_volScale;
-        tetInfo->trC = (Real)(tetInfo->deformationTensor(0, 0) + tetInfo->deformationTensor(1, 1) +
-                              tetInfo->deformationTensor(2, 2));
-        tetInfo->m_SPKTensorGeneral.clear();
-        m_myMaterial->deriveSPKTensor(tetInfo, globalParameters, tetInfo->m_SPKTensorGeneral);
-        for (l = 0; l < 4; ++l)
+        for (int m = 0; m < 3; m++)
         {
-            f[ta[l]] -= tetInfo->m_deformationGradient * (
-                tetInfo->m_SPKTensorGeneral * tetInfo->m_shapeVector[l]) * tetInfo->m_restVolume;
+            if constexpr (std::is_same_v<Material, HyperelasticMaterial<DataTypes> >)
+            {
+                material.applyElasticityTensor(&tetInfo, globalParameters, inputTensor[m], outputTensor);
+            }
+            else
+            {
+                material.Material::applyElasticityTensor(&tetInfo, globalParameters, inputTensor[m], outputTensor);
+            }
+            const Coord vectortemp = df * (outputTensor * svk);
+            for (int u = 0; u < 3; u++)
+            {
+                N[m][u] += vectortemp[u];
+            }
         }
-    }
 
+        //Now M
+        const Coord vectSD = tetInfo.m_SPKTensorGeneral * svk;
+        const Real productSD = dot(vectSD, svl);
+        M[0][1] = M[0][2] = M[1][0] = M[1][2] = M[2][0] = M[2][1] = 0;
+        M[0][0] = M[1][1] = M[2][2] = (Real)productSD;
 
-    /// indicates that the next call to addDForce will need to update the stiffness matrix
-    m_updateMatrix = true;
+        edgeStiffness[j] = (M+N)*tetInfo.m_restVolume;
+    }
 }
 
 template <class DataTypes>
 void TetrahedronHyperelasticityFEMForceField<DataTypes>::updateTangentMatrix()
 {
-    unsigned int k = 0, l;
     const unsigned int nbEdges = m_topology->getNbEdges();
-    const type::vector<Edge>& edgeArray = m_topology->getEdges();
 
     auto edgeInf = sofa::helper::getWriteAccessor(m_edgeInfo);
     auto tetrahedronInf = sofa::helper::getWriteAccessor(m_tetrahedronInfo);
 
     const unsigned int nbTetrahedra = m_topology->getNbTetrahedra();
-    const type::vector<Tetrahedron>& tetrahedronArray = m_topology->getTetrahedra();
 
-    for (l = 0; l < nbEdges; l++)
+    for (unsigned int l = 0; l < nbEdges; l++)
     {
         edgeInf[l].DfDx.clear();
     }
-    for (unsigned int i = 0; i < nbTetrahedra; i++)
-    {
-        TetrahedronRestInformation* tetInfo = &tetrahedronInf[i];
-        Matrix3& df = tetInfo->m_deformationGradient;
-//			Matrix3 Tdf=df.transposed();
-        const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
 
-        /// describe the jth vertex index of triangle no i
-        const Tetrahedron& ta = tetrahedronArray[i];
-        for (unsigned int j = 0; j < 6; j++)
+    dispatchMaterial([&](auto& material)
+    {
+        type::fixed_array<Matrix3, 6> edgeStiffness;
+        for (unsigned int i = 0; i < nbTetrahedra; i++)
         {
-            EdgeInformation* einfo = &edgeInf[te[j]];
-            Edge e = m_topology->getLocalEdgesInTetrahedron(j);
+            computeTetrahedronEdgeStiffness(material, i, tetrahedronInf[i], edgeStiffness);
 
-            k = e[0];
-            l = e[1];
-            if (edgeArray[te[j]][0] != ta[k])
+            const BaseMeshTopology::EdgesInTetrahedron& te = m_topology->getEdgesInTetrahedron(i);
+            for (unsigned int j = 0; j < 6; j++)
             {
-                k = e[1];
-                l = e[0];
+                edgeInf[te[j]].DfDx += edgeStiffness[j];
             }
-            Matrix3 &edgeDfDx = einfo->DfDx;
-
-
-            const Coord& svl = tetInfo->m_shapeVector[l];
-            const Coord& svk = tetInfo->m_shapeVector[k];
-
-            Matrix3  M, N;
-            MatrixSym outputTensor;
-            N.clear();
-            type::vector<MatrixSym> inputTensor;
-            inputTensor.resize(3);
-            //	MatrixSym input1,input2,input3,outputTensor;
-            for (int m = 0; m < 3; m++)
-            {
-                for (int n = m; n < 3; n++)
-                {
-                    inputTensor[0](m, n) = svl[m] * df[0][n] + df[0][m] * svl[n];
-                    inputTensor[1](m, n) = svl[m] * df[1][n] + df[1][m] * svl[n];
-                    inputTensor[2](m, n) = svl[m] * df[2][n] + df[2][m] * svl[n];
-                }
-            }
-
-            for (int m = 0; m < 3; m++)
-            {
-                m_myMaterial->applyElasticityTensor(tetInfo, globalParameters, inputTensor[m],
-                                                    outputTensor);
-                Coord vectortemp = df * (outputTensor * svk);
-                Matrix3 Nv;
-                //Nv.clear();
-                for (int u = 0; u < 3; u++)
-                {
-                    Nv[u][m] = vectortemp[u];
-                }
-                N += Nv.transposed();
-            }
-
-
-            //Now M
-            Real productSD = 0;
-
-            const Coord vectSD = tetInfo->m_SPKTensorGeneral * svk;
-            productSD = dot(vectSD, svl);
-            M[0][1] = M[0][2] = M[1][0] = M[1][2] = M[2][0] = M[2][1] = 0;
-            M[0][0] = M[1][1] = M[2][2] = (Real)productSD;
-
-            edgeDfDx += (M+N)*tetInfo->m_restVolume;
-
+        }
+    });
 
-        }// end of for j
-    }//end of for i
     m_updateMatrix=false;
 }
 
@@ -654,9 +654,8 @@ void SparseGridTopology::constructCollisionModels(const sofa::type::vector< sofa
     sofa::type::vector< PointID>	triangles;
     vector< type::Vec3 >		vertices;
 
-    type::vector<unsigned char> * datas = d_dataVoxels.beginEdit();
-    marchingCubes.run(&(*datas)[0], 0.5f, triangles, vertices);
-    d_dataVoxels.endEdit();
+    const type::vector<unsigned char>& datas = d_dataVoxels.getValue();
+    marchingCubes.runByBlocks(datas.data(), 0.5f, triangles, vertices);
 
     for (unsigned int i=0; i<list_mesh.size(); ++i)
     {
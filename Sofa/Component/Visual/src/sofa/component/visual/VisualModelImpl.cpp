@@ -36,6 +36,8 @@
 #include <sofa/core/ObjectFactory.h>
 
 #include <sofa/component/topology/container/grid/SparseGridTopology.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #include <sstream>
 #include <map>
@@ -120,6 +122,8 @@ VisualModelImpl::VisualModelImpl() //const std::string &name, std::string filena
     , d_handleDynamicTopology (initData   (&d_handleDynamicTopology, true, "handleDynamicTopology", "True if topological changes should be handled"))
     , d_fixMergedUVSeams (initData   (&d_fixMergedUVSeams, true, "fixMergedUVSeams", "True if UV seams should be handled even when duplicate UVs are merged"))
     , d_keepLines (initData   (&d_keepLines, false, "keepLines", "keep and draw lines (false by default)"))
+    , d_parallelNormals (initData   (&d_parallelNormals, false, "parallelNormals", "Compute the normals and tangents in parallel, using the task scheduler"))
+    , d_asynchronousUpdate (initData   (&d_asynchronousUpdate, false, "asynchronousUpdate", "Compute the normals and tangents on a separate thread, from a copy of the positions. The simulation does not wait for them, but they are used one visual update later"))
     , d_vertices2       (initData   (&d_vertices2, "vertices", "vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)"))
     , d_vtexcoords      (initData   (&d_vtexcoords, "texcoords", "coordinates of the texture"))
     , d_vtangents       (initData   (&d_vtangents, "tangents", "tangents for normal mapping"))
@@ -208,6 +212,7 @@ VisualModelImpl::VisualModelImpl() //const std::string &name, std::string filena
 
 VisualModelImpl::~VisualModelImpl()
 {
+    waitAsynchronousUpdate();
 }
 
 bool VisualModelImpl::hasTransparent()
@@ -995,6 +1000,14 @@ void VisualModelImpl::computeNormals()
     const VecVisualQuad& quads = d_quads.getValue();
     const type::vector<visual_index_type> &vertNormIdx = d_vertNormIdx.getValue();
 
+    if (d_parallelNormals.getValue())
+    {
+        waitAsynchronousUpdate();
+        auto normals = sofa::helper::getWriteOnlyAccessor(m_vnormals);
+        m_normalsAccumulator.computeNormals(vertices, triangles, quads, vertNormIdx, getTopologyRevision(), normals.wref(), getParallelForRange());
+        return;
+    }
+
     if (vertNormIdx.empty())
     {
         const std::size_t nbn = vertices.size();
@@ -1114,6 +1127,14 @@ void VisualModelImpl::computeTangents()
     auto tangents = sofa::helper::getWriteOnlyAccessor(d_vtangents);
     auto bitangents = sofa::helper::getWriteOnlyAccessor(d_vbitangents);
 
+    if (d_parallelNormals.getValue())
+    {
+        waitAsynchronousUpdate();
+        m_normalsAccumulator.computeTangents(vertices, triangles, quads, texcoords, normals, d_fixMergedUVSeams.getValue(),
+                                             getTopologyRevision(), tangents.wref(), bitangents.wref(), getParallelForRange());
+        return;
+    }
+
     tangents.resize(vertices.size());
     bitangents.resize(vertices.size());
 
@@ -1356,14 +1377,22 @@ void VisualModelImpl::doUpdateVisual(const core::visual::VisualParams* vparams)
             SCOPED_TIMER_VARNAME(t, "VisualModelImpl::computePositions");
             computePositions();
         }
+        if (d_asynchronousUpdate.getValue() && d_updateNormals.getValue())
         {
-            SCOPED_TIMER_VARNAME(t, "VisualModelImpl::computeNormals");
-            computeNormals();
+            SCOPED_TIMER_VARNAME(t, "VisualModelImpl::updateNormalsAsynchronously");
+            updateNormalsAsynchronously();
         }
-        if (d_updateTangents.getValue())
+        else
         {
-            SCOPED_TIMER_VARNAME(t, "VisualModelImpl::computeTangents");
-            computeTangents();
+            {
+                SCOPED_TIMER_VARNAME(t, "VisualModelImpl::computeNormals");
+                computeNormals();
+            }
+            if (d_updateTangents.getValue())
+            {
+                SCOPED_TIMER_VARNAME(t, "VisualModelImpl::computeTangents");
+                computeTangents();
+            }
         }
         if (d_vtexcoords.getValue().size() == 0)
         {
@@ -1392,6 +1421,321 @@ void VisualModelImpl::doUpdateVisual(const core::visual::VisualParams* vparams)
 }
 
 
+simulation::TaskScheduler* VisualModelImpl::getTaskScheduler()
+{
+    if (m_taskScheduler == nullptr)
+    {
+        m_taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(m_taskScheduler != nullptr);
+        if (m_taskScheduler->getThreadCount() < 1)
+        {
+            m_taskScheduler->init(0);
+        }
+    }
+    return m_taskScheduler;
+}
+
+VisualModelImpl::NormalsAccumulator::ParallelForRange VisualModelImpl::getParallelForRange()
+{
+    return [taskScheduler = getTaskScheduler()](std::size_t size, const std::function<void(std::size_t, std::size_t)>& task)
+    {
+        simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+            [&task](const auto& range)
+            {
+                task(range.start, range.end);
+            });
+    };
+}
+
+int VisualModelImpl::getTopologyRevision() const
+{
+    return d_triangles.getCounter() + d_quads.getCounter() + d_vertNormIdx.getCounter();
+}
+
+void VisualModelImpl::waitAsynchronousUpdate()
+{
+    if (m_asynchronousUpdatePending)
+    {
+        m_taskScheduler->workUntilDone(&m_asynchronousUpdateStatus);
+    }
+}
+
+void VisualModelImpl::updateNormalsAsynchronously()
+{
+    const VecCoord& vertices = getVertices();
+    const bool updateTangents = d_updateTangents.getValue() && d_computeTangents.getValue() && !d_vtexcoords.getValue().empty();
+    AsynchronousBuffers& buffers = m_asynchronousBuffers;
+
+    waitAsynchronousUpdate();
+    if (m_asynchronousUpdatePending && buffers.normals.size() == vertices.size()
+        && (!updateTangents || (buffers.updateTangents && buffers.tangents.size() == vertices.size())))
+    {
+        // the buffers are swapped: the previous normals and tangents are overwritten by the next computation
+        m_vnormals.beginEdit()->swap(buffers.normals);
+        m_vnormals.endEdit();
+        if (updateTangents)
+        {
+            d_vtangents.beginEdit()->swap(buffers.tangents);
+            d_vtangents.endEdit();
+            d_vbitangents.beginEdit()->swap(buffers.bitangents);
+            d_vbitangents.endEdit();
+        }
+    }
+    else
+    {
+        // nothing has been computed yet for this mesh
+        computeNormals();
+        if (d_updateTangents.getValue())
+        {
+            computeTangents();
+        }
+    }
+
+    buffers.vertices = vertices;
+    const int topologyRevision = getTopologyRevision();
+    if (buffers.topologyRevision != topologyRevision)
+    {
+        buffers.triangles = d_triangles.getValue();
+        buffers.quads = d_quads.getValue();
+        buffers.vertNormIdx = d_vertNormIdx.getValue();
+        buffers.topologyRevision = topologyRevision;
+    }
+    buffers.updateTangents = updateTangents;
+    if (updateTangents)
+    {
+        buffers.texcoords = d_vtexcoords.getValue();
+        buffers.fixMergedUVSeams = d_fixMergedUVSeams.getValue();
+    }
+
+    m_asynchronousUpdatePending = true;
+    getTaskScheduler()->addTask(m_asynchronousUpdateStatus, [this]()
+    {
+        AsynchronousBuffers& b = m_asynchronousBuffers;
+        m_normalsAccumulator.computeNormals(b.vertices, b.triangles, b.quads, b.vertNormIdx, b.topologyRevision, b.normals, {});
+        if (b.updateTangents)
+        {
+            m_normalsAccumulator.computeTangents(b.vertices, b.triangles, b.quads, b.texcoords, b.normals, b.fixMergedUVSeams,
+                                                 b.topologyRevision, b.tangents, b.bitangents, {});
+        }
+    });
+}
+
+void VisualModelImpl::NormalsAccumulator::updateIncidence(Incidence& incidence, std::size_t nbVertices, const VecVisualTriangle& triangles,
+                                                          const VecVisualQuad& quads, const type::vector<visual_index_type>& vertexSlots, int topologyRevision)
+{
+    if (incidence.revision == topologyRevision && incidence.offsets.size() == nbVertices + 1)
+    {
+        return;
+    }
+
+    const auto slot = [&vertexSlots](visual_index_type v) -> std::size_t
+    {
+        return vertexSlots.empty() ? v : vertexSlots[v];
+    };
+
+    // counting sort of the contributions per vertex, in the order of the faces
+    incidence.offsets.assign(nbVertices + 1, 0);
+    for (const auto& triangle : triangles)
+    {
+        for (const auto v : triangle)
+        {
+            ++incidence.offsets[slot(v) + 1];
+        }
+    }
+    for (const auto& quad : quads)
+    {
+        for (const auto v : quad)
+        {
+            ++incidence.offsets[slot(v) + 1];
+        }
+    }
+    for (std::size_t i = 0; i < nbVertices; ++i)
+    {
+        incidence.offsets[i + 1] += incidence.offsets[i];
+    }
+
+    incidence.contributions.resize(incidence.offsets.back());
+    type::vector<std::size_t> next(incidence.offsets.begin(), incidence.offsets.end() - 1);
+    for (std::size_t t = 0; t < triangles.size(); ++t)
+    {
+        for (const auto v : triangles[t])
+        {
+            incidence.contributions[next[slot(v)]++] = t;
+        }
+    }
+    for (std::size_t q = 0; q < quads.size(); ++q)
+    {
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            incidence.contributions[next[slot(quads[q][c])]++] = triangles.size() + 4 * q + c;
+        }
+    }
+
+    incidence.revision = topologyRevision;
+}
+
+void VisualModelImpl::NormalsAccumulator::computeNormals(const VecCoord& vertices, const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                                                         const type::vector<visual_index_type>& vertNormIdx, int topologyRevision,
+                                                         VecDeriv& normals, const ParallelForRange& parallelFor)
+{
+    const auto forEachRange = [&parallelFor](std::size_t size, const std::function<void(std::size_t, std::size_t)>& task)
+    {
+        if (parallelFor)
+            parallelFor(size, task);
+        else
+            task(0, size);
+    };
+
+    const std::size_t nbTriangles = triangles.size();
+    m_faceNormals.resize(nbTriangles + 4 * quads.size());
+
+    forEachRange(nbTriangles, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t t = begin; t < end; ++t)
+        {
+            const Coord& v1 = vertices[ triangles[t][0] ];
+            const Coord& v2 = vertices[ triangles[t][1] ];
+            const Coord& v3 = vertices[ triangles[t][2] ];
+            m_faceNormals[t] = cross(v2-v1, v3-v1);
+        }
+    });
+
+    forEachRange(quads.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t q = begin; q < end; ++q)
+        {
+            const Coord & v1 = vertices[ quads[q][0] ];
+            const Coord & v2 = vertices[ quads[q][1] ];
+            const Coord & v3 = vertices[ quads[q][2] ];
+            const Coord & v4 = vertices[ quads[q][3] ];
+            Deriv* n = &m_faceNormals[nbTriangles + 4 * q];
+            n[0] = cross(v2-v1, v4-v1);
+            n[1] = cross(v3-v2, v1-v2);
+            n[2] = cross(v4-v3, v2-v3);
+            n[3] = cross(v1-v4, v3-v4);
+        }
+    });
+
+    const std::size_t nbSlots = vertNormIdx.empty() ? vertices.size()
+        : static_cast<std::size_t>(*std::max_element(vertNormIdx.begin(), vertNormIdx.end())) + 1;
+    updateIncidence(m_normalsIncidence, nbSlots, triangles, quads, vertNormIdx, topologyRevision);
+
+    VecDeriv& slotNormals = vertNormIdx.empty() ? normals : m_slotNormals;
+    slotNormals.resize(nbSlots);
+    forEachRange(nbSlots, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Deriv n;
+            for (std::size_t j = m_normalsIncidence.offsets[i]; j < m_normalsIncidence.offsets[i + 1]; ++j)
+            {
+                n += m_faceNormals[m_normalsIncidence.contributions[j]];
+            }
+            n.normalize();
+            slotNormals[i] = n;
+        }
+    });
+
+    if (!vertNormIdx.empty())
+    {
+        normals.resize(vertices.size());
+        forEachRange(vertices.size(), [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                normals[i] = m_slotNormals[vertNormIdx[i]];
+            }
+        });
+    }
+}
+
+void VisualModelImpl::NormalsAccumulator::computeTangents(const VecCoord& vertices, const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                                                          const VecTexCoord& texcoords, const VecDeriv& normals, bool fixMergedUVSeams, int topologyRevision,
+                                                          VecCoord& tangents, VecCoord& bitangents, const ParallelForRange& parallelFor)
+{
+    const auto forEachRange = [&parallelFor](std::size_t size, const std::function<void(std::size_t, std::size_t)>& task)
+    {
+        if (parallelFor)
+            parallelFor(size, task);
+        else
+            task(0, size);
+    };
+
+    // the bitangents are deduced from the normals and the tangents: only the tangents are accumulated
+    const std::size_t nbTriangles = triangles.size();
+    m_faceTangents.resize(nbTriangles + 4 * quads.size());
+
+    forEachRange(nbTriangles, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Coord& v1 = vertices[triangles[i][0]];
+            const Coord& v2 = vertices[triangles[i][1]];
+            const Coord& v3 = vertices[triangles[i][2]];
+            const TexCoord& t1 = texcoords[triangles[i][0]];
+            TexCoord t2 = texcoords[triangles[i][1]];
+            TexCoord t3 = texcoords[triangles[i][2]];
+            if (fixMergedUVSeams)
+            {
+                for (Size j=0; j<TexCoord::size(); ++j)
+                {
+                    t2[j] += helper::rnear(t1[j]-t2[j]);
+                    t3[j] += helper::rnear(t1[j]-t3[j]);
+                }
+            }
+            m_faceTangents[i] = computeTangent(v1, v2, v3, t1, t2, t3);
+        }
+    });
+
+    forEachRange(quads.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const Coord& v1 = vertices[quads[i][0]];
+            const Coord& v2 = vertices[quads[i][1]];
+            const Coord& v3 = vertices[quads[i][2]];
+            const Coord& v4 = vertices[quads[i][3]];
+            const TexCoord& t1 = texcoords[quads[i][0]];
+            const TexCoord& t2 = texcoords[quads[i][1]];
+            const TexCoord& t3 = texcoords[quads[i][2]];
+            const TexCoord& t4 = texcoords[quads[i][3]];
+
+            // same splits of the quad as in VisualModelImpl::computeTangents
+            const Coord t123 = computeTangent(v1, v2, v3, t1, t2, t3);
+            const Coord t234 = computeTangent(v2, v3, v4, t2, t3, t4);
+            const Coord t341 = computeTangent(v3, v4, v1, t3, t4, t1);
+            const Coord t412 = computeTangent(v4, v1, v2, t4, t1, t2);
+
+            Coord* t = &m_faceTangents[nbTriangles + 4 * i];
+            t[0] = t123        + t341 + t412;
+            t[1] = t123 + t234        + t412;
+            t[2] = t123 + t234 + t341;
+            t[3] =        t234 + t341 + t412;
+        }
+    });
+
+    updateIncidence(m_tangentsIncidence, vertices.size(), triangles, quads, {}, topologyRevision);
+
+    tangents.resize(vertices.size());
+    bitangents.resize(vertices.size());
+    forEachRange(vertices.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            Coord t;
+            for (std::size_t j = m_tangentsIncidence.offsets[i]; j < m_tangentsIncidence.offsets[i + 1]; ++j)
+            {
+                t += m_faceTangents[m_tangentsIncidence.contributions[j]];
+            }
+
+            const Coord& n = normals[i];
+            const Coord b = sofa::type::cross(n, t.normalized());
+            bitangents[i] = b;
+            tangents[i] = sofa::type::cross(b, n);
+        }
+    });
+}
+
 void VisualModelImpl::computePositions()
 {
     const type::vector<visual_index_type> &vertPosIdx = d_vertPosIdx.getValue();
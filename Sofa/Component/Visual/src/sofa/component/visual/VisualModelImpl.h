@@ -29,11 +29,18 @@
 #include <sofa/core/visual/VisualState.h>
 #include <sofa/core/objectmodel/DataFileName.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/simulation/CpuTaskStatus.h>
 
+#include <functional>
 #include <string>
 
 #include <sofa/core/objectmodel/RenamedData.h>
 
+namespace sofa::simulation
+{
+class TaskScheduler;
+}
+
 namespace sofa::component::visual
 {
 
@@ -144,6 +151,8 @@ public:
     Data<bool> d_handleDynamicTopology; ///< True if topological changes should be handled
     Data<bool> d_fixMergedUVSeams; ///< True if UV seams should be handled even when duplicate UVs are merged
     Data<bool> d_keepLines; ///< keep and draw lines (false by default)
+    Data<bool> d_parallelNormals; ///< Compute the normals and tangents in parallel, using the task scheduler
+    Data<bool> d_asynchronousUpdate; ///< Compute the normals and tangents on a separate thread, from a copy of the positions
 
     Data< VecCoord > d_vertices2; ///< vertices of the model (only if vertices have multiple normals/texcoords, otherwise positions are used)
     core::topology::PointData< VecTexCoord > d_vtexcoords; ///< coordinates of the texture
@@ -488,6 +497,79 @@ public:
     bool removeInNode( core::objectmodel::BaseNode* node ) override { Inherit1::removeInNode(node); Inherit2::removeInNode(node); return true; }
 
 protected:
+    /**
+     * Computation of the normals and tangents where each vertex gathers the contributions of its faces.
+     * The contributions are computed once per face, then summed for each vertex in the order of the faces:
+     * the vertices are independent from each other, and the results are the same as the ones of the
+     * sequential accumulation of computeNormals and computeTangents.
+     */
+    class SOFA_COMPONENT_VISUAL_API NormalsAccumulator
+    {
+    public:
+        /// Calls a task on ranges [begin, end) covering [0, size). The task is called on the whole range if empty.
+        using ParallelForRange = std::function<void(std::size_t size, const std::function<void(std::size_t, std::size_t)>& task)>;
+
+        /// topologyRevision must change when the faces or the normal indices change
+        void computeNormals(const VecCoord& vertices, const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                            const type::vector<visual_index_type>& vertNormIdx, int topologyRevision,
+                            VecDeriv& normals, const ParallelForRange& parallelFor);
+
+        void computeTangents(const VecCoord& vertices, const VecVisualTriangle& triangles, const VecVisualQuad& quads,
+                             const VecTexCoord& texcoords, const VecDeriv& normals, bool fixMergedUVSeams, int topologyRevision,
+                             VecCoord& tangents, VecCoord& bitangents, const ParallelForRange& parallelFor);
+
+    protected:
+        /// Contributions of the faces around each vertex (or each normal): the contributions of the triangle t
+        /// and of the corner c of the quad q are stored at t and nbTriangles + 4 q + c
+        struct Incidence
+        {
+            type::vector<std::size_t> offsets; ///< the contributions of the vertex i are contributions[offsets[i]..offsets[i+1]]
+            type::vector<std::size_t> contributions;
+            int revision { -1 };
+        };
+
+        static void updateIncidence(Incidence& incidence, std::size_t nbVertices, const VecVisualTriangle& triangles,
+                                    const VecVisualQuad& quads, const type::vector<visual_index_type>& vertexSlots, int topologyRevision);
+
+        Incidence m_normalsIncidence;
+        Incidence m_tangentsIncidence;
+        VecDeriv m_faceNormals;
+        VecDeriv m_slotNormals;
+        VecCoord m_faceTangents;
+    };
+
+    simulation::TaskScheduler* getTaskScheduler();
+    NormalsAccumulator::ParallelForRange getParallelForRange();
+    int getTopologyRevision() const;
+
+    /// Publishes the normals and tangents computed by the previous task, then adds a task computing them
+    /// from a copy of the current vertices to the main task scheduler. The normals and tangents are then one update late.
+    void updateNormalsAsynchronously();
+    void waitAsynchronousUpdate();
+
+    NormalsAccumulator m_normalsAccumulator;
+    simulation::TaskScheduler* m_taskScheduler { nullptr };
+
+    /// Copy of the mesh used by the asynchronous task, and results of the asynchronous task
+    struct AsynchronousBuffers
+    {
+        VecCoord vertices;
+        VecVisualTriangle triangles;
+        VecVisualQuad quads;
+        type::vector<visual_index_type> vertNormIdx;
+        VecTexCoord texcoords;
+        int topologyRevision { -1 };
+        bool fixMergedUVSeams { true };
+        bool updateTangents { false };
+
+        VecDeriv normals;
+        VecCoord tangents;
+        VecCoord bitangents;
+    };
+    AsynchronousBuffers m_asynchronousBuffers;
+    simulation::CpuTaskStatus m_asynchronousUpdateStatus;
+    bool m_asynchronousUpdatePending { false };
+
     /// Internal buffer to be filled by topology Data @sa d_triangles callback when points are removed. Those dirty triangles will be updated at next updateVisual
     /// This avoid to update the whole mesh.
     std::set< sofa::core::topology::BaseMeshTopology::TriangleID> m_dirtyTriangles;
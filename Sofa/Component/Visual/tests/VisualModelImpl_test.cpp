@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 #include <sofa/component/visual/VisualModelImpl.h>
 #include <sofa/defaulttype/VecTypes.h>
+#include <sofa/core/visual/VisualParams.h>
+#include <cmath>
 
 namespace sofa {
 
@@ -120,4 +122,129 @@ TEST( VisualModelImpl_test , checkThatMembersAreCorrectlyConstructed )
     ASSERT_EQ(1u, visualModel.xforms.size());
 }
 
+namespace
+{
+using component::visual::VisualModelImpl;
+
+/// Positions of a bumpy n x n grid, moving with the phase
+VisualModelImpl::VecCoord bumpyGrid(std::size_t n, double phase)
+{
+    VisualModelImpl::VecCoord positions;
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double x = static_cast<double>(i);
+            const double y = static_cast<double>(j);
+            positions.emplace_back(x, y, 0.3 * std::sin(0.7 * x + phase) * std::cos(0.5 * y - phase));
+        }
+    }
+    return positions;
+}
+
+/// Triangulated n x n grid with texture coordinates, computing its tangents
+void setupGrid(VisualModelImpl& visualModel, std::size_t n, bool parallelNormals, bool asynchronousUpdate)
+{
+    VisualModelImpl::VecVisualTriangle triangles;
+    VisualModelImpl::VecTexCoord texcoords;
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            texcoords.emplace_back(static_cast<float>(i) / n, static_cast<float>(j) / n);
+            if (i + 1 < n && j + 1 < n)
+            {
+                const auto p = static_cast<VisualModelImpl::visual_index_type>(j * n + i);
+                const auto q = static_cast<VisualModelImpl::visual_index_type>(n);
+                triangles.push_back({p, p + 1, p + q + 1});
+                triangles.push_back({p, p + q + 1, p + q});
+            }
+        }
+    }
+
+    VisualModelImpl::VecCoord positions = bumpyGrid(n, 0.0);
+    visualModel.setVertices(&positions);
+    visualModel.d_triangles.setValue(triangles);
+    visualModel.d_vtexcoords.setValue(texcoords);
+    visualModel.d_computeTangents.setValue(true);
+    visualModel.d_parallelNormals.setValue(parallelNormals);
+    visualModel.d_asynchronousUpdate.setValue(asynchronousUpdate);
+    visualModel.init();
+}
+
+void moveGrid(VisualModelImpl& visualModel, std::size_t n, double phase)
+{
+    VisualModelImpl::VecCoord positions = bumpyGrid(n, phase);
+    visualModel.setVertices(&positions);
+    visualModel.modified = true;
+    visualModel.doUpdateVisual(core::visual::visualparams::defaultInstance());
+}
+
+template <class VecType>
+void expectNear(const VecType& expected, const VecType& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        for (std::size_t c = 0; c < expected[i].size(); ++c)
+        {
+            EXPECT_NEAR(expected[i][c], actual[i][c], 1e-12) << "vertex " << i;
+        }
+    }
+}
+}
+
+TEST( VisualModelImpl_test , parallelNormalsAndTangentsMatchSequential )
+{
+    constexpr std::size_t n = 40;
+    StubVisualModelImpl sequential;
+    StubVisualModelImpl parallel;
+    setupGrid(sequential, n, false, false);
+    setupGrid(parallel, n, true, false);
+
+    for (const double phase : {0.1, 0.2, 0.3})
+    {
+        moveGrid(sequential, n, phase);
+        moveGrid(parallel, n, phase);
+
+        ASSERT_EQ(n * n, sequential.getVnormals().size());
+        ASSERT_EQ(n * n, sequential.getVtangents().size());
+        expectNear(sequential.getVnormals(), parallel.getVnormals());
+        expectNear(sequential.getVtangents(), parallel.getVtangents());
+        expectNear(sequential.getVbitangents(), parallel.getVbitangents());
+    }
+}
+
+TEST( VisualModelImpl_test , asynchronousUpdatePublishesOneUpdateLater )
+{
+    constexpr std::size_t n = 40;
+    StubVisualModelImpl reference;
+    StubVisualModelImpl asynchronous;
+    setupGrid(reference, n, false, false);
+    setupGrid(asynchronous, n, false, true);
+
+    const std::vector<double> phases { 0.1, 0.2, 0.3, 0.4 };
+    std::vector<VisualModelImpl::VecDeriv> normals;
+    std::vector<VisualModelImpl::VecCoord> tangents;
+    for (const double phase : phases)
+    {
+        moveGrid(reference, n, phase);
+        normals.push_back(reference.getVnormals());
+        tangents.push_back(reference.getVtangents());
+    }
+
+    // the first update has nothing to publish yet: it is computed synchronously
+    moveGrid(asynchronous, n, phases[0]);
+    expectNear(normals[0], asynchronous.getVnormals());
+    expectNear(tangents[0], asynchronous.getVtangents());
+
+    // then each update publishes the normals and tangents of the previous positions
+    for (std::size_t k = 1; k < phases.size(); ++k)
+    {
+        moveGrid(asynchronous, n, phases[k]);
+        expectNear(normals[k - 1], asynchronous.getVnormals());
+        expectNear(tangents[k - 1], asynchronous.getVtangents());
+    }
+}
+
 } //sofa
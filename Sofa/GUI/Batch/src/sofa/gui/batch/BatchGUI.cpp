@@ -31,10 +31,12 @@
 
 #include <cxxopts.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <iomanip>
 #include <sofa/gui/batch/ProgressBar.h>
+#include <sofa/gui/batch/BatchRunner.h>
 
 
 namespace sofa::gui::batch
@@ -57,6 +59,11 @@ BatchGUI::~BatchGUI()
 
 int BatchGUI::mainLoop()
 {
+    if (!batchScenes.empty())
+    {
+        return runBatchScenes();
+    }
+
     if (groot)
     {   
         if (nbIter != -1)
@@ -124,6 +131,35 @@ int BatchGUI::mainLoop()
     return 0;
 }
 
+int BatchGUI::runBatchScenes() const
+{
+    if (nbIter == -1)
+    {
+        msg_error("BatchGUI") << "The instances of a batch file cannot be run for infinite iterations.";
+        return 1;
+    }
+
+    std::vector<BatchRunner::Instance> instances;
+    if (!BatchRunner::readInstances(batchScenes, instances))
+    {
+        return 1;
+    }
+
+    BatchRunner runner;
+    for (const auto& instance : instances)
+    {
+        runner.addInstance(instance);
+    }
+    runner.run(nbIter, batchThreads);
+
+    msg_info("BatchGUI") << "Writing " << batchOutput;
+    std::ofstream out(batchOutput);
+    runner.writeResults(out);
+
+    const auto& results = runner.getResults();
+    return std::all_of(results.begin(), results.end(), [](const BatchRunner::RunResult& r) { return r.error.empty(); }) ? 0 : 1;
+}
+
 void BatchGUI::redraw()
 {
 }
@@ -203,6 +239,21 @@ int BatchGUI::RegisterGUIParameters(ArgumentParser* argumentParser)
         "hideProgressBar",
         "if defined, hides the progress bar"
     );
+    argumentParser->addArgument(
+        cxxopts::value<std::string>(batchScenes),
+        "batchScenes",
+        "(only batch) File listing scene instances to simulate concurrently instead of the loaded scene, one per line: <scene file> [@/path/to/object.data=value ...] [scene argument ...]"
+    );
+    argumentParser->addArgument(
+        cxxopts::value<int>(batchThreads)->default_value("0"),
+        "batchThreads",
+        "(only batch) Number of threads simulating the instances of the batch file (0: one per core)"
+    );
+    argumentParser->addArgument(
+        cxxopts::value<std::string>(batchOutput)->default_value("batch_results.json"),
+        "batchOutput",
+        "(only batch) Json file receiving the timings and the final states of the instances of the batch file"
+    );
     return 0;
 }
 
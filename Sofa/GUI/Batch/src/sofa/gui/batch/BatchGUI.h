@@ -85,6 +85,14 @@ protected:
     static std::string nbIterInp;
     inline static bool hideProgressBar { false };
 
+    /// batch file listing scene instances to run concurrently (@sa BatchRunner), instead of the loaded scene
+    inline static std::string batchScenes;
+    inline static int batchThreads { 0 };
+    inline static std::string batchOutput { "batch_results.json" };
+
+    /// Runs the instances of the batch file @sa batchScenes and writes their results in @sa batchOutput
+    int runBatchScenes() const;
+
     /// Return true if the timer output string has a json string and the timer is setup to output json
     static bool canExportJson(const std::string& timerOutputStr, const std::string& timerId);
 
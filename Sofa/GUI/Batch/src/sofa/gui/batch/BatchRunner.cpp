@@ -0,0 +1,381 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/gui/batch/BatchRunner.h>
+
+#include <sofa/core/PathResolver.h>
+#include <sofa/core/behavior/BaseMechanicalState.h>
+#include <sofa/core/objectmodel/BaseData.h>
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/thread/CTime.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/CpuTaskStatus.h>
+
+#include <json.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+namespace sofa::gui::batch
+{
+
+using sofa::helper::system::thread::CTime;
+using sofa::helper::system::thread::ctime_t;
+using json = sofa::helper::json;
+
+namespace
+{
+double elapsedSeconds(const ctime_t start)
+{
+    return static_cast<double>(CTime::getRefTime() - start) / static_cast<double>(CTime::getRefTicksPerSec());
+}
+
+/// CPU time consumed by the calling thread, in seconds
+double threadCpuTime()
+{
+#ifdef WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return 0.0;
+    }
+    // the times are given in units of 100 nanoseconds
+    const auto toSeconds = [](const FILETIME& time)
+    {
+        return (static_cast<double>(time.dwHighDateTime) * 4294967296.0 + static_cast<double>(time.dwLowDateTime)) * 1e-7;
+    };
+    return toSeconds(kernelTime) + toSeconds(userTime);
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+#endif
+}
+}
+
+bool BatchRunner::readInstances(const std::string& batchFilename, std::vector<Instance>& instances)
+{
+    std::ifstream in(batchFilename);
+    if (!in.is_open())
+    {
+        msg_error("BatchRunner") << "Cannot read the batch file " << batchFilename;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+        {
+            continue;
+        }
+        instances.push_back(parseInstance(line));
+    }
+    return true;
+}
+
+BatchRunner::Instance BatchRunner::parseInstance(const std::string& line)
+{
+    Instance instance;
+    std::istringstream words(line);
+    words >> instance.filename;
+
+    std::string word;
+    while (words >> word)
+    {
+        const auto equal = word.find('=');
+        if (word.front() == '@' && equal != std::string::npos)
+        {
+            instance.dataValues.emplace_back(word.substr(0, equal), word.substr(equal + 1));
+        }
+        else
+        {
+            instance.sceneArguments.push_back(word);
+        }
+    }
+    return instance;
+}
+
+void BatchRunner::addInstance(const Instance& instance)
+{
+    m_instances.push_back(instance);
+}
+
+void BatchRunner::run(const int nbIterations, const int nbThreads)
+{
+    const ctime_t start = CTime::getRefTime();
+
+    // The main task scheduler is shared with the components of the scenes and the rest of the application:
+    // it is initialized only if it has not been yet
+    simulation::TaskScheduler* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+    assert(taskScheduler != nullptr);
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(static_cast<unsigned int>(std::max(nbThreads, 0)));
+    }
+    else if (nbThreads > 0 && taskScheduler->getThreadCount() != static_cast<unsigned int>(nbThreads))
+    {
+        msg_warning("BatchRunner") << "The main task scheduler is already initialized: its "
+                                   << taskScheduler->getThreadCount() << " threads are used instead of " << nbThreads;
+    }
+    m_nbThreads = static_cast<int>(taskScheduler->getThreadCount());
+
+    m_roots.assign(m_instances.size(), nullptr);
+    m_results.assign(m_instances.size(), RunResult());
+
+    // The scene loaders and the object factory are not thread-safe: the instances are loaded one after the other
+    for (std::size_t i = 0; i < m_instances.size(); ++i)
+    {
+        load(i);
+    }
+
+    msg_info("BatchRunner") << "Simulating " << m_instances.size() << " instances, " << nbIterations
+                            << " iterations each, on " << m_nbThreads << " threads.";
+
+    std::vector<std::size_t> loadedInstances;
+    for (std::size_t i = 0; i < m_instances.size(); ++i)
+    {
+        if (m_roots[i])
+        {
+            loadedInstances.push_back(i);
+        }
+    }
+
+    // The instances are not tasks of the scheduler: a thread waiting for the tasks of its instance could steal
+    // another instance, and simulate it entirely in the middle of a step. Instead, one runner task per thread
+    // (at most one per instance) takes the instances one after the other, which balances the instances of
+    // different costs. The runners wait for each other before starting, so that none of them remains in the
+    // queues of the scheduler: only the tasks of the parallel components can be stolen.
+    const std::size_t nbRunners = std::min(loadedInstances.size(), static_cast<std::size_t>(std::max(m_nbThreads, 1)));
+    std::atomic<std::size_t> nbStartedRunners { 0 };
+    std::atomic<std::size_t> nextInstance { 0 };
+
+    simulation::CpuTaskStatus status;
+    for (std::size_t r = 0; r < nbRunners; ++r)
+    {
+        taskScheduler->addTask(status, [this, &loadedInstances, &nbStartedRunners, &nextInstance, nbRunners, nbIterations]()
+        {
+            ++nbStartedRunners;
+            while (nbStartedRunners.load() < nbRunners)
+            {
+                std::this_thread::yield();
+            }
+
+            for (std::size_t k = nextInstance++; k < loadedInstances.size(); k = nextInstance++)
+            {
+                simulate(loadedInstances[k], nbIterations);
+                collectStates(loadedInstances[k]);
+            }
+        });
+    }
+    taskScheduler->workUntilDone(&status);
+
+    for (auto& root : m_roots)
+    {
+        if (root)
+        {
+            sofa::simulation::node::unload(root);
+            root.reset();
+        }
+    }
+
+    m_totalTime = elapsedSeconds(start);
+    msg_info("BatchRunner") << m_instances.size() << " instances done in " << m_totalTime << " s.";
+}
+
+void BatchRunner::load(const std::size_t instanceId)
+{
+    const Instance& instance = m_instances[instanceId];
+    RunResult& result = m_results[instanceId];
+    const ctime_t start = CTime::getRefTime();
+
+    std::string filename = instance.filename;
+    if (!sofa::helper::system::DataRepository.findFile(filename))
+    {
+        result.error = "scene file not found";
+        msg_error("BatchRunner") << "Instance " << instanceId << ": cannot find " << instance.filename;
+        return;
+    }
+
+    const sofa::simulation::NodeSPtr root = sofa::simulation::node::load(filename, false, instance.sceneArguments);
+    if (!root)
+    {
+        result.error = "scene cannot be loaded";
+        msg_error("BatchRunner") << "Instance " << instanceId << ": cannot load " << filename;
+        return;
+    }
+
+    for (const auto& [path, value] : instance.dataValues)
+    {
+        core::objectmodel::BaseData* data = core::PathResolver::FindBaseDataFromPath(root.get(), path);
+        if (!data || !data->read(value))
+        {
+            result.error = "cannot set " + path;
+            msg_error("BatchRunner") << "Instance " << instanceId << ": cannot set " << path << " to " << value;
+            sofa::simulation::node::unload(root);
+            return;
+        }
+    }
+
+    sofa::simulation::node::initRoot(root.get());
+    m_roots[instanceId] = root;
+    result.loadingTime = elapsedSeconds(start);
+}
+
+void BatchRunner::simulate(const std::size_t instanceId, const int nbIterations)
+{
+    RunResult& result = m_results[instanceId];
+    sofa::simulation::Node* root = m_roots[instanceId].get();
+
+    const ctime_t start = CTime::getRefTime();
+    const double cpuStart = threadCpuTime();
+    try
+    {
+        for (int i = 0; i < nbIterations; ++i)
+        {
+            const ctime_t stepStart = CTime::getRefTime();
+            const double stepCpuStart = threadCpuTime();
+            sofa::simulation::node::animate(root);
+            result.maxStepTime = std::max(result.maxStepTime, elapsedSeconds(stepStart));
+            result.maxStepCpuTime = std::max(result.maxStepCpuTime, threadCpuTime() - stepCpuStart);
+            ++result.nbIterations;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        result.error = e.what();
+        msg_error("BatchRunner") << "Instance " << instanceId << ": " << e.what();
+    }
+
+    result.wallTime = elapsedSeconds(start);
+    result.cpuTime = threadCpuTime() - cpuStart;
+    result.meanStepTime = result.nbIterations > 0 ? result.wallTime / result.nbIterations : 0.0;
+    result.simulatedTime = root->getTime();
+}
+
+void BatchRunner::collectStates(const std::size_t instanceId)
+{
+    RunResult& result = m_results[instanceId];
+
+    std::vector<core::behavior::BaseMechanicalState*> states;
+    m_roots[instanceId]->getTreeObjects<core::behavior::BaseMechanicalState>(&states);
+    for (const core::behavior::BaseMechanicalState* state : states)
+    {
+        StateResult stateResult;
+        stateResult.path = state->getPathName();
+        stateResult.size = state->getSize();
+
+        if (stateResult.size > 0)
+        {
+            std::fill(std::begin(stateResult.min), std::end(stateResult.min), std::numeric_limits<SReal>::max());
+            std::fill(std::begin(stateResult.max), std::end(stateResult.max), std::numeric_limits<SReal>::lowest());
+            for (std::size_t i = 0; i < stateResult.size; ++i)
+            {
+                const SReal p[3] = { state->getPX(i), state->getPY(i), state->getPZ(i) };
+                for (int c = 0; c < 3; ++c)
+                {
+                    stateResult.center[c] += p[c];
+                    stateResult.min[c] = std::min(stateResult.min[c], p[c]);
+                    stateResult.max[c] = std::max(stateResult.max[c], p[c]);
+                }
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                stateResult.center[c] /= static_cast<SReal>(stateResult.size);
+            }
+        }
+        result.states.push_back(stateResult);
+    }
+}
+
+void BatchRunner::writeResults(std::ostream& out) const
+{
+    json runs = json::array();
+    for (std::size_t i = 0; i < m_instances.size(); ++i)
+    {
+        const Instance& instance = m_instances[i];
+        const RunResult& result = m_results[i];
+
+        json dataValues = json::object();
+        for (const auto& [path, value] : instance.dataValues)
+        {
+            dataValues[path] = value;
+        }
+
+        json states = json::array();
+        for (const StateResult& state : result.states)
+        {
+            states.push_back({
+                {"path", state.path},
+                {"size", state.size},
+                {"center", {state.center[0], state.center[1], state.center[2]}},
+                {"min", {state.min[0], state.min[1], state.min[2]}},
+                {"max", {state.max[0], state.max[1], state.max[2]}}
+            });
+        }
+
+        runs.push_back({
+            {"id", i},
+            {"scene", instance.filename},
+            {"dataValues", dataValues},
+            {"sceneArguments", instance.sceneArguments},
+            {"status", result.error.empty() ? "ok" : result.error},
+            {"iterations", result.nbIterations},
+            {"simulatedTime", result.simulatedTime},
+            {"loadingTime", result.loadingTime},
+            {"wallTime", result.wallTime},
+            {"meanStepTime", result.meanStepTime},
+            {"maxStepTime", result.maxStepTime},
+            {"cpuTime", result.cpuTime},
+            {"maxStepCpuTime", result.maxStepCpuTime},
+            {"states", states}
+        });
+    }
+
+    const json results = {
+        {"nbThreads", m_nbThreads},
+        {"totalTime", m_totalTime},
+        {"runs", runs}
+    };
+    out << std::setw(4) << results << std::endl;
+}
+
+} // namespace sofa::gui::batch
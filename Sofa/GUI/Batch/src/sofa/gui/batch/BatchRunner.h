@@ -0,0 +1,114 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/gui/batch/config.h>
+#include <sofa/simulation/fwd.h>
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sofa::gui::batch
+{
+
+/**
+ * Runs several scene instances in one process: the plugins are loaded once, then each instance
+ * is loaded in its own simulation root, and the instances are simulated concurrently on the threads
+ * of the main task scheduler, each instance by a single thread. The parallel components of the scenes
+ * add their tasks to the same scheduler, from the thread running their instance.
+ *
+ * The wall times of an instance include the time its thread spends on the tasks of the other instances
+ * while waiting for its own tasks. The CPU times only measure the thread simulating the instance: they
+ * do not depend on the load of the machine, but they do not include the tasks run by the other threads.
+ *
+ * An instance is described by one line of a batch file:
+ *     <scene file> [@/path/to/object.data=value ...] [scene argument ...]
+ * The Data values are set after the scene is loaded, before its initialization.
+ * The other words are given to the scene loader as scene arguments (e.g. to Python scenes).
+ * Empty lines and lines starting with # are ignored.
+ */
+class SOFA_GUI_BATCH_API BatchRunner
+{
+public:
+    struct Instance
+    {
+        std::string filename;
+        std::vector<std::pair<std::string, std::string> > dataValues;
+        std::vector<std::string> sceneArguments;
+    };
+
+    struct StateResult
+    {
+        std::string path;
+        std::size_t size { 0 };
+        SReal center[3] {};
+        SReal min[3] {};
+        SReal max[3] {};
+    };
+
+    struct RunResult
+    {
+        std::string error; ///< empty if the instance has been loaded and simulated
+        int nbIterations { 0 };
+        SReal simulatedTime { 0 };
+        double loadingTime { 0 }; ///< in seconds
+        double wallTime { 0 }; ///< in seconds, for all the iterations
+        double meanStepTime { 0 }; ///< in seconds
+        double maxStepTime { 0 }; ///< in seconds
+        double cpuTime { 0 }; ///< in seconds, CPU time of the thread simulating the instance, for all the iterations
+        double maxStepCpuTime { 0 }; ///< in seconds, CPU time of the thread simulating the instance
+        std::vector<StateResult> states;
+    };
+
+    /// Parses the instances of a batch file. Returns false if the file cannot be read.
+    static bool readInstances(const std::string& batchFilename, std::vector<Instance>& instances);
+    static Instance parseInstance(const std::string& line);
+
+    void addInstance(const Instance& instance);
+
+    /// Loads all the instances, then simulates nbIterations steps of each of them, using nbThreads threads (0: one per core).
+    /// If the main task scheduler is already initialized, its threads are used.
+    void run(int nbIterations, int nbThreads);
+
+    const std::vector<Instance>& getInstances() const { return m_instances; }
+    const std::vector<RunResult>& getResults() const { return m_results; }
+    double getTotalTime() const { return m_totalTime; }
+    int getNbThreads() const { return m_nbThreads; }
+
+    /// Writes the instances and their results as json
+    void writeResults(std::ostream& out) const;
+
+protected:
+    void load(std::size_t instanceId);
+    void simulate(std::size_t instanceId, int nbIterations);
+    void collectStates(std::size_t instanceId);
+
+    std::vector<Instance> m_instances;
+    std::vector<sofa::simulation::NodeSPtr> m_roots;
+    std::vector<RunResult> m_results;
+    double m_totalTime { 0 };
+    int m_nbThreads { 0 };
+};
+
+} // namespace sofa::gui::batch
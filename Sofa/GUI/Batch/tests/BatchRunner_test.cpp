@@ -0,0 +1,196 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/gui/batch/BatchRunner.h>
+
+#include <sofa/testing/BaseSimulationTest.h>
+#include <sofa/simpleapi/SimpleApi.h>
+
+#include <json.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+using sofa::gui::batch::BatchRunner;
+using json = sofa::helper::json;
+
+/// A 1D particle moving at a constant velocity: after n steps, its position is n * dt * velocity
+constexpr const char* particleScene =
+    "<?xml version='1.0'?>"
+    "<Node name='root' gravity='0 0 0' dt='0.01'>"
+    "    <DefaultAnimationLoop/>"
+    "    <Node name='particle'>"
+    "        <EulerExplicitSolver/>"
+    "        <MechanicalObject name='dofs' template='Vec1d' position='0' velocity='1'/>"
+    "        <UniformMass totalMass='1'/>"
+    "    </Node>"
+    "</Node>";
+
+class BatchRunner_test : public sofa::testing::BaseSimulationTest
+{
+public:
+    void onSetUp() override
+    {
+        sofa::simpleapi::importPlugin("Sofa.Component.AnimationLoop");
+        sofa::simpleapi::importPlugin("Sofa.Component.ODESolver.Forward");
+        sofa::simpleapi::importPlugin("Sofa.Component.StateContainer");
+        sofa::simpleapi::importPlugin("Sofa.Component.Mass");
+
+        m_directory = std::filesystem::temp_directory_path() / "BatchRunner_test";
+        std::filesystem::create_directories(m_directory);
+        m_sceneFilename = writeFile("particle.scn", particleScene);
+    }
+
+    void onTearDown() override
+    {
+        std::error_code error;
+        std::filesystem::remove_all(m_directory, error);
+    }
+
+    std::string writeFile(const std::string& name, const std::string& content) const
+    {
+        const std::string filename = (m_directory / name).string();
+        std::ofstream out(filename);
+        out << content;
+        return filename;
+    }
+
+    static json runAndWriteResults(BatchRunner& runner, int nbIterations, int nbThreads)
+    {
+        runner.run(nbIterations, nbThreads);
+        std::stringstream out;
+        runner.writeResults(out);
+        return json::parse(out.str());
+    }
+
+    std::filesystem::path m_directory;
+    std::string m_sceneFilename;
+};
+
+TEST_F(BatchRunner_test, parseInstance)
+{
+    const BatchRunner::Instance instance = BatchRunner::parseInstance(
+        "scene.scn @/particle/dofs.velocity=2 @/.dt=0.02 --argument value");
+
+    EXPECT_EQ(instance.filename, "scene.scn");
+    ASSERT_EQ(instance.dataValues.size(), 2u);
+    EXPECT_EQ(instance.dataValues[0].first, "@/particle/dofs.velocity");
+    EXPECT_EQ(instance.dataValues[0].second, "2");
+    EXPECT_EQ(instance.dataValues[1].first, "@/.dt");
+    EXPECT_EQ(instance.dataValues[1].second, "0.02");
+    ASSERT_EQ(instance.sceneArguments.size(), 2u);
+    EXPECT_EQ(instance.sceneArguments[0], "--argument");
+    EXPECT_EQ(instance.sceneArguments[1], "value");
+}
+
+TEST_F(BatchRunner_test, readInstances)
+{
+    const std::string batchFilename = writeFile("instances.txt",
+        "# comment\n"
+        "\n"
+        "first.scn @/particle/dofs.velocity=2\n"
+        "   \t\n"
+        "  # indented comment\n"
+        "second.scn argument\n");
+
+    std::vector<BatchRunner::Instance> instances;
+    ASSERT_TRUE(BatchRunner::readInstances(batchFilename, instances));
+    ASSERT_EQ(instances.size(), 2u);
+    EXPECT_EQ(instances[0].filename, "first.scn");
+    ASSERT_EQ(instances[0].dataValues.size(), 1u);
+    EXPECT_TRUE(instances[0].sceneArguments.empty());
+    EXPECT_EQ(instances[1].filename, "second.scn");
+    EXPECT_TRUE(instances[1].dataValues.empty());
+    ASSERT_EQ(instances[1].sceneArguments.size(), 1u);
+    EXPECT_EQ(instances[1].sceneArguments[0], "argument");
+
+    EXPECT_MSG_EMIT(Error);
+    EXPECT_FALSE(BatchRunner::readInstances((m_directory / "missing.txt").string(), instances));
+}
+
+TEST_F(BatchRunner_test, runConcurrentInstancesWithDataValues)
+{
+    BatchRunner runner;
+    runner.addInstance(BatchRunner::parseInstance(m_sceneFilename));
+    runner.addInstance(BatchRunner::parseInstance(m_sceneFilename + " @/particle/dofs.velocity=2"));
+
+    constexpr int nbIterations = 10;
+    const json results = runAndWriteResults(runner, nbIterations, 2);
+
+    EXPECT_EQ(results["nbThreads"].get<int>(), runner.getNbThreads());
+    EXPECT_GE(results["totalTime"].get<double>(), 0.0);
+
+    const json& runs = results["runs"];
+    ASSERT_EQ(runs.size(), 2u);
+    const double expectedPositions[2] = { nbIterations * 0.01 * 1.0, nbIterations * 0.01 * 2.0 };
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        const json& run = runs[i];
+        EXPECT_EQ(run["id"].get<std::size_t>(), i);
+        EXPECT_EQ(run["scene"].get<std::string>(), m_sceneFilename);
+        EXPECT_EQ(run["status"].get<std::string>(), "ok");
+        EXPECT_EQ(run["iterations"].get<int>(), nbIterations);
+        EXPECT_NEAR(run["simulatedTime"].get<double>(), nbIterations * 0.01, 1e-12);
+        EXPECT_GE(run["cpuTime"].get<double>(), 0.0);
+        EXPECT_GE(run["maxStepCpuTime"].get<double>(), 0.0);
+        EXPECT_LE(run["maxStepCpuTime"].get<double>(), run["cpuTime"].get<double>());
+
+        const json& states = run["states"];
+        ASSERT_EQ(states.size(), 1u);
+        EXPECT_EQ(states[0]["path"].get<std::string>(), "/particle/dofs");
+        EXPECT_EQ(states[0]["size"].get<std::size_t>(), 1u);
+        EXPECT_NEAR(states[0]["center"][0].get<double>(), expectedPositions[i], 1e-12);
+    }
+    EXPECT_TRUE(runs[0]["dataValues"].empty());
+    EXPECT_EQ(runs[1]["dataValues"]["@/particle/dofs.velocity"].get<std::string>(), "2");
+}
+
+TEST_F(BatchRunner_test, missingSceneStatus)
+{
+    BatchRunner runner;
+    runner.addInstance(BatchRunner::parseInstance((m_directory / "missing.scn").string()));
+    runner.addInstance(BatchRunner::parseInstance(m_sceneFilename + " @/particle/missing.velocity=2"));
+    runner.addInstance(BatchRunner::parseInstance(m_sceneFilename));
+
+    json results;
+    {
+        EXPECT_MSG_EMIT(Error);
+        results = runAndWriteResults(runner, 5, 1);
+    }
+
+    const json& runs = results["runs"];
+    ASSERT_EQ(runs.size(), 3u);
+    EXPECT_EQ(runs[0]["status"].get<std::string>(), "scene file not found");
+    EXPECT_EQ(runs[0]["iterations"].get<int>(), 0);
+    EXPECT_TRUE(runs[0]["states"].empty());
+    EXPECT_EQ(runs[1]["status"].get<std::string>(), "cannot set @/particle/missing.velocity");
+    EXPECT_EQ(runs[1]["iterations"].get<int>(), 0);
+
+    // a failing instance does not prevent the others from running
+    EXPECT_EQ(runs[2]["status"].get<std::string>(), "ok");
+    EXPECT_EQ(runs[2]["iterations"].get<int>(), 5);
+}
+
+}
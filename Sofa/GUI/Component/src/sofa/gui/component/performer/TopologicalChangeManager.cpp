@@ -59,48 +59,10 @@ TopologicalChangeManager::~TopologicalChangeManager()
 {
 }
 
-Index TopologicalChangeManager::removeItemsFromTriangleModel(TriangleCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const
+Index TopologicalChangeManager::collectItemsFromTopology(sofa::core::topology::BaseMeshTopology* topo_curr, std::set<Index> items, RemovalBatch& batch) const
 {
-    sofa::core::topology::BaseMeshTopology* topo_curr;
-    topo_curr = model->getCollisionTopology();
-
-    if(topo_curr == nullptr)
-        return 0;
-
-    std::set< unsigned int > items;
-
     const simulation::Node *node_curr = dynamic_cast<simulation::Node*>(topo_curr->getContext());
 
-    if (topo_curr->getNbTetrahedra() > 0)
-    {
-        // get the index of the tetra linked to each triangle
-        for (unsigned int i=0; i<indices.size(); ++i)
-            items.insert(topo_curr->getTetrahedraAroundTriangle(indices[i])[0]);
-    }
-    else if (topo_curr->getNbHexahedra() > 0)
-    {
-        // get the index of the hexa linked to each quad
-        for (unsigned int i=0; i<indices.size(); ++i)
-            items.insert(topo_curr->getHexahedraAroundQuad(indices[i]/2)[0]);
-    }
-    else
-    {
-        //Quick HACK for Hexa2TetraMapping
-        sofa::component::topology::mapping::Hexa2TetraTopologicalMapping* badMapping;
-        model->getContext()->get(badMapping, sofa::core::objectmodel::BaseContext::SearchUp);
-        if(badMapping) //stop process
-        {
-            msg_warning("TopologicalChangeManager") << " Removing element is not handle by Hexa2TetraTopologicalMapping. Stopping process." ;
-            return 0;
-        }
-
-        const auto nbt = topo_curr->getNbTriangles();
-        for (unsigned int i=0; i<indices.size(); ++i)
-        {
-            items.insert(indices[i] < nbt ? indices[i] : (indices[i]+nbt)/2);
-        }
-    }
-
     bool is_topoMap = true;
 
     while(is_topoMap)
@@ -114,13 +76,11 @@ Index TopologicalChangeManager::removeItemsFromTriangleModel(TriangleCollisionMo
             if(topoMap != nullptr && !topoMap->propagateFromOutputToInputModel())
             {
                 is_topoMap = true;
-                //unsigned int ind_glob = topoMap->getGlobIndex(ind_curr);
-                //ind_curr = topoMap->getFromIndex(ind_glob);
-                std::set< unsigned int > loc_items = items;
-                items.clear();
+                std::set< Index > loc_items;
+                loc_items.swap(items);
                 if( topoMap->isTheOutputTopologySubdividingTheInputOne())
                 {
-                    for (std::set< unsigned int >::const_iterator it=loc_items.begin(); it != loc_items.end(); ++it)
+                    for (std::set< Index >::const_iterator it=loc_items.begin(); it != loc_items.end(); ++it)
                     {
                         const unsigned int ind_glob = topoMap->getGlobIndex(*it);
                         unsigned int ind = topoMap->getFromIndex(ind_glob);
@@ -129,14 +89,12 @@ Index TopologicalChangeManager::removeItemsFromTriangleModel(TriangleCollisionMo
                 }
                 else
                 {
-                    for (std::set< unsigned int >::const_iterator it=loc_items.begin(); it != loc_items.end(); ++it)
+                    vector<Index> indices;
+                    for (std::set< Index >::const_iterator it=loc_items.begin(); it != loc_items.end(); ++it)
                     {
-                        vector<Index> indices;
+                        indices.clear();
                         topoMap->getFromIndex( indices, *it);
-                        for( auto itIndices = indices.begin(); itIndices != indices.end(); ++itIndices)
-                        {
-                            items.insert( *itIndices );
-                        }
+                        items.insert( indices.begin(), indices.end() );
                     }
                 }
                 topo_curr = topoMap->getFrom();
@@ -147,150 +105,92 @@ Index TopologicalChangeManager::removeItemsFromTriangleModel(TriangleCollisionMo
         }
     }
 
-    sofa::type::vector<Index> vitems;
-    vitems.reserve(items.size());
-    vitems.insert(vitems.end(), items.rbegin(), items.rend());
-
-    const Index res = vitems.size();
-
     sofa::core::topology::TopologyModifier* topoMod;
     topo_curr->getContext()->get(topoMod);
+    if (topoMod == nullptr)
+    {
+        msg_warning("TopologicalChangeManager") << "Cannot find a TopologyModifier to perform the changes on topology " << topo_curr->getName();
+        return 0;
+    }
 
-    topoMod->removeItems(vitems);
-
-    topoMod->notifyEndingEvent();
-
-
-    topoMod->propagateTopologicalChanges();
+    const Index res = items.size();
+    batch[topoMod].insert(items.begin(), items.end());
 
     return res;
 }
 
-
-Index TopologicalChangeManager::removeItemsFromPointModel(PointCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const
+Index TopologicalChangeManager::collectItemsFromTriangles(sofa::core::CollisionModel* model, sofa::core::topology::BaseMeshTopology* topo_curr, const type::vector<Index>& indices, RemovalBatch& batch) const
 {
-    sofa::core::topology::BaseMeshTopology* topo_curr;
-    topo_curr = model->getCollisionTopology();
-
-    if (topo_curr == nullptr)
-        return 0;
-
-    sofa::type::vector<unsigned int> tItems;
-    for (const auto i : indices)
-    {
-        const sofa::core::topology::BaseMeshTopology::TrianglesAroundVertex& triAV = topo_curr->getTrianglesAroundVertex(i);        
-        for (auto j : triAV)
-        {
-            bool found = false;
-            for (const auto k : tItems)
-            {
-                if (j == k)
-                {
-                    found = true;
-                    break;
-                }
-            }
-
-            if (!found)
-                tItems.push_back(j);
-        }
-    }
-
-    std::set< unsigned int > items;
-
-    const simulation::Node *node_curr = dynamic_cast<simulation::Node*>(topo_curr->getContext());
+    std::set< Index > items;
 
     if (topo_curr->getNbTetrahedra() > 0)
     {
         // get the index of the tetra linked to each triangle
-        for (unsigned int i = 0; i<tItems.size(); ++i)
-            items.insert(topo_curr->getTetrahedraAroundTriangle(tItems[i])[0]);
+        for (unsigned int i=0; i<indices.size(); ++i)
+            items.insert(topo_curr->getTetrahedraAroundTriangle(indices[i])[0]);
     }
     else if (topo_curr->getNbHexahedra() > 0)
     {
         // get the index of the hexa linked to each quad
-        for (unsigned int i = 0; i<tItems.size(); ++i)
-            items.insert(topo_curr->getHexahedraAroundQuad(tItems[i] / 2)[0]);
+        for (unsigned int i=0; i<indices.size(); ++i)
+            items.insert(topo_curr->getHexahedraAroundQuad(indices[i]/2)[0]);
     }
     else
     {
         //Quick HACK for Hexa2TetraMapping
         sofa::component::topology::mapping::Hexa2TetraTopologicalMapping* badMapping;
         model->getContext()->get(badMapping, sofa::core::objectmodel::BaseContext::SearchUp);
-        if (badMapping) //stop process
+        if(badMapping) //stop process
         {
-            msg_warning("TopologicalChangeManager") << " Removing element is not handle by Hexa2TetraTopologicalMapping. Stopping process.";
+            msg_warning("TopologicalChangeManager") << " Removing element is not handle by Hexa2TetraTopologicalMapping. Stopping process." ;
             return 0;
         }
 
-        const size_t nbt = topo_curr->getNbTriangles();
-        for (unsigned int i = 0; i<tItems.size(); ++i)
+        const auto nbt = topo_curr->getNbTriangles();
+        for (unsigned int i=0; i<indices.size(); ++i)
         {
-            items.insert(tItems[i] < nbt ? tItems[i] : (tItems[i] + nbt) / 2);
+            items.insert(indices[i] < nbt ? indices[i] : (indices[i]+nbt)/2);
         }
     }
 
-    bool is_topoMap = true;
+    return collectItemsFromTopology(topo_curr, std::move(items), batch);
+}
 
-    while (is_topoMap)
-    {
-        is_topoMap = false;
-        std::vector< core::objectmodel::BaseObject * > listObject;
-        node_curr->get<core::objectmodel::BaseObject>(&listObject, core::objectmodel::BaseContext::Local);
-        for (unsigned int i = 0; i<listObject.size(); ++i)
-        {
-            sofa::core::topology::TopologicalMapping *topoMap = dynamic_cast<sofa::core::topology::TopologicalMapping *>(listObject[i]);
-            if (topoMap != nullptr && !topoMap->propagateFromOutputToInputModel())
-            {
-                is_topoMap = true;
-                std::set< unsigned int > loc_items = items;
-                items.clear();
-                if (topoMap->isTheOutputTopologySubdividingTheInputOne())
-                {
-                    for (std::set< unsigned int >::const_iterator it = loc_items.begin(); it != loc_items.end(); ++it)
-                    {
-                        const unsigned int ind_glob = topoMap->getGlobIndex(*it);
-                        unsigned int ind = topoMap->getFromIndex(ind_glob);
-                        items.insert(ind);
-                    }
-                }
-                else
-                {
-                    for (auto it = loc_items.begin(); it != loc_items.end(); ++it)
-                    {
-                        vector<Index> indices;
-                        topoMap->getFromIndex(indices, *it);
-                        for (auto itIndices = indices.begin(); itIndices != indices.end(); ++itIndices)
-                        {
-                            items.insert(*itIndices);
-                        }
-                    }
-                }
-                topo_curr = topoMap->getFrom();
-                node_curr = dynamic_cast<simulation::Node*>(topo_curr->getContext());
-                break;
-            }
-        }
-    }
+Index TopologicalChangeManager::collectItemsFromTriangleModel(TriangleCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const
+{
+    sofa::core::topology::BaseMeshTopology* topo_curr;
+    topo_curr = model->getCollisionTopology();
+
+    if(topo_curr == nullptr)
+        return 0;
 
-    sofa::type::vector<Index> vitems;
-    vitems.reserve(items.size());
-    vitems.insert(vitems.end(), items.rbegin(), items.rend());
+    return collectItemsFromTriangles(model, topo_curr, indices, batch);
+}
 
-    const Index res = vitems.size();
 
+Index TopologicalChangeManager::collectItemsFromPointModel(PointCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const
+{
+    sofa::core::topology::BaseMeshTopology* topo_curr;
+    topo_curr = model->getCollisionTopology();
 
-    sofa::core::topology::TopologyModifier* topoMod;
-    topo_curr->getContext()->get(topoMod);
+    if (topo_curr == nullptr)
+        return 0;
 
-    topoMod->removeItems(vitems);
-    topoMod->notifyEndingEvent();
-    topoMod->propagateTopologicalChanges();
+    // the triangles around the vertices are removed
+    std::set< Index > triangles;
+    for (const auto i : indices)
+    {
+        const sofa::core::topology::BaseMeshTopology::TrianglesAroundVertex& triAV = topo_curr->getTrianglesAroundVertex(i);
+        triangles.insert(triAV.begin(), triAV.end());
+    }
 
-    return res;
+    type::vector<Index> tItems;
+    tItems.reserve(triangles.size());
+    tItems.insert(tItems.end(), triangles.begin(), triangles.end());
+    return collectItemsFromTriangles(model, topo_curr, tItems, batch);
 }
 
-Index TopologicalChangeManager::removeItemsFromLineModel(LineCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const
+Index TopologicalChangeManager::collectItemsFromLineModel(LineCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const
 {
     // EdgeSetTopologyContainer
     sofa::core::topology::BaseMeshTopology* topo_curr;
@@ -301,12 +201,6 @@ Index TopologicalChangeManager::removeItemsFromLineModel(LineCollisionModel<sofa
         return 0;
     }
 
-    // copy indices to have a mutable version of the vector
-    type::vector<Index> unique_indices = indices;
-    // sort followed by unique, to remove all duplicates
-    std::sort(unique_indices.begin(), unique_indices.end());
-    unique_indices.erase(std::unique(unique_indices.begin(), unique_indices.end()), unique_indices.end());
-
     EdgeSetTopologyModifier* topo_mod;
     topo_curr->getContext()->get(topo_mod);
     if(topo_mod  == nullptr){
@@ -314,14 +208,13 @@ Index TopologicalChangeManager::removeItemsFromLineModel(LineCollisionModel<sofa
         return 0;
     }
 
-    topo_mod->removeItems(unique_indices);
-
-    topo_mod->notifyEndingEvent();
+    // the set removes all duplicates
+    batch[topo_mod].insert(indices.begin(), indices.end());
 
     return indices.size();
 }
 
-Index TopologicalChangeManager::removeItemsFromSphereModel(SphereCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const
+Index TopologicalChangeManager::collectItemsFromSphereModel(SphereCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const
 {
     sofa::core::topology::BaseMeshTopology* topo_curr;
     topo_curr = model->getCollisionTopology();
@@ -329,72 +222,30 @@ Index TopologicalChangeManager::removeItemsFromSphereModel(SphereCollisionModel<
     if(dynamic_cast<PointSetTopologyContainer*>(topo_curr) == nullptr)
         return 0;
 
-    std::set< unsigned int > items;
-
-    const simulation::Node *node_curr = dynamic_cast<simulation::Node*>(topo_curr->getContext());
-
-    for (unsigned int i=0; i<indices.size(); ++i)
-        items.insert(indices[i]);
-
-    bool is_topoMap = true;
+    return collectItemsFromTopology(topo_curr, std::set< Index >(indices.begin(), indices.end()), batch);
+}
 
-    while(is_topoMap)
+Index TopologicalChangeManager::removeCollectedItems(RemovalBatch& batch) const
+{
+    Index res = 0;
+    for (auto& [topoMod, items] : batch)
     {
-        is_topoMap = false;
-
-        std::vector< core::objectmodel::BaseObject * > listObject;
-        node_curr->get<core::objectmodel::BaseObject>(&listObject, core::objectmodel::BaseContext::Local);
-        for(unsigned int i=0; i<listObject.size(); ++i)
-        {
-            sofa::core::topology::TopologicalMapping *topoMap = dynamic_cast<sofa::core::topology::TopologicalMapping *>(listObject[i]);
-            if(topoMap != nullptr && !topoMap->propagateFromOutputToInputModel())
-            {
-                is_topoMap = true;
-                std::set< unsigned int > loc_items = items;
-                items.clear();
-                if( topoMap->isTheOutputTopologySubdividingTheInputOne())
-                {
-                    for (std::set< unsigned int >::const_iterator it=loc_items.begin(); it != loc_items.end(); ++it)
-                    {
-                        const unsigned int ind_glob = topoMap->getGlobIndex(*it);
-                        unsigned int ind = topoMap->getFromIndex(ind_glob);
-                        items.insert(ind);
-                    }
-                }
-                else
-                {
-                    for (auto it=loc_items.begin(); it != loc_items.end(); ++it)
-                    {
-                        vector<Index> tmpindices;
-                        topoMap->getFromIndex( tmpindices, *it);
-                        for(auto itIndices = tmpindices.begin(); itIndices != tmpindices.end(); ++itIndices)
-                        {
-                            items.insert( *itIndices );
-                        }
-                    }
-                }
-                topo_curr = topoMap->getFrom();
-                node_curr = dynamic_cast<simulation::Node*>(topo_curr->getContext());
+        if (items.empty())
+            continue;
 
-                break;
-            }
-        }
-    }
+        // items are removed in descending order
+        sofa::type::vector<Index> vitems;
+        vitems.reserve(items.size());
+        vitems.insert(vitems.end(), items.rbegin(), items.rend());
+        res += vitems.size();
 
-    sofa::type::vector<Index> vitems;
-    vitems.reserve(items.size());
-    vitems.insert(vitems.end(), items.rbegin(), items.rend());
+        topoMod->removeItems(vitems);
 
-    const Index res = vitems.size();
+        topoMod->notifyEndingEvent();
 
-    sofa::core::topology::TopologyModifier* topoMod;
-    topo_curr->getContext()->get(topoMod);
-
-    topoMod->removeItems(vitems);
-
-    topoMod->notifyEndingEvent();
-
-    topoMod->propagateTopologicalChanges();
+        topoMod->propagateTopologicalChanges();
+    }
+    batch.clear();
 
     return res;
 }
@@ -416,22 +267,30 @@ Index TopologicalChangeManager::removeItemsFromCollisionModel(sofa::core::Collis
 
 
 Index TopologicalChangeManager::removeItemsFromCollisionModel(sofa::core::CollisionModel* model, const type::vector<Index>& indices) const
+{
+    RemovalBatch batch;
+    if (collectItemsFromCollisionModel(model, indices, batch) == 0)
+        return 0;
+    return removeCollectedItems(batch);
+}
+
+Index TopologicalChangeManager::collectItemsFromCollisionModel(sofa::core::CollisionModel* model, const type::vector<Index>& indices, RemovalBatch& batch) const
 {
     if(dynamic_cast<TriangleCollisionModel<sofa::defaulttype::Vec3Types>*>(model)!= nullptr)
     {
-        return removeItemsFromTriangleModel(static_cast<TriangleCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices);
+        return collectItemsFromTriangleModel(static_cast<TriangleCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices, batch);
     }
     if (dynamic_cast<PointCollisionModel<sofa::defaulttype::Vec3Types>*>(model) != nullptr)
     {
-        return removeItemsFromPointModel(static_cast<PointCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices);
+        return collectItemsFromPointModel(static_cast<PointCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices, batch);
     }
     else if(dynamic_cast<SphereCollisionModel<sofa::defaulttype::Vec3Types>*>(model)!= nullptr)
     {
-        return removeItemsFromSphereModel(static_cast<SphereCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices);
+        return collectItemsFromSphereModel(static_cast<SphereCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices, batch);
     }
     else if(dynamic_cast<LineCollisionModel<sofa::defaulttype::Vec3Types>*>(model)!= nullptr)
     {
-        return removeItemsFromLineModel(static_cast<LineCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices);
+        return collectItemsFromLineModel(static_cast<LineCollisionModel<sofa::defaulttype::Vec3Types>*>(model), indices, batch);
     }
     else
         return 0;
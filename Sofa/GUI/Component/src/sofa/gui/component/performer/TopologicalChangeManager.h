@@ -26,6 +26,7 @@
 
 #include <sofa/core/BehaviorModel.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
+#include <sofa/core/topology/BaseTopology.h>
 
 #include <sofa/component/collision/geometry/SphereModel.h>
 #include <sofa/component/collision/geometry/PointModel.h>
@@ -35,6 +36,11 @@
 #include <sofa/type/Vec.h>
 #include <sofa/defaulttype/VecTypes.h>
 
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace sofa::gui::component::performer
 {
 
@@ -44,6 +50,43 @@ class SOFA_GUI_COMPONENT_API TopologicalChangeManager
 public:
     using Index = sofa::Index;
 
+    /// Topological elements to remove, gathered per topology modifier.
+    /// The modifiers are iterated in the order in which they were first collected, so that the removals do not
+    /// depend on the addresses of the modifiers.
+    class RemovalBatch
+    {
+    public:
+        using Items = std::pair<sofa::core::topology::TopologyModifier*, std::set<Index> >;
+
+        /// The elements collected for a modifier, added at the end of the batch if not collected yet
+        std::set<Index>& operator[](sofa::core::topology::TopologyModifier* modifier)
+        {
+            const auto [it, inserted] = m_modifierIds.emplace(modifier, m_items.size());
+            if (inserted)
+            {
+                m_items.emplace_back(modifier, std::set<Index>());
+            }
+            return m_items[it->second].second;
+        }
+
+        auto begin() { return m_items.begin(); }
+        auto end() { return m_items.end(); }
+        auto begin() const { return m_items.begin(); }
+        auto end() const { return m_items.end(); }
+        std::size_t size() const { return m_items.size(); }
+        bool empty() const { return m_items.empty(); }
+
+        void clear()
+        {
+            m_items.clear();
+            m_modifierIds.clear();
+        }
+
+    private:
+        std::vector<Items> m_items;
+        std::unordered_map<sofa::core::topology::TopologyModifier*, std::size_t> m_modifierIds;
+    };
+
     TopologicalChangeManager();
     ~TopologicalChangeManager();
 
@@ -52,6 +95,23 @@ public:
     Index removeItemsFromCollisionModel(sofa::core::CollisionModel* model, const Index& index) const;
     Index removeItemsFromCollisionModel(sofa::core::CollisionModel* model, const type::vector<Index>& indices) const;
 
+    /** Collects the topological elements corresponding to elements of a collision model, without modifying the topology.
+     *
+     * The elements are converted to the elements of the topmost topology, as it is done by removeItemsFromCollisionModel,
+     * and added to the batch. Elements collected from several collision models (or several times) are merged, so that
+     * they can all be removed at once by @sa removeCollectedItems, before any of the indices becomes invalid.
+     *
+     * @return the number of topological elements added to the batch.
+     */
+    Index collectItemsFromCollisionModel(sofa::core::CollisionModel* model, const type::vector<Index>& indices, RemovalBatch& batch) const;
+
+    /** Removes the elements of a batch, with a single removal and a single propagation of the topological changes
+     * per topology modifier. The batch is cleared.
+     *
+     * @return the number of topological elements removed.
+     */
+    Index removeCollectedItems(RemovalBatch& batch) const;
+
 
     /** Handles Cutting (activated only for a triangular topology)
      *
@@ -135,13 +195,19 @@ private:
                                int snapingBorderValue = 0);
 
 
-    Index removeItemsFromTriangleModel(sofa::component::collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const;
-    Index removeItemsFromPointModel(sofa::component::collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const;
-    /** \brief Method to remove topological elements from a Topology linked to a Line collision model. Only Edge Topology  is supported.
-    *  \param indices : list of element indices to remove (unique check is done internally)
+    Index collectItemsFromTriangleModel(sofa::component::collision::geometry::TriangleCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const;
+    Index collectItemsFromPointModel(sofa::component::collision::geometry::PointCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const;
+    /** \brief Method to collect topological elements from a Topology linked to a Line collision model. Only Edge Topology  is supported.
+    *  \param indices : list of element indices to remove (unique check is done by the batch)
     */
-    Index removeItemsFromLineModel(sofa::component::collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const;
-    Index removeItemsFromSphereModel(sofa::component::collision::geometry::SphereCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices) const;
+    Index collectItemsFromLineModel(sofa::component::collision::geometry::LineCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const;
+    Index collectItemsFromSphereModel(sofa::component::collision::geometry::SphereCollisionModel<sofa::defaulttype::Vec3Types>* model, const type::vector<Index>& indices, RemovalBatch& batch) const;
+
+    /// Converts triangles of a topology (or quads, for a hexahedral topology) to the elements to remove, then collects them
+    Index collectItemsFromTriangles(sofa::core::CollisionModel* model, sofa::core::topology::BaseMeshTopology* topo, const type::vector<Index>& triangles, RemovalBatch& batch) const;
+
+    /// Follows the topological mappings up to the topmost topology, converting the items, and adds them to the batch
+    Index collectItemsFromTopology(sofa::core::topology::BaseMeshTopology* topo, std::set<Index> items, RemovalBatch& batch) const;
 
 
 private:
@@ -35,6 +35,16 @@ IntersectorMap::~IntersectorMap()
     }
 }
 
+int ElementIntersector::intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const CandidatePairs& pairs, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection)
+{
+    int nbContacts = 0;
+    for (const auto& [index1, index2] : pairs)
+    {
+        nbContacts += intersect(core::CollisionElementIterator(model1, index1), core::CollisionElementIterator(model2, index2), contacts, currentIntersection);
+    }
+    return nbContacts;
+}
+
 helper::TypeInfo IntersectorMap::getType(core::CollisionModel* model)
 {
     helper::TypeInfo t(typeid(*model));
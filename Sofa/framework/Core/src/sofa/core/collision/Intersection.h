@@ -76,6 +76,15 @@ public:
 
     /// Compute the intersection between 2 elements. Return the number of contacts written in the contacts vector.
     virtual int intersect(core::CollisionElementIterator elem1, core::CollisionElementIterator elem2, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection) = 0;
+
+    /// Pairs of indices of elements of two collision models
+    typedef sofa::type::vector<std::pair<sofa::Index, sofa::Index> > CandidatePairs;
+
+    /// Compute the intersections of a list of candidate pairs of elements of two collision models (typically
+    /// all the pairs of two overlapping leaves of bounding trees). The contacts are written in the order of the pairs.
+    /// Return the number of contacts written in the contacts vector.
+    /// The default implementation calls intersect on each pair.
+    virtual int intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const CandidatePairs& pairs, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection);
     
     /// End intersection tests between two collision models. Return the number of contacts written in the contacts vector.
     virtual int endIntersect(core::CollisionModel* model1, core::CollisionModel* model2, DetectionOutputVector* contacts) = 0;
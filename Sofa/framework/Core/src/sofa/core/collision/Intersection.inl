@@ -26,9 +26,22 @@
 
 #include <sofa/version.h>
 
+#include <type_traits>
+
 namespace sofa::core::collision
 {
 
+/// True if the intersection class T computes the intersections of a list of candidate pairs of
+/// elements of Model1 and Model2 with computeIntersection(model1, model2, pairs, begin, end, contacts, intersection)
+template<class T, class Model1, class Model2, class = void>
+struct HasPairsComputeIntersection : std::false_type {};
+
+template<class T, class Model1, class Model2>
+struct HasPairsComputeIntersection<T, Model1, Model2, std::void_t<decltype(std::declval<T&>().computeIntersection(
+    std::declval<Model1*>(), std::declval<Model2*>(), std::declval<const ElementIntersector::CandidatePairs&>(),
+    std::size_t(), std::size_t(), std::declval<TDetectionOutputVector<Model1, Model2>*>(),
+    std::declval<const core::collision::Intersection*>()))> > : std::true_type {};
+
 template<class Elem1, class Elem2, class T>
 class MemberElementIntersector : public ElementIntersector
 {
@@ -71,6 +84,20 @@ public:
         return impl->computeIntersection(e1, e2, impl->getOutputVector(e1.getCollisionModel(), e2.getCollisionModel(), contacts), currentIntersection);
     }
 
+    int intersectPairs(core::CollisionModel* model1, core::CollisionModel* model2, const CandidatePairs& pairs, DetectionOutputVector* contacts, const core::collision::Intersection* currentIntersection) override
+    {
+        if constexpr (HasPairsComputeIntersection<T, Model1, Model2>::value)
+        {
+            Model1* m1 = static_cast<Model1*>(model1);
+            Model2* m2 = static_cast<Model2*>(model2);
+            return impl->computeIntersection(m1, m2, pairs, 0, pairs.size(), impl->getOutputVector(m1, m2, contacts), currentIntersection);
+        }
+        else
+        {
+            return ElementIntersector::intersectPairs(model1, model2, pairs, contacts, currentIntersection);
+        }
+    }
+
     std::string name() const override
     {
         return sofa::helper::gettypename(typeid(Elem1))+std::string("-")+sofa::helper::gettypename(typeid(Elem2));
@@ -22,9 +22,29 @@
 #include <sofa/core/collision/NarrowPhaseDetection.h>
 #include <sofa/core/visual/VisualParams.h>
 
+#include <algorithm>
+
 namespace sofa::core::collision
 {
 
+namespace
+{
+/// Root of the scene graph containing the object, or nullptr if the object was removed from its node
+const objectmodel::BaseContext* getSceneRoot(const objectmodel::BaseObject* object)
+{
+    const objectmodel::BaseContext* context = object->getContext();
+    return context ? context->getRootContext() : nullptr;
+}
+}
+
+NarrowPhaseDetection::NarrowPhaseDetection()
+    : d_detectionOutputsPoolSize(initData(&d_detectionOutputsPoolSize, 0u, "detectionOutputsPoolSize",
+        "Maximum number of detection outputs kept for reuse when a pair of models stops colliding. "
+        "They are reused, with their memory already allocated, if the same pair collides again. "
+        "0 means that the detection outputs are deleted as soon as the pair is no longer colliding"))
+{
+}
+
 NarrowPhaseDetection::~NarrowPhaseDetection()
 {
     for (const auto& it : m_outputsMap)
@@ -37,6 +57,11 @@ NarrowPhaseDetection::~NarrowPhaseDetection()
             do_vec->release();
         }
     }
+
+    for (const auto& [models, do_vec] : m_outputsPool)
+    {
+        do_vec->release();
+    }
 }
 
 void NarrowPhaseDetection::beginNarrowPhase()
@@ -80,6 +105,8 @@ void NarrowPhaseDetection::addCollisionPairs(const sofa::type::vector< std::pair
 
 void NarrowPhaseDetection::endNarrowPhase()
 {
+    const unsigned int poolSize = d_detectionOutputsPoolSize.getValue();
+
     for (auto it = m_outputsMap.begin(); it != m_outputsMap.end();)
     {
         DetectionOutputVector *do_vec = (it->second);
@@ -87,8 +114,17 @@ void NarrowPhaseDetection::endNarrowPhase()
         {
             if (do_vec)
             {
-                do_vec->release();
+                const auto models = m_outputsModels.find(it->first);
+                if (poolSize > 0 && models != m_outputsModels.end())
+                {
+                    m_outputsPool.emplace_front(models->second, do_vec);
+                }
+                else
+                {
+                    do_vec->release();
+                }
             }
+            m_outputsModels.erase(it->first);
             m_outputsMap.erase(it++);
         }
         else
@@ -97,6 +133,37 @@ void NarrowPhaseDetection::endNarrowPhase()
         }
     }
 
+    purgeRemovedModelsFromPool();
+
+    // the least recently used detection outputs are deleted
+    while (m_outputsPool.size() > poolSize)
+    {
+        m_outputsPool.back().second->release();
+        m_outputsPool.pop_back();
+    }
+
+    if (poolSize == 0)
+    {
+        m_outputsModels.clear();
+    }
+}
+
+void NarrowPhaseDetection::purgeRemovedModelsFromPool()
+{
+    const objectmodel::BaseContext* root = getSceneRoot(this);
+    for (auto it = m_outputsPool.begin(); it != m_outputsPool.end();)
+    {
+        const auto& [model1, model2] = it->first;
+        if (getSceneRoot(model1.get()) != root || getSceneRoot(model2.get()) != root)
+        {
+            it->second->release();
+            it = m_outputsPool.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 size_t NarrowPhaseDetection::getPrimitiveTestCount() const
@@ -113,6 +180,28 @@ DetectionOutputVector*& NarrowPhaseDetection::getDetectionOutputs(CollisionModel
 {
     std::pair< CollisionModel*, CollisionModel* > cm_pair = std::make_pair(cm1, cm2);
     const auto res = m_outputsMap.insert(m_outputsMap.end(), {cm_pair, nullptr});
+
+    if (d_detectionOutputsPoolSize.getValue() > 0)
+    {
+        // the models are referenced while their pair is known, so that its detection output can be pooled
+        m_outputsModels.try_emplace(cm_pair, cm1, cm2);
+    }
+
+    if (res->second == nullptr && !m_outputsPool.empty())
+    {
+        // the pair of models collided previously: its detection output is given back
+        const auto pooled = std::find_if(m_outputsPool.begin(), m_outputsPool.end(),
+            [cm1, cm2](const auto& entry)
+            {
+                return entry.first.first.get() == cm1 && entry.first.second.get() == cm2;
+            });
+        if (pooled != m_outputsPool.end())
+        {
+            res->second = pooled->second;
+            m_outputsPool.erase(pooled);
+        }
+    }
+
     return res->second;
 }
 
@@ -23,8 +23,10 @@
 
 #include <sofa/core/collision/Detection.h>
 #include <sofa/core/collision/DetectionOutput.h>
+#include <sofa/core/CollisionModel.h>
 #include <sofa/helper/map_ptr_stable_compare.h>
 #include <vector>
+#include <list>
 #include <map>
 #include <unordered_map>
 
@@ -50,11 +52,16 @@ public:
     typedef sofa::helper::map_ptr_stable_compare< std::pair< core::CollisionModel*, core::CollisionModel* >, DetectionOutputVector*> DetectionOutputMap;
 
 protected:
+    NarrowPhaseDetection();
+
     /// Destructor
     ~NarrowPhaseDetection() override;
 
 public:
 
+    Data<unsigned int> d_detectionOutputsPoolSize; ///< Maximum number of detection outputs kept for reuse
+
+
     void draw(const core::visual::VisualParams* vparams) override;
 
     /// Clear all the potentially colliding pairs detected in the previous simulation step
@@ -88,6 +95,20 @@ protected:
 
     DetectionOutputMap m_outputsMap;
 
+    /// A pair of models referenced by the pool of detection outputs. The references keep the models alive, so that
+    /// the address of a removed model cannot be reused by a new model while its detection output is in the pool.
+    using PooledModels = std::pair< sptr<CollisionModel>, sptr<CollisionModel> >;
+
+    /// Models of the pairs of m_outputsMap, only when the pool is enabled
+    std::map< std::pair< core::CollisionModel*, core::CollisionModel* >, PooledModels > m_outputsModels;
+
+    /// Detection outputs of the pairs of models which are no longer colliding, most recently used first.
+    /// They are given back to the same pair of models if it collides again, with their memory already allocated.
+    std::list< std::pair< PooledModels, DetectionOutputVector* > > m_outputsPool;
+
+    /// Deletes the detection outputs of the pool whose models are no longer in the scene graph of this component
+    void purgeRemovedModelsFromPool();
+
     size_t m_primitiveTestCount; // used only for statistics purpose
     
 };
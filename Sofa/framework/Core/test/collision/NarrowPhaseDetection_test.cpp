@@ -82,7 +82,12 @@ namespace sofa::core
 class DummyCollisionModel : public CollisionModel
 {
 public:
+    SOFA_CLASS(DummyCollisionModel, CollisionModel);
+
     void computeBoundingTree(int /*maxDepth*/) override {}
+
+    /// Same as the removal of the model from its node
+    void removeFromContext() { l_context.reset(); }
 };
 } //namespace sofa::collision
 
@@ -160,4 +165,81 @@ TEST(NarrowPhaseDetection_test, DetectionOutputMap)
     EXPECT_TRUE(outputMap.empty());
     EXPECT_TRUE(isDestroyed_1);
 }
-} //namespace sofa
\ No newline at end of file
+
+TEST(NarrowPhaseDetection_test, DetectionOutputsPool)
+{
+    const auto narrowPhaseDetection = New<sofa::core::collision::DummyNarrowPhaseDetection>();
+    narrowPhaseDetection->d_detectionOutputsPoolSize.setValue(1);
+
+    const auto modelA = New<core::DummyCollisionModel>();
+    const auto modelB = New<core::DummyCollisionModel>();
+    const auto modelC = New<core::DummyCollisionModel>();
+
+    const auto& outputMap = narrowPhaseDetection->getDetectionOutputs();
+
+    auto*& detection_0 = narrowPhaseDetection->getDetectionOutputs(modelA.get(), modelB.get());
+    bool isDestroyed_0 { false };
+    auto* output_0 = new sofa::core::collision::DummyDetectionOutputVector(0, &isDestroyed_0);
+    detection_0 = output_0;
+
+    // size is 0, so it is removed from the map, but kept in the pool
+    narrowPhaseDetection->endNarrowPhase();
+    EXPECT_TRUE(outputMap.empty());
+    EXPECT_FALSE(isDestroyed_0);
+
+    // the same pair of models gets back its detection output
+    EXPECT_EQ(narrowPhaseDetection->getDetectionOutputs(modelA.get(), modelB.get()), output_0);
+
+    // another pair gets no detection output from the pool
+    EXPECT_EQ(narrowPhaseDetection->getDetectionOutputs(modelA.get(), modelC.get()), nullptr);
+
+    auto*& detection_1 = narrowPhaseDetection->getDetectionOutputs(modelB.get(), modelC.get());
+    bool isDestroyed_1 { false };
+    detection_1 = new sofa::core::collision::DummyDetectionOutputVector(0, &isDestroyed_1);
+
+    // both are empty, but the pool only keeps one of them
+    narrowPhaseDetection->endNarrowPhase();
+    EXPECT_TRUE(outputMap.empty());
+    EXPECT_NE(isDestroyed_0, isDestroyed_1);
+
+    // without pool, the detection outputs are destroyed
+    narrowPhaseDetection->d_detectionOutputsPoolSize.setValue(0);
+    narrowPhaseDetection->endNarrowPhase();
+    EXPECT_TRUE(isDestroyed_0);
+    EXPECT_TRUE(isDestroyed_1);
+}
+
+TEST(NarrowPhaseDetection_test, DetectionOutputsPoolRemovedModel)
+{
+    const auto narrowPhaseDetection = New<sofa::core::collision::DummyNarrowPhaseDetection>();
+    narrowPhaseDetection->d_detectionOutputsPoolSize.setValue(2);
+
+    const auto modelA = New<core::DummyCollisionModel>();
+    const auto modelB = New<core::DummyCollisionModel>();
+    const auto modelC = New<core::DummyCollisionModel>();
+
+    auto*& detection_0 = narrowPhaseDetection->getDetectionOutputs(modelA.get(), modelB.get());
+    bool isDestroyed_0 { false };
+    detection_0 = new sofa::core::collision::DummyDetectionOutputVector(0, &isDestroyed_0);
+
+    auto*& detection_1 = narrowPhaseDetection->getDetectionOutputs(modelB.get(), modelC.get());
+    bool isDestroyed_1 { false };
+    auto* output_1 = new sofa::core::collision::DummyDetectionOutputVector(0, &isDestroyed_1);
+    detection_1 = output_1;
+
+    // both pairs stop colliding and are kept in the pool
+    narrowPhaseDetection->endNarrowPhase();
+    EXPECT_FALSE(isDestroyed_0);
+    EXPECT_FALSE(isDestroyed_1);
+
+    // the detection output of a removed model is deleted, even if the pool is not full
+    modelA->removeFromContext();
+    narrowPhaseDetection->endNarrowPhase();
+    EXPECT_TRUE(isDestroyed_0);
+    EXPECT_FALSE(isDestroyed_1);
+
+    EXPECT_EQ(narrowPhaseDetection->getDetectionOutputs(modelA.get(), modelB.get()), nullptr);
+    EXPECT_EQ(narrowPhaseDetection->getDetectionOutputs(modelB.get(), modelC.get()), output_1);
+}
+
+} //namespace sofa
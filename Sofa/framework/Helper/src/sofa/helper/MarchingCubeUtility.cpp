@@ -36,6 +36,8 @@
 
 #include <cstring>
 #include <set>
+#include <algorithm>
+#include <limits>
 
 MSG_REGISTER_CLASS(sofa::helper::MarchingCubeUtility, "MarchingCubeUtility")
 
@@ -763,6 +765,495 @@ namespace sofa::helper
 
 
 
+    float MarchingCubeUtility::gridValue ( const type::Vec3i& coord, const unsigned char* data, const type::Vec3i& dataGridStep ) const
+    {
+        const type::Vec3i valPos = coord.linearProduct ( dataGridStep );
+        return (float)((( valPos[0] >= roi.min[0]) && ( valPos[1] >= roi.min[1]) && ( valPos[2] >= roi.min[2]) && ( valPos[0] < roi.max[0]) && ( valPos[1] < roi.max[1]) && ( valPos[2] < roi.max[2]))?data[valPos[0] + valPos[1]*dataResolution[0] + valPos[2]*dataResolution[0]*dataResolution[1]]:0);
+    }
+
+
+    bool MarchingCubeUtility::isBlockCacheValid ( const BlockCache& cache, const float isolevel ) const
+    {
+        return cache.valid
+            && cache.isolevel == isolevel
+            && cache.cubeStep == cubeStep
+            && cache.convolutionSize == convolutionSize
+            && cache.dataResolution == dataResolution
+            && cache.dataVoxelSize == dataVoxelSize
+            && cache.bboxMin == bbox.min && cache.bboxMax == bbox.max
+            && cache.roiMin == roi.min && cache.roiMax == roi.max
+            && cache.verticesTranslation == verticesTranslation;
+    }
+
+
+    void MarchingCubeUtility::initBlockCache ( BlockCache& cache, const float isolevel ) const
+    {
+        cache.clear();
+        cache.valid = true;
+        cache.isolevel = isolevel;
+        cache.cubeStep = cubeStep;
+        cache.convolutionSize = convolutionSize;
+        cache.dataResolution = dataResolution;
+        cache.dataVoxelSize = dataVoxelSize;
+        cache.bboxMin = bbox.min;
+        cache.bboxMax = bbox.max;
+        cache.roiMin = roi.min;
+        cache.roiMax = roi.max;
+        cache.verticesTranslation = verticesTranslation;
+
+        // same grid of cubes as in run
+        const type::Vec3i bboxMin = type::Vec3i ( bbox.min / cubeStep );
+        const type::Vec3i bboxMax = type::Vec3i ( bbox.max / cubeStep );
+        const type::Vec3i gridSize = type::Vec3i ( dataResolution /cubeStep );
+
+        cache.gridStep = type::Vec3 ( 2_sreal / static_cast<SReal>(gridSize[0]),
+                                      2_sreal / static_cast<SReal>(gridSize[1]),
+                                      2_sreal / static_cast<SReal>(gridSize[2]) );
+        cache.dataGridStep = type::Vec3i ( dataResolution[0]/gridSize[0],dataResolution[1]/gridSize[1],dataResolution[2]/gridSize[2] );
+        cache.cubeMin = bboxMin;
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+            cache.nbCubes[c] = std::max ( bboxMax[c] - 1 - bboxMin[c], 0 );
+            cache.nbBlocks[c] = ( cache.nbCubes[c] + BlockSize - 1 ) / BlockSize;
+        }
+
+        if ( cache.nbBlocks[0] * cache.nbBlocks[1] * cache.nbBlocks[2] == 0 )
+            return;
+
+        cache.blocks.resize ( cache.nbBlocks[0] * cache.nbBlocks[1] * cache.nbBlocks[2] );
+
+        type::Vec3i size = cache.nbBlocks;
+        while ( true )
+        {
+            cache.pyramidSize.push_back ( size );
+            cache.pyramid.emplace_back ( size[0] * size[1] * size[2] );
+            if ( size[0] == 1 && size[1] == 1 && size[2] == 1 )
+                break;
+            size = type::Vec3i ( ( size[0] + 1 ) / 2, ( size[1] + 1 ) / 2, ( size[2] + 1 ) / 2 );
+        }
+    }
+
+
+    void MarchingCubeUtility::updateBlockPyramid ( BlockCache& cache, const unsigned char* data,
+                                                   const type::Vec3i& blockMin, const type::Vec3i& blockMax,
+                                                   const ParallelForRange& parallelFor ) const
+    {
+        const type::Vec3i range = blockMax - blockMin;
+        if ( range[0] <= 0 || range[1] <= 0 || range[2] <= 0 )
+            return;
+
+        // range of the values of the modified blocks
+        const RangeTask updateBlocks = [&] ( std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t b = begin; b < end; ++b )
+            {
+                const type::Vec3i block = blockMin + type::Vec3i ( static_cast<int>(b % range[0]),
+                                                                   static_cast<int>(( b / range[0] ) % range[1]),
+                                                                   static_cast<int>(b / ( range[0] * range[1] )) );
+                const type::Vec3i first = cache.cubeMin + block * BlockSize;
+                type::Vec3i last; // last point of the block (included)
+                for ( unsigned int c = 0; c < 3; ++c )
+                    last[c] = cache.cubeMin[c] + std::min ( ( block[c] + 1 ) * BlockSize, cache.nbCubes[c] );
+
+                float vmin = std::numeric_limits<float>::max();
+                float vmax = std::numeric_limits<float>::lowest();
+                for ( int k = first[2]; k <= last[2]; ++k )
+                    for ( int j = first[1]; j <= last[1]; ++j )
+                        for ( int i = first[0]; i <= last[0]; ++i )
+                        {
+                            const float v = gridValue ( type::Vec3i ( i, j, k ), data, cache.dataGridStep );
+                            vmin = std::min ( vmin, v );
+                            vmax = std::max ( vmax, v );
+                        }
+
+                const unsigned int blockIndex = block[0] + cache.nbBlocks[0] * ( block[1] + cache.nbBlocks[1] * block[2] );
+                cache.pyramid[0][blockIndex] = std::make_pair ( vmin, vmax );
+                cache.blocks[blockIndex].upToDate = false;
+            }
+        };
+
+        const std::size_t nbModifiedBlocks = range[0] * range[1] * range[2];
+        if ( parallelFor )
+            parallelFor ( nbModifiedBlocks, updateBlocks );
+        else
+            updateBlocks ( 0, nbModifiedBlocks );
+
+        // upper levels
+        type::Vec3i nodeMin = blockMin, nodeMax = blockMax - type::Vec3i ( 1, 1, 1 );
+        for ( std::size_t level = 1; level < cache.pyramid.size(); ++level )
+        {
+            nodeMin = type::Vec3i ( nodeMin[0] / 2, nodeMin[1] / 2, nodeMin[2] / 2 );
+            nodeMax = type::Vec3i ( nodeMax[0] / 2, nodeMax[1] / 2, nodeMax[2] / 2 );
+            const type::Vec3i& size = cache.pyramidSize[level];
+            const type::Vec3i& childSize = cache.pyramidSize[level - 1];
+
+            for ( int z = nodeMin[2]; z <= nodeMax[2]; ++z )
+                for ( int y = nodeMin[1]; y <= nodeMax[1]; ++y )
+                    for ( int x = nodeMin[0]; x <= nodeMax[0]; ++x )
+                    {
+                        auto& node = cache.pyramid[level][x + size[0] * ( y + size[1] * z )];
+                        node = std::make_pair ( std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() );
+                        for ( int cz = 2 * z; cz < std::min ( 2 * z + 2, childSize[2] ); ++cz )
+                            for ( int cy = 2 * y; cy < std::min ( 2 * y + 2, childSize[1] ); ++cy )
+                                for ( int cx = 2 * x; cx < std::min ( 2 * x + 2, childSize[0] ); ++cx )
+                                {
+                                    const auto& child = cache.pyramid[level - 1][cx + childSize[0] * ( cy + childSize[1] * cz )];
+                                    node.first = std::min ( node.first, child.first );
+                                    node.second = std::max ( node.second, child.second );
+                                }
+                    }
+        }
+    }
+
+
+    void MarchingCubeUtility::collectActiveBlocks ( const BlockCache& cache, const float isolevel, unsigned int level,
+                                                    const type::Vec3i& node, int slab,
+                                                    sofa::type::vector<unsigned int>& activeBlocks ) const
+    {
+        const type::Vec3i& size = cache.pyramidSize[level];
+        const auto& range = cache.pyramid[level][node[0] + size[0] * ( node[1] + size[1] * node[2] )];
+
+        // all the points of the node are on the same side of the isosurface
+        if ( !testGrid ( range.first, isolevel ) || testGrid ( range.second, isolevel ) )
+            return;
+
+        if ( level == 0 )
+        {
+            activeBlocks.push_back ( node[0] + size[0] * ( node[1] + size[1] * node[2] ) );
+            return;
+        }
+
+        const type::Vec3i& childSize = cache.pyramidSize[level - 1];
+        const int cz = slab >> ( level - 1 );
+        for ( int cy = 2 * node[1]; cy < std::min ( 2 * node[1] + 2, childSize[1] ); ++cy )
+            for ( int cx = 2 * node[0]; cx < std::min ( 2 * node[0] + 2, childSize[0] ); ++cx )
+                collectActiveBlocks ( cache, isolevel, level - 1, type::Vec3i ( cx, cy, cz ), slab, activeBlocks );
+    }
+
+
+    void MarchingCubeUtility::polygoniseBlock ( BlockCache& cache, unsigned int blockIndex, const unsigned char* data, const float isolevel ) const
+    {
+        // corners and edges of a cube, in the order of the tables
+        static const int cornerOffset[8][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+        static const int edgeOrigin[12][3] = { {0,0,0}, {1,0,0}, {0,1,0}, {0,0,0}, {0,0,1}, {1,0,1}, {0,1,1}, {0,0,1}, {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} };
+        static const int edgeAxis[12] = { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 };
+
+        BlockCache::Block& surface = cache.blocks[blockIndex];
+        surface.vertices.clear();
+        surface.triangles.clear();
+        surface.sharedVertices.clear();
+
+        const type::Vec3i block ( static_cast<int>(blockIndex % cache.nbBlocks[0]),
+                                  static_cast<int>(( blockIndex / cache.nbBlocks[0] ) % cache.nbBlocks[1]),
+                                  static_cast<int>(blockIndex / ( cache.nbBlocks[0] * cache.nbBlocks[1] )) );
+        const type::Vec3i first = block * BlockSize; // first cube of the block, relatively to the bounding box
+        type::Vec3i nbCubes;
+        for ( unsigned int c = 0; c < 3; ++c )
+            nbCubes[c] = std::min ( BlockSize, cache.nbCubes[c] - first[c] );
+        const type::Vec3i nbPoints = nbCubes + type::Vec3i ( 1, 1, 1 );
+        const auto pointIndex = [&nbPoints] ( int i, int j, int k ) { return i + nbPoints[0] * ( j + nbPoints[1] * k ); };
+
+        // values of the points of the block
+        sofa::type::vector<float> values ( nbPoints[0] * nbPoints[1] * nbPoints[2] );
+        for ( int k = 0; k < nbPoints[2]; ++k )
+            for ( int j = 0; j < nbPoints[1]; ++j )
+                for ( int i = 0; i < nbPoints[0]; ++i )
+                    values[pointIndex ( i, j, k )] = gridValue ( cache.cubeMin + first + type::Vec3i ( i, j, k ), data, cache.dataGridStep );
+
+        // vertex created on each edge of the block, if any. A vertex located on a point of the grid
+        // (value equal to the isolevel) is shared by all the edges of this point, using a fourth slot.
+        static constexpr PointID InvalidVertex = std::numeric_limits<PointID>::max();
+        sofa::type::vector<PointID> vertexSlots ( values.size() * 4, InvalidVertex );
+
+        const std::uint64_t nbGridPointsX = cache.nbCubes[0] + 1;
+        const std::uint64_t nbGridPointsY = cache.nbCubes[1] + 1;
+
+        for ( int k = 0; k < nbCubes[2]; ++k )
+            for ( int j = 0; j < nbCubes[1]; ++j )
+                for ( int i = 0; i < nbCubes[0]; ++i )
+                {
+                    int cubeConf = 0;
+                    for ( int c = 0; c < 8; ++c )
+                    {
+                        if ( testGrid ( values[pointIndex ( i + cornerOffset[c][0], j + cornerOffset[c][1], k + cornerOffset[c][2] )], isolevel ) )
+                            cubeConf |= ( 1 << c );
+                    }
+
+                    const int edges = MarchingCubeEdgeTable[cubeConf];
+                    if ( edges == 0 ) continue;
+
+                    PointID cubeVertices[12];
+                    for ( int e = 0; e < 12; ++e )
+                    {
+                        if ( !( edges & ( 1 << e ) ) ) continue;
+
+                        const type::Vec3i origin ( i + edgeOrigin[e][0], j + edgeOrigin[e][1], k + edgeOrigin[e][2] );
+                        const int axis = edgeAxis[e];
+                        type::Vec3i end = origin;
+                        end[axis] += 1;
+                        const float valOrigin = values[pointIndex ( origin[0], origin[1], origin[2] )];
+                        const float valEnd = values[pointIndex ( end[0], end[1], end[2] )];
+
+                        type::Vec3i slotPoint = origin;
+                        int slot = axis;
+                        if ( valOrigin == isolevel ) { slot = 3; }
+                        else if ( valEnd == isolevel ) { slotPoint = end; slot = 3; }
+
+                        PointID& vertex = vertexSlots[pointIndex ( slotPoint[0], slotPoint[1], slotPoint[2] ) * 4 + slot];
+                        if ( vertex == InvalidVertex )
+                        {
+                            const type::Vec3i gridOrigin = cache.cubeMin + first + origin;
+                            const type::Vec3i gridEnd = cache.cubeMin + first + end;
+                            const type::Vec3 p1 = type::Vec3 ( gridOrigin[0], gridOrigin[1], gridOrigin[2] ).linearProduct ( cache.gridStep ) - type::Vec3 ( 1_sreal, 1_sreal, 1_sreal );
+                            const type::Vec3 p2 = type::Vec3 ( gridEnd[0], gridEnd[1], gridEnd[2] ).linearProduct ( cache.gridStep ) - type::Vec3 ( 1_sreal, 1_sreal, 1_sreal );
+
+                            type::Vec3 p;
+                            vertexInterp ( p, isolevel, p1, p2, valOrigin, valEnd );
+                            vertex = static_cast<PointID>( surface.vertices.size() );
+                            surface.vertices.push_back ( p );
+
+                            // the slots on the faces of the block are shared with the neighbor blocks
+                            bool isShared = false;
+                            for ( int c = 0; c < 3; ++c )
+                            {
+                                if ( c != slot && ( slotPoint[c] == 0 || slotPoint[c] == nbCubes[c] ) ) isShared = true;
+                            }
+                            if ( isShared )
+                            {
+                                const type::Vec3i point = first + slotPoint;
+                                const std::uint64_t key = ( ( point[2] * nbGridPointsY + point[1] ) * nbGridPointsX + point[0] ) * 4 + slot;
+                                surface.sharedVertices.emplace_back ( key, vertex );
+                            }
+                        }
+                        cubeVertices[e] = vertex;
+                    }
+
+                    for ( int t = 0; MarchingCubeTriTable[cubeConf][t] != -1; t += 3 )
+                    {
+                        surface.triangles.push_back ( cubeVertices[MarchingCubeTriTable[cubeConf][t]] );
+                        surface.triangles.push_back ( cubeVertices[MarchingCubeTriTable[cubeConf][t+1]] );
+                        surface.triangles.push_back ( cubeVertices[MarchingCubeTriTable[cubeConf][t+2]] );
+                    }
+                }
+
+        surface.upToDate = true;
+    }
+
+
+    void MarchingCubeUtility::runByBlocks ( const unsigned char *_data, const float isolevel, BlockCache& cache, const BoundingBox* dirty,
+                                            const PointID firstIndex, const SurfaceChunkCallback& onChunk,
+                                            const ParallelForRange& parallelFor, bool keepBlocks ) const
+    {
+        const size_t datasize = dataResolution[0]*dataResolution[1]*dataResolution[2];
+        if ( datasize == 0 )
+            return;
+
+        // modified voxels
+        BoundingBox modified { type::Vec3i ( 0, 0, 0 ), dataResolution };
+        if ( dirty && isBlockCacheValid ( cache, isolevel ) )
+        {
+            modified = *dirty;
+        }
+        else
+        {
+            initBlockCache ( cache, isolevel );
+        }
+
+        if ( cache.blocks.empty() )
+            return;
+
+        const unsigned char* data = _data;
+        if ( convolutionSize > 1 )
+        {
+            // the smoothing spreads the modifications
+            for ( unsigned int c = 0; c < 3; ++c )
+            {
+                modified.min[c] = std::max ( modified.min[c] - static_cast<int>(convolutionSize), 0 );
+                modified.max[c] = std::min ( modified.max[c] + static_cast<int>(convolutionSize), dataResolution[c] );
+            }
+            cache.smoothedData.resize ( datasize );
+            smoothData ( _data, cache.smoothedData.data(), modified.min, modified.max, parallelFor );
+            data = cache.smoothedData.data();
+        }
+
+        // blocks containing cubes using the modified voxels
+        type::Vec3i blockMin, blockMax;
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+            const int firstPoint = modified.min[c] / cache.dataGridStep[c];
+            const int lastPoint = ( modified.max[c] - 1 ) / cache.dataGridStep[c];
+            const int firstCube = std::max ( firstPoint - 1 - cache.cubeMin[c], 0 );
+            const int lastCube = std::min ( lastPoint - cache.cubeMin[c], cache.nbCubes[c] - 1 );
+            blockMin[c] = firstCube / BlockSize;
+            blockMax[c] = ( lastCube >= firstCube ) ? lastCube / BlockSize + 1 : blockMin[c];
+        }
+        updateBlockPyramid ( cache, data, blockMin, blockMax, parallelFor );
+
+        // the surface is built slab by slab, the vertices shared with the previous slab being identified by their edge
+        sofa::type::vector< std::pair<std::uint64_t, PointID> > previousShared, shared;
+        sofa::type::vector<unsigned int> activeBlocks;
+        sofa::type::vector<PointID> blockOffsets, finalIndex;
+        SurfaceChunk chunk;
+        PointID nbVertices = 0;
+
+        const unsigned int topLevel = static_cast<unsigned int>( cache.pyramid.size() ) - 1;
+        for ( int slab = 0; slab < cache.nbBlocks[2]; ++slab )
+        {
+            activeBlocks.clear();
+            collectActiveBlocks ( cache, isolevel, topLevel, type::Vec3i ( 0, 0, 0 ), slab, activeBlocks );
+
+            const RangeTask polygoniseBlocks = [&] ( std::size_t begin, std::size_t end )
+            {
+                for ( std::size_t b = begin; b < end; ++b )
+                {
+                    if ( !cache.blocks[activeBlocks[b]].upToDate )
+                        polygoniseBlock ( cache, activeBlocks[b], data, isolevel );
+                }
+            };
+            if ( parallelFor )
+                parallelFor ( activeBlocks.size(), polygoniseBlocks );
+            else
+                polygoniseBlocks ( 0, activeBlocks.size() );
+
+            // provisional indices of the vertices of the slab, following the indices of the previous slabs
+            blockOffsets.resize ( activeBlocks.size() );
+            PointID nbSlabVertices = 0;
+            shared = previousShared;
+            for ( std::size_t b = 0; b < activeBlocks.size(); ++b )
+            {
+                const BlockCache::Block& surface = cache.blocks[activeBlocks[b]];
+                blockOffsets[b] = nbSlabVertices;
+                for ( const auto& [key, vertex] : surface.sharedVertices )
+                    shared.emplace_back ( key, nbVertices + nbSlabVertices + vertex );
+                nbSlabVertices += static_cast<PointID>( surface.vertices.size() );
+            }
+
+            // a shared vertex is replaced by the first vertex created on the same edge
+            std::sort ( shared.begin(), shared.end() );
+            finalIndex.resize ( nbSlabVertices );
+            for ( PointID v = 0; v < nbSlabVertices; ++v )
+                finalIndex[v] = nbVertices + v;
+            previousShared.clear();
+            for ( std::size_t i = 0; i < shared.size(); )
+            {
+                std::size_t j = i + 1;
+                for ( ; j < shared.size() && shared[j].first == shared[i].first; ++j )
+                    finalIndex[shared[j].second - nbVertices] = shared[i].second;
+                if ( shared[j - 1].second >= nbVertices ) // the edge is used in the current slab, and may be used in the next one
+                    previousShared.push_back ( shared[i] );
+                i = j;
+            }
+
+            // compact numbering of the new vertices
+            chunk.vertices.clear();
+            chunk.triangles.clear();
+            PointID nbNewVertices = 0;
+            for ( std::size_t b = 0; b < activeBlocks.size(); ++b )
+            {
+                const BlockCache::Block& surface = cache.blocks[activeBlocks[b]];
+                for ( PointID v = 0; v < surface.vertices.size(); ++v )
+                {
+                    PointID& index = finalIndex[blockOffsets[b] + v];
+                    if ( index == nbVertices + blockOffsets[b] + v )
+                    {
+                        index = nbVertices + nbNewVertices++;
+                        chunk.vertices.push_back ( surface.vertices[v] );
+                    }
+                    else if ( index >= nbVertices )
+                    {
+                        index = finalIndex[index - nbVertices];
+                    }
+                }
+            }
+            for ( auto& [key, vertex] : previousShared )
+            {
+                if ( vertex >= nbVertices ) vertex = finalIndex[vertex - nbVertices];
+            }
+
+            for ( std::size_t b = 0; b < activeBlocks.size(); ++b )
+            {
+                const BlockCache::Block& surface = cache.blocks[activeBlocks[b]];
+                for ( std::size_t t = 0; t < surface.triangles.size(); t += 3 )
+                {
+                    const PointID v0 = finalIndex[blockOffsets[b] + surface.triangles[t]];
+                    const PointID v1 = finalIndex[blockOffsets[b] + surface.triangles[t + 1]];
+                    const PointID v2 = finalIndex[blockOffsets[b] + surface.triangles[t + 2]];
+                    if ( v0 == v1 || v0 == v2 || v1 == v2 ) continue;
+                    chunk.triangles.push_back ( firstIndex + v0 );
+                    chunk.triangles.push_back ( firstIndex + v1 );
+                    chunk.triangles.push_back ( firstIndex + v2 );
+                }
+
+                if ( !keepBlocks )
+                {
+                    cache.blocks[activeBlocks[b]] = BlockCache::Block();
+                }
+            }
+            nbVertices += nbNewVertices;
+
+            if ( !chunk.triangles.empty() || !chunk.vertices.empty() )
+                onChunk ( chunk );
+        }
+
+        if ( !keepBlocks )
+        {
+            cache.clear();
+        }
+    }
+
+
+    void MarchingCubeUtility::runByBlocks ( const unsigned char *data, const float isolevel,
+                                            sofa::type::vector< PointID > &triangles,
+                                            sofa::type::vector< type::Vec3 > &vertices,
+                                            const ParallelForRange& parallelFor ) const
+    {
+        BlockCache cache;
+        runByBlocks ( data, isolevel, cache, nullptr, static_cast<PointID>( vertices.size() ) + verticesIndexOffset,
+                      [&triangles, &vertices] ( const SurfaceChunk& chunk )
+                      {
+                          vertices.insert ( vertices.end(), chunk.vertices.begin(), chunk.vertices.end() );
+                          triangles.insert ( triangles.end(), chunk.triangles.begin(), chunk.triangles.end() );
+                      },
+                      parallelFor, false );
+    }
+
+
+    void MarchingCubeUtility::runByBlocks ( const unsigned char *data, const float isolevel,
+                                            const SurfaceChunkCallback& onChunk,
+                                            const ParallelForRange& parallelFor ) const
+    {
+        BlockCache cache;
+        runByBlocks ( data, isolevel, cache, nullptr, verticesIndexOffset, onChunk, parallelFor, false );
+    }
+
+
+    void MarchingCubeUtility::runByBlocks ( const unsigned char *data, const float isolevel,
+                                            BlockCache& cache, const type::Vec3i& dirtyMin, const type::Vec3i& dirtyMax,
+                                            sofa::type::vector< PointID > &triangles,
+                                            sofa::type::vector< type::Vec3 > &vertices,
+                                            const ParallelForRange& parallelFor ) const
+    {
+        triangles.clear();
+        vertices.clear();
+
+        BoundingBox dirty;
+        for ( unsigned int c = 0; c < 3; ++c )
+        {
+            dirty.min[c] = std::max ( dirtyMin[c], 0 );
+            dirty.max[c] = std::min ( dirtyMax[c], dataResolution[c] );
+        }
+
+        runByBlocks ( data, isolevel, cache, &dirty, verticesIndexOffset,
+                      [&triangles, &vertices] ( const SurfaceChunk& chunk )
+                      {
+                          vertices.insert ( vertices.end(), chunk.vertices.begin(), chunk.vertices.end() );
+                          triangles.insert ( triangles.end(), chunk.triangles.begin(), chunk.triangles.end() );
+                      },
+                      parallelFor, true );
+    }
+
+
+
     // A priori, il n'y a pas de données sur les bords (tout du moins sur le premier voxel)
     void MarchingCubeUtility::findSeeds ( vector<type::Vec3i>& seeds, const float isoValue, unsigned char *_data )
     {
@@ -936,6 +1427,45 @@ namespace sofa::helper
                 }
     }
 
+    void MarchingCubeUtility::smoothData ( const unsigned char *input, unsigned char *output,
+                                           const type::Vec3i& min, const type::Vec3i& max,
+                                           const ParallelForRange& parallelFor ) const
+    {
+        vector< float > convolutionKernel;
+        createGaussianConvolutionKernel ( convolutionKernel );
+        const int halfSize = static_cast<int>( convolutionSize / 2 );
+        const int size = static_cast<int>( convolutionSize );
+
+        // same as applyConvolution, the voxels outside of the data being 0
+        const RangeTask smoothSlices = [&] ( std::size_t begin, std::size_t end )
+        {
+            for ( int z = min[2] + static_cast<int>(begin); z < min[2] + static_cast<int>(end); ++z )
+                for ( int y = min[1]; y < max[1]; ++y )
+                    for ( int x = min[0]; x < max[0]; ++x )
+                    {
+                        unsigned char value = 0;
+                        size_t idx = 0;
+                        for ( int k = 0; k < size; ++k )
+                            for ( int j = 0; j < size; ++j )
+                                for ( int i = 0; i < size; ++i, ++idx )
+                                {
+                                    const int xi = x + i - halfSize;
+                                    const int yj = y + j - halfSize;
+                                    const int zk = z + k - halfSize;
+                                    if ( xi < 0 || yj < 0 || zk < 0 || xi >= dataResolution[0] || yj >= dataResolution[1] || zk >= dataResolution[2] ) continue;
+                                    value += (unsigned char)( convolutionKernel[idx] * input[xi + dataResolution[0] * ( yj + dataResolution[1] * zk )] );
+                                }
+                        output[x + dataResolution[0] * ( y + dataResolution[1] * z )] = value;
+                    }
+        };
+
+        const std::size_t nbSlices = std::max ( max[2] - min[2], 0 );
+        if ( parallelFor )
+            parallelFor ( nbSlices, smoothSlices );
+        else
+            smoothSlices ( 0, nbSlices );
+    }
+
     void  MarchingCubeUtility::applyConvolution ( const float* convolutionKernel,
                                                   unsigned int x, unsigned int y, unsigned int z,
                                                   const unsigned char* input_data,
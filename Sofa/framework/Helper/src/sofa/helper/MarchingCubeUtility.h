@@ -27,6 +27,8 @@
 #include <sofa/type/vector.h>
 #include <sofa/helper/io/Mesh.h>
 #include <map>
+#include <functional>
+#include <cstdint>
 
 namespace sofa::helper
 {
@@ -43,6 +45,67 @@ public:
     SOFA_ATTRIBUTE_REPLACED__TYPEMEMBER(Vector3, sofa::type::Vec3);
     SOFA_ATTRIBUTE_REPLACED__TYPEMEMBER(Real, SReal);
 
+    /// Task processing the indices [begin, end)
+    using RangeTask = std::function<void(std::size_t /*begin*/, std::size_t /*end*/)>;
+
+    /// Calls the task on sub-ranges covering [0, size), possibly in parallel
+    using ParallelForRange = std::function<void(std::size_t /*size*/, const RangeTask&)>;
+
+    /// Number of cubes along each side of the blocks processed by runByBlocks
+    static constexpr int BlockSize = 8;
+
+    /// Part of the surface produced by runByBlocks for one slab of blocks
+    struct SurfaceChunk
+    {
+        sofa::type::vector< type::Vec3 > vertices; ///< vertices created in this chunk
+        sofa::type::vector< PointID > triangles;   ///< triangles of this chunk, which may refer to the vertices of the previous chunks
+    };
+    using SurfaceChunkCallback = std::function<void(const SurfaceChunk&)>;
+
+    /// Data kept between two calls of runByBlocks, so that only the blocks containing modified voxels are polygonized again
+    class BlockCache
+    {
+    public:
+        void clear() { *this = BlockCache(); }
+
+    private:
+        friend class MarchingCubeUtility;
+
+        /// surface of one block, with local vertex indices
+        struct Block
+        {
+            sofa::type::vector< type::Vec3 > vertices;
+            sofa::type::vector< PointID > triangles;
+            sofa::type::vector< std::pair<std::uint64_t, PointID> > sharedVertices; ///< vertices on the faces of the block, identified by their edge (or point) in the grid
+            bool upToDate { false };
+        };
+
+        bool valid { false };
+
+        // parameters used to build the cache
+        float isolevel { 0.f };
+        unsigned int cubeStep { 0 };
+        unsigned int convolutionSize { 0 };
+        type::Vec3i dataResolution;
+        type::Vec3 dataVoxelSize;
+        type::Vec3i bboxMin, bboxMax, roiMin, roiMax;
+        type::Vec3 verticesTranslation;
+
+        // geometry of the grid of cubes
+        type::Vec3i cubeMin;      ///< first cube of the bounding box
+        type::Vec3i nbCubes;      ///< number of cubes along each axis
+        type::Vec3i nbBlocks;     ///< number of blocks along each axis
+        type::Vec3 gridStep;
+        type::Vec3i dataGridStep;
+
+        /// min/max pyramid of the values: level 0 stores the range of the values of each block, level l+1 merges 2x2x2 nodes of level l
+        sofa::type::vector< sofa::type::vector< std::pair<float, float> > > pyramid;
+        sofa::type::vector< type::Vec3i > pyramidSize;
+
+        sofa::type::vector< Block > blocks;
+        sofa::type::vector< unsigned char > smoothedData;
+    };
+
     MarchingCubeUtility();
 
     ~MarchingCubeUtility() {};
@@ -148,6 +211,31 @@ public:
     /// we construct a Sofa mesh.
     void run ( unsigned char *data,  const float isolevel, sofa::helper::io::Mesh &m ) const;
 
+    /// Same as the first run function, but the grid is processed by blocks of BlockSize^3 cubes:
+    /// - the blocks where the data do not cross the isolevel are skipped using a min/max pyramid,
+    /// - the blocks of a slab are polygonized in parallel if a parallel loop is provided,
+    /// - the vertices are shared by indexing the edges of the grid, instead of comparing their positions.
+    /// The new vertices are appended to vertices. The seeds and triangleIndexInRegularGrid are not supported.
+    void runByBlocks ( const unsigned char *data, const float isolevel,
+                       sofa::type::vector< PointID > &triangles,
+                       sofa::type::vector< type::Vec3 > &vertices,
+                       const ParallelForRange& parallelFor = {} ) const;
+
+    /// Streaming version: the surface is produced slab by slab (along z) and given to onChunk as soon as
+    /// it is available. The vertex indices start at the vertices index offset.
+    void runByBlocks ( const unsigned char *data, const float isolevel,
+                       const SurfaceChunkCallback& onChunk,
+                       const ParallelForRange& parallelFor = {} ) const;
+
+    /// Incremental version: only the blocks containing voxels in [dirtyMin, dirtyMax) (in the data space) are
+    /// polygonized again, the other ones being taken from the cache. The whole grid is polygonized if the cache is
+    /// empty or if it was built with other parameters. triangles and vertices are replaced by the whole surface.
+    void runByBlocks ( const unsigned char *data, const float isolevel,
+                       BlockCache& cache, const type::Vec3i& dirtyMin, const type::Vec3i& dirtyMax,
+                       sofa::type::vector< PointID > &triangles,
+                       sofa::type::vector< type::Vec3 > &vertices,
+                       const ParallelForRange& parallelFor = {} ) const;
+
     /// given a set of data, find seeds to run quickly.
     void findSeeds ( vector<type::Vec3i>& seeds, const float isoValue, unsigned char *_data );
 
@@ -204,6 +292,24 @@ private:
 
     void smoothData ( unsigned char *data ) const;
 
+    /// value of a point of the grid of cubes
+    float gridValue ( const type::Vec3i& coord, const unsigned char* data, const type::Vec3i& dataGridStep ) const;
+
+    /// smoothing restricted to the voxels in [min, max)
+    void smoothData ( const unsigned char *input, unsigned char *output, const type::Vec3i& min, const type::Vec3i& max, const ParallelForRange& parallelFor ) const;
+
+    bool isBlockCacheValid ( const BlockCache& cache, const float isolevel ) const;
+    void initBlockCache ( BlockCache& cache, const float isolevel ) const;
+    void updateBlockPyramid ( BlockCache& cache, const unsigned char* data, const type::Vec3i& blockMin, const type::Vec3i& blockMax, const ParallelForRange& parallelFor ) const;
+    void collectActiveBlocks ( const BlockCache& cache, const float isolevel, unsigned int level, const type::Vec3i& node, int slab, sofa::type::vector<unsigned int>& activeBlocks ) const;
+    void polygoniseBlock ( BlockCache& cache, unsigned int blockIndex, const unsigned char* data, const float isolevel ) const;
+
+    /// Polygonize the blocks slab by slab and give the surface of each slab to onChunk.
+    /// If dirty is null, all the blocks are polygonized. If keepBlocks is false, the surfaces of the blocks are released after use.
+    void runByBlocks ( const unsigned char *data, const float isolevel, BlockCache& cache, const BoundingBox* dirty,
+                       const PointID firstIndex, const SurfaceChunkCallback& onChunk,
+                       const ParallelForRange& parallelFor, bool keepBlocks ) const;
+
     /// Propagate the triangulation surface creation from a cell.
     void propagateFrom ( const sofa::type::vector<type::Vec3i>& coord,
                          unsigned char* data, const float isolevel,
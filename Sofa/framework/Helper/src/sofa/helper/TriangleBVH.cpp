@@ -0,0 +1,514 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/TriangleBVH.h>
+
+#include <sofa/helper/visual/DrawTool.h>
+#include <sofa/geometry/Triangle.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace sofa::helper
+{
+
+namespace
+{
+
+using Node = TriangleBVH::Node;
+
+/// Bounding boxes and centroids of the triangles, used during the construction only
+struct TriangleBounds
+{
+    type::vector<type::Vec3> bbmin;
+    type::vector<type::Vec3> bbmax;
+    type::vector<type::Vec3> centroid;
+};
+
+/// Lower part of the hierarchy, built independently from the other subtrees
+struct Subtree
+{
+    unsigned int node;
+    unsigned int begin;
+    unsigned int end;
+    type::vector<Node> nodes;
+};
+
+/// The depth of the hierarchy is bounded by the median split
+constexpr std::size_t MaxStackSize = 64;
+
+void buildNode(type::vector<Node>& nodes, unsigned int nodeId, unsigned int begin, unsigned int end,
+               type::vector<int>& triangleIds, const TriangleBounds& bounds,
+               unsigned int deferredSize, type::vector<Subtree>* deferred)
+{
+    constexpr SReal maxReal = std::numeric_limits<SReal>::max();
+    type::Vec3 bbmin(maxReal, maxReal, maxReal), bbmax(-maxReal, -maxReal, -maxReal);
+    type::Vec3 cmin = bbmin, cmax = bbmax;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        const int t = triangleIds[i];
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            bbmin[c] = std::min(bbmin[c], bounds.bbmin[t][c]);
+            bbmax[c] = std::max(bbmax[c], bounds.bbmax[t][c]);
+            cmin[c] = std::min(cmin[c], bounds.centroid[t][c]);
+            cmax[c] = std::max(cmax[c], bounds.centroid[t][c]);
+        }
+    }
+    nodes[nodeId].bbmin = bbmin;
+    nodes[nodeId].bbmax = bbmax;
+
+    const unsigned int count = end - begin;
+    if (count <= TriangleBVH::MaxLeafSize)
+    {
+        nodes[nodeId].index = begin;
+        nodes[nodeId].count = count;
+        return;
+    }
+
+    if (deferred && count <= deferredSize)
+    {
+        deferred->push_back({nodeId, begin, end, {}});
+        return;
+    }
+
+    // median split along the largest extent of the centroids
+    const type::Vec3 extent = cmax - cmin;
+    unsigned int axis = 0;
+    if (extent[1] > extent[axis]) axis = 1;
+    if (extent[2] > extent[axis]) axis = 2;
+
+    const unsigned int mid = begin + count / 2;
+    std::nth_element(triangleIds.begin() + begin, triangleIds.begin() + mid, triangleIds.begin() + end,
+        [&bounds, axis](int a, int b)
+        {
+            return bounds.centroid[a][axis] < bounds.centroid[b][axis];
+        });
+
+    const auto firstChild = static_cast<unsigned int>(nodes.size());
+    nodes.resize(nodes.size() + 2);
+    nodes[nodeId].index = firstChild;
+    nodes[nodeId].count = 0;
+
+    buildNode(nodes, firstChild, begin, mid, triangleIds, bounds, deferredSize, deferred);
+    buildNode(nodes, firstChild + 1, mid, end, triangleIds, bounds, deferredSize, deferred);
+}
+
+type::Vec3 inverseDirection(const type::Vec3& direction)
+{
+    type::Vec3 invDir;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+        // a huge value instead of an infinite one avoids NaN when the origin is on a slab
+        invDir[c] = direction[c] != 0 ? 1 / direction[c] : std::numeric_limits<SReal>::max();
+    }
+    return invDir;
+}
+
+/// Slab test between a ray and the bounding box of a node, for abscissas in [0, tmax]
+bool intersectBox(const Node& node, const type::Vec3& origin, const type::Vec3& invDir, SReal tmax, SReal& tEnter)
+{
+    SReal t0 = 0, t1 = tmax;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+        SReal a = (node.bbmin[c] - origin[c]) * invDir[c];
+        SReal b = (node.bbmax[c] - origin[c]) * invDir[c];
+        if (a > b) std::swap(a, b);
+        t0 = std::max(t0, a);
+        t1 = std::min(t1, b);
+    }
+    tEnter = t0;
+    return t0 <= t1;
+}
+
+} // anonymous namespace
+
+void TriangleBVH::clear()
+{
+    m_nodes.clear();
+    m_triangleIds.clear();
+    m_triangles = nullptr;
+    m_positions = nullptr;
+}
+
+void TriangleBVH::build(const SeqTriangles& triangles, const VecCoord& positions, const ParallelForRange& parallelFor)
+{
+    clear();
+    m_triangles = &triangles;
+    m_positions = &positions;
+
+    const std::size_t nbTriangles = triangles.size();
+    if (nbTriangles == 0)
+        return;
+
+    TriangleBounds bounds;
+    bounds.bbmin.resize(nbTriangles);
+    bounds.bbmax.resize(nbTriangles);
+    bounds.centroid.resize(nbTriangles);
+    m_triangleIds.resize(nbTriangles);
+
+    const RangeTask computeTriangleBounds = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t t = begin; t < end; ++t)
+        {
+            const Tri& tri = triangles[t];
+            const Coord& p0 = positions[tri[0]];
+            const Coord& p1 = positions[tri[1]];
+            const Coord& p2 = positions[tri[2]];
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+                bounds.bbmin[t][c] = std::min({ p0[c], p1[c], p2[c] });
+                bounds.bbmax[t][c] = std::max({ p0[c], p1[c], p2[c] });
+            }
+            bounds.centroid[t] = (p0 + p1 + p2) / 3;
+            m_triangleIds[t] = static_cast<int>(t);
+        }
+    };
+
+    if (parallelFor)
+        parallelFor(nbTriangles, computeTriangleBounds);
+    else
+        computeTriangleBounds(0, nbTriangles);
+
+    m_nodes.reserve(2 * nbTriangles / MaxLeafSize + 1);
+    m_nodes.resize(1);
+
+    if (!parallelFor)
+    {
+        buildNode(m_nodes, 0, 0, static_cast<unsigned int>(nbTriangles), m_triangleIds, bounds, 0, nullptr);
+        return;
+    }
+
+    // The upper levels are built sequentially, until the subtrees are small enough to be
+    // built independently. Each subtree sorts its own range of triangles.
+    const auto deferredSize = static_cast<unsigned int>(std::max<std::size_t>(nbTriangles / 64, 1024));
+    type::vector<Subtree> subtrees;
+    buildNode(m_nodes, 0, 0, static_cast<unsigned int>(nbTriangles), m_triangleIds, bounds, deferredSize, &subtrees);
+
+    parallelFor(subtrees.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t s = begin; s < end; ++s)
+        {
+            Subtree& subtree = subtrees[s];
+            subtree.nodes.resize(1);
+            buildNode(subtree.nodes, 0, subtree.begin, subtree.end, m_triangleIds, bounds, 0, nullptr);
+        }
+    });
+
+    // the root of a subtree replaces its placeholder, the other nodes are appended
+    for (const Subtree& subtree : subtrees)
+    {
+        const auto offset = static_cast<unsigned int>(m_nodes.size());
+        const auto relocate = [offset](Node node)
+        {
+            if (!node.isLeaf())
+                node.index = offset + node.index - 1;
+            return node;
+        };
+
+        m_nodes[subtree.node] = relocate(subtree.nodes[0]);
+        for (std::size_t i = 1; i < subtree.nodes.size(); ++i)
+        {
+            m_nodes.push_back(relocate(subtree.nodes[i]));
+        }
+    }
+}
+
+template<class LeafFunction>
+void TriangleBVH::traverseRay(const type::Vec3& origin, const type::Vec3& direction, const LeafFunction& leafFunction) const
+{
+    if (m_nodes.empty())
+        return;
+
+    const type::Vec3 invDir = inverseDirection(direction);
+    SReal tmax = std::numeric_limits<SReal>::max();
+
+    SReal tEnter = 0;
+    if (!intersectBox(m_nodes[0], origin, invDir, tmax, tEnter))
+        return;
+
+    std::array<std::pair<unsigned int, SReal>, MaxStackSize> stack;
+    std::size_t stackSize = 0;
+    unsigned int current = 0;
+
+    while (true)
+    {
+        const Node& node = m_nodes[current];
+        if (node.isLeaf())
+        {
+            leafFunction(node, tmax);
+        }
+        else
+        {
+            SReal t0 = 0, t1 = 0;
+            const bool hit0 = intersectBox(m_nodes[node.index], origin, invDir, tmax, t0);
+            const bool hit1 = intersectBox(m_nodes[node.index + 1], origin, invDir, tmax, t1);
+            if (hit0 && hit1)
+            {
+                // visit the nearest child first
+                const bool firstIsNearest = t0 <= t1;
+                stack[stackSize++] = firstIsNearest ? std::make_pair(node.index + 1, t1) : std::make_pair(node.index, t0);
+                current = firstIsNearest ? node.index : node.index + 1;
+                continue;
+            }
+            if (hit0 || hit1)
+            {
+                current = hit0 ? node.index : node.index + 1;
+                continue;
+            }
+        }
+
+        // skip the pending nodes that are now farther than tmax
+        do
+        {
+            if (stackSize == 0)
+                return;
+            --stackSize;
+        } while (stack[stackSize].second > tmax);
+        current = stack[stackSize].first;
+    }
+}
+
+int TriangleBVH::trace(const type::Vec3& origin, const type::Vec3& direction, traceResult& result) const
+{
+    result = traceResult();
+    const VecCoord& pos = *m_positions;
+    const SeqTriangles& tri = *m_triangles;
+
+    traverseRay(origin, direction, [&](const Node& leaf, SReal& tmax)
+    {
+        SReal t, u, v;
+        for (unsigned int i = leaf.index; i < leaf.index + leaf.count; ++i)
+        {
+            const Tri& tr = tri[m_triangleIds[i]];
+            if (sofa::geometry::Triangle::rayIntersection(pos[tr[0]], pos[tr[1]], pos[tr[2]], origin, direction, t, u, v)
+                && t < tmax)
+            {
+                tmax = t;
+                result.t = t;
+                result.u = u;
+                result.v = v;
+                result.tid = m_triangleIds[i];
+            }
+        }
+    });
+
+    return result.tid;
+}
+
+void TriangleBVH::tracePacket(const type::Vec3* origins, const type::Vec3* directions, std::size_t nbRays, traceResult* results) const
+{
+    using PacketReal = std::array<SReal, PacketSize>;
+
+    for (std::size_t i = 0; i < nbRays; ++i)
+    {
+        results[i] = traceResult();
+    }
+    if (m_nodes.empty())
+        return;
+
+    const VecCoord& pos = *m_positions;
+    const SeqTriangles& tri = *m_triangles;
+
+    for (std::size_t first = 0; first < nbRays; first += PacketSize)
+    {
+        const std::size_t packetSize = std::min(PacketSize, nbRays - first);
+
+        // structure of arrays: the box tests are performed on all the rays of the packet at once
+        PacketReal ox{}, oy{}, oz{}, ix{}, iy{}, iz{}, tmax;
+        for (std::size_t k = 0; k < PacketSize; ++k)
+        {
+            if (k < packetSize)
+            {
+                const type::Vec3& o = origins[first + k];
+                const type::Vec3 invDir = inverseDirection(directions[first + k]);
+                ox[k] = o[0]; oy[k] = o[1]; oz[k] = o[2];
+                ix[k] = invDir[0]; iy[k] = invDir[1]; iz[k] = invDir[2];
+                tmax[k] = std::numeric_limits<SReal>::max();
+            }
+            else
+            {
+                // inactive ray: never intersects a box
+                tmax[k] = -1;
+            }
+        }
+
+        std::array<unsigned int, MaxStackSize> stack;
+        std::size_t stackSize = 0;
+        unsigned int current = 0;
+
+        while (true)
+        {
+            const Node& node = m_nodes[current];
+
+            std::array<bool, PacketSize> hit;
+            for (std::size_t k = 0; k < PacketSize; ++k)
+            {
+                const SReal ax = (node.bbmin[0] - ox[k]) * ix[k], bx = (node.bbmax[0] - ox[k]) * ix[k];
+                const SReal ay = (node.bbmin[1] - oy[k]) * iy[k], by = (node.bbmax[1] - oy[k]) * iy[k];
+                const SReal az = (node.bbmin[2] - oz[k]) * iz[k], bz = (node.bbmax[2] - oz[k]) * iz[k];
+                const SReal t0 = std::max(std::max(std::min(ax, bx), std::min(ay, by)), std::max(std::min(az, bz), SReal(0)));
+                const SReal t1 = std::min(std::min(std::max(ax, bx), std::max(ay, by)), std::min(std::max(az, bz), tmax[k]));
+                hit[k] = t0 <= t1;
+            }
+
+            bool anyHit = false;
+            for (std::size_t k = 0; k < PacketSize; ++k)
+            {
+                anyHit |= hit[k];
+            }
+
+            if (anyHit)
+            {
+                if (!node.isLeaf())
+                {
+                    stack[stackSize++] = node.index + 1;
+                    current = node.index;
+                    continue;
+                }
+
+                SReal t, u, v;
+                for (unsigned int i = node.index; i < node.index + node.count; ++i)
+                {
+                    const Tri& tr = tri[m_triangleIds[i]];
+                    for (std::size_t k = 0; k < packetSize; ++k)
+                    {
+                        if (hit[k] && sofa::geometry::Triangle::rayIntersection(pos[tr[0]], pos[tr[1]], pos[tr[2]],
+                                                                                origins[first + k], directions[first + k], t, u, v)
+                            && t < tmax[k])
+                        {
+                            tmax[k] = t;
+                            traceResult& result = results[first + k];
+                            result.t = t;
+                            result.u = u;
+                            result.v = v;
+                            result.tid = m_triangleIds[i];
+                        }
+                    }
+                }
+            }
+
+            if (stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+    }
+}
+
+void TriangleBVH::traceAll(const type::Vec3& origin, const type::Vec3& direction, type::vector<traceResult>& results) const
+{
+    const VecCoord& pos = *m_positions;
+    const SeqTriangles& tri = *m_triangles;
+
+    traverseRay(origin, direction, [&](const Node& leaf, SReal& /*tmax*/)
+    {
+        SReal t, u, v;
+        for (unsigned int i = leaf.index; i < leaf.index + leaf.count; ++i)
+        {
+            const Tri& tr = tri[m_triangleIds[i]];
+            if (sofa::geometry::Triangle::rayIntersection(pos[tr[0]], pos[tr[1]], pos[tr[2]], origin, direction, t, u, v))
+            {
+                traceResult result;
+                result.t = t;
+                result.u = u;
+                result.v = v;
+                result.tid = m_triangleIds[i];
+                results.push_back(result);
+            }
+        }
+    });
+}
+
+void TriangleBVH::traceAllCandidates(const type::Vec3& origin, const type::Vec3& direction, type::vector<int>& results) const
+{
+    traverseRay(origin, direction, [&](const Node& leaf, SReal& /*tmax*/)
+    {
+        results.insert(results.end(), m_triangleIds.begin() + leaf.index, m_triangleIds.begin() + leaf.index + leaf.count);
+    });
+}
+
+void TriangleBVH::bboxAllCandidates(const type::Vec3& bbmin, const type::Vec3& bbmax, type::vector<int>& results) const
+{
+    if (m_nodes.empty())
+        return;
+
+    const VecCoord& pos = *m_positions;
+    const SeqTriangles& tri = *m_triangles;
+
+    const auto overlaps = [&bbmin, &bbmax](const type::Vec3& min, const type::Vec3& max)
+    {
+        return min[0] <= bbmax[0] && max[0] >= bbmin[0]
+            && min[1] <= bbmax[1] && max[1] >= bbmin[1]
+            && min[2] <= bbmax[2] && max[2] >= bbmin[2];
+    };
+
+    std::array<unsigned int, MaxStackSize> stack;
+    std::size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+        if (!overlaps(node.bbmin, node.bbmax))
+            continue;
+
+        if (!node.isLeaf())
+        {
+            stack[stackSize++] = node.index + 1;
+            stack[stackSize++] = node.index;
+            continue;
+        }
+
+        for (unsigned int i = node.index; i < node.index + node.count; ++i)
+        {
+            const int t = m_triangleIds[i];
+            type::Vec3 tmin = pos[tri[t][0]];
+            type::Vec3 tmax = tmin;
+            for (int j = 1; j < 3; ++j)
+            {
+                const type::Vec3& p = pos[tri[t][j]];
+                for (int c = 0; c < 3; ++c)
+                {
+                    tmin[c] = std::min(tmin[c], p[c]);
+                    tmax[c] = std::max(tmax[c], p[c]);
+                }
+            }
+            if (overlaps(tmin, tmax))
+            {
+                results.push_back(t);
+            }
+        }
+    }
+}
+
+void TriangleBVH::draw(sofa::helper::visual::DrawTool* drawTool) const
+{
+    for (const Node& node : m_nodes)
+    {
+        if (node.isLeaf())
+        {
+            drawTool->drawBoundingBox(node.bbmin, node.bbmax);
+        }
+    }
+}
+
+} // namespace sofa::helper
@@ -0,0 +1,131 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/helper/config.h>
+
+#include <sofa/helper/TriangleOctree.h>
+#include <sofa/type/Vec.h>
+#include <sofa/type/vector.h>
+#include <sofa/topology/Triangle.h>
+#include <functional>
+
+namespace sofa::helper
+{
+
+namespace visual
+{
+    class DrawTool;
+}
+
+/**
+ * Bounding volume hierarchy of a triangle mesh, stored in a linear array of nodes.
+ *
+ * It provides the same queries than TriangleOctree (nearest triangle along a ray,
+ * triangles intersecting a ray or a bounding box), without pointer chasing and
+ * without allocations during the queries: the results are written into buffers
+ * provided by the caller. Each triangle is referenced by exactly one leaf, so the
+ * candidates are returned without duplicates.
+ *
+ * Rays can also be traced by packets: the rays of a packet traverse the hierarchy
+ * together, the bounding box tests being performed on all the rays of the packet at
+ * once (structure of arrays, vectorized by the compiler).
+ */
+class SOFA_HELPER_API TriangleBVH
+{
+public:
+    typedef sofa::topology::Triangle Tri;
+    typedef sofa::type::vector<sofa::topology::Triangle> SeqTriangles;
+    typedef sofa::type::Vec3 Coord;
+    typedef sofa::type::vector<sofa::type::Vec3> VecCoord;
+    typedef TriangleOctree::traceResult traceResult;
+
+    /// maximum number of triangles in a leaf
+    static constexpr unsigned int MaxLeafSize = 4;
+
+    /// number of rays traversing the hierarchy together in tracePacket
+    static constexpr std::size_t PacketSize = 8;
+
+    struct Node
+    {
+        type::Vec3 bbmin;
+        type::Vec3 bbmax;
+
+        /// index of the first child for an inner node (the second child follows it),
+        /// or index of the first triangle in getTriangleIndices() for a leaf
+        unsigned int index { 0 };
+
+        /// number of triangles for a leaf, 0 for an inner node
+        unsigned int count { 0 };
+
+        bool isLeaf() const { return count != 0; }
+    };
+
+    /// Task processing the indices [begin, end)
+    using RangeTask = std::function<void(std::size_t /*begin*/, std::size_t /*end*/)>;
+
+    /// Calls the task on sub-ranges covering [0, size), possibly in parallel
+    using ParallelForRange = std::function<void(std::size_t /*size*/, const RangeTask&)>;
+
+    /// Build the hierarchy. If parallelFor is provided, the bounding boxes of the
+    /// triangles and the lower levels of the hierarchy are built in parallel.
+    void build(const SeqTriangles& triangles, const VecCoord& positions, const ParallelForRange& parallelFor = {});
+
+    void clear();
+
+    bool empty() const { return m_nodes.empty(); }
+
+    const type::vector<Node>& getNodes() const { return m_nodes; }
+    const type::vector<int>& getTriangleIndices() const { return m_triangleIds; }
+
+    /// Find the nearest triangle intersecting the given ray, or -1 if not found
+    int trace(const type::Vec3& origin, const type::Vec3& direction, traceResult& result) const;
+
+    /// Find the nearest triangle intersecting each of the given rays.
+    /// results[i].tid is -1 if the i-th ray does not intersect any triangle.
+    void tracePacket(const type::Vec3* origins, const type::Vec3* directions, std::size_t nbRays, traceResult* results) const;
+
+    /// Append all triangles intersecting the given ray to results
+    void traceAll(const type::Vec3& origin, const type::Vec3& direction, type::vector<traceResult>& results) const;
+
+    /// Append the triangles of all the leaves crossed by the given ray to results
+    void traceAllCandidates(const type::Vec3& origin, const type::Vec3& direction, type::vector<int>& results) const;
+
+    /// Append the triangles whose bounding box intersects the given bounding box to results
+    void bboxAllCandidates(const type::Vec3& bbmin, const type::Vec3& bbmax, type::vector<int>& results) const;
+
+    void draw(sofa::helper::visual::DrawTool* drawTool) const;
+
+protected:
+    const SeqTriangles* m_triangles { nullptr };
+    const VecCoord* m_positions { nullptr };
+
+    type::vector<Node> m_nodes;
+    type::vector<int> m_triangleIds;
+
+    /// Visit the leaves crossed by the ray, nearest first. The leaf function receives the
+    /// leaf and the maximum abscissa along the ray, that it can reduce to prune the traversal.
+    template<class LeafFunction>
+    void traverseRay(const type::Vec3& origin, const type::Vec3& direction, const LeafFunction& leafFunction) const;
+};
+
+} // namespace sofa::helper
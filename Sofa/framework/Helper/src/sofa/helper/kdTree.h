@@ -22,7 +22,8 @@
 #pragma once
 
 #include <set>
-#include <list>
+#include <functional>
+#include <limits>
 
 #include <sofa/helper/config.h>
 #include <sofa/type/Vec.h>
@@ -39,6 +40,15 @@ namespace sofa::helper
 *  - Caching may be used to speed up retrieval: if dx< (d(n)-d(0))/2, then the closest point is in the n-1 cached points (updateCachedDistances is used to update the n-1 distances)
 *  see for instance: [zhang92] report and [simon96] thesis for more details
 *
+*  The tree is implicit: the points are stored in tree order, the node of a range [begin,end) being
+*  its median (begin+end)/2, so that no child index is stored. Each node stores the bounding box of
+*  its subtree, which is used to prune the search. When the points move slightly, the tree can be
+*  refitted (bounding boxes update) instead of being rebuilt: the queries remain exact, only their
+*  efficiency decreases with the displacements.
+*
+*  The construction and the batched queries can be run in parallel, by providing a parallel loop
+*  (e.g. based on the task scheduler).
+*
 *  @author Benjamin Gilles
 **/
 
@@ -54,22 +64,37 @@ public:
     typedef std::pair<Real,unsigned int> distanceToPoint;
     typedef std::set<distanceToPoint> distanceSet;
     typedef typename distanceSet::iterator distanceSetIt;
-    typedef std::list<unsigned int> UIlist;
-
-    typedef struct
-    {
-        unsigned char splitdir; // 0/1/2 -> x/y/z
-        unsigned int left;	// index of the left node
-        unsigned int right; // index of the right node
-    } TREENODE;
-
-    bool isEmpty() const {return tree.size()==0;}
-    void build(const VecCoord& positions);       ///< update tree (to be used whenever positions have changed)
-    void build(const VecCoord& positions, const type::vector<unsigned int> &ROI);       ///< update tree based on positions subset (to be used whenever points p have changed)
-    void getNClosest(distanceSet &cl, const Coord &x, const VecCoord& positions, const unsigned int n) const;  ///< get an ordered set of n distance/index pairs between positions and x
-    unsigned int getClosest(const Coord &x, const VecCoord& positions) const; ///< get the index of the closest point between positions and x
+
+    /// Task processing the indices [begin, end)
+    using RangeTask = std::function<void(std::size_t /*begin*/, std::size_t /*end*/)>;
+
+    /// Calls the task on sub-ranges covering [0, size), possibly in parallel
+    using ParallelForRange = std::function<void(std::size_t /*size*/, const RangeTask&)>;
+
+    /// index used to fill the results when there are less points in the tree than requested
+    static constexpr unsigned int InvalidIndex = std::numeric_limits<unsigned int>::max();
+
+    bool isEmpty() const {return m_indices.size()==0;}
+    void build(const VecCoord& positions, const ParallelForRange& parallelFor = {});       ///< update tree (to be used whenever positions have changed)
+    void build(const VecCoord& positions, const type::vector<unsigned int> &ROI, const ParallelForRange& parallelFor = {});       ///< update tree based on positions subset (to be used whenever points p have changed)
+    void refit(const VecCoord& positions, const ParallelForRange& parallelFor = {});       ///< update the bounding boxes of the tree, whose structure is kept (to be used when positions have slightly changed)
+    void getNClosest(distanceSet &cl, const Coord &x, const unsigned int n) const;  ///< get an ordered set of n distance/index pairs between the points of the tree and x
+    unsigned int getClosest(const Coord &x) const; ///< get the index of the closest point of the tree to x
+
+    SOFA_HELPER_KDTREE_POSITIONS_DEPRECATED()
+    void getNClosest(distanceSet &cl, const Coord &x, const VecCoord& /*positions*/, const unsigned int n) const { getNClosest(cl, x, n); }
+    SOFA_HELPER_KDTREE_POSITIONS_DEPRECATED()
+    unsigned int getClosest(const Coord &x, const VecCoord& /*positions*/) const { return getClosest(x); }
+
     bool getNClosestCached(distanceSet &cl, distanceToPoint &cacheThresh_max, distanceToPoint &cacheThresh_min, Coord &previous_x, const Coord &x, const VecCoord& positions, const unsigned int n) const;  ///< use distance caching to accelerate closest point computation when positions are fixed (see simon96 thesis)
 
+    /// Batched query: the n closest points of queries[i], sorted by increasing distance, are written
+    /// in results[i*n] ... results[i*n+n-1]. The missing entries are filled with (max, InvalidIndex).
+    void getNClosest(type::vector<distanceToPoint>& results, const VecCoord& queries, const unsigned int n, const ParallelForRange& parallelFor = {}) const;
+
+    /// Batched query: index of the closest point of each query point
+    void getClosest(type::vector<unsigned int>& results, const VecCoord& queries, const ParallelForRange& parallelFor = {}) const;
+
 
     /// @name To be Data-zable
     /// @{
@@ -78,13 +103,20 @@ public:
     /// @}
 
 protected :
-    void print(const unsigned int index);
+    type::vector<unsigned int> m_indices; ///< indices of the points, in tree order
+    type::vector<Coord> m_points;         ///< copy of the points, in tree order
+    type::vector<Coord> m_bbmin;          ///< lower corner of the bounding box of the subtree of each node
+    type::vector<Coord> m_bbmax;          ///< upper corner of the bounding box of the subtree of each node
+
+    static unsigned int node(unsigned int begin, unsigned int end) { return begin + (end - begin) / 2; } // node of the range [begin,end)
 
-    type::vector< TREENODE > tree; unsigned int firstNode;
+    void buildFromIndices(const VecCoord& positions, const ParallelForRange& parallelFor); // build the tree from the points listed in m_indices
+    void buildRange(const VecCoord& positions, unsigned int begin, unsigned int end, unsigned int deferredSize, type::vector<std::pair<unsigned int, unsigned int> >* deferred); // recursive function to build the kdtree
+    void refitRange(unsigned int begin, unsigned int end); // recursive function to update the bounding boxes
 
-    unsigned int build(UIlist &list, unsigned char direction, const VecCoord& positions); // recursive function to build the kdtree
-    void closest(distanceSet &cl, const Coord &x, const unsigned int &currentnode, const VecCoord& positions, unsigned N) const;     // recursive function to get closest points
-    void closest(distanceToPoint &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions) const;  // recursive function to get closest point
+    Real distanceToBox(const Coord& x, unsigned int nodeIndex) const; // squared distance between x and the bounding box of a node
+    void closest(distanceToPoint* cl, unsigned int& size, const Coord &x, unsigned int begin, unsigned int end, unsigned int N) const;     // recursive function to get closest points, sorted in cl with squared distances
+    void closest(distanceToPoint &cl, const Coord &x, unsigned int begin, unsigned int end) const;  // recursive function to get closest point, with squared distance
 };
 
 
@@ -25,145 +25,297 @@
 
 #include <sofa/helper/logging/Messaging.h>
 
-#include <map>
+#include <algorithm>
 #include <limits>
-#include <iterator>
 #include <cmath>
 
 namespace sofa::helper
 {
 
 template<class Coord>
-void kdTree<Coord>::build(const VecCoord& positions)
+void kdTree<Coord>::build(const VecCoord& positions, const ParallelForRange& parallelFor)
 {
     const auto nbp = positions.size();
-    UIlist list;   for(unsigned int i=0; i<nbp; i++) list.push_back(i);
-    tree.resize(nbp);
-    firstNode=build(list,(unsigned char)0, positions);
+    m_indices.resize(nbp);
+    for(unsigned int i=0; i<nbp; i++) m_indices[i]=i;
+    buildFromIndices(positions, parallelFor);
 }
 
 template<class Coord>
-void kdTree<Coord>::build(const VecCoord& positions, const type::vector<unsigned int> &ROI)
+void kdTree<Coord>::build(const VecCoord& positions, const type::vector<unsigned int> &ROI, const ParallelForRange& parallelFor)
 {
-    const size_t nbp = ROI.size();
-    UIlist list;
-    for(size_t i=0; i<nbp; i++)
-        list.push_back(ROI[i]);
-    tree.resize(positions.size());
-    firstNode=build(list,(unsigned char)0, positions);
+    m_indices.assign(ROI.begin(), ROI.end());
+    buildFromIndices(positions, parallelFor);
 }
 
 template<class Coord>
-void kdTree<Coord>::print(const unsigned int index)
+void kdTree<Coord>::buildFromIndices(const VecCoord& positions, const ParallelForRange& parallelFor)
 {
-    dmsg_info("KDTree") << index<<"["<<(int)tree[index].splitdir<<"] "<<tree[index].left<<" "<<tree[index].right ;
-    if(tree[index].left!=index) print(tree[index].left);
-    if(tree[index].right!=index) print(tree[index].right);
+    const auto nbp = static_cast<unsigned int>(m_indices.size());
+    m_points.resize(nbp);
+    m_bbmin.resize(nbp);
+    m_bbmax.resize(nbp);
+
+    if (!parallelFor)
+    {
+        buildRange(positions, 0, nbp, 0, nullptr);
+        return;
+    }
+
+    // the upper levels are built sequentially, until the subtrees are small enough to be built independently
+    const auto deferredSize = std::max(nbp / 64, 1024u);
+    type::vector<std::pair<unsigned int, unsigned int> > subtrees;
+    buildRange(positions, 0, nbp, deferredSize, &subtrees);
+
+    parallelFor(subtrees.size(), [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t s = begin; s < end; ++s)
+        {
+            buildRange(positions, subtrees[s].first, subtrees[s].second, 0, nullptr);
+        }
+    });
 }
 
 template<class Coord>
-unsigned int kdTree<Coord>::build(UIlist &list, unsigned char direction, const VecCoord& positions)
+void kdTree<Coord>::buildRange(const VecCoord& positions, unsigned int begin, unsigned int end, unsigned int deferredSize, type::vector<std::pair<unsigned int, unsigned int> >* deferred)
 {
-    // detect leaf
-    if(list.size()==(unsigned int)1)
+    if (begin >= end)
+        return;
+
+    if (deferred && end - begin <= deferredSize)
+    {
+        deferred->emplace_back(begin, end);
+        return;
+    }
+
+    // bounding box of the points of the subtree
+    Coord bbmin = positions[m_indices[begin]], bbmax = bbmin;
+    for (unsigned int i = begin + 1; i < end; ++i)
+    {
+        const Coord& p = positions[m_indices[i]];
+        for (unsigned int c = 0; c < dim; ++c)
+        {
+            bbmin[c] = std::min(bbmin[c], p[c]);
+            bbmax[c] = std::max(bbmax[c], p[c]);
+        }
+    }
+
+    // split at the median along the largest extent
+    unsigned int splitdir = 0;
+    for (unsigned int c = 1; c < dim; ++c)
     {
-        unsigned int index=list.front(); list.pop_front();
-        tree[index].left=tree[index].right=index;
-        tree[index].splitdir=direction;
-        return index;
+        if (bbmax[c] - bbmin[c] > bbmax[splitdir] - bbmin[splitdir]) splitdir = c;
     }
-    // ordered list of 1D coord
-    distanceSet q;
-    UIlist::iterator it;
-    for(it=list.begin(); it!=list.end(); it++) q.insert( distanceToPoint(positions[*it][direction],*it));
-    it=list.begin();    for(distanceSetIt sit=q.begin(); sit!=q.end(); sit++) {*it=sit->second; it++;}
-    // split list in 2
-    it=list.begin(); advance (it,list.size()/2);
-    UIlist newlist;
-    newlist.splice(newlist.begin(),list,list.begin(),it);
-    // add node
-    unsigned int index=list.front(); list.pop_front();
-    tree[index].splitdir=direction;
-    tree[index].left=tree[index].right=index;
-    // split children recursively
-    unsigned char newdirection=direction+1; if(newdirection==dim) newdirection=0;
-    if(newlist.size()!=0) tree[index].left=build(newlist,newdirection,positions);
-    if(list.size()!=0) tree[index].right=build(list,newdirection,positions);
-    // return child index to parent
-    return index;
+
+    const unsigned int index = node(begin, end);
+    std::nth_element(m_indices.begin() + begin, m_indices.begin() + index, m_indices.begin() + end,
+        [&positions, splitdir](unsigned int a, unsigned int b)
+        {
+            return positions[a][splitdir] < positions[b][splitdir];
+        });
+
+    m_points[index] = positions[m_indices[index]];
+    m_bbmin[index] = bbmin;
+    m_bbmax[index] = bbmax;
+
+    buildRange(positions, begin, index, deferredSize, deferred);
+    buildRange(positions, index + 1, end, deferredSize, deferred);
 }
 
+template<class Coord>
+void kdTree<Coord>::refit(const VecCoord& positions, const ParallelForRange& parallelFor)
+{
+    const auto nbp = m_indices.size();
+    const RangeTask updatePoints = [this, &positions](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            m_points[i] = positions[m_indices[i]];
+        }
+    };
+
+    if (parallelFor)
+        parallelFor(nbp, updatePoints);
+    else
+        updatePoints(0, nbp);
+
+    refitRange(0, static_cast<unsigned int>(nbp));
+}
 
 template<class Coord>
-void kdTree<Coord>::closest(distanceSet &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions, unsigned N) const
-// [zhang94] algorithm
+void kdTree<Coord>::refitRange(unsigned int begin, unsigned int end)
 {
-    Real Dmax;
-    distanceSetIt it=cl.end();
-    if(cl.size()==N) { it--; Dmax=it->first; } else Dmax=std::numeric_limits<Real>::max();
-    unsigned int splitdir=tree[currentnode].splitdir;
-    Coord pos=positions[currentnode];
-    Real c1=x[splitdir],c2=pos[splitdir];
-    if(std::abs(c1-c2)<=Dmax)
-    {
-        Real d=(x-pos).norm();
-        if(d<Dmax)
+    if (begin >= end)
+        return;
+
+    const unsigned int index = node(begin, end);
+    refitRange(begin, index);
+    refitRange(index + 1, end);
+
+    Coord bbmin = m_points[index], bbmax = bbmin;
+    const auto merge = [&](unsigned int child)
+    {
+        for (unsigned int c = 0; c < dim; ++c)
         {
-            Dmax=d;
-            cl.insert(distanceToPoint(d,currentnode));
-            if(cl.size()>N) {it=cl.end(); it--; cl.erase(it);}
+            bbmin[c] = std::min(bbmin[c], m_bbmin[child][c]);
+            bbmax[c] = std::max(bbmax[c], m_bbmax[child][c]);
         }
+    };
+    if (begin < index) merge(node(begin, index));
+    if (index + 1 < end) merge(node(index + 1, end));
+
+    m_bbmin[index] = bbmin;
+    m_bbmax[index] = bbmax;
+}
+
+template<class Coord>
+typename kdTree<Coord>::Real kdTree<Coord>::distanceToBox(const Coord& x, unsigned int nodeIndex) const
+{
+    Real d = 0;
+    for (unsigned int c = 0; c < dim; ++c)
+    {
+        const Real delta = std::max({ m_bbmin[nodeIndex][c] - x[c], x[c] - m_bbmax[nodeIndex][c], static_cast<Real>(0) });
+        d += delta * delta;
+    }
+    return d;
+}
+
+template<class Coord>
+void kdTree<Coord>::closest(distanceToPoint* cl, unsigned int& size, const Coord &x, unsigned int begin, unsigned int end, unsigned int N) const
+// [zhang94] algorithm, with the bounding boxes of the subtrees
+{
+    const unsigned int index = node(begin, end);
+
+    // insertion in the list of the closest points, sorted by increasing distance
+    const Real d = (x - m_points[index]).norm2();
+    if (size < N || d < cl[size - 1].first)
+    {
+        unsigned int i = (size < N) ? size++ : size - 1;
+        for (; i > 0 && cl[i - 1].first > d; --i) cl[i] = cl[i - 1];
+        cl[i] = distanceToPoint(d, m_indices[index]);
+    }
+
+    // visit the nearest subtree first
+    const Real dLeft = (begin < index) ? distanceToBox(x, node(begin, index)) : std::numeric_limits<Real>::max();
+    const Real dRight = (index + 1 < end) ? distanceToBox(x, node(index + 1, end)) : std::numeric_limits<Real>::max();
+    const auto visit = [&](unsigned int b, unsigned int e, Real dBox)
+    {
+        if (b < e && (size < N || dBox < cl[size - 1].first)) closest(cl, size, x, b, e, N);
+    };
+    if (dLeft <= dRight)
+    {
+        visit(begin, index, dLeft);
+        visit(index + 1, end, dRight);
+    }
+    else
+    {
+        visit(index + 1, end, dRight);
+        visit(begin, index, dLeft);
     }
-    if(tree[currentnode].left!=currentnode)     if(c1-Dmax<c2)  closest(cl,x,tree[currentnode].left,positions,N);
-    if(tree[currentnode].right!=currentnode)    if(c2-Dmax<c1)  closest(cl,x,tree[currentnode].right,positions,N);
 }
 
 
 // slightly improved version of the above, for one point
 template<class Coord>
-void kdTree<Coord>::closest(distanceToPoint &cl,const Coord &x, const unsigned int &currentnode, const VecCoord& positions) const
+void kdTree<Coord>::closest(distanceToPoint &cl,const Coord &x, unsigned int begin, unsigned int end) const
 {
-    Real Dmax=cl.first;
-    unsigned int splitdir=tree[currentnode].splitdir;
-    Coord pos=positions[currentnode];
-    Real c1=x[splitdir],c2=pos[splitdir];
-    if(std::abs(c1-c2)<=Dmax)
-    {
-        Real d=(x-pos).norm();
-        if(d<Dmax)
-        {
-            Dmax=d;
-            cl.first=d;
-            cl.second=currentnode;
-        }
+    const unsigned int index = node(begin, end);
+
+    const Real d = (x - m_points[index]).norm2();
+    if (d < cl.first)
+    {
+        cl.first = d;
+        cl.second = m_indices[index];
+    }
+
+    const Real dLeft = (begin < index) ? distanceToBox(x, node(begin, index)) : std::numeric_limits<Real>::max();
+    const Real dRight = (index + 1 < end) ? distanceToBox(x, node(index + 1, end)) : std::numeric_limits<Real>::max();
+    if (dLeft <= dRight)
+    {
+        if (begin < index && dLeft < cl.first) closest(cl, x, begin, index);
+        if (index + 1 < end && dRight < cl.first) closest(cl, x, index + 1, end);
+    }
+    else
+    {
+        if (index + 1 < end && dRight < cl.first) closest(cl, x, index + 1, end);
+        if (begin < index && dLeft < cl.first) closest(cl, x, begin, index);
     }
-    if(tree[currentnode].left!=currentnode)     if(c1-Dmax<c2)  closest(cl,x,tree[currentnode].left,positions);
-    if(tree[currentnode].right!=currentnode)    if(c2-Dmax<c1)  closest(cl,x,tree[currentnode].right,positions);
 }
 
 
 template<class Coord>
-void kdTree<Coord>::getNClosest(distanceSet &cl, const Coord &x, const VecCoord& positions, const unsigned int n) const
+void kdTree<Coord>::getNClosest(distanceSet &cl, const Coord &x, const unsigned int n) const
 {
     cl.clear();
-    closest(cl,x,firstNode,positions,n);
+    if (isEmpty() || n == 0) return;
+
+    type::vector<distanceToPoint> closestPoints(n);
+    unsigned int size = 0;
+    closest(closestPoints.data(), size, x, 0, static_cast<unsigned int>(m_indices.size()), n);
+    for (unsigned int i = 0; i < size; ++i)
+        cl.insert(distanceToPoint(std::sqrt(closestPoints[i].first), closestPoints[i].second));
 }
 
 template<class Coord>
-unsigned int kdTree<Coord>::getClosest(const Coord &x, const VecCoord& positions) const
+unsigned int kdTree<Coord>::getClosest(const Coord &x) const
 {
-    distanceToPoint cl(std::numeric_limits<Real>::max(),firstNode);
-    closest(cl,x,firstNode,positions);
+    distanceToPoint cl(std::numeric_limits<Real>::max(), InvalidIndex);
+    if (!isEmpty()) closest(cl, x, 0, static_cast<unsigned int>(m_indices.size()));
     return cl.second;
 }
 
+template<class Coord>
+void kdTree<Coord>::getNClosest(type::vector<distanceToPoint>& results, const VecCoord& queries, const unsigned int n, const ParallelForRange& parallelFor) const
+{
+    results.resize(queries.size() * n);
+    if (n == 0) return;
+
+    const RangeTask query = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t q = begin; q < end; ++q)
+        {
+            distanceToPoint* cl = results.data() + q * n;
+            unsigned int size = 0;
+            if (!isEmpty()) closest(cl, size, queries[q], 0, static_cast<unsigned int>(m_indices.size()), n);
+            for (unsigned int i = 0; i < size; ++i) cl[i].first = std::sqrt(cl[i].first);
+            for (unsigned int i = size; i < n; ++i) cl[i] = distanceToPoint(std::numeric_limits<Real>::max(), InvalidIndex);
+        }
+    };
+
+    if (parallelFor)
+        parallelFor(queries.size(), query);
+    else
+        query(0, queries.size());
+}
+
+template<class Coord>
+void kdTree<Coord>::getClosest(type::vector<unsigned int>& results, const VecCoord& queries, const ParallelForRange& parallelFor) const
+{
+    results.resize(queries.size());
+
+    const RangeTask query = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t q = begin; q < end; ++q)
+        {
+            distanceToPoint cl(std::numeric_limits<Real>::max(), InvalidIndex);
+            if (!isEmpty()) closest(cl, queries[q], 0, static_cast<unsigned int>(m_indices.size()));
+            results[q] = cl.second;
+        }
+    };
+
+    if (parallelFor)
+        parallelFor(queries.size(), query);
+    else
+        query(0, queries.size());
+}
+
 template<class Coord>
 bool kdTree<Coord>::getNClosestCached(distanceSet &cl,  distanceToPoint &cacheThresh_max, distanceToPoint &cacheThresh_min, Coord &previous_x, const Coord &x, const VecCoord& positions, const unsigned int n) const
 {
     Real dx=(previous_x-x).norm();
     if(dx>=cacheThresh_max.first || cl.size()<2)
     {
-        getNClosest(cl,x,positions,n);
+        getNClosest(cl,x,n);
         distanceSetIt it0=cl.begin(), it1=it0; it1++;
         typename distanceSet::reverse_iterator itn=cl.rbegin();
         cacheThresh_max.first=((itn->first)-(it0->first))*(Real)0.5; // half distance between first and last closest points
@@ -79,7 +79,7 @@ struct KdTreeTest: public BaseTest
 
         for(unsigned int i=0;i<nbp_source;i++)
         {
-            unsigned int closest_kdt=KDT.getClosest(sourceposition[i],targetposition);
+            unsigned int closest_kdt=KDT.getClosest(sourceposition[i]);
             distanceSet closest_brute; getClosetNPoints(closest_brute,sourceposition[i],targetposition,1);
             ASSERT_EQ( closest_brute.begin()->second , closest_kdt);
         }
@@ -98,7 +98,7 @@ struct KdTreeTest: public BaseTest
 
         for(unsigned int i=0;i<nbp_source;i++)
         {
-            distanceSet closest_kdt; KDT.getNClosest(closest_kdt, sourceposition[i],targetposition,N);
+            distanceSet closest_kdt; KDT.getNClosest(closest_kdt, sourceposition[i],N);
             distanceSet closest_brute; getClosetNPoints(closest_brute,sourceposition[i],targetposition,N);
             distanceSet::iterator closestKdt=closest_kdt.begin();
             for(distanceSet::iterator closestBrute=closest_brute.begin();closestBrute!=closest_brute.end();++closestBrute)
@@ -136,11 +136,89 @@ struct KdTreeTest: public BaseTest
 
     }
 
+    /// test if the batched queries find the same N closest points as the brute force, before and after a refit
+    void testBatchedCorrespondences(const unsigned int nbp_source, const unsigned int nbp_target,const Real range, const Real dprange, const unsigned int N, bool parallel)
+    {
+        kdT::VecCoord sourceposition;
+        generateRandomPoint(sourceposition,nbp_source,range);
+        kdT::VecCoord targetposition;
+        generateRandomPoint(targetposition,nbp_target,range);
+
+        // sequential loop split in chunks, to mimic a parallel loop
+        kdT::ParallelForRange parallelFor;
+        if (parallel)
+        {
+            parallelFor = [](std::size_t size, const kdT::RangeTask& task)
+            {
+                for (std::size_t begin = 0; begin < size; begin += 7) task(begin, std::min(begin + 7, size));
+            };
+        }
+
+        kdT KDT;
+        KDT.build(targetposition, parallelFor);
+
+        for (unsigned int step = 0; step < 2; ++step)
+        {
+            type::vector<distanceToPoint> closest_kdt;
+            KDT.getNClosest(closest_kdt, sourceposition, N, parallelFor);
+            ASSERT_EQ(closest_kdt.size(), nbp_source * N);
+
+            type::vector<unsigned int> closestPoint_kdt;
+            KDT.getClosest(closestPoint_kdt, sourceposition, parallelFor);
+            ASSERT_EQ(closestPoint_kdt.size(), nbp_source);
+
+            for(unsigned int i=0;i<nbp_source;i++)
+            {
+                distanceSet closest_brute; getClosetNPoints(closest_brute,sourceposition[i],targetposition,N);
+                unsigned int j = i * N;
+                for(distanceSet::iterator closestBrute=closest_brute.begin();closestBrute!=closest_brute.end();++closestBrute, ++j)
+                {
+                    ASSERT_EQ( closestBrute->second , closest_kdt[j].second);
+                    ASSERT_NEAR( std::sqrt(closestBrute->first) , closest_kdt[j].first, 1e-6);
+                }
+                ASSERT_EQ( closest_brute.begin()->second , closestPoint_kdt[i]);
+            }
+
+            // small displacement of the target points: the tree is refitted instead of rebuilt
+            kdT::VecCoord displacement;
+            generateRandomPoint(displacement,nbp_target,dprange);
+            for(unsigned int i=0;i<nbp_target;i++) targetposition[i] += displacement[i];
+            KDT.refit(targetposition, parallelFor);
+        }
+    }
+
+    /// test the padding of the results when there are less points than requested
+    void testMissingPoints()
+    {
+        kdT::VecCoord targetposition;
+        generateRandomPoint(targetposition,3,1);
+        const kdT::VecCoord sourceposition { Coord(0,0,0) };
+
+        kdT KDT;
+        KDT.build(targetposition);
+
+        type::vector<distanceToPoint> closest_kdt;
+        KDT.getNClosest(closest_kdt, sourceposition, 5);
+        ASSERT_EQ(closest_kdt.size(), 5u);
+        for (unsigned int i = 0; i < 3; ++i) EXPECT_NE(closest_kdt[i].second, kdT::InvalidIndex);
+        for (unsigned int i = 3; i < 5; ++i) EXPECT_EQ(closest_kdt[i].second, kdT::InvalidIndex);
+
+        kdT emptyTree;
+        emptyTree.build(kdT::VecCoord());
+        type::vector<unsigned int> closestPoint_kdt;
+        emptyTree.getClosest(closestPoint_kdt, sourceposition);
+        ASSERT_EQ(closestPoint_kdt.size(), 1u);
+        EXPECT_EQ(closestPoint_kdt[0], kdT::InvalidIndex);
+    }
+
 };
 
 TEST_F(KdTreeTest, point_point ) {    testPointPointCorrespondences(100,100,10); }
 TEST_F(KdTreeTest, point_Npoints ) {   testPointNPointsCorrespondences(100,100,10,10); }
 TEST_F(KdTreeTest, cached_point_point ) {   testCachedPointPointCorrespondences(100,100,10,0.5,5); }
+TEST_F(KdTreeTest, batched_Npoints ) {   testBatchedCorrespondences(100,2000,10,0.5,10,false); }
+TEST_F(KdTreeTest, batched_Npoints_parallel ) {   testBatchedCorrespondences(100,5000,10,0.5,10,true); }
+TEST_F(KdTreeTest, missing_points ) {   testMissingPoints(); }
 
 
 } // namespace sofa
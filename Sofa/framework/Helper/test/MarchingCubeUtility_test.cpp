@@ -0,0 +1,200 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/MarchingCubeUtility.h>
+
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <algorithm>
+
+
+namespace sofa
+{
+
+struct MarchingCubeUtilityTest : public BaseTest
+{
+    using MarchingCubeUtility = helper::MarchingCubeUtility;
+    using PointID = MarchingCubeUtility::PointID;
+
+    const type::Vec3i resolution { 37, 29, 45 };
+    type::vector<unsigned char> data;
+
+    void onSetUp() override
+    {
+        data.resize(resolution[0] * resolution[1] * resolution[2]);
+        for (int k = 0; k < resolution[2]; ++k)
+            for (int j = 0; j < resolution[1]; ++j)
+                for (int i = 0; i < resolution[0]; ++i)
+                {
+                    // two overlapping balls
+                    const SReal d0 = (type::Vec3(i, j, k) - type::Vec3(15, 14, 18)).norm();
+                    const SReal d1 = (type::Vec3(i, j, k) - type::Vec3(22, 13, 28)).norm();
+                    data[index(i, j, k)] = static_cast<unsigned char>(std::clamp<SReal>(255 - 20 * std::min(d0, d1 - 3), 0, 255));
+                }
+    }
+
+    std::size_t index(int i, int j, int k) const
+    {
+        return i + resolution[0] * (j + resolution[1] * k);
+    }
+
+    MarchingCubeUtility createMarchingCubes(unsigned int convolutionSize) const
+    {
+        MarchingCubeUtility marchingCubes;
+        marchingCubes.setDataResolution(resolution);
+        marchingCubes.setDataVoxelSize(type::Vec3(0.5, 1, 2));
+        marchingCubes.setConvolutionSize(convolutionSize);
+        return marchingCubes;
+    }
+
+    /// Sequential loop split in chunks, to mimic a parallel loop
+    static void chunkedLoop(std::size_t size, const MarchingCubeUtility::RangeTask& task)
+    {
+        for (std::size_t begin = 0; begin < size; begin += 3) task(begin, std::min(begin + 3, size));
+    }
+
+    /// The triangles as sorted triplets of positions, to compare surfaces independently of the vertex numbering
+    static type::vector<type::fixed_array<type::Vec3, 3>> getTriangles(const type::vector<PointID>& triangles, const type::vector<type::Vec3>& vertices)
+    {
+        type::vector<type::fixed_array<type::Vec3, 3>> result;
+        for (std::size_t t = 0; t < triangles.size(); t += 3)
+        {
+            type::fixed_array<type::Vec3, 3> triangle { vertices[triangles[t]], vertices[triangles[t + 1]], vertices[triangles[t + 2]] };
+            std::sort(triangle.begin(), triangle.end());
+            result.push_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void compareWithRun(unsigned int convolutionSize)
+    {
+        const auto marchingCubes = createMarchingCubes(convolutionSize);
+
+        type::vector<PointID> triangles, blockTriangles;
+        type::vector<type::Vec3> vertices, blockVertices;
+        marchingCubes.run(data.data(), 128.f, triangles, vertices);
+        marchingCubes.runByBlocks(data.data(), 128.f, blockTriangles, blockVertices);
+
+        ASSERT_FALSE(triangles.empty());
+        EXPECT_EQ(vertices.size(), blockVertices.size());
+        ASSERT_EQ(triangles.size(), blockTriangles.size());
+
+        const auto expected = getTriangles(triangles, vertices);
+        const auto actual = getTriangles(blockTriangles, blockVertices);
+        for (std::size_t t = 0; t < expected.size(); ++t)
+        {
+            for (unsigned int v = 0; v < 3; ++v)
+            {
+                EXPECT_LT((expected[t][v] - actual[t][v]).norm(), 1e-3);
+            }
+        }
+    }
+};
+
+TEST_F(MarchingCubeUtilityTest, sameSurfaceAsRun)
+{
+    compareWithRun(1);
+}
+
+TEST_F(MarchingCubeUtilityTest, sameSurfaceAsRunWithSmoothing)
+{
+    compareWithRun(3);
+}
+
+TEST_F(MarchingCubeUtilityTest, parallel)
+{
+    const auto marchingCubes = createMarchingCubes(3);
+
+    type::vector<PointID> triangles, parallelTriangles;
+    type::vector<type::Vec3> vertices, parallelVertices;
+    marchingCubes.runByBlocks(data.data(), 128.f, triangles, vertices);
+    marchingCubes.runByBlocks(data.data(), 128.f, parallelTriangles, parallelVertices, chunkedLoop);
+
+    EXPECT_EQ(triangles, parallelTriangles);
+    EXPECT_EQ(vertices, parallelVertices);
+}
+
+TEST_F(MarchingCubeUtilityTest, streaming)
+{
+    auto marchingCubes = createMarchingCubes(1);
+    marchingCubes.setVerticesIndexOffset(10);
+
+    type::vector<PointID> triangles, streamedTriangles;
+    type::vector<type::Vec3> vertices, streamedVertices;
+    marchingCubes.runByBlocks(data.data(), 128.f, triangles, vertices);
+
+    unsigned int nbChunks = 0;
+    marchingCubes.runByBlocks(data.data(), 128.f, [&](const MarchingCubeUtility::SurfaceChunk& chunk)
+    {
+        // a chunk only refers to the vertices already streamed
+        for (const auto t : chunk.triangles)
+        {
+            EXPECT_LT(t, 10 + streamedVertices.size() + chunk.vertices.size());
+        }
+        streamedVertices.insert(streamedVertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+        streamedTriangles.insert(streamedTriangles.end(), chunk.triangles.begin(), chunk.triangles.end());
+        ++nbChunks;
+    });
+
+    EXPECT_GT(nbChunks, 1u);
+    EXPECT_EQ(triangles, streamedTriangles);
+    EXPECT_EQ(vertices, streamedVertices);
+}
+
+TEST_F(MarchingCubeUtilityTest, incremental)
+{
+    const auto marchingCubes = createMarchingCubes(3);
+
+    MarchingCubeUtility::BlockCache cache;
+    type::vector<PointID> triangles, expectedTriangles;
+    type::vector<type::Vec3> vertices, expectedVertices;
+    marchingCubes.runByBlocks(data.data(), 128.f, cache, type::Vec3i(0, 0, 0), resolution, triangles, vertices, chunkedLoop);
+
+    // local modification of the data
+    const type::Vec3i dirtyMin(20, 5, 10), dirtyMax(30, 12, 20);
+    for (int k = dirtyMin[2]; k < dirtyMax[2]; ++k)
+        for (int j = dirtyMin[1]; j < dirtyMax[1]; ++j)
+            for (int i = dirtyMin[0]; i < dirtyMax[0]; ++i)
+                data[index(i, j, k)] = 255;
+
+    marchingCubes.runByBlocks(data.data(), 128.f, cache, dirtyMin, dirtyMax, triangles, vertices, chunkedLoop);
+    marchingCubes.runByBlocks(data.data(), 128.f, expectedTriangles, expectedVertices);
+
+    EXPECT_EQ(triangles, expectedTriangles);
+    EXPECT_EQ(vertices, expectedVertices);
+}
+
+TEST_F(MarchingCubeUtilityTest, empty)
+{
+    std::fill(data.begin(), data.end(), 0);
+    const auto marchingCubes = createMarchingCubes(1);
+
+    type::vector<PointID> triangles;
+    type::vector<type::Vec3> vertices;
+    marchingCubes.runByBlocks(data.data(), 128.f, triangles, vertices);
+
+    EXPECT_TRUE(triangles.empty());
+    EXPECT_TRUE(vertices.empty());
+}
+
+}
@@ -0,0 +1,239 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/helper/TriangleBVH.h>
+#include <sofa/helper/random.h>
+#include <sofa/geometry/Triangle.h>
+
+#include <sofa/testing/BaseTest.h>
+using sofa::testing::BaseTest;
+
+#include <algorithm>
+
+
+namespace sofa
+{
+
+struct TriangleBVHTest : public BaseTest
+{
+    using TriangleBVH = helper::TriangleBVH;
+    using traceResult = TriangleBVH::traceResult;
+
+    TriangleBVH::VecCoord positions;
+    TriangleBVH::SeqTriangles triangles;
+    type::vector<type::Vec3> origins;
+    type::vector<type::Vec3> directions;
+
+    void onSetUp() override
+    {
+        helper::srand(1);
+
+        // triangle soup
+        constexpr unsigned int nbTriangles = 2000;
+        for (unsigned int i = 0; i < nbTriangles; ++i)
+        {
+            const type::Vec3 center(helper::drand(10.), helper::drand(10.), helper::drand(10.));
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                positions.push_back(center + type::Vec3(helper::drand(1.), helper::drand(1.), helper::drand(1.)));
+            }
+            triangles.emplace_back(3 * i, 3 * i + 1, 3 * i + 2);
+        }
+
+        constexpr unsigned int nbRays = 100;
+        for (unsigned int i = 0; i < nbRays; ++i)
+        {
+            origins.emplace_back(helper::drand(12.), helper::drand(12.), helper::drand(12.));
+            type::Vec3 direction(helper::drand(1.), helper::drand(1.), helper::drand(1.));
+            if (i % 10 == 0)
+            {
+                direction[i % 3] = 0; // rays parallel to the axis planes
+            }
+            directions.push_back(direction);
+        }
+    }
+
+    /// brute force search of the nearest triangle along a ray
+    int bruteForceTrace(const type::Vec3& origin, const type::Vec3& direction) const
+    {
+        int nearest = -1;
+        SReal nearestT = std::numeric_limits<SReal>::max();
+        for (std::size_t i = 0; i < triangles.size(); ++i)
+        {
+            SReal t, u, v;
+            const auto& tri = triangles[i];
+            if (geometry::Triangle::rayIntersection(positions[tri[0]], positions[tri[1]], positions[tri[2]], origin, direction, t, u, v)
+                && t < nearestT)
+            {
+                nearestT = t;
+                nearest = static_cast<int>(i);
+            }
+        }
+        return nearest;
+    }
+
+    /// parallelFor calling the task on small chunks, to exercise the subtree construction
+    static void chunkedFor(std::size_t size, const TriangleBVH::RangeTask& task)
+    {
+        for (std::size_t begin = 0; begin < size; begin += 7)
+        {
+            task(begin, std::min(size, begin + 7));
+        }
+    }
+
+    void testTrace(const TriangleBVH& bvh) const
+    {
+        for (std::size_t r = 0; r < origins.size(); ++r)
+        {
+            traceResult result;
+            EXPECT_EQ(bvh.trace(origins[r], directions[r], result), bruteForceTrace(origins[r], directions[r]));
+        }
+    }
+};
+
+TEST_F(TriangleBVHTest, trace)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions);
+    testTrace(bvh);
+}
+
+TEST_F(TriangleBVHTest, parallelBuild)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions, &TriangleBVHTest::chunkedFor);
+    testTrace(bvh);
+
+    // each triangle is referenced by exactly one leaf
+    type::vector<int> ids = bvh.getTriangleIndices();
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(ids.size(), triangles.size());
+    for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+        EXPECT_EQ(ids[i], static_cast<int>(i));
+    }
+}
+
+TEST_F(TriangleBVHTest, tracePacket)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions);
+
+    type::vector<traceResult> results(origins.size());
+    bvh.tracePacket(origins.data(), directions.data(), origins.size(), results.data());
+
+    for (std::size_t r = 0; r < origins.size(); ++r)
+    {
+        traceResult result;
+        bvh.trace(origins[r], directions[r], result);
+        EXPECT_EQ(results[r], result);
+    }
+}
+
+TEST_F(TriangleBVHTest, traceAll)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions);
+
+    for (std::size_t r = 0; r < origins.size(); ++r)
+    {
+        type::vector<traceResult> results;
+        bvh.traceAll(origins[r], directions[r], results);
+
+        type::vector<int> candidates;
+        bvh.traceAllCandidates(origins[r], directions[r], candidates);
+
+        std::size_t nbIntersections = 0;
+        for (std::size_t i = 0; i < triangles.size(); ++i)
+        {
+            const auto& tri = triangles[i];
+            if (geometry::Triangle::rayIntersection(positions[tri[0]], positions[tri[1]], positions[tri[2]], origins[r], directions[r]))
+            {
+                ++nbIntersections;
+                EXPECT_NE(std::find(candidates.begin(), candidates.end(), static_cast<int>(i)), candidates.end());
+            }
+        }
+        EXPECT_EQ(results.size(), nbIntersections);
+    }
+}
+
+TEST_F(TriangleBVHTest, bboxAllCandidates)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions);
+
+    const type::Vec3 bbmin(-2, -3, -1), bbmax(4, 2, 3);
+    type::vector<int> candidates;
+    bvh.bboxAllCandidates(bbmin, bbmax, candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    type::vector<int> expected;
+    for (std::size_t i = 0; i < triangles.size(); ++i)
+    {
+        bool overlaps = true;
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            const auto& tri = triangles[i];
+            const SReal tmin = std::min({ positions[tri[0]][c], positions[tri[1]][c], positions[tri[2]][c] });
+            const SReal tmax = std::max({ positions[tri[0]][c], positions[tri[1]][c], positions[tri[2]][c] });
+            overlaps &= tmin <= bbmax[c] && tmax >= bbmin[c];
+        }
+        if (overlaps)
+        {
+            expected.push_back(static_cast<int>(i));
+        }
+    }
+
+    EXPECT_EQ(candidates, expected);
+}
+
+TEST_F(TriangleBVHTest, sameResultsAsOctree)
+{
+    TriangleBVH bvh;
+    bvh.build(triangles, positions);
+
+    helper::TriangleOctreeRoot octree;
+    octree.buildOctree(&triangles, &positions);
+
+    for (std::size_t r = 0; r < origins.size(); ++r)
+    {
+        traceResult bvhResult, octreeResult;
+        EXPECT_EQ(bvh.trace(origins[r], directions[r], bvhResult),
+                  octree.octreeRoot->trace(origins[r], directions[r], octreeResult));
+    }
+}
+
+TEST_F(TriangleBVHTest, empty)
+{
+    const TriangleBVH::SeqTriangles noTriangles;
+    TriangleBVH bvh;
+    bvh.build(noTriangles, positions);
+    EXPECT_TRUE(bvh.empty());
+
+    traceResult result;
+    EXPECT_EQ(bvh.trace(origins[0], directions[0], result), -1);
+
+    type::vector<int> candidates;
+    bvh.bboxAllCandidates(type::Vec3(-1, -1, -1), type::Vec3(1, 1, 1), candidates);
+    EXPECT_TRUE(candidates.empty());
+}
+
+} // namespace sofa
@@ -114,6 +114,50 @@ struct TestSparseMatrixProduct : public sofa::testing::SparseMatrixTest<typename
 
         return true;
     }
+
+    bool checkSparsityPatternChange(typename LHSMatrix::Index nbRowsA, typename LHSMatrix::Index nbColsA, typename RHSMatrix::Index nbColsB)
+    {
+        Eigen::SparseMatrix<Real, Eigen::RowMajor> eigen_a;
+        Eigen::SparseMatrix<Real, Eigen::ColMajor> eigen_b;
+
+        generateRandomSparseMatrix(eigen_a, nbRowsA, nbColsA, 1. / 5.);
+        generateRandomSparseMatrix(eigen_b, nbColsA, nbColsB, 1. / 5.);
+
+        LHSMatrix A;
+        RHSMatrix B;
+        copyFromEigen(A, eigen_a);
+        copyFromEigen(B, eigen_b);
+
+        T product(&A, &B);
+        SparseMatrixProductInit<T>::init(product);
+        product.computeProduct();
+
+        Eigen::SparseMatrix<Real, Eigen::RowMajor> eigen_c = eigen_a * eigen_b;
+        EXPECT_TRUE(compareSparseMatrix(eigen_c, product.getProductResult()));
+
+        //modify the sparsity pattern of A
+        generateRandomSparseMatrix(eigen_a, nbRowsA, nbColsA, 3. / 5.);
+        copyFromEigen(A, eigen_a);
+        eigen_c = eigen_a * eigen_b;
+
+        //the change is detected: the intersection is computed again without forcing it
+        product.m_lhs = &A;
+        product.computeProduct();
+        EXPECT_TRUE(compareSparseMatrix(eigen_c, product.getProductResult()));
+
+        //modify the sparsity pattern of B
+        generateRandomSparseMatrix(eigen_b, nbColsA, nbColsB, 3. / 5.);
+        copyFromEigen(B, eigen_b);
+        eigen_c = eigen_a * eigen_b;
+
+        product.m_rhs = &B;
+        product.computeProduct();
+        EXPECT_TRUE(compareSparseMatrix(eigen_c, product.getProductResult()));
+
+        SparseMatrixProductInit<T>::cleanup(product);
+
+        return true;
+    }
 };
 
 TYPED_TEST_SUITE_P(TestSparseMatrixProduct);
@@ -144,7 +188,13 @@ TYPED_TEST_P(TestSparseMatrixProduct, rectangularMatrix )
     EXPECT_TRUE( this->checkMatrix( 20, 30, 10, 1. ) );
 }
 
+TYPED_TEST_P(TestSparseMatrixProduct, sparsityPatternChange )
+{
+    EXPECT_TRUE( this->checkSparsityPatternChange( 5, 5, 5 ) );
+    EXPECT_TRUE( this->checkSparsityPatternChange( 20, 30, 10 ) );
+}
+
 REGISTER_TYPED_TEST_SUITE_P(TestSparseMatrixProduct,
-                            squareMatrix,rectangularMatrix);
+                            squareMatrix,rectangularMatrix,sparsityPatternChange);
 
 }
@@ -39,6 +39,10 @@ namespace sofa::linearalgebra
  *
  * To compute the product, the method computeProduct must be called.
  *
+ * By default, the sparsity patterns of both input matrices are compared to the ones used to compute the intersection.
+ * If a change is detected, the intersection is computed again. The comparison is linear in the number of non-zero
+ * values. It can be disabled if the caller guarantees that the sparsity patterns do not change.
+ *
  * Based on:
  * Saupin, G., Duriez, C. and Grisoni, L., 2007, November. Embedded multigrid approach for real-time volumetric deformation. In International Symposium on Visual Computing (pp. 149-159). Springer, Berlin, Heidelberg.
  * and
@@ -64,6 +68,9 @@ public:
 
     using Index = Eigen::Index;
 
+    /// If true, a change in the sparsity pattern of an input matrix is detected and the intersection is computed again
+    bool m_detectSparsityPatternChange { true };
+
     using ProductResult = ResultType;
 
 
@@ -100,6 +107,28 @@ protected:
 
     Intersection m_intersectionAB;
 
+    /// Copy of the sparsity pattern of a compressed sparse matrix
+    template<class StorageIndex>
+    struct SparsityPattern
+    {
+        Index rows {};
+        Index cols {};
+        sofa::type::vector<StorageIndex> outerIndex;
+        sofa::type::vector<StorageIndex> innerIndex;
+
+        template<class Matrix>
+        void set(const Matrix& matrix);
+
+        template<class Matrix>
+        [[nodiscard]] bool isSame(const Matrix& matrix) const;
+    };
+
+    /// Sparsity patterns of the input matrices used to compute the intersection
+    SparsityPattern<typename LhsCleaned::StorageIndex> m_lhsPattern;
+    SparsityPattern<typename RhsCleaned::StorageIndex> m_rhsPattern;
+
+    [[nodiscard]] bool hasSparsityPatternChanged() const;
+
 };
 
 
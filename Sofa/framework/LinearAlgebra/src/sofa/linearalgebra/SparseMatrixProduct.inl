@@ -23,6 +23,7 @@
 #include <sofa/linearalgebra/SparseMatrixProduct.h>
 #include <Eigen/Sparse>
 #include <sofa/type/vector.h>
+#include <algorithm>
 
 
 namespace sofa::linearalgebra::sparsematrixproduct
@@ -157,6 +158,10 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeProduct(bool forceCompute
     {
         m_hasComputedIntersection = false;
     }
+    else if (m_hasComputedIntersection && m_detectSparsityPatternChange && hasSparsityPatternChanged())
+    {
+        m_hasComputedIntersection = false;
+    }
 
     if (m_hasComputedIntersection == false)
     {
@@ -280,6 +285,12 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeIntersection()
     }
 
     m_productResult = product.template cast<ResultScalar>();
+
+    if (m_detectSparsityPatternChange)
+    {
+        m_lhsPattern.set(*m_lhs);
+        m_rhsPattern.set(*m_rhs);
+    }
 }
 
 template<class Lhs, class Rhs, class ResultType>
@@ -307,6 +318,42 @@ void SparseMatrixProduct<Lhs, Rhs, ResultType>::computeProductFromIntersection()
     }
 }
 
+template<class Lhs, class Rhs, class ResultType>
+bool SparseMatrixProduct<Lhs, Rhs, ResultType>::hasSparsityPatternChanged() const
+{
+    return !m_lhsPattern.isSame(*m_lhs) || !m_rhsPattern.isSame(*m_rhs);
+}
+
+template<class Lhs, class Rhs, class ResultType>
+template<class StorageIndex>
+template<class Matrix>
+void SparseMatrixProduct<Lhs, Rhs, ResultType>::SparsityPattern<StorageIndex>::set(const Matrix& matrix)
+{
+    rows = matrix.rows();
+    cols = matrix.cols();
+
+    const auto* outerBegin = matrix.outerIndexPtr();
+    const auto* innerBegin = matrix.innerIndexPtr();
+    outerIndex.assign(outerBegin, outerBegin + matrix.outerSize() + 1);
+    innerIndex.assign(innerBegin, innerBegin + matrix.nonZeros());
+}
+
+template<class Lhs, class Rhs, class ResultType>
+template<class StorageIndex>
+template<class Matrix>
+bool SparseMatrixProduct<Lhs, Rhs, ResultType>::SparsityPattern<StorageIndex>::isSame(const Matrix& matrix) const
+{
+    if (rows != matrix.rows() || cols != matrix.cols()
+        || outerIndex.size() != static_cast<std::size_t>(matrix.outerSize() + 1)
+        || innerIndex.size() != static_cast<std::size_t>(matrix.nonZeros()))
+    {
+        return false;
+    }
+
+    return std::equal(outerIndex.begin(), outerIndex.end(), matrix.outerIndexPtr())
+        && std::equal(innerIndex.begin(), innerIndex.end(), matrix.innerIndexPtr());
+}
+
 template<class Lhs, class Rhs, class ResultType>
 void SparseMatrixProduct<Lhs, Rhs, ResultType>::invalidateIntersection()
 {
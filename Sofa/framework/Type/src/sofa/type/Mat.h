@@ -547,13 +547,14 @@ public:
     /// Multiplication operator Matrix * Line.
     constexpr Col operator*(const Line& v) const noexcept
     {
+        // j-i loop order: the innermost loop updates all the entries of the result independently, so that it can be
+        // vectorized. Each entry is still accumulated in the order of j, so the result is the same as with dot products.
         Col r(NOINIT);
         for(Size i=0; i<L; i++)
-        {
             r[i]=(*this)[i][0] * v[0];
-            for(Size j=1; j<C; j++)
+        for(Size j=1; j<C; j++)
+            for(Size i=0; i<L; i++)
                 r[i] += (*this)[i][j] * v[j];
-        }
         return r;
     }
 
@@ -571,12 +572,16 @@ public:
     /// Multiplication of the transposed Matrix * Column
     constexpr Line multTranspose(const Col& v) const noexcept
     {
+        // The lines of the matrix are traversed contiguously, so that the inner loop can be vectorized.
+        // Each entry of the result is still accumulated in the order of the lines.
         Line r(NOINIT);
         for(Size i=0; i<C; i++)
-        {
             r[i]=(*this)[0][i] * v[0];
-            for(Size j=1; j<L; j++)
-                r[i] += (*this)[j][i] * v[j];
+        for(Size j=1; j<L; j++)
+        {
+            const real vj = v[j];
+            for(Size i=0; i<C; i++)
+                r[i] += (*this)[j][i] * vj;
         }
         return r;
     }
@@ -1262,15 +1267,22 @@ constexpr Mat<L,L,Real> tensorProduct(const Vec<L,Real>& a, const Vec<L,Real>& b
 template <sofa::Size L, sofa::Size C, sofa::Size P, class real>
 constexpr Mat<L,P,real> operator*(const Mat<L,C,real>& m1, const Mat<C,P,real>& m2) noexcept
 {
+    // i-k-j loop order: the innermost loop traverses the lines of m2 and r contiguously, so that it can be
+    // vectorized. Each entry is still accumulated in the order of k, so the result is the same as with dot products.
     Mat<L,P,real> r(NOINIT);
     for (Size i = 0; i<L; i++)
     {
+        const real m1i0 = m1[i][0];
         for (Size j = 0; j<P; j++)
         {
-            r[i][j] = m1[i][0] * m2[0][j];
-            for (Size k = 1; k<C; k++)
+            r[i][j] = m1i0 * m2[0][j];
+        }
+        for (Size k = 1; k<C; k++)
+        {
+            const real m1ik = m1[i][k];
+            for (Size j = 0; j<P; j++)
             {
-                r[i][j] += m1[i][k] * m2[k][j];
+                r[i][j] += m1ik * m2[k][j];
             }
         }
     }
@@ -1320,15 +1332,25 @@ constexpr Mat<3,3,real> operator*(const Mat<3,3,real>& m1, const Mat<3,3,real>&
 template <sofa::Size L, sofa::Size C, sofa::Size P, class real>
 constexpr Mat<C,P,real> multTranspose(const Mat<L,C,real>& m1, const Mat<L,P,real>& m2) noexcept
 {
+    // k-i-j loop order: the innermost loop traverses the lines of m2 and r contiguously, so that it can be
+    // vectorized. Each entry is still accumulated in the order of k, so the result is the same as with dot products.
     Mat<C, P, real> r(NOINIT);
     for (Size i = 0; i<C; i++)
     {
+        const real m10i = m1[0][i];
         for (Size j = 0; j<P; j++)
         {
-            r[i][j] = m1[0][i] * m2[0][j];
-            for (Size k = 1; k<L; k++)
+            r[i][j] = m10i * m2[0][j];
+        }
+    }
+    for (Size k = 1; k<L; k++)
+    {
+        for (Size i = 0; i<C; i++)
+        {
+            const real m1ki = m1[k][i];
+            for (Size j = 0; j<P; j++)
             {
-                r[i][j] += m1[k][i] * m2[k][j];
+                r[i][j] += m1ki * m2[k][j];
             }
         }
     }
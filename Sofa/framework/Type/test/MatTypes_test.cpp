@@ -19,6 +19,7 @@
 *                                                                             *
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
+#include <cstdint>
 #include <iostream>
 #include <sofa/type/Mat.h>
 #include <sofa/type/Quat.h>
@@ -165,6 +166,79 @@ TEST(MatTypesTest, multTranspose)
 
 }
 
+namespace
+{
+/// Fills a matrix with small integer values, so that the products are computed exactly whatever the order of the operations
+template<sofa::Size L, sofa::Size C>
+Mat<L, C, SReal> integerValuedMatrix(std::uint32_t seed)
+{
+    Mat<L, C, SReal> m;
+    for (sofa::Size i = 0; i < L; ++i)
+    {
+        for (sofa::Size j = 0; j < C; ++j)
+        {
+            // unsigned arithmetic: the overflow of the linear congruential generator is well-defined
+            seed = (seed * 1103515245u + 12345u) & 0x7fffffffu;
+            m[i][j] = static_cast<SReal>(static_cast<int>(seed % 17u) - 8);
+        }
+    }
+    return m;
+}
+}
+
+TEST(MatTypesTest, genericProductsMatchDotProducts)
+{
+    // the generic products must give the same values as a computation of each entry by a dot product
+    static constexpr sofa::type::Mat<2, 3, int> a { {1, 2, 3}, {4, 5, 6} };
+    static constexpr sofa::type::Mat<3, 2, int> b { {1, 2}, {3, 4}, {5, 6} };
+    static constexpr auto ab = a * b;
+    static_assert(ab[0][0] == 22 && ab[0][1] == 28 && ab[1][0] == 49 && ab[1][1] == 64);
+    static constexpr sofa::type::Vec<3, int> c { 1, 2, 3 };
+    static constexpr auto ac = a * c;
+    static_assert(ac[0] == 14 && ac[1] == 32);
+
+    const auto m1 = integerValuedMatrix<12, 12>(1);
+    const auto m2 = integerValuedMatrix<12, 12>(2);
+    const auto m3 = integerValuedMatrix<12, 6>(3);
+    const auto m4 = integerValuedMatrix<12, 3>(4);
+    const auto v = integerValuedMatrix<1, 12>(5)[0];
+
+    const auto m1m2 = m1 * m2;
+    const auto m1v = m1 * v;
+    const auto m3Tm4 = m3.multTranspose(m4);
+    const auto m3Tv = m3.multTranspose(v);
+    for (sofa::Size i = 0; i < 12; ++i)
+    {
+        for (sofa::Size j = 0; j < 12; ++j)
+        {
+            SReal expected = 0;
+            for (sofa::Size k = 0; k < 12; ++k)
+                expected += m1[i][k] * m2[k][j];
+            EXPECT_EQ(m1m2[i][j], expected);
+        }
+
+        SReal expected = 0;
+        for (sofa::Size k = 0; k < 12; ++k)
+            expected += m1[i][k] * v[k];
+        EXPECT_EQ(m1v[i], expected);
+    }
+    for (sofa::Size i = 0; i < 6; ++i)
+    {
+        for (sofa::Size j = 0; j < 3; ++j)
+        {
+            SReal expected = 0;
+            for (sofa::Size k = 0; k < 12; ++k)
+                expected += m3[k][i] * m4[k][j];
+            EXPECT_EQ(m3Tm4[i][j], expected);
+        }
+
+        SReal expected = 0;
+        for (sofa::Size k = 0; k < 12; ++k)
+            expected += m3[k][i] * v[k];
+        EXPECT_EQ(m3Tv[i], expected);
+    }
+}
+
 void test_transformInverse(Matrix4 const& M)
 {
     Matrix4 M_inv;
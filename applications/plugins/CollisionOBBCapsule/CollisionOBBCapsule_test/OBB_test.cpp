@@ -20,11 +20,13 @@
 * Contact information: contact@sofa-framework.org                             *
 ******************************************************************************/
 #include <CollisionOBBCapsule/detection/intersection/OBBIntTool.h>
+#include <CollisionOBBCapsule/detection/intersection/OBBBatchIntTool.h>
 #include <CollisionOBBCapsule/detection/intersection/CapsuleIntTool.h>
 #include <CollisionOBBCapsule/detection/intersection/BaseIntTool.h>
 #include <CollisionOBBCapsule/detection/intersection/MeshIntTool.h>
 
 #include <sofa/component/collision/geometry/TriangleModel.h>
+#include <sofa/component/collision/detection/intersection/MinProximityIntersection.h>
 
 #include <sofa/simulation/graph/DAGNode.h>
 
@@ -46,6 +48,8 @@ struct TestOBB : public BaseTest {
     bool faceEdge();
     bool edgeEdge();
     bool edgeVertex();
+    bool batchedPairs();
+    bool intersectorPairs();
 };
 
 
@@ -56,6 +60,8 @@ struct TestCapOBB  : public ::testing::Test{
     bool edgeEdge();
     bool vertexVertex();
     bool vertexEdge();
+    bool batchedPairs();
+    bool intersectorPairs();
 };
 
 struct TestSphereOBB : public ::testing::Test{
@@ -1247,6 +1253,215 @@ bool TestTriOBB::vertexVertex(){
     return true;
 }
 
+static bool sameDetectionOutputs(const sofa::type::vector<sofa::core::collision::DetectionOutput>& a,
+                                 const sofa::type::vector<sofa::core::collision::DetectionOutput>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].elem != b[i].elem || a[i].id != b[i].id || a[i].value != b[i].value
+            || a[i].point[0] != b[i].point[0] || a[i].point[1] != b[i].point[1] || a[i].normal != b[i].normal)
+            return false;
+    }
+    return true;
+}
+
+//a row of rotated OBBs, close enough to be in contact with their neighbors: the contacts computed by packets
+//must be the ones computed pair by pair
+bool TestOBB::batchedPairs(){
+    sofa::simulation::Node::SPtr scn = New<sofa::simulation::graph::DAGNode>();
+
+    const int nbBoxes = 13;
+    std::vector<collisionobbcapsule::geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>::SPtr> models;
+    for (int i = 0; i < nbBoxes; ++i)
+    {
+        double angles[3] = {0.3 * i, 0.7 * i, 1.1 * i};
+        int order[3] = {i % 3, (i + 1) % 3, (i + 2) % 3};
+        const Vec3 velocity = (i % 2) ? Vec3(0,0,-10) : Vec3(0,0,0);
+        models.push_back(makeOBB(Vec3(1.9 * i, 0.1 * (i % 4), 0),angles,order,velocity,Vec3(1,0.8,0.6),scn));
+    }
+
+    sofa::type::vector<sofa::core::collision::DetectionOutput> pairByPair;
+    sofa::type::vector<sofa::core::collision::DetectionOutput> batched;
+    collisionobbcapsule::detection::intersection::OBBPairBatch batch;
+
+    int nbContacts = 0;
+    for (int i = 0; i < nbBoxes; ++i)
+    {
+        for (int j = i + 1; j < nbBoxes; ++j)
+        {
+            collisionobbcapsule::geometry::OBB obb0(models[i].get(),0);
+            collisionobbcapsule::geometry::OBB obb1(models[j].get(),0);
+            nbContacts += collisionobbcapsule::detection::intersection::OBBIntTool::computeIntersection(obb0,obb1,0.5,0.1,&pairByPair);
+            batch.add(obb0, obb1);
+        }
+    }
+
+    if (nbContacts == 0)
+        return false;
+
+    if (collisionobbcapsule::detection::intersection::OBBBatchIntTool::computeIntersection(batch,0.5,0.1,&batched) != nbContacts)
+        return false;
+
+    return sameDetectionOutputs(pairByPair, batched);
+}
+
+//capsules crossing a row of OBBs: the contacts computed by packets must be the ones computed pair by pair
+bool TestCapOBB::batchedPairs(){
+    sofa::simulation::Node::SPtr scn = New<sofa::simulation::graph::DAGNode>();
+
+    const int nbBoxes = 9;
+    std::vector<collisionobbcapsule::geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>::SPtr> obbModels;
+    std::vector<collisionobbcapsule::geometry::CapsuleCollisionModel<sofa::defaulttype::Vec3Types>::SPtr> capModels;
+    for (int i = 0; i < nbBoxes; ++i)
+    {
+        double angles[3] = {0.4 * i, 0.9 * i, 0.2 * i};
+        int order[3] = {0,1,2};
+        obbModels.push_back(makeOBB(Vec3(2.5 * i, 0, 0),angles,order,Vec3(0,0,0),Vec3(1,1,1),scn));
+        capModels.push_back(makeCap(Vec3(2.5 * i + 0.5, -0.3 * i, 1.2),Vec3(2.5 * i + 1.5, 0.5, 3),0.5,Vec3(0,0,-10),scn));
+    }
+
+    sofa::type::vector<sofa::core::collision::DetectionOutput> pairByPair;
+    sofa::type::vector<sofa::core::collision::DetectionOutput> batched;
+    collisionobbcapsule::detection::intersection::TCapsuleOBBPairBatch<sofa::defaulttype::Vec3Types> batch;
+
+    int nbContacts = 0;
+    for (int i = 0; i < nbBoxes; ++i)
+    {
+        for (int j = 0; j < nbBoxes; ++j)
+        {
+            collisionobbcapsule::geometry::Capsule cap(capModels[i].get(),0);
+            collisionobbcapsule::geometry::OBB obb(obbModels[j].get(),0);
+            nbContacts += collisionobbcapsule::detection::intersection::CapsuleIntTool::computeIntersection(cap,obb,0.5,0.1,&pairByPair);
+            batch.add(cap, obb);
+        }
+    }
+
+    if (nbContacts == 0)
+        return false;
+
+    if (collisionobbcapsule::detection::intersection::OBBBatchIntTool::computeIntersection(batch,0.5,0.1,&batched) != nbContacts)
+        return false;
+
+    return sameDetectionOutputs(pairByPair, batched);
+}
+
+//an OBB model holding nbBoxes boxes of default extents along the x axis, each one rotated differently
+static collisionobbcapsule::geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>::SPtr makeOBBRow(int nbBoxes, const Vec3& origin, sofa::simulation::Node::SPtr& father)
+{
+    sofa::simulation::Node::SPtr node = father->createChild("obbRow");
+
+    MechanicalObjectRigid3::SPtr dof = New<MechanicalObjectRigid3>();
+    dof->resize(nbBoxes);
+    {
+        auto positions = sofa::helper::getWriteAccessor(*dof->write(sofa::core::VecId::position()));
+        for (int i = 0; i < nbBoxes; ++i)
+        {
+            positions[i] = Rigid3Types::Coord(origin + Vec3(1.9 * i, 0.1 * (i % 4), 0), Quat<SReal>(Vec3(1, 2, 3).normalized(), 0.4 * i));
+        }
+    }
+    node->addObject(dof);
+
+    auto model = New<collisionobbcapsule::geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>>();
+    node->addObject(model);
+    model->init();
+
+    return model;
+}
+
+//all the pairs of elements of two models, in the order of the narrow phase
+static sofa::core::collision::ElementIntersector::CandidatePairs allPairs(sofa::Size size1, sofa::Size size2)
+{
+    sofa::core::collision::ElementIntersector::CandidatePairs pairs;
+    for (sofa::Index i = 0; i < size1; ++i)
+    {
+        for (sofa::Index j = 0; j < size2; ++j)
+        {
+            pairs.emplace_back(i, j);
+        }
+    }
+    return pairs;
+}
+
+//the intersector used by the narrow phase for the candidate pairs of two models computes them by packets: its contacts
+//must be the ones computed pair by pair
+template <class Model1, class Model2>
+static bool sameIntersectorContacts(Model1* model1, Model2* model2)
+{
+    auto intersection = New<sofa::component::collision::detection::intersection::MinProximityIntersection>();
+    intersection->setAlarmDistance(0.5);
+    intersection->setContactDistance(0.1);
+
+    bool swapModels = false;
+    sofa::core::collision::ElementIntersector* intersector = intersection->findIntersector(model1, model2, swapModels);
+    if (intersector == nullptr || swapModels)
+        return false;
+
+    const auto pairs = allPairs(model1->getSize(), model2->getSize());
+
+    sofa::core::collision::TDetectionOutputVector<Model1, Model2> pairByPair;
+    sofa::core::collision::TDetectionOutputVector<Model1, Model2> batched;
+
+    int nbContacts = 0;
+    for (const auto& [index1, index2] : pairs)
+    {
+        nbContacts += intersector->intersect(sofa::core::CollisionElementIterator(model1, index1), sofa::core::CollisionElementIterator(model2, index2), &pairByPair, intersection.get());
+    }
+
+    if (nbContacts == 0)
+        return false;
+
+    if (intersector->intersectPairs(model1, model2, pairs, &batched, intersection.get()) != nbContacts)
+        return false;
+
+    return sameDetectionOutputs(pairByPair, batched);
+}
+
+bool TestOBB::intersectorPairs(){
+    sofa::simulation::Node::SPtr scn = New<sofa::simulation::graph::DAGNode>();
+
+    auto row0 = makeOBBRow(11, Vec3(0, 0, 0), scn);
+    auto row1 = makeOBBRow(13, Vec3(0.5, 1.5, 0.3), scn);
+
+    return sameIntersectorContacts(row0.get(), row1.get());
+}
+
+bool TestCapOBB::intersectorPairs(){
+    sofa::simulation::Node::SPtr scn = New<sofa::simulation::graph::DAGNode>();
+
+    const int nbCapsules = 10;
+    auto boxes = makeOBBRow(9, Vec3(0, 0, 0), scn);
+
+    //a capsule model holding nbCapsules capsules of default radius crossing the row of boxes
+    sofa::simulation::Node::SPtr node = scn->createChild("capsules");
+    MechanicalObject3::SPtr dof = New<MechanicalObject3>();
+    dof->resize(2 * nbCapsules);
+    {
+        auto positions = sofa::helper::getWriteAccessor(*dof->write(sofa::core::VecId::position()));
+        for (int i = 0; i < nbCapsules; ++i)
+        {
+            positions[2 * i] = Vec3(1.7 * i + 0.5, -0.3 * i, 1.2);
+            positions[2 * i + 1] = Vec3(1.7 * i + 1.5, 0.5, 3);
+        }
+    }
+    node->addObject(dof);
+
+    sofa::component::topology::container::constant::MeshTopology::SPtr topology = New<sofa::component::topology::container::constant::MeshTopology>();
+    for (int i = 0; i < nbCapsules; ++i)
+    {
+        topology->addEdge(2 * i, 2 * i + 1);
+    }
+    node->addObject(topology);
+
+    auto capsules = New<collisionobbcapsule::geometry::CapsuleCollisionModel<sofa::defaulttype::Vec3Types>>();
+    node->addObject(capsules);
+    capsules->init();
+
+    return sameIntersectorContacts(capsules.get(), boxes.get());
+}
+
 TEST_F(TestOBB, face_vertex ) {
     ASSERT_TRUE( faceVertex());
 }
@@ -1271,6 +1486,14 @@ TEST_F(TestOBB, edge_vertex ) {
     ASSERT_TRUE( edgeVertex());
 }
 
+TEST_F(TestOBB, batched_pairs ) {
+    ASSERT_TRUE( batchedPairs());
+}
+
+TEST_F(TestOBB, intersector_pairs ) {
+    ASSERT_TRUE( intersectorPairs());
+}
+
 TEST_F(TestCapOBB, face_vertex ) {
     ASSERT_TRUE( faceVertex());
 }
@@ -1295,6 +1518,14 @@ TEST_F(TestCapOBB, vertex_vertex) {
     ASSERT_TRUE( vertexVertex());
 }
 
+TEST_F(TestCapOBB, batched_pairs) {
+    ASSERT_TRUE( batchedPairs());
+}
+
+TEST_F(TestCapOBB, intersector_pairs) {
+    ASSERT_TRUE( intersectorPairs());
+}
+
 TEST_F(TestSphereOBB, vertex_sphere ) {
     ASSERT_TRUE( vertex());
 }
@@ -29,8 +29,10 @@
 #include <sofa/component/collision/detection/intersection/NewProximityIntersection.h>
 #include <sofa/component/collision/detection/intersection/MeshNewProximityIntersection.h>
 #include <CollisionOBBCapsule/geometry/CapsuleModel.h>
+#include <CollisionOBBCapsule/geometry/OBBModel.h>
 #include <CollisionOBBCapsule/detection/intersection/BaseIntTool.h>
 #include <CollisionOBBCapsule/detection/intersection/MeshIntTool.h>
+#include <CollisionOBBCapsule/detection/intersection/OBBBatchIntTool.h>
 
 namespace collisionobbcapsule::detection::intersection
 {
@@ -58,6 +60,28 @@ public:
         return BaseIntTool::testIntersection(e1, e2, intersection->getAlarmDistance());
     }
 
+    /// Intersections of the candidate pairs [begin, end) of a capsule model and an OBB model, tested by packets
+    /// with OBBBatchIntTool. The contacts are the same, in the same order, as the ones of the pair by pair tests.
+    template <class DataTypes>
+    int computeIntersection(geometry::CapsuleCollisionModel<DataTypes>* model1, geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>* model2,
+                            const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end,
+                            OutputVector* contacts, const core::collision::Intersection* intersection)
+    {
+        const SReal proximity = model1->getProximity() + model2->getProximity();
+
+        // one buffer per thread, as the narrow phase may test several pairs of models concurrently
+        thread_local TCapsuleOBBPairBatch<DataTypes> batch;
+        batch.clear();
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            batch.add(geometry::TCapsule<DataTypes>(model1, pairs[i].first), geometry::OBB(model2, pairs[i].second));
+        }
+
+        return OBBBatchIntTool::computeIntersection(batch,
+            proximity + intersection->getAlarmDistance(),
+            proximity + intersection->getContactDistance(),
+            contacts);
+    }
 };
 
 
@@ -0,0 +1,198 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_COMPONENT_COLLISION_OBBBATCHINTTOOL_CPP
+#include <CollisionOBBCapsule/detection/intersection/OBBBatchIntTool.h>
+
+#include <cmath>
+
+namespace collisionobbcapsule::detection::intersection
+{
+using namespace sofa::defaulttype;
+
+void OBBPairBatch::clear()
+{
+    m_pairs.clear();
+    m_packets.clear();
+}
+
+void OBBPairBatch::add(const geometry::OBB& box0, const geometry::OBB& box1)
+{
+    const std::size_t lane = m_pairs.size() % OBBBatchPacketSize;
+    if (lane == 0)
+    {
+        m_packets.emplace_back();
+    }
+    m_pairs.emplace_back(box0, box1);
+
+    OBBPacket& packet = m_packets.back();
+    const geometry::OBB* boxes[2] = { &box0, &box1 };
+    for (int b = 0; b < 2; ++b)
+    {
+        const auto& center = boxes[b]->center();
+        const auto& extents = boxes[b]->extents();
+        for (int i = 0; i < 3; ++i)
+        {
+            packet.center[b][i][lane] = center[i];
+            packet.extent[b][i][lane] = extents[i];
+
+            const auto a = boxes[b]->axis(i);
+            for (int c = 0; c < 3; ++c)
+            {
+                packet.axis[b][i][c][lane] = a[c];
+            }
+        }
+    }
+}
+
+int OBBBatchIntTool::computeIntersection(const OBBPairBatch& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts)
+{
+    int nbContacts = 0;
+    int separated[OBBBatchPacketSize];
+    const auto& packets = batch.packets();
+    for (std::size_t p = 0; p < packets.size(); ++p)
+    {
+        findSeparatedLanes(packets[p], (Real)alarmDist, separated);
+
+        const std::size_t end = std::min(batch.size(), (p + 1) * OBBBatchPacketSize);
+        for (std::size_t i = p * OBBBatchPacketSize; i < end; ++i)
+        {
+            if (separated[i - p * OBBBatchPacketSize])
+                continue;
+
+            geometry::OBB box0 = batch.pair(i).first;
+            geometry::OBB box1 = batch.pair(i).second;
+            nbContacts += OBBIntTool::computeIntersection(box0, box1, alarmDist, contactDist, contacts);
+        }
+    }
+    return nbContacts;
+}
+
+void OBBBatchIntTool::findSeparatedLanes(const OBBPacket& packet, Real alarmDist, int* separated)
+{
+    // small value added to the absolute values of the rotation, to be robust when two edges are parallel
+    // (their cross product is then close to zero and would not separate anything)
+    const Real epsilon = (Real)1e-6;
+
+    // The 15 potential separating axes of Gottschalk et al. are expressed in the frame of the first box.
+    // The cross product axes are not normalized: as their norm is at most 1, comparing with alarmDist
+    // keeps the test conservative.
+    for (std::size_t l = 0; l < OBBBatchPacketSize; ++l)
+    {
+        Real R[3][3], AbsR[3][3], T[3], d[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            d[c] = packet.center[1][c][l] - packet.center[0][c][l];
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            T[i] = d[0] * packet.axis[0][i][0][l] + d[1] * packet.axis[0][i][1][l] + d[2] * packet.axis[0][i][2][l];
+            for (int j = 0; j < 3; ++j)
+            {
+                R[i][j] = packet.axis[0][i][0][l] * packet.axis[1][j][0][l]
+                        + packet.axis[0][i][1][l] * packet.axis[1][j][1][l]
+                        + packet.axis[0][i][2][l] * packet.axis[1][j][2][l];
+                AbsR[i][j] = std::abs(R[i][j]) + epsilon;
+            }
+        }
+
+        const Real e0[3] = { packet.extent[0][0][l], packet.extent[0][1][l], packet.extent[0][2][l] };
+        const Real e1[3] = { packet.extent[1][0][l], packet.extent[1][1][l], packet.extent[1][2][l] };
+
+        int sep = 0;
+
+        // axes of the first box
+        for (int i = 0; i < 3; ++i)
+        {
+            const Real r1 = e1[0] * AbsR[i][0] + e1[1] * AbsR[i][1] + e1[2] * AbsR[i][2];
+            sep |= (std::abs(T[i]) > e0[i] + r1 + alarmDist);
+        }
+
+        // axes of the second box
+        for (int j = 0; j < 3; ++j)
+        {
+            const Real r0 = e0[0] * AbsR[0][j] + e0[1] * AbsR[1][j] + e0[2] * AbsR[2][j];
+            const Real t = T[0] * R[0][j] + T[1] * R[1][j] + T[2] * R[2][j];
+            sep |= (std::abs(t) > r0 + e1[j] + alarmDist);
+        }
+
+        // cross products of the axes of the two boxes
+        for (int i = 0; i < 3; ++i)
+        {
+            const int i1 = (i + 1) % 3;
+            const int i2 = (i + 2) % 3;
+            for (int j = 0; j < 3; ++j)
+            {
+                const int j1 = (j + 1) % 3;
+                const int j2 = (j + 2) % 3;
+                const Real r0 = e0[i1] * AbsR[i2][j] + e0[i2] * AbsR[i1][j];
+                const Real r1 = e1[j1] * AbsR[i][j2] + e1[j2] * AbsR[i][j1];
+                const Real t = T[i2] * R[i1][j] - T[i1] * R[i2][j];
+                sep |= (std::abs(t) > r0 + r1 + alarmDist);
+            }
+        }
+
+        separated[l] = sep;
+    }
+}
+
+void OBBBatchIntTool::findSeparatedLanes(const CapsuleOBBPacket& packet, Real alarmDist, int* separated)
+{
+    for (std::size_t l = 0; l < OBBBatchPacketSize; ++l)
+    {
+        Real d[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            d[c] = packet.segmentCenter[c][l] - packet.center[c][l];
+        }
+
+        int sep = 0;
+
+        // axes of the box: the capsule projects on the projection of its segment, enlarged by its radius
+        for (int i = 0; i < 3; ++i)
+        {
+            const Real t = d[0] * packet.axis[i][0][l] + d[1] * packet.axis[i][1][l] + d[2] * packet.axis[i][2][l];
+            const Real h = packet.segmentHalf[0][l] * packet.axis[i][0][l]
+                         + packet.segmentHalf[1][l] * packet.axis[i][1][l]
+                         + packet.segmentHalf[2][l] * packet.axis[i][2][l];
+            sep |= (std::abs(t) > packet.extent[i][l] + std::abs(h) + packet.radius[l] + alarmDist);
+        }
+
+        // bounding spheres, compared with squared distances
+        const Real h2 = packet.segmentHalf[0][l] * packet.segmentHalf[0][l]
+                      + packet.segmentHalf[1][l] * packet.segmentHalf[1][l]
+                      + packet.segmentHalf[2][l] * packet.segmentHalf[2][l];
+        const Real e2 = packet.extent[0][l] * packet.extent[0][l]
+                      + packet.extent[1][l] * packet.extent[1][l]
+                      + packet.extent[2][l] * packet.extent[2][l];
+        const Real r = std::sqrt(h2) + std::sqrt(e2) + packet.radius[l] + alarmDist;
+        sep |= (d[0] * d[0] + d[1] * d[1] + d[2] * d[2] > r * r);
+
+        separated[l] = sep;
+    }
+}
+
+template class COLLISIONOBBCAPSULE_API TCapsuleOBBPairBatch<Vec3Types>;
+template class COLLISIONOBBCAPSULE_API TCapsuleOBBPairBatch<RigidTypes>;
+template COLLISIONOBBCAPSULE_API int OBBBatchIntTool::computeIntersection(const TCapsuleOBBPairBatch<Vec3Types>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+template COLLISIONOBBCAPSULE_API int OBBBatchIntTool::computeIntersection(const TCapsuleOBBPairBatch<RigidTypes>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+
+} // namespace collisionobbcapsule::detection::intersection
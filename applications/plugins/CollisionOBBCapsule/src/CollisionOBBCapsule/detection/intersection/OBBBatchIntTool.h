@@ -0,0 +1,213 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <CollisionOBBCapsule/config.h>
+
+#include <CollisionOBBCapsule/detection/intersection/OBBIntTool.h>
+#include <CollisionOBBCapsule/detection/intersection/CapsuleIntTool.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace collisionobbcapsule::detection::intersection
+{
+
+/// Number of candidate pairs evaluated together by the separating axis kernels of OBBBatchIntTool
+constexpr std::size_t OBBBatchPacketSize = 8;
+
+/**
+  *Data of OBBBatchPacketSize OBB-OBB pairs, stored as structure of arrays: each array holds
+  *one scalar for every lane (pair) of the packet.
+  */
+struct OBBPacket
+{
+    using Real = geometry::OBB::Real;
+
+    Real center[2][3][OBBBatchPacketSize] {};
+    Real axis[2][3][3][OBBBatchPacketSize] {}; ///< [box][axis][coordinate][lane]
+    Real extent[2][3][OBBBatchPacketSize] {};
+};
+
+/**
+  *Data of OBBBatchPacketSize capsule-OBB pairs, stored as structure of arrays.
+  *The capsule segment is stored as its middle point and its half vector.
+  */
+struct CapsuleOBBPacket
+{
+    using Real = geometry::OBB::Real;
+
+    Real segmentCenter[3][OBBBatchPacketSize] {};
+    Real segmentHalf[3][OBBBatchPacketSize] {};
+    Real radius[OBBBatchPacketSize] {};
+    Real center[3][OBBBatchPacketSize] {};
+    Real axis[3][3][OBBBatchPacketSize] {}; ///< [axis][coordinate][lane]
+    Real extent[3][OBBBatchPacketSize] {};
+};
+
+/**
+  *List of candidate OBB-OBB pairs given by a broad phase. The geometry of the pairs is gathered
+  *in packets when they are added, so that it is read only once by the narrow phase.
+  */
+class COLLISIONOBBCAPSULE_API OBBPairBatch
+{
+public:
+    void clear();
+
+    void add(const geometry::OBB& box0, const geometry::OBB& box1);
+
+    std::size_t size() const { return m_pairs.size(); }
+
+    const std::pair<geometry::OBB, geometry::OBB>& pair(std::size_t i) const { return m_pairs[i]; }
+
+    const std::vector<OBBPacket>& packets() const { return m_packets; }
+
+protected:
+    std::vector<std::pair<geometry::OBB, geometry::OBB> > m_pairs;
+    std::vector<OBBPacket> m_packets;
+};
+
+/**
+  *List of candidate capsule-OBB pairs given by a broad phase.
+  */
+template <class DataTypes>
+class TCapsuleOBBPairBatch
+{
+public:
+    typedef CapsuleOBBPacket::Real Real;
+
+    void clear()
+    {
+        m_pairs.clear();
+        m_packets.clear();
+    }
+
+    void add(const TCapsule<DataTypes>& cap, const geometry::OBB& box);
+
+    std::size_t size() const { return m_pairs.size(); }
+
+    const std::pair<TCapsule<DataTypes>, geometry::OBB>& pair(std::size_t i) const { return m_pairs[i]; }
+
+    const std::vector<CapsuleOBBPacket>& packets() const { return m_packets; }
+
+protected:
+    std::vector<std::pair<TCapsule<DataTypes>, geometry::OBB> > m_pairs;
+    std::vector<CapsuleOBBPacket> m_packets;
+};
+
+/**
+  *Narrow phase of lists of candidate pairs.
+  *The pairs are first tested by packets against a conservative separating axis test, written
+  *without branches on the lanes so that it is vectorized by the compiler. Only the pairs for which
+  *no axis separates the primitives by more than the alarm distance are then given to the exact
+  *tests of OBBIntTool and CapsuleIntTool, which append their contacts to the output vector.
+  *The contacts are the same as the ones of the pair by pair tests, in the order of the pairs.
+  */
+class COLLISIONOBBCAPSULE_API OBBBatchIntTool
+{
+public:
+    typedef sofa::type::vector<sofa::core::collision::DetectionOutput> OutputVector;
+    typedef geometry::OBB::Real Real;
+
+    /// Returns the number of contacts added to contacts
+    static int computeIntersection(const OBBPairBatch& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+
+    /// Returns the number of contacts added to contacts
+    template <class DataTypes>
+    static int computeIntersection(const TCapsuleOBBPairBatch<DataTypes>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+
+    /**
+      *Sets separated[lane] to a non-zero value if an axis separates the two boxes of the lane
+      *by more than alarmDist. Face axes and edge cross product axes are tested.
+      */
+    static void findSeparatedLanes(const OBBPacket& packet, Real alarmDist, int* separated);
+
+    /**
+      *Sets separated[lane] to a non-zero value if an axis separates the capsule from the box of
+      *the lane by more than alarmDist. Box face axes and bounding spheres are tested.
+      */
+    static void findSeparatedLanes(const CapsuleOBBPacket& packet, Real alarmDist, int* separated);
+};
+
+template <class DataTypes>
+void TCapsuleOBBPairBatch<DataTypes>::add(const TCapsule<DataTypes>& cap, const geometry::OBB& box)
+{
+    const std::size_t lane = m_pairs.size() % OBBBatchPacketSize;
+    if (lane == 0)
+    {
+        m_packets.emplace_back();
+    }
+    m_pairs.emplace_back(cap, box);
+
+    CapsuleOBBPacket& packet = m_packets.back();
+    const auto p1 = cap.point1();
+    const auto p2 = cap.point2();
+    packet.radius[lane] = cap.radius();
+    for (int c = 0; c < 3; ++c)
+    {
+        packet.segmentCenter[c][lane] = (p1[c] + p2[c]) * (Real)0.5;
+        packet.segmentHalf[c][lane] = (p2[c] - p1[c]) * (Real)0.5;
+        packet.center[c][lane] = box.center()[c];
+        packet.extent[c][lane] = box.extent(c);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto a = box.axis(i);
+        for (int c = 0; c < 3; ++c)
+        {
+            packet.axis[i][c][lane] = a[c];
+        }
+    }
+}
+
+template <class DataTypes>
+int OBBBatchIntTool::computeIntersection(const TCapsuleOBBPairBatch<DataTypes>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts)
+{
+    int nbContacts = 0;
+    int separated[OBBBatchPacketSize];
+    const auto& packets = batch.packets();
+    for (std::size_t p = 0; p < packets.size(); ++p)
+    {
+        findSeparatedLanes(packets[p], (Real)alarmDist, separated);
+
+        const std::size_t end = std::min(batch.size(), (p + 1) * OBBBatchPacketSize);
+        for (std::size_t i = p * OBBBatchPacketSize; i < end; ++i)
+        {
+            if (separated[i - p * OBBBatchPacketSize])
+                continue;
+
+            TCapsule<DataTypes> cap = batch.pair(i).first;
+            geometry::OBB box = batch.pair(i).second;
+            nbContacts += CapsuleIntTool::computeIntersection(cap, box, alarmDist, contactDist, contacts);
+        }
+    }
+    return nbContacts;
+}
+
+#if !defined(SOFA_COMPONENT_COLLISION_OBBBATCHINTTOOL_CPP)
+extern template class COLLISIONOBBCAPSULE_API TCapsuleOBBPairBatch<sofa::defaulttype::Vec3Types>;
+extern template class COLLISIONOBBCAPSULE_API TCapsuleOBBPairBatch<sofa::defaulttype::RigidTypes>;
+extern template COLLISIONOBBCAPSULE_API int OBBBatchIntTool::computeIntersection(const TCapsuleOBBPairBatch<sofa::defaulttype::Vec3Types>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+extern template COLLISIONOBBCAPSULE_API int OBBBatchIntTool::computeIntersection(const TCapsuleOBBPairBatch<sofa::defaulttype::RigidTypes>& batch, SReal alarmDist, SReal contactDist, OutputVector* contacts);
+#endif
+
+} // namespace collisionobbcapsule::detection::intersection
@@ -57,6 +57,26 @@ RigidMeshDiscreteIntersection::RigidMeshDiscreteIntersection(NewProximityInterse
     intersection->intersectors.add<TriangleCollisionModel<sofa::defaulttype::Vec3Types>, OBBCollisionModel<sofa::defaulttype::Rigid3Types>, RigidMeshDiscreteIntersection>(this);
 }
 
+int RigidDiscreteIntersection::computeIntersection(OBBCollisionModel<sofa::defaulttype::Rigid3Types>* model1, OBBCollisionModel<sofa::defaulttype::Rigid3Types>* model2,
+                                                   const ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end,
+                                                   OutputVector* contacts, const core::collision::Intersection* intersection)
+{
+    const SReal proximity = model1->getProximity() + model2->getProximity();
+
+    // one buffer per thread, as the narrow phase may test several pairs of models concurrently
+    thread_local OBBPairBatch batch;
+    batch.clear();
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        batch.add(OBB(model1, pairs[i].first), OBB(model2, pairs[i].second));
+    }
+
+    return OBBBatchIntTool::computeIntersection(batch,
+        proximity + intersection->getAlarmDistance(),
+        proximity + intersection->getContactDistance(),
+        contacts);
+}
+
 bool RigidDiscreteIntersection::testIntersection(Ray& /*rRay*/, OBB& /*rOBB*/, const core::collision::Intersection*)
 {
     return false;
@@ -30,6 +30,7 @@
 #include <CollisionOBBCapsule/geometry/OBBModel.h>
 #include <CollisionOBBCapsule/detection/intersection/BaseIntTool.h>
 #include <CollisionOBBCapsule/detection/intersection/MeshIntTool.h>
+#include <CollisionOBBCapsule/detection/intersection/OBBBatchIntTool.h>
 
 namespace collisionobbcapsule::detection::intersection
 {
@@ -60,6 +61,12 @@ public:
 
     bool testIntersection(Ray& /*rRay*/, OBB& /*rOBB*/, const core::collision::Intersection* intersection);
     int computeIntersection(Ray& rRay, OBB& rObb, OutputVector* contacts, const core::collision::Intersection* intersection);
+
+    /// Intersections of the candidate pairs [begin, end) of two OBB models, tested by packets with OBBBatchIntTool.
+    /// The contacts are the same, in the same order, as the ones of the pair by pair tests.
+    int computeIntersection(geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>* model1, geometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>* model2,
+                            const core::collision::ElementIntersector::CandidatePairs& pairs, std::size_t begin, std::size_t end,
+                            OutputVector* contacts, const core::collision::Intersection* intersection);
 };
 
 
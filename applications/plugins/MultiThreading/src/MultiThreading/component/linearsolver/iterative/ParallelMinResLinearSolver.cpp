@@ -0,0 +1,53 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_MULTITHREADING_PARALLELMINRESLINEARSOLVER_CPP
+#include <MultiThreading/component/linearsolver/iterative/ParallelMinResLinearSolver.inl>
+#include <MultiThreading/config.h>
+#include <MultiThreading/ParallelImplementationsRegistry.h>
+#include <sofa/component/linearsolver/iterative/MinResLinearSolver.inl>
+#include <MultiThreading/component/linearsolver/iterative/ParallelCompressedRowSparseMatrixMechanical.h>
+
+using multithreading::component::linearsolver::iterative::ParallelCompressedRowSparseMatrixMechanical;
+
+// TypedMatrixLinearSystem, MatrixLinearSystem and MatrixLinearSolver are instantiated for these types in ParallelCGLinearSolver.cpp
+template class SOFA_MULTITHREADING_PLUGIN_API
+sofa::component::linearsolver::iterative::MinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<SReal>, sofa::linearalgebra::FullVector<SReal> >;
+template class SOFA_MULTITHREADING_PLUGIN_API
+sofa::component::linearsolver::iterative::MinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<sofa::type::Mat<3,3,SReal>>, sofa::linearalgebra::FullVector<SReal> >;
+
+namespace multithreading::component::linearsolver::iterative
+{
+
+template class SOFA_MULTITHREADING_PLUGIN_API
+ParallelMinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<SReal>, sofa::linearalgebra::FullVector<SReal> >;
+
+template class SOFA_MULTITHREADING_PLUGIN_API
+ParallelMinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<sofa::type::Mat<3,3,SReal>>, sofa::linearalgebra::FullVector<SReal> >;
+
+int ParallelMinResLinearSolverClass = sofa::core::RegisterObject("Linear system solver using the MINRES iterative algorithm in parallel")
+    .add< ParallelMinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<SReal>, sofa::linearalgebra::FullVector<SReal> > >(true)
+    .add< ParallelMinResLinearSolver< ParallelCompressedRowSparseMatrixMechanical<sofa::type::Mat<3,3,SReal>>, sofa::linearalgebra::FullVector<SReal> > >();
+
+const bool isParallelMinResLinearSolverImplementationRegistered =
+    ParallelImplementationsRegistry::addEquivalentImplementations("MinResLinearSolver", "ParallelMinResLinearSolver");
+
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/config.h>
+#include <MultiThreading/TaskSchedulerUser.h>
+#include <sofa/component/linearsolver/iterative/MinResLinearSolver.h>
+
+namespace multithreading::component::linearsolver::iterative
+{
+
+/**
+ * Parallel implementation of MinResLinearSolver
+ *
+ * The matrix-vector products and the dot products are computed in parallel by the task scheduler.
+ */
+template<class TMatrix, class TVector>
+class ParallelMinResLinearSolver :
+    public sofa::component::linearsolver::iterative::MinResLinearSolver<TMatrix, TVector>,
+    public TaskSchedulerUser
+{
+public:
+    SOFA_CLASS2(SOFA_TEMPLATE2(ParallelMinResLinearSolver,TMatrix,TVector),
+               SOFA_TEMPLATE2(sofa::component::linearsolver::iterative::MinResLinearSolver,TMatrix,TVector),
+               TaskSchedulerUser);
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+
+    void init() override;
+
+    void solve(Matrix& A, Vector& x, Vector& b) override;
+
+protected:
+
+    /// Dot product computed as partial sums over ranges of entries in parallel, added in the order of the ranges
+    SReal computeDot(Vector& a, Vector& b) override;
+};
+
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/component/linearsolver/iterative/ParallelMinResLinearSolver.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <numeric>
+
+namespace multithreading::component::linearsolver::iterative
+{
+
+template <class TMatrix, class TVector>
+void ParallelMinResLinearSolver<TMatrix, TVector>::init()
+{
+    Inherit1::init();
+    initTaskScheduler();
+}
+
+template <class TMatrix, class TVector>
+void ParallelMinResLinearSolver<TMatrix, TVector>::solve(
+    Matrix& A, Vector& x, Vector& b)
+{
+    A.setTaskScheduler(this->m_taskScheduler);
+    Inherit1::solve(A, x, b);
+}
+
+template <class TMatrix, class TVector>
+SReal ParallelMinResLinearSolver<TMatrix, TVector>::computeDot(Vector& a, Vector& b)
+{
+    const auto n = static_cast<sofa::Index>(a.size());
+    const auto ranges = sofa::simulation::makeRangesForLoop(
+        static_cast<sofa::Index>(0), n, this->m_taskScheduler->getThreadCount());
+
+    // one partial sum per range: the result depends on the number of threads, but not on the scheduling of the tasks
+    sofa::type::vector<SReal> partialSums(ranges.size(), 0);
+    sofa::simulation::parallelForEach(*this->m_taskScheduler,
+        static_cast<std::size_t>(0), ranges.size(),
+        [&ranges, &partialSums, &a, &b](const std::size_t r)
+        {
+            SReal sum = 0;
+            for (auto i = ranges[r].start; i != ranges[r].end; ++i)
+            {
+                sum += a[i] * b[i];
+            }
+            partialSums[r] = sum;
+        });
+
+    return std::accumulate(partialSums.begin(), partialSums.end(), static_cast<SReal>(0));
+}
+
+}
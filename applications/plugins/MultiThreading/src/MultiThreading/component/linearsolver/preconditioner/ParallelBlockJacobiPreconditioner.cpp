@@ -0,0 +1,40 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_MULTITHREADING_PARALLELBLOCKJACOBIPRECONDITIONER_CPP
+#include <MultiThreading/component/linearsolver/preconditioner/ParallelBlockJacobiPreconditioner.inl>
+#include <MultiThreading/config.h>
+#include <MultiThreading/ParallelImplementationsRegistry.h>
+#include <sofa/core/ObjectFactory.h>
+
+namespace multithreading::component::linearsolver::preconditioner
+{
+
+template class SOFA_MULTITHREADING_PLUGIN_API
+ParallelBlockJacobiPreconditioner< sofa::linearalgebra::BlockDiagonalMatrix<3, SReal>, sofa::linearalgebra::FullVector<SReal> >;
+
+int ParallelBlockJacobiPreconditionerClass = sofa::core::RegisterObject("Parallel linear solver based on a NxN block diagonal matrix (i.e. block Jacobi preconditioner)")
+    .add< ParallelBlockJacobiPreconditioner< sofa::linearalgebra::BlockDiagonalMatrix<3, SReal>, sofa::linearalgebra::FullVector<SReal> > >();
+
+const bool isParallelBlockJacobiPreconditionerImplementationRegistered =
+    ParallelImplementationsRegistry::addEquivalentImplementations("BlockJacobiPreconditioner", "ParallelBlockJacobiPreconditioner");
+
+}
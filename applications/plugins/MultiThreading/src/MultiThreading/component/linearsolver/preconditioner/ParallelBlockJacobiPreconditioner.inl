@@ -0,0 +1,94 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/component/linearsolver/preconditioner/ParallelBlockJacobiPreconditioner.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+namespace multithreading::component::linearsolver::preconditioner
+{
+
+template <class TMatrix, class TVector>
+void ParallelBlockJacobiPreconditioner<TMatrix, TVector>::init()
+{
+    Inherit1::init();
+    initTaskScheduler();
+}
+
+template <class TMatrix, class TVector>
+void ParallelBlockJacobiPreconditioner<TMatrix, TVector>::solve(Matrix& M, Vector& z, Vector& r)
+{
+    using Real = typename Vector::value_type;
+    constexpr auto BSIZE = static_cast<sofa::Index>(Matrix::BSIZE);
+
+    const auto n = static_cast<sofa::Index>(M.colSize());
+    z.resize(n);
+
+    // each diagonal block writes into its own chunk of z: no conflict between tasks
+    const auto applyBlock = [&M, &z, &r](sofa::Index b, sofa::Index size)
+    {
+        const auto& block = M.bloc(b);
+        const sofa::Index i = b * BSIZE;
+        for (sofa::Index bj = 0; bj < size; ++bj)
+        {
+            Real res = 0;
+            for (sofa::Index bi = 0; bi < size; ++bi)
+            {
+                res += static_cast<Real>(Matrix::traits::v(block, bi, bj) * r[i + bi]);
+            }
+            z[i + bj] = res;
+        }
+    };
+
+    const sofa::Index nbFullBlocks = n / BSIZE;
+    sofa::simulation::parallelForEachRange(*m_taskScheduler,
+        static_cast<sofa::Index>(0), nbFullBlocks,
+        [&applyBlock](const auto& range)
+        {
+            for (auto b = range.start; b != range.end; ++b)
+            {
+                applyBlock(b, BSIZE);
+            }
+        });
+
+    if (const sofa::Index lastSize = n % BSIZE)
+    {
+        applyBlock(nbFullBlocks, lastSize);
+    }
+}
+
+template <class TMatrix, class TVector>
+void ParallelBlockJacobiPreconditioner<TMatrix, TVector>::invert(Matrix& M)
+{
+    sofa::simulation::parallelForEachRange(*m_taskScheduler,
+        static_cast<sofa::Index>(0), static_cast<sofa::Index>(M.rowBSize()),
+        [&M](const auto& range)
+        {
+            for (auto b = range.start; b != range.end; ++b)
+            {
+                const typename Matrix::Block m = M.bloc(b);
+                Matrix::traits::invert(*M.wbloc(b), m);
+            }
+        });
+}
+
+}
@@ -0,0 +1,45 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_MULTITHREADING_PARALLELSSORPRECONDITIONER_CPP
+#include <MultiThreading/component/linearsolver/preconditioner/ParallelSSORPreconditioner.inl>
+#include <MultiThreading/config.h>
+#include <MultiThreading/ParallelImplementationsRegistry.h>
+#include <sofa/linearalgebra/CompressedRowSparseMatrix.h>
+#include <sofa/core/ObjectFactory.h>
+
+namespace multithreading::component::linearsolver::preconditioner
+{
+
+template class SOFA_MULTITHREADING_PLUGIN_API
+ParallelSSORPreconditioner< sofa::linearalgebra::CompressedRowSparseMatrix<SReal>, sofa::linearalgebra::FullVector<SReal> >;
+
+template class SOFA_MULTITHREADING_PLUGIN_API
+ParallelSSORPreconditioner< sofa::linearalgebra::CompressedRowSparseMatrix<sofa::type::Mat<3, 3, SReal> >, sofa::linearalgebra::FullVector<SReal> >;
+
+int ParallelSSORPreconditionerClass = sofa::core::RegisterObject("Parallel linear solver / preconditioner based on a multicolor Symmetric Successive Over-Relaxation (SSOR)")
+    .add< ParallelSSORPreconditioner< sofa::linearalgebra::CompressedRowSparseMatrix<SReal>, sofa::linearalgebra::FullVector<SReal> > >(true)
+    .add< ParallelSSORPreconditioner< sofa::linearalgebra::CompressedRowSparseMatrix<sofa::type::Mat<3, 3, SReal> >, sofa::linearalgebra::FullVector<SReal> > >();
+
+const bool isParallelSSORPreconditionerImplementationRegistered =
+    ParallelImplementationsRegistry::addEquivalentImplementations("SSORPreconditioner", "ParallelSSORPreconditioner");
+
+}
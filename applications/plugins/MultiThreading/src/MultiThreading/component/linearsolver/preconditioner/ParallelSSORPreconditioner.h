@@ -0,0 +1,92 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/config.h>
+#include <MultiThreading/TaskSchedulerUser.h>
+#include <sofa/component/linearsolver/preconditioner/SSORPreconditioner.h>
+
+namespace multithreading::component::linearsolver::preconditioner
+{
+
+/**
+ * Parallel implementation of SSORPreconditioner
+ *
+ * The block rows of the matrix are colored such that two rows sharing a non-zero block
+ * have different colors. The forward and backward sweeps are then processed color by
+ * color, the rows of a same color being independent and relaxed in parallel
+ * (multicolor SSOR). The ordering of the unknowns differs from the sequential
+ * implementation, so the preconditioner is not strictly the same, but it keeps its
+ * properties (symmetry, positive definiteness).
+ */
+template<class TMatrix, class TVector>
+class ParallelSSORPreconditioner :
+    public sofa::component::linearsolver::preconditioner::SSORPreconditioner<TMatrix, TVector>,
+    public TaskSchedulerUser
+{
+public:
+    SOFA_CLASS2(SOFA_TEMPLATE2(ParallelSSORPreconditioner,TMatrix,TVector),
+               SOFA_TEMPLATE2(sofa::component::linearsolver::preconditioner::SSORPreconditioner,TMatrix,TVector),
+               TaskSchedulerUser);
+
+    using Matrix = TMatrix;
+    using Vector = TVector;
+    using Index = typename Matrix::Index;
+    using Real = SReal;
+
+    void init() override;
+
+    void solve(Matrix& M, Vector& z, Vector& r) override;
+    void invert(Matrix& M) override;
+
+    sofa::component::linearsolver::MatrixInvertData* createInvertData() override
+    {
+        return new ParallelSSORPreconditionerInvertData();
+    }
+
+protected:
+
+    class ParallelSSORPreconditionerInvertData : public Inherit1::SSORPreconditionerInvertData
+    {
+    public:
+        /// true if the structure of the matrix allows the multicolor sweeps
+        bool isColored { false };
+
+        /// color of each block row
+        sofa::type::vector<Index> rowColor;
+
+        /// block rows sorted by color: rows of color c are colorRows[colorBegin[c]] ... colorRows[colorBegin[c+1]-1]
+        sofa::type::vector<Index> colorBegin;
+        sofa::type::vector<Index> colorRows;
+
+        /// position of the diagonal block of each block row in the compressed storage
+        sofa::type::vector<Index> diagonalBlock;
+    };
+
+    /// Greedy coloring of the block rows, based on the sparsity pattern of the matrix
+    void computeColoring(const Matrix& M, ParallelSSORPreconditionerInvertData* data);
+
+    template<class Sweep>
+    void sweep(const ParallelSSORPreconditionerInvertData* data, bool ascendingColors, const Sweep& sweepRow);
+};
+
+}
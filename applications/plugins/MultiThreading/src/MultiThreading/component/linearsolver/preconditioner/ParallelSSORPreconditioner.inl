@@ -0,0 +1,276 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/component/linearsolver/preconditioner/ParallelSSORPreconditioner.h>
+#include <sofa/simulation/ParallelForEach.h>
+#include <algorithm>
+
+namespace multithreading::component::linearsolver::preconditioner
+{
+
+template <class TMatrix, class TVector>
+void ParallelSSORPreconditioner<TMatrix, TVector>::init()
+{
+    Inherit1::init();
+    initTaskScheduler();
+}
+
+template <class TMatrix, class TVector>
+void ParallelSSORPreconditioner<TMatrix, TVector>::computeColoring(
+    const Matrix& M, ParallelSSORPreconditionerInvertData* data)
+{
+    constexpr Index NL = Matrix::NL;
+    static constexpr Index InvalidColor = static_cast<Index>(-1);
+
+    const auto& rowIndex = M.getRowIndex();
+    const auto& rowBegin = M.getRowBegin();
+    const auto& colsIndex = M.getColsIndex();
+
+    data->isColored = false;
+
+    const Index nbBlockRows = M.rowBSize();
+    if (Matrix::NL != Matrix::NC
+        || M.rowSize() != nbBlockRows * NL
+        || static_cast<Index>(rowIndex.size()) != nbBlockRows)
+    {
+        // some block rows are empty: the matrix cannot be inverted anyway
+        return;
+    }
+
+    // the diagonal block of each row is required to relax the row
+    data->diagonalBlock.resize(nbBlockRows);
+    for (Index b = 0; b < nbBlockRows; ++b)
+    {
+        const auto first = colsIndex.begin() + rowBegin[b];
+        const auto last = colsIndex.begin() + rowBegin[b + 1];
+        const auto it = std::lower_bound(first, last, b);
+        if (rowIndex[b] != b || it == last || *it != b)
+        {
+            return;
+        }
+        data->diagonalBlock[b] = static_cast<Index>(std::distance(colsIndex.begin(), it));
+    }
+
+    // greedy coloring: a row takes the first color not used by its already colored neighbors
+    data->rowColor.assign(nbBlockRows, InvalidColor);
+    sofa::type::vector<Index> colorUsedByRow;
+    for (Index b = 0; b < nbBlockRows; ++b)
+    {
+        for (Index xi = rowBegin[b]; xi < rowBegin[b + 1]; ++xi)
+        {
+            const Index neighborColor = data->rowColor[colsIndex[xi]];
+            if (neighborColor != InvalidColor)
+            {
+                colorUsedByRow[neighborColor] = b;
+            }
+        }
+
+        Index color = 0;
+        while (color < static_cast<Index>(colorUsedByRow.size()) && colorUsedByRow[color] == b)
+        {
+            ++color;
+        }
+        if (color == static_cast<Index>(colorUsedByRow.size()))
+        {
+            colorUsedByRow.push_back(InvalidColor);
+        }
+        data->rowColor[b] = color;
+    }
+
+    // sort the rows by color
+    const auto nbColors = static_cast<Index>(colorUsedByRow.size());
+    data->colorBegin.assign(nbColors + 1, 0);
+    for (Index b = 0; b < nbBlockRows; ++b)
+    {
+        ++data->colorBegin[data->rowColor[b] + 1];
+    }
+    for (Index c = 0; c < nbColors; ++c)
+    {
+        data->colorBegin[c + 1] += data->colorBegin[c];
+    }
+    data->colorRows.resize(nbBlockRows);
+    sofa::type::vector<Index> insertion(data->colorBegin.begin(), data->colorBegin.end() - 1);
+    for (Index b = 0; b < nbBlockRows; ++b)
+    {
+        data->colorRows[insertion[data->rowColor[b]]++] = b;
+    }
+
+    data->isColored = true;
+
+    msg_info() << nbBlockRows << " block rows distributed in " << nbColors << " colors";
+}
+
+template <class TMatrix, class TVector>
+void ParallelSSORPreconditioner<TMatrix, TVector>::invert(Matrix& M)
+{
+    auto* data = static_cast<ParallelSSORPreconditionerInvertData*>(this->getMatrixInvertData(&M));
+
+    M.compress();
+    computeColoring(M, data);
+
+    if (!data->isColored)
+    {
+        msg_warning() << "The structure of the matrix does not allow a parallel relaxation: "
+                         "sequential SSOR is used instead";
+        Inherit1::invert(M);
+        return;
+    }
+
+    constexpr Index NL = Matrix::NL;
+    const auto& colsValue = M.getColsValue();
+
+    data->bsize = NL;
+    data->inv_diag.resize(M.rowSize());
+    sofa::simulation::parallelForEachRange(*m_taskScheduler,
+        static_cast<Index>(0), static_cast<Index>(M.rowBSize()),
+        [data, &colsValue](const auto& range)
+        {
+            for (auto b = range.start; b != range.end; ++b)
+            {
+                const auto& diag = colsValue[data->diagonalBlock[b]];
+                for (Index bi = 0; bi < NL; ++bi)
+                {
+                    data->inv_diag[b * NL + bi] = 1.0 / Matrix::traits::v(diag, bi, bi);
+                }
+            }
+        });
+}
+
+template <class TMatrix, class TVector>
+template <class Sweep>
+void ParallelSSORPreconditioner<TMatrix, TVector>::sweep(
+    const ParallelSSORPreconditionerInvertData* data, bool ascendingColors, const Sweep& sweepRow)
+{
+    const auto nbColors = static_cast<Index>(data->colorBegin.size()) - 1;
+    for (Index k = 0; k < nbColors; ++k)
+    {
+        const Index color = ascendingColors ? k : nbColors - 1 - k;
+
+        // rows of the same color do not depend on each other
+        sofa::simulation::parallelForEachRange(*m_taskScheduler,
+            data->colorBegin[color], data->colorBegin[color + 1],
+            [data, &sweepRow](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    sweepRow(data->colorRows[i]);
+                }
+            });
+    }
+}
+
+// solve (D+U) * D^-1 * ( D + U), the unknowns being ordered by color
+template <class TMatrix, class TVector>
+void ParallelSSORPreconditioner<TMatrix, TVector>::solve(Matrix& M, Vector& z, Vector& r)
+{
+    const auto* data = static_cast<ParallelSSORPreconditionerInvertData*>(this->getMatrixInvertData(&M));
+
+    if (!data->isColored)
+    {
+        Inherit1::solve(M, z, r);
+        return;
+    }
+
+    constexpr Index NL = Matrix::NL;
+    using LocalVec = sofa::type::Vec<NL, Real>;
+
+    const Real w = static_cast<Real>(this->d_omega.getValue());
+
+    const auto& rowBegin = M.getRowBegin();
+    const auto& colsIndex = M.getColsIndex();
+    const auto& colsValue = M.getColsValue();
+    const auto& inv_diag = data->inv_diag;
+    const auto& rowColor = data->rowColor;
+
+    // accumulate the products with the neighbor rows of a color selected by the predicate
+    const auto accumulateNeighbors = [&](Index b, LocalVec& temp, const auto& isNeighborRead)
+    {
+        for (Index xi = rowBegin[b]; xi < rowBegin[b + 1]; ++xi)
+        {
+            const Index j = colsIndex[xi];
+            if (isNeighborRead(rowColor[j]))
+            {
+                const auto& block = colsValue[xi];
+                for (Index bi = 0; bi < NL; ++bi)
+                {
+                    for (Index bj = 0; bj < NL; ++bj)
+                    {
+                        temp[bi] += Matrix::traits::v(block, bi, bj) * z[j * NL + bj];
+                    }
+                }
+            }
+        }
+    };
+
+    // Solve (D/w+U) * t = r;
+    sweep(data, false, [&](Index b)
+    {
+        const Index color = rowColor[b];
+        LocalVec temp;
+        accumulateNeighbors(b, temp, [color](Index neighborColor){ return neighborColor > color; });
+
+        const auto& diag = colsValue[data->diagonalBlock[b]];
+        for (Index k = 0; k < NL; ++k)
+        {
+            const Index bi = NL - 1 - k;
+            for (Index bj = bi + 1; bj < NL; ++bj)
+            {
+                temp[bi] += Matrix::traits::v(diag, bi, bj) * z[b * NL + bj];
+            }
+            z[b * NL + bi] = (r[b * NL + bi] - temp[bi]) * w * inv_diag[b * NL + bi];
+        }
+    });
+
+    // Solve (I + w D^-1 * L) * z = t
+    sweep(data, true, [&](Index b)
+    {
+        const Index color = rowColor[b];
+        LocalVec temp;
+        accumulateNeighbors(b, temp, [color](Index neighborColor){ return neighborColor < color; });
+
+        const auto& diag = colsValue[data->diagonalBlock[b]];
+        for (Index bi = 0; bi < NL; ++bi)
+        {
+            for (Index bj = 0; bj < bi; ++bj)
+            {
+                temp[bi] += Matrix::traits::v(diag, bi, bj) * z[b * NL + bj];
+            }
+            z[b * NL + bi] -= temp[bi] * w * inv_diag[b * NL + bi];
+        }
+    });
+
+    if (w != static_cast<Real>(1.0))
+    {
+        sofa::simulation::parallelForEachRange(*m_taskScheduler,
+            static_cast<Index>(0), static_cast<Index>(M.rowSize()),
+            [&z, w](const auto& range)
+            {
+                for (auto j = range.start; j != range.end; ++j)
+                {
+                    z[j] *= 2 - w;
+                }
+            });
+    }
+}
+
+}
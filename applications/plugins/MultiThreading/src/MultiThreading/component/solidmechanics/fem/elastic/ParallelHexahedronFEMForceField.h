@@ -85,8 +85,7 @@ protected:
 
     // code duplicated from HexahedronFEMForceField::accumulateForceLarge but adapted to be thread-safe
     void computeTaskForceLarge(RDataRefVecCoord& p, sofa::Index elementId, const Element& elem,
-                               const VecElementStiffness& elementStiffnesses, SReal& OutPotentialEnery,
-                               sofa::type::Vec<8, Deriv>& OutF);
+                               SReal& OutPotentialEnery, sofa::type::Vec<8, Deriv>& OutF);
 
     /// Assuming a vertex has 8 adjacent hexahedra, the array stores where the vertex is referenced in each of the adjacent hexahedra
     using HexaAroundVerticesIndex = sofa::type::fixed_array<sofa::Size, 8>;
@@ -92,7 +92,6 @@ void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::Mech
     const auto* indexedElements = this->getIndexedElements();
     this->m_potentialEnergy = 0;
 
-    const auto& elementStiffnesses = this->d_elementStiffnesses.getValue();
     updateStiffnessMatrices = this->d_updateStiffnessMatrix.getValue();
     if (updateStiffnessMatrices)
     {
@@ -107,7 +106,7 @@ void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::Mech
 
     sofa::simulation::parallelForEachRange(*m_taskScheduler,
         indexedElements->begin(), indexedElements->end(),
-        [this, &_p, &elementStiffnesses, &mutex, &_f](const auto& range)
+        [this, &_p, &mutex, &_f](const auto& range)
         {
             auto elementId = std::distance(this->getIndexedElements()->begin(), range.start);
 
@@ -118,7 +117,7 @@ void ParallelHexahedronFEMForceField<DataTypes>::addForce(const sofa::core::Mech
             for (auto it = range.start; it != range.end; ++it, ++elementId)
             {
                 sofa::type::Vec<8, Deriv> forceInElement;
-                this->computeTaskForceLarge(_p, elementId, *it, elementStiffnesses, potentialEnergy, forceInElement);
+                this->computeTaskForceLarge(_p, elementId, *it, potentialEnergy, forceInElement);
                 fElements.emplace_back(forceInElement);
             }
 
@@ -144,7 +143,6 @@ template<class DataTypes>
 void ParallelHexahedronFEMForceField<DataTypes>::computeTaskForceLarge(RDataRefVecCoord &p,
                                                                       sofa::Index elementId,
                                                                       const Element& elem,
-                                                                      const VecElementStiffness& elementStiffnesses,
                                                                       SReal& OutPotentialEnery,
                                                                       sofa::type::Vec<8, Deriv>& OutF)
 {
@@ -182,7 +180,7 @@ void ParallelHexahedronFEMForceField<DataTypes>::computeTaskForceLarge(RDataRefV
     }
 
     sofa::type::Vec<24, Real> F; //forces
-    this->computeForce( F, D, elementStiffnesses[elementId] ); // compute force on element
+    this->computeElementForce( F, D, elementId ); // compute force on element
 
     for(int w=0; w<8; ++w)
         OutF[w] += this->_rotations[elementId].multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2]  ) );
@@ -208,18 +206,16 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
     if (_df.size() != _dx.size())
         _df.resize(_dx.size());
 
-    const auto& elementStiffnesses = this->d_elementStiffnesses.getValue();
     const auto& indexedElements = *this->getIndexedElements();
 
     m_elementsDf.resize(indexedElements.size());
 
     sofa::simulation::parallelForEachRange(*m_taskScheduler,
          indexedElements.begin(), indexedElements.end(),
-         [this, &_dx, &elementStiffnesses, kFactor, &indexedElements](const auto& range)
+         [this, &_dx, kFactor, &indexedElements](const auto& range)
          {
              auto elementId = std::distance(indexedElements.begin(), range.start);
              auto elementsDfIt = m_elementsDf.begin() + elementId;
-             auto elementStiffnessesIt = elementStiffnesses.begin() + elementId;
              auto rotationIt = this->_rotations.begin() + elementId;
 
              for (auto it = range.start; it != range.end; ++it, ++elementId)
@@ -240,12 +236,14 @@ void ParallelHexahedronFEMForceField<DataTypes>::addDForce (const sofa::core::Me
                  }
 
                  // F = K * X
-                 this->computeForce(F, X, *elementStiffnessesIt++);
+                 Real factor;
+                 this->computeForce(F, X, this->getElementStiffness(elementId, factor));
 
+                 const Real elementKFactor = factor * kFactor;
                  sofa::type::Vec<8, Deriv>& df = *elementsDfIt++;
                  for (sofa::Size w = 0; w < 8; ++w)
                  {
-                     df[w] = -r.multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2])) * kFactor;
+                     df[w] = -r.multTranspose(Deriv(F[w * 3], F[w * 3 + 1], F[w * 3 + 2])) * elementKFactor;
                  }
              }
          });
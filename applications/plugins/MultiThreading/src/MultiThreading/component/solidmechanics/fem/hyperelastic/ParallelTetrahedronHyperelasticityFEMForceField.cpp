@@ -0,0 +1,43 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#define SOFA_MULTITHREADING_PARALLELTETRAHEDRONHYPERELASTICITYFEMFORCEFIELD_CPP
+#include <MultiThreading/component/solidmechanics/fem/hyperelastic/ParallelTetrahedronHyperelasticityFEMForceField.inl>
+#include <sofa/defaulttype/VecTypes.h>
+#include <sofa/core/ObjectFactory.h>
+
+#include <MultiThreading/ParallelImplementationsRegistry.h>
+
+namespace multithreading::component::solidmechanics::fem::hyperelastic
+{
+
+using namespace sofa::defaulttype;
+
+const bool isParallelTetrahedronHyperelasticityFEMForceFieldImplementationRegistered =
+    multithreading::ParallelImplementationsRegistry::addEquivalentImplementations("TetrahedronHyperelasticityFEMForceField", "ParallelTetrahedronHyperelasticityFEMForceField");
+
+// Register in the Factory
+int ParallelTetrahedronHyperelasticityFEMForceFieldClass = sofa::core::RegisterObject("Parallel generic tetrahedral finite elements for hyperelastic materials")
+                                           .add < ParallelTetrahedronHyperelasticityFEMForceField < Vec3Types > > ();
+
+template class SOFA_MULTITHREADING_PLUGIN_API ParallelTetrahedronHyperelasticityFEMForceField<Vec3Types>;
+
+}
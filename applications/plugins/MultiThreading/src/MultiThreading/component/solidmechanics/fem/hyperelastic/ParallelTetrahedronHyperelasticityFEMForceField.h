@@ -0,0 +1,116 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/config.h>
+#include <MultiThreading/TaskSchedulerUser.h>
+
+#include <sofa/component/solidmechanics/fem/hyperelastic/TetrahedronHyperelasticityFEMForceField.h>
+
+namespace multithreading::component::solidmechanics::fem::hyperelastic
+{
+
+/**
+ * Parallel implementation of TetrahedronHyperelasticityFEMForceField
+ *
+ * This implementation is the most efficient when:
+ * 1) the number of tetrahedron is large (> 1000)
+ *
+ * The following methods are executed in parallel:
+ * - addForce
+ * - addDForce
+ * - the update of the tangent stiffness matrix (used by addDForce, addKToMatrix and buildStiffnessMatrix)
+ *
+ * The contributions of the elements are computed in parallel into a buffer, then gathered per vertex (or per edge)
+ * in parallel. The gather only relies on lists of contributions built once per topology, so that no thread writes
+ * into the same vector entry, and the result does not depend on the number of threads.
+ */
+template<class DataTypes>
+class SOFA_MULTITHREADING_PLUGIN_API ParallelTetrahedronHyperelasticityFEMForceField :
+    virtual public sofa::component::solidmechanics::fem::hyperelastic::TetrahedronHyperelasticityFEMForceField<DataTypes>,
+    public TaskSchedulerUser
+{
+public:
+    SOFA_CLASS(SOFA_TEMPLATE(ParallelTetrahedronHyperelasticityFEMForceField, DataTypes), SOFA_TEMPLATE(sofa::component::solidmechanics::fem::hyperelastic::TetrahedronHyperelasticityFEMForceField, DataTypes));
+
+    using VecCoord = typename DataTypes::VecCoord;
+    using VecDeriv = typename DataTypes::VecDeriv;
+    using Coord = typename DataTypes::Coord;
+    using Deriv = typename DataTypes::Deriv;
+    using Real = typename Coord::value_type;
+
+    using DataVecDeriv = sofa::core::objectmodel::Data<VecDeriv>;
+    using DataVecCoord = sofa::core::objectmodel::Data<VecCoord>;
+
+    using Matrix3 = typename Inherit1::Matrix3;
+
+    void init() override;
+
+    void addForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& d_f,
+                  const DataVecCoord& d_x, const DataVecDeriv& d_v) override;
+
+    void addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& d_df,
+                   const DataVecDeriv& d_dx) override;
+
+protected:
+
+    void updateTangentMatrix() override;
+
+    /**
+     * Compressed lists of contributions: the contributions to the entry i are the ids stored between
+     * begin[i] and begin[i+1]
+     */
+    struct ContributionsMap
+    {
+        sofa::type::vector<sofa::Index> begin;
+        sofa::type::vector<sofa::Index> ids;
+
+        template<class KeyFunction>
+        void build(std::size_t nbEntries, std::size_t nbContributions, KeyFunction key);
+    };
+
+    /// Build the lists of contributions if the topology changed since the last call
+    void updateContributionsMaps();
+
+    /// For each vertex, the ids (4 * tetrahedronId + local vertex id) of the forces to gather
+    ContributionsMap m_vertexForces;
+
+    /// For each edge, the ids (6 * tetrahedronId + local edge id) of the stiffness matrices to gather
+    ContributionsMap m_edgeStiffnesses;
+
+    /// For each vertex, the ids (2 * edgeId + local vertex id) of the edges it belongs to
+    ContributionsMap m_vertexEdges;
+
+    sofa::type::vector<sofa::type::fixed_array<Deriv, 4> > m_tetrahedronForces;
+    sofa::type::vector<sofa::type::fixed_array<Matrix3, 6> > m_tetrahedronEdgeStiffnesses;
+
+    std::size_t m_nbMappedVertices { 0 };
+    std::size_t m_nbMappedTetrahedra { 0 };
+    std::size_t m_nbMappedEdges { 0 };
+    int m_mappedTopologyRevision { -1 };
+};
+
+#if !defined(SOFA_MULTITHREADING_PARALLELTETRAHEDRONHYPERELASTICITYFEMFORCEFIELD_CPP)
+extern template class SOFA_MULTITHREADING_PLUGIN_API ParallelTetrahedronHyperelasticityFEMForceField<sofa::defaulttype::Vec3Types>;
+#endif
+
+} //namespace multithreading::component::solidmechanics::fem::hyperelastic
@@ -0,0 +1,227 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <MultiThreading/component/solidmechanics/fem/hyperelastic/ParallelTetrahedronHyperelasticityFEMForceField.h>
+#include <sofa/component/solidmechanics/fem/hyperelastic/TetrahedronHyperelasticityFEMForceField.inl>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/TaskScheduler.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <numeric>
+
+namespace multithreading::component::solidmechanics::fem::hyperelastic
+{
+
+template<class DataTypes>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::init()
+{
+    Inherit1::init();
+    initTaskScheduler();
+}
+
+template <class DataTypes>
+template <class KeyFunction>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::ContributionsMap::build(
+    std::size_t nbEntries, std::size_t nbContributions, KeyFunction key)
+{
+    begin.assign(nbEntries + 1, 0);
+    for (std::size_t c = 0; c < nbContributions; ++c)
+    {
+        ++begin[key(c) + 1];
+    }
+    std::partial_sum(begin.begin(), begin.end(), begin.begin());
+
+    ids.resize(nbContributions);
+    sofa::type::vector<sofa::Index> position(begin.begin(), begin.end() - 1);
+    for (std::size_t c = 0; c < nbContributions; ++c)
+    {
+        ids[position[key(c)]++] = static_cast<sofa::Index>(c);
+    }
+}
+
+template <class DataTypes>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::updateContributionsMaps()
+{
+    const auto& tetrahedra = this->m_topology->getTetrahedra();
+    const auto& edges = this->m_topology->getEdges();
+    const std::size_t nbVertices = this->mstate->getSize();
+    const int revision = this->m_topology->getRevision();
+
+    if (nbVertices == m_nbMappedVertices && tetrahedra.size() == m_nbMappedTetrahedra
+        && edges.size() == m_nbMappedEdges && revision == m_mappedTopologyRevision)
+    {
+        return;
+    }
+
+    m_vertexForces.build(nbVertices, 4 * tetrahedra.size(),
+        [&tetrahedra](std::size_t c) { return tetrahedra[c / 4][c % 4]; });
+
+    m_edgeStiffnesses.build(edges.size(), 6 * tetrahedra.size(),
+        [this](std::size_t c) { return this->m_topology->getEdgesInTetrahedron(c / 6)[c % 6]; });
+
+    m_vertexEdges.build(nbVertices, 2 * edges.size(),
+        [&edges](std::size_t c) { return edges[c / 2][c % 2]; });
+
+    m_tetrahedronForces.resize(tetrahedra.size());
+    m_tetrahedronEdgeStiffnesses.resize(tetrahedra.size());
+
+    m_nbMappedVertices = nbVertices;
+    m_nbMappedTetrahedra = tetrahedra.size();
+    m_nbMappedEdges = edges.size();
+    m_mappedTopologyRevision = revision;
+}
+
+template<class DataTypes>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::addForce(const sofa::core::MechanicalParams* /* mparams */, DataVecDeriv& d_f,
+    const DataVecCoord& d_x, const DataVecDeriv& /* d_v */)
+{
+    updateContributionsMaps();
+
+    auto fAccessor = sofa::helper::getWriteAccessor(d_f);
+    VecDeriv& f = fAccessor.wref();
+    const VecCoord& x = d_x.getValue();
+
+    const auto& tetrahedra = this->m_topology->getTetrahedra();
+    auto tetrahedronInfAccessor = sofa::helper::getWriteAccessor(this->m_tetrahedronInfo);
+    auto& tetrahedronInf = tetrahedronInfAccessor.wref();
+
+    this->dispatchMaterial([&](auto& material)
+    {
+        sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), tetrahedra.size(),
+            [&](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    this->computeTetrahedronForce(material, tetrahedra[i], tetrahedronInf[i], x, m_tetrahedronForces[i]);
+                }
+            });
+    });
+
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), std::min(f.size(), m_nbMappedVertices),
+        [&](const auto& range)
+        {
+            for (auto v = range.start; v != range.end; ++v)
+            {
+                for (auto c = m_vertexForces.begin[v]; c < m_vertexForces.begin[v + 1]; ++c)
+                {
+                    const auto id = m_vertexForces.ids[c];
+                    f[v] += m_tetrahedronForces[id / 4][id % 4];
+                }
+            }
+        });
+
+    /// indicates that the next call to addDForce will need to update the stiffness matrix
+    this->m_updateMatrix = true;
+}
+
+template<class DataTypes>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::updateTangentMatrix()
+{
+    updateContributionsMaps();
+
+    auto edgeInfAccessor = sofa::helper::getWriteAccessor(this->m_edgeInfo);
+    auto& edgeInf = edgeInfAccessor.wref();
+    auto tetrahedronInfAccessor = sofa::helper::getWriteAccessor(this->m_tetrahedronInfo);
+    auto& tetrahedronInf = tetrahedronInfAccessor.wref();
+
+    this->dispatchMaterial([&](auto& material)
+    {
+        sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), m_nbMappedTetrahedra,
+            [&](const auto& range)
+            {
+                for (auto i = range.start; i != range.end; ++i)
+                {
+                    this->computeTetrahedronEdgeStiffness(material, static_cast<sofa::Index>(i), tetrahedronInf[i], m_tetrahedronEdgeStiffnesses[i]);
+                }
+            });
+    });
+
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), m_nbMappedEdges,
+        [&](const auto& range)
+        {
+            for (auto e = range.start; e != range.end; ++e)
+            {
+                Matrix3& DfDx = edgeInf[e].DfDx;
+                DfDx.clear();
+                for (auto c = m_edgeStiffnesses.begin[e]; c < m_edgeStiffnesses.begin[e + 1]; ++c)
+                {
+                    const auto id = m_edgeStiffnesses.ids[c];
+                    DfDx += m_tetrahedronEdgeStiffnesses[id / 6][id % 6];
+                }
+            }
+        });
+
+    this->m_updateMatrix = false;
+}
+
+template<class DataTypes>
+void ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>::addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& d_df,
+    const DataVecDeriv& d_dx)
+{
+    /// if the  matrix needs to be updated
+    if (this->m_updateMatrix)
+    {
+        this->updateTangentMatrix();
+    }
+    else
+    {
+        updateContributionsMaps();
+    }
+
+    auto dfAccessor = sofa::helper::getWriteAccessor(d_df);
+    VecDeriv& df = dfAccessor.wref();
+    const VecDeriv& dx = d_dx.getValue();
+    const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams, this->rayleighStiffness.getValue());
+
+    const auto& edges = this->m_topology->getEdges();
+    const auto& edgeInf = this->m_edgeInfo.getValue();
+
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), std::min(df.size(), m_nbMappedVertices),
+        [&](const auto& range)
+        {
+            for (auto v = range.start; v != range.end; ++v)
+            {
+                Deriv dfv;
+                for (auto c = m_vertexEdges.begin[v]; c < m_vertexEdges.begin[v + 1]; ++c)
+                {
+                    const auto id = m_vertexEdges.ids[c];
+                    const auto& edge = edges[id / 2];
+                    const Matrix3& DfDx = edgeInf[id / 2].DfDx;
+                    const Deriv deltax = dx[edge[0]] - dx[edge[1]];
+
+                    if (id % 2 == 0)
+                    {
+                        // transpose multiply for the first vertex of the edge
+                        dfv += DfDx.multTranspose(deltax);
+                    }
+                    else
+                    {
+                        dfv -= DfDx * deltax;
+                    }
+                }
+                df[v] += dfv * kFactor;
+            }
+        });
+}
+
+} //namespace multithreading::component::solidmechanics::fem::hyperelastic
@@ -25,6 +25,8 @@
 #include <MultiThreading/TaskSchedulerUser.h>
 #include <sofa/component/solidmechanics/spring/SpringForceField.h>
 
+#include <array>
+
 namespace sofa::simulation
 {
 class TaskScheduler;
@@ -51,11 +53,65 @@ public:
 
     using Spring = typename Inherit1::Spring;
     using SpringForce = typename Inherit1::SpringForce;
+    using CPos = typename DataTypes::CPos;
+    using DPos = typename DataTypes::DPos;
 
     void init() override;
 
     void addForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1, const DataVecCoord& data_x2, const DataVecDeriv& data_v1, const DataVecDeriv& data_v2 ) override;
     void addDForce(const sofa::core::MechanicalParams* mparams, DataVecDeriv& data_df1, DataVecDeriv& data_df2, const DataVecDeriv& data_dx1, const DataVecDeriv& data_dx2) override;
+
+    void addKToMatrix(const sofa::core::MechanicalParams* mparams, const sofa::core::behavior::MultiMatrixAccessor* matrix) override;
+    void buildStiffnessMatrix(sofa::core::behavior::StiffnessMatrix* matrix) override;
+
+protected:
+
+    /// The springs stored as a structure of arrays, sorted by their particles so that consecutive
+    /// springs access close particles. The arrays are rebuilt when the springs are modified.
+    struct SpringArrays
+    {
+        sofa::type::vector<sofa::Index> springId; ///< index of the spring in d_springs
+        sofa::type::vector<sofa::Index> m1;
+        sofa::type::vector<sofa::Index> m2;
+        sofa::type::vector<Real> ks;
+        sofa::type::vector<Real> kd;
+        sofa::type::vector<Real> restLength;
+        sofa::type::vector<char> enabled;
+        sofa::type::vector<char> elongationOnly;
+    };
+    SpringArrays m_springArrays;
+
+    /// The springs attached to each particle, in compressed sparse row format, so that the forces of the
+    /// springs are summed particle by particle instead of being scattered under a lock.
+    /// An entry is 2 * (position of the spring in the sorted arrays), plus 1 if the particle is the second one of the spring.
+    struct SpringIncidence
+    {
+        sofa::type::vector<sofa::Index> begin;
+        sofa::type::vector<sofa::Index> entries;
+    };
+    /// Incidence in the first and in the second state. If both states share the same force vector,
+    /// only the first incidence is used, and contains both ends of the springs.
+    std::array<SpringIncidence, 2> m_incidences;
+
+    int m_springsCounter { -1 };
+    bool m_sharedForceVector { false };
+
+    /// Force (or force derivative) of each spring on its first particle, the opposite being applied on the second one
+    sofa::type::vector<DPos> m_springForces;
+    sofa::type::vector<Real> m_springEnergies;
+
+    /// Compact stiffness of each spring: dF/dX = a.U.U^T + b.I, where U is the direction of the spring
+    sofa::type::vector<CPos> m_springDirections;
+    sofa::type::vector<Real> m_stiffnessA;
+    sofa::type::vector<Real> m_stiffnessB;
+    /// The stiffness matrices dfdx are only built from the compact stiffness when a matrix is assembled
+    bool m_areStiffnessMatricesDirty { true };
+
+    void updateSpringArrays(std::size_t nbParticles1, std::size_t nbParticles2, bool sharedForceVector);
+    void updateStiffnessMatrices();
+
+    /// Adds the forces stored in m_springForces on the particles, in parallel over the particles
+    void accumulateSpringForces(VecDeriv& f1, VecDeriv& f2);
 };
 
 }
@@ -24,6 +24,10 @@
 #include <MultiThreading/component/solidmechanics/spring/ParallelSpringForceField.h>
 #include <sofa/simulation/MainTaskSchedulerFactory.h>
 #include <sofa/simulation/ParallelForEach.h>
+#include <sofa/core/behavior/MultiMatrixAccessor.h>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
 
 namespace multithreading::component::solidmechanics::spring
 {
@@ -34,6 +38,142 @@ void ParallelSpringForceField<DataTypes>::init()
     initTaskScheduler();
 }
 
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::updateSpringArrays(std::size_t nbParticles1, std::size_t nbParticles2, bool sharedForceVector)
+{
+    const sofa::type::vector<Spring>& springs = this->d_springs.getValue();
+
+    const bool isUpToDate = m_springsCounter == this->d_springs.getCounter()
+        && m_springArrays.springId.size() == springs.size()
+        && m_sharedForceVector == sharedForceVector
+        && m_incidences[0].begin.size() == nbParticles1 + 1
+        && (sharedForceVector || m_incidences[1].begin.size() == nbParticles2 + 1);
+    if (isUpToDate)
+    {
+        return;
+    }
+
+    m_springsCounter = this->d_springs.getCounter();
+    m_sharedForceVector = sharedForceVector;
+
+    const std::size_t nbSprings = springs.size();
+
+    // sort the springs by their particles, to improve the locality of the accesses
+    SpringArrays& arrays = m_springArrays;
+    arrays.springId.resize(nbSprings);
+    std::iota(arrays.springId.begin(), arrays.springId.end(), 0);
+    std::stable_sort(arrays.springId.begin(), arrays.springId.end(), [&springs](const sofa::Index i, const sofa::Index j)
+    {
+        return std::tie(springs[i].m1, springs[i].m2) < std::tie(springs[j].m1, springs[j].m2);
+    });
+
+    arrays.m1.resize(nbSprings);
+    arrays.m2.resize(nbSprings);
+    arrays.ks.resize(nbSprings);
+    arrays.kd.resize(nbSprings);
+    arrays.restLength.resize(nbSprings);
+    arrays.enabled.resize(nbSprings);
+    arrays.elongationOnly.resize(nbSprings);
+    for (std::size_t k = 0; k < nbSprings; ++k)
+    {
+        const Spring& spring = springs[arrays.springId[k]];
+        arrays.m1[k] = spring.m1;
+        arrays.m2[k] = spring.m2;
+        arrays.ks[k] = spring.ks;
+        arrays.kd[k] = spring.kd;
+        arrays.restLength[k] = spring.initpos;
+        arrays.enabled[k] = spring.enabled;
+        arrays.elongationOnly[k] = spring.elongationOnly;
+    }
+
+    // counting sort of the ends of the springs by particle
+    const auto buildIncidence = [&arrays, nbSprings](SpringIncidence& incidence, std::size_t nbParticles, bool withFirstEnds, bool withSecondEnds)
+    {
+        incidence.begin.assign(nbParticles + 1, 0);
+        const auto forEachEnd = [&](const auto& f)
+        {
+            for (std::size_t k = 0; k < nbSprings; ++k)
+            {
+                if (withFirstEnds && arrays.m1[k] < nbParticles)
+                {
+                    f(arrays.m1[k], static_cast<sofa::Index>(2 * k));
+                }
+                if (withSecondEnds && arrays.m2[k] < nbParticles)
+                {
+                    f(arrays.m2[k], static_cast<sofa::Index>(2 * k + 1));
+                }
+            }
+        };
+
+        forEachEnd([&incidence](const sofa::Index particle, sofa::Index) { ++incidence.begin[particle + 1]; });
+        std::partial_sum(incidence.begin.begin(), incidence.begin.end(), incidence.begin.begin());
+
+        incidence.entries.resize(incidence.begin.back());
+        sofa::type::vector<sofa::Index> next(incidence.begin.begin(), incidence.begin.end() - 1);
+        forEachEnd([&incidence, &next](const sofa::Index particle, const sofa::Index entry) { incidence.entries[next[particle]++] = entry; });
+    };
+
+    if (sharedForceVector)
+    {
+        buildIncidence(m_incidences[0], nbParticles1, true, true);
+        m_incidences[1] = SpringIncidence();
+    }
+    else
+    {
+        buildIncidence(m_incidences[0], nbParticles1, true, false);
+        buildIncidence(m_incidences[1], nbParticles2, false, true);
+    }
+
+    m_springForces.resize(nbSprings);
+    m_springEnergies.resize(nbSprings);
+    m_springDirections.resize(nbSprings);
+    m_stiffnessA.resize(nbSprings);
+    m_stiffnessB.resize(nbSprings);
+}
+
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::accumulateSpringForces(VecDeriv& f1, VecDeriv& f2)
+{
+    const auto accumulate = [this](const SpringIncidence& incidence, VecDeriv& f)
+    {
+        sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), incidence.begin.size() - 1,
+            [this, &incidence, &f](const auto& range)
+            {
+                for (auto particle = range.start; particle < range.end; ++particle)
+                {
+                    const sofa::Index begin = incidence.begin[particle];
+                    const sofa::Index end = incidence.begin[particle + 1];
+                    if (begin == end)
+                    {
+                        continue;
+                    }
+
+                    DPos force {};
+                    for (sofa::Index j = begin; j < end; ++j)
+                    {
+                        const sofa::Index entry = incidence.entries[j];
+                        const DPos& springForce = m_springForces[entry >> 1];
+                        if (entry & 1)
+                        {
+                            force -= springForce;
+                        }
+                        else
+                        {
+                            force += springForce;
+                        }
+                    }
+                    DataTypes::setDPos(f[particle], DataTypes::getDPos(f[particle]) + force);
+                }
+            });
+    };
+
+    accumulate(m_incidences[0], f1);
+    if (!m_sharedForceVector)
+    {
+        accumulate(m_incidences[1], f2);
+    }
+}
+
 template <class DataTypes>
 void ParallelSpringForceField<DataTypes>::addForce(const sofa::core::MechanicalParams* mparams,
     DataVecDeriv& data_f1, DataVecDeriv& data_f2, const DataVecCoord& data_x1,
@@ -53,48 +193,53 @@ void ParallelSpringForceField<DataTypes>::addForce(const sofa::core::MechanicalP
     this->dfdx.resize(springs.size());
     f1.resize(x1.size());
     f2.resize(x2.size());
-    this->m_potentialEnergy = 0;
 
-    std::mutex mutex;
+    updateSpringArrays(x1.size(), x2.size(), &data_f1 == &data_f2);
+    const SpringArrays& arrays = m_springArrays;
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &x1, &v1, &x2, &v2, &mutex, &f1, &f2](const auto& range)
+    // forces and compact stiffness of the springs, in parallel over the springs
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), arrays.springId.size(),
+        [this, &arrays, &x1, &v1, &x2, &v2](const auto& range)
         {
-            sofa::type::vector<std::unique_ptr<SpringForce> > springForces;
-            springForces.reserve(range.end - range.start);
-            for (auto i = range.start; i < range.end; ++i)
+            for (auto k = range.start; k < range.end; ++k)
             {
-                std::unique_ptr<SpringForce> springForce = this->computeSpringForce(x1, v1, x2, v2, springs[i]);
-                springForces.push_back(std::move(springForce));
-            }
-
-            std::lock_guard lock(mutex);
+                const sofa::Index a = arrays.m1[k];
+                const sofa::Index b = arrays.m2[k];
 
-            std::size_t i = range.start;
-            for (auto& springForce : springForces)
-            {
-                if (springForce)
+                CPos u = DataTypes::getCPos(x2[b]) - DataTypes::getCPos(x1[a]);
+                const Real d = u.norm();
+                if (arrays.enabled[k] && d > 1.0e-9 && (!arrays.elongationOnly[k] || d > arrays.restLength[k]))
                 {
-                    const SpringForce* stiffSpringForce = static_cast<const SpringForce*>(springForce.get());
-
-                    sofa::Index a = springs[i].m1;
-                    sofa::Index b = springs[i].m2;
+                    // same computation as SpringForceField::computeSpringForce
+                    const Real inverseLength = 1.0f / d;
+                    u *= inverseLength;
+                    const Real elongation = d - arrays.restLength[k];
+                    const DPos relativeVelocity = DataTypes::getDPos(v2[b]) - DataTypes::getDPos(v1[a]);
+                    const Real elongationVelocity = dot(u, relativeVelocity);
+                    const Real forceIntensity = arrays.ks[k] * elongation + arrays.kd[k] * elongationVelocity;
+                    const Real tgt = forceIntensity * inverseLength;
 
-                    DataTypes::setDPos( f1[a], DataTypes::getDPos(f1[a]) + std::get<0>(stiffSpringForce->force)) ;
-                    DataTypes::setDPos( f2[b], DataTypes::getDPos(f2[b]) + std::get<1>(stiffSpringForce->force)) ;
-
-                    this->m_potentialEnergy += stiffSpringForce->energy;
-
-                    this->dfdx[i] = stiffSpringForce->dForce_dX;
+                    m_springForces[k] = u * forceIntensity;
+                    m_springEnergies[k] = elongation * elongation * arrays.ks[k] / 2;
+                    m_springDirections[k] = u;
+                    m_stiffnessA[k] = arrays.ks[k] - tgt;
+                    m_stiffnessB[k] = tgt;
                 }
                 else
                 {
-                    // set derivative to 0
-                    this->dfdx[i].clear();
+                    m_springForces[k] = DPos();
+                    m_springEnergies[k] = 0;
+                    m_springDirections[k] = CPos();
+                    m_stiffnessA[k] = 0;
+                    m_stiffnessB[k] = 0;
                 }
-                ++i;
             }
         });
+
+    this->m_potentialEnergy = std::accumulate(m_springEnergies.begin(), m_springEnergies.end(), Real(0));
+    m_areStiffnessMatricesDirty = true;
+
+    accumulateSpringForces(f1.wref(), f2.wref());
 }
 
 template <class DataTypes>
@@ -112,37 +257,75 @@ void ParallelSpringForceField<DataTypes>::addDForce(
     df2.resize(dx2.size());
 
     const Real kFactor = (Real)sofa::core::mechanicalparams::kFactorIncludingRayleighDamping(mparams,this->rayleighStiffness.getValue());
-    const Real bFactor = (Real)sofa::core::mechanicalparams::bFactor(mparams);
 
-    const sofa::type::vector<Spring>& springs= this->d_springs.getValue();
-
-    std::mutex mutex;
+    // the compact stiffness is computed by addForce
+    if (m_springArrays.springId.size() != this->d_springs.getValue().size() || m_springsCounter != this->d_springs.getCounter())
+    {
+        msg_error() << "addDForce is called before addForce: the springs have been modified since the last computation of the forces";
+        return;
+    }
+    updateSpringArrays(dx1.size(), dx2.size(), &data_df1 == &data_df2);
+    const SpringArrays& arrays = m_springArrays;
 
-    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), springs.size(),
-        [this, &springs, &df1, &df2, &dx1, &dx2, kFactor, bFactor, &mutex](const auto& range)
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), arrays.springId.size(),
+        [this, &arrays, &dx1, &dx2, kFactor](const auto& range)
         {
-            sofa::type::vector<typename DataTypes::DPos> dforces;
-            dforces.reserve(range.end - range.start);
-            for (auto i = range.start; i < range.end; ++i)
+            for (auto k = range.start; k < range.end; ++k)
             {
-                dforces.push_back(
-                    this->computeSpringDForce(df1.wref(), dx1, df2.wref(), dx2, i, springs[i], kFactor, bFactor));
+                const CPos d = DataTypes::getDPos(dx2[arrays.m2[k]]) - DataTypes::getDPos(dx1[arrays.m1[k]]);
+                const CPos& u = m_springDirections[k];
+                m_springForces[k] = (u * (m_stiffnessA[k] * dot(u, d)) + d * m_stiffnessB[k]) * kFactor;
             }
+        });
 
-            std::lock_guard lock(mutex);
+    accumulateSpringForces(df1.wref(), df2.wref());
+}
 
-            auto dforceIt = dforces.begin();
-            for (auto i = range.start; i < range.end; ++i)
-            {
-                const auto& dforce = *dforceIt++;
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::updateStiffnessMatrices()
+{
+    if (!m_areStiffnessMatricesDirty)
+    {
+        return;
+    }
 
-                const sofa::Index a = springs[i].m1;
-                const sofa::Index b = springs[i].m2;
+    const SpringArrays& arrays = m_springArrays;
+    this->dfdx.resize(this->d_springs.getValue().size());
 
-                DataTypes::setDPos( df1[a], DataTypes::getDPos(df1[a]) + dforce ) ;
-                DataTypes::setDPos( df2[b], DataTypes::getDPos(df2[b]) - dforce ) ;
+    sofa::simulation::parallelForEachRange(*m_taskScheduler, static_cast<std::size_t>(0), arrays.springId.size(),
+        [this, &arrays](const auto& range)
+        {
+            constexpr auto N = Inherit1::N;
+            for (auto k = range.start; k < range.end; ++k)
+            {
+                auto& m = this->dfdx[arrays.springId[k]];
+                const CPos& u = m_springDirections[k];
+                for (sofa::Index j = 0; j < N; ++j)
+                {
+                    for (sofa::Index l = 0; l < N; ++l)
+                    {
+                        m[j][l] = m_stiffnessA[k] * u[j] * u[l];
+                    }
+                    m[j][j] += m_stiffnessB[k];
+                }
             }
-        }
-    );
+        });
+
+    m_areStiffnessMatricesDirty = false;
 }
+
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::addKToMatrix(const sofa::core::MechanicalParams* mparams, const sofa::core::behavior::MultiMatrixAccessor* matrix)
+{
+    updateStiffnessMatrices();
+    Inherit1::addKToMatrix(mparams, matrix);
+}
+
+template <class DataTypes>
+void ParallelSpringForceField<DataTypes>::buildStiffnessMatrix(sofa::core::behavior::StiffnessMatrix* matrix)
+{
+    updateStiffnessMatrices();
+    Inherit1::buildStiffnessMatrix(matrix);
+}
+
 }
@@ -0,0 +1,168 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/common/SceneLoaderXML.h>
+#include <sofa/testing/BaseSimulationTest.h>
+
+#include <sstream>
+
+namespace sofa
+{
+
+using DataTypes = sofa::defaulttype::Vec3Types;
+using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<DataTypes>;
+
+/**
+ * Scenes made of identical bending beams, each of them being solved with its own linear solver
+ */
+struct ParallelLinearSolvers_test : public sofa::testing::BaseSimulationTest
+{
+    simulation::Node::SPtr root;
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    /// Create one beam for each of the linear solvers, given as XML elements
+    void createScene(const std::vector<std::string>& linearSolvers)
+    {
+        std::stringstream scene;
+        scene << "<?xml version='1.0'?>"
+                 "<Node name='root' dt='0.02' gravity='0 -10 0'>"
+                 "  <RequiredPlugin name='MultiThreading'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Constraint.Projective'/>"
+                 "  <RequiredPlugin name='Sofa.Component.LinearSolver.Iterative'/>"
+                 "  <RequiredPlugin name='Sofa.Component.LinearSolver.Preconditioner'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Mass'/>"
+                 "  <RequiredPlugin name='Sofa.Component.ODESolver.Backward'/>"
+                 "  <RequiredPlugin name='Sofa.Component.SolidMechanics.FEM.Elastic'/>"
+                 "  <RequiredPlugin name='Sofa.Component.StateContainer'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Topology.Container.Grid'/>"
+                 "  <DefaultAnimationLoop/>";
+        for (std::size_t i = 0; i < linearSolvers.size(); ++i)
+        {
+            scene << "  <Node name='beam" << i << "'>"
+                     "    <EulerImplicitSolver rayleighStiffness='0.1' rayleighMass='0.1'/>"
+                  << linearSolvers[i] <<
+                     "    <RegularGridTopology name='grid' n='4 4 12' min='0 0 0' max='1 1 5'/>"
+                     "    <MechanicalObject name='dofs' template='Vec3d'/>"
+                     "    <UniformMass totalMass='10'/>"
+                     "    <FixedProjectiveConstraint indices='0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15'/>"
+                     "    <HexahedronFEMForceField youngModulus='4000' poissonRatio='0.3' method='large'/>"
+                     "  </Node>";
+        }
+        scene << "</Node>";
+
+        root = simulation::SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        ASSERT_NE(root, nullptr);
+        sofa::simulation::node::initRoot(root.get());
+    }
+
+    const DataTypes::VecCoord& getPositions(std::size_t beam) const
+    {
+        const auto* dofs = dynamic_cast<MechanicalObject3*>(root->getChild("beam" + std::to_string(beam))->getObject("dofs"));
+        EXPECT_NE(dofs, nullptr);
+        return dofs->read(core::ConstVecCoordId::position())->getValue();
+    }
+
+    /// Compare the positions of the beams after a few time steps. The reductions are not computed in the same order
+    /// by the parallel implementations, so the results are not expected to be bitwise identical.
+    void checkSamePositions(std::size_t nbSteps)
+    {
+        for (std::size_t step = 0; step < nbSteps; ++step)
+        {
+            sofa::simulation::node::animate(root.get(), root->getDt());
+        }
+
+        const auto& expected = getPositions(0);
+        const auto& actual = getPositions(1);
+        ASSERT_EQ(expected.size(), actual.size());
+
+        // the beams must have moved under gravity
+        EXPECT_LT(expected.back()[1], -1e-3);
+
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                EXPECT_NEAR(expected[i][c], actual[i][c], 1e-7) << "vertex " << i;
+            }
+        }
+    }
+};
+
+TEST_F(ParallelLinearSolvers_test, minResSameAsSequential)
+{
+    createScene({
+        "<MinResLinearSolver template='CompressedRowSparseMatrixMat3x3d' iterations='1000' tolerance='1e-12'/>",
+        "<ParallelMinResLinearSolver template='ParallelCompressedRowSparseMatrixMat3x3d' iterations='1000' tolerance='1e-12'/>"
+    });
+    checkSamePositions(3);
+}
+
+TEST_F(ParallelLinearSolvers_test, blockJacobiPreconditionerSameAsSequential)
+{
+    createScene({
+        "<ShewchukPCGLinearSolver iterations='1000' tolerance='1e-15' preconditioner='@preconditioner'/>"
+        "<BlockJacobiPreconditioner name='preconditioner'/>",
+        "<ShewchukPCGLinearSolver iterations='1000' tolerance='1e-15' preconditioner='@preconditioner'/>"
+        "<ParallelBlockJacobiPreconditioner name='preconditioner'/>"
+    });
+    checkSamePositions(3);
+}
+
+TEST_F(ParallelLinearSolvers_test, ssorPreconditionedConjugateGradientConverges)
+{
+    constexpr unsigned int maxIterations = 1000;
+    constexpr double tolerance = 1e-12;
+
+    std::stringstream linearSolver;
+    linearSolver << "<ShewchukPCGLinearSolver name='pcg' iterations='" << maxIterations << "' tolerance='" << tolerance << "' preconditioner='@preconditioner'/>"
+                    "<ParallelSSORPreconditioner name='preconditioner' template='CompressedRowSparseMatrixMat3x3d'/>";
+    createScene({ linearSolver.str() });
+
+    sofa::simulation::node::animate(root.get(), root->getDt());
+
+    const auto* pcg = root->getChild("beam0")->getObject("pcg");
+    ASSERT_NE(pcg, nullptr);
+    const auto* graphData = dynamic_cast<const Data<std::map<std::string, sofa::type::vector<double> > >*>(pcg->findData("graph"));
+    ASSERT_NE(graphData, nullptr);
+
+    // the residuals of the first solve of the time step
+    const auto& graph = graphData->getValue();
+    const auto residuals = graph.find("Error 1");
+    ASSERT_NE(residuals, graph.end());
+    ASSERT_FALSE(residuals->second.empty());
+
+    EXPECT_LE(residuals->second.back(), tolerance);
+    EXPECT_LT(residuals->second.size(), maxIterations);
+
+    EXPECT_LT(getPositions(0).back()[1], -1e-3);
+}
+
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <MultiThreading/component/solidmechanics/spring/ParallelSpringForceField.h>
+#include <sofa/component/solidmechanics/spring/SpringForceField.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/testing/BaseSimulationTest.h>
+
+#include <cmath>
+
+namespace sofa
+{
+
+using DataTypes = sofa::defaulttype::Vec3Types;
+using VecCoord = DataTypes::VecCoord;
+using VecDeriv = DataTypes::VecDeriv;
+using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<DataTypes>;
+using SpringForceField3 = sofa::component::solidmechanics::spring::SpringForceField<DataTypes>;
+using ParallelSpringForceField3 = multithreading::component::solidmechanics::spring::ParallelSpringForceField<DataTypes>;
+
+struct ParallelSpringForceField_test : public sofa::testing::BaseSimulationTest
+{
+    simulation::Node::SPtr root;
+    MechanicalObject3::SPtr dofs;
+    SpringForceField3::SPtr sequential;
+    ParallelSpringForceField3::SPtr parallel;
+
+    VecCoord x;
+    VecDeriv v;
+    VecDeriv dx;
+
+    void onSetUp() override
+    {
+        root = simulation::getSimulation()->createNewGraph("root");
+
+        // a deformed and moving grid of particles
+        constexpr unsigned int n = 8;
+        for (unsigned int k = 0; k < n; ++k)
+        {
+            for (unsigned int j = 0; j < n; ++j)
+            {
+                for (unsigned int i = 0; i < n; ++i)
+                {
+                    x.emplace_back(i + 0.1 * std::sin(j + k), j + 0.1 * std::cos(i * k), k + 0.05 * i);
+                    v.emplace_back(0.1 * std::cos(i + j), 0.2 * std::sin(k), -0.1 * j);
+                    dx.emplace_back(0.01 * i, -0.02 * j, 0.01 * std::sin(i + j + k));
+                }
+            }
+        }
+
+        dofs = core::objectmodel::New<MechanicalObject3>();
+        dofs->resize(x.size());
+        root->addObject(dofs);
+
+        sequential = core::objectmodel::New<SpringForceField3>();
+        parallel = core::objectmodel::New<ParallelSpringForceField3>();
+        root->addObject(sequential);
+        root->addObject(parallel);
+
+        // springs along the three directions of the grid, in a shuffled order, some of them being only in elongation or disabled
+        const auto index = [n](unsigned int i, unsigned int j, unsigned int k) { return i + n * (j + n * k); };
+        for (unsigned int k = n; k-- > 0;)
+        {
+            for (unsigned int j = 0; j < n; ++j)
+            {
+                for (unsigned int i = n; i-- > 0;)
+                {
+                    const sofa::Index p = index(i, j, k);
+                    for (const sofa::Index q : { i + 1 < n ? index(i + 1, j, k) : p, j + 1 < n ? index(i, j + 1, k) : p, k + 1 < n ? index(i, j, k + 1) : p })
+                    {
+                        if (q == p)
+                        {
+                            continue;
+                        }
+                        SpringForceField3::Spring spring((p + q) % 2 ? q : p, (p + q) % 2 ? p : q, 100. + p, 0.5, 1.);
+                        spring.elongationOnly = (p % 5 == 0);
+                        spring.enabled = (p % 7 != 0);
+                        sequential->addSpring(spring);
+                        parallel->addSpring(spring);
+                    }
+                }
+            }
+        }
+
+        sequential->init();
+        parallel->init();
+    }
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    static void expectEqual(const VecDeriv& expected, const VecDeriv& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                EXPECT_NEAR(expected[i][c], actual[i][c], 1e-9) << "particle " << i;
+            }
+        }
+    }
+
+    template<class ForceField>
+    static void computeForces(ForceField& forceField, const VecCoord& x, const VecDeriv& v, const VecDeriv& dx, bool sharedForceVector,
+                              VecDeriv& f, VecDeriv& df)
+    {
+        core::MechanicalParams mparams;
+        mparams.setKFactor(2.0);
+
+        Data<VecCoord> dataX(x);
+        Data<VecDeriv> dataV(v);
+        Data<VecDeriv> dataDx(dx);
+        Data<VecDeriv> dataF1, dataF2, dataDf1, dataDf2;
+
+        forceField.addForce(&mparams, dataF1, sharedForceVector ? dataF1 : dataF2, dataX, dataX, dataV, dataV);
+        forceField.addDForce(&mparams, dataDf1, sharedForceVector ? dataDf1 : dataDf2, dataDx, dataDx);
+
+        // sum the forces on both ends of the springs
+        f = dataF1.getValue();
+        df = dataDf1.getValue();
+        if (!sharedForceVector)
+        {
+            for (std::size_t i = 0; i < f.size(); ++i)
+            {
+                f[i] += dataF2.getValue()[i];
+                df[i] += dataDf2.getValue()[i];
+            }
+        }
+    }
+
+    void checkSameForces(bool sharedForceVector)
+    {
+        VecDeriv expectedForce, expectedDForce, actualForce, actualDForce;
+        computeForces(*sequential, x, v, dx, sharedForceVector, expectedForce, expectedDForce);
+        computeForces(*parallel, x, v, dx, sharedForceVector, actualForce, actualDForce);
+
+        expectEqual(expectedForce, actualForce);
+        expectEqual(expectedDForce, actualDForce);
+    }
+};
+
+TEST_F(ParallelSpringForceField_test, sameForcesAsSequential_sharedForceVector)
+{
+    checkSameForces(true);
+}
+
+TEST_F(ParallelSpringForceField_test, sameForcesAsSequential_separateForceVectors)
+{
+    checkSameForces(false);
+}
+
+TEST_F(ParallelSpringForceField_test, sameForcesAfterSpringsModification)
+{
+    checkSameForces(true);
+
+    sequential->removeSpring(3);
+    parallel->removeSpring(3);
+    sequential->addSpring(0, static_cast<sofa::Index>(x.size() - 1), 10., 0.1, 2.);
+    parallel->addSpring(0, static_cast<sofa::Index>(x.size() - 1), 10., 0.1, 2.);
+
+    checkSameForces(true);
+}
+
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <MultiThreading/component/solidmechanics/fem/hyperelastic/ParallelTetrahedronHyperelasticityFEMForceField.h>
+#include <sofa/component/solidmechanics/fem/hyperelastic/TetrahedronHyperelasticityFEMForceField.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/core/MechanicalParams.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/simulation/common/SceneLoaderXML.h>
+#include <sofa/testing/BaseSimulationTest.h>
+
+#include <cmath>
+#include <sstream>
+
+namespace sofa
+{
+
+using DataTypes = sofa::defaulttype::Vec3Types;
+using VecCoord = DataTypes::VecCoord;
+using VecDeriv = DataTypes::VecDeriv;
+using MechanicalObject3 = sofa::component::statecontainer::MechanicalObject<DataTypes>;
+using TetrahedronHyperelasticityFEMForceField3 = sofa::component::solidmechanics::fem::hyperelastic::TetrahedronHyperelasticityFEMForceField<DataTypes>;
+using ParallelTetrahedronHyperelasticityFEMForceField3 = multithreading::component::solidmechanics::fem::hyperelastic::ParallelTetrahedronHyperelasticityFEMForceField<DataTypes>;
+
+struct ParallelTetrahedronHyperelasticityFEMForceField_test : public sofa::testing::BaseSimulationTest
+{
+    simulation::Node::SPtr root;
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    /// Two identical tetrahedral beams, one with the sequential force field, the other one with the parallel force field
+    void createScene(const std::string& materialName, const std::string& parameterSet)
+    {
+        std::stringstream scene;
+        scene << "<?xml version='1.0'?>"
+                 "<Node name='root' gravity='0 0 0'>"
+                 "  <RequiredPlugin name='MultiThreading'/>"
+                 "  <RequiredPlugin name='Sofa.Component.SolidMechanics.FEM.HyperElastic'/>"
+                 "  <RequiredPlugin name='Sofa.Component.StateContainer'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Topology.Container.Dynamic'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Topology.Container.Grid'/>"
+                 "  <RequiredPlugin name='Sofa.Component.Topology.Mapping'/>";
+        for (const std::string& component : { "TetrahedronHyperelasticityFEMForceField", "ParallelTetrahedronHyperelasticityFEMForceField" })
+        {
+            scene << "  <Node name='" << component << "'>"
+                     "    <RegularGridTopology name='grid' min='0 0 0' max='1 1 3' n='4 4 7'/>"
+                     "    <MechanicalObject name='dofs' template='Vec3d'/>"
+                     "    <TetrahedronSetTopologyContainer name='topology'/>"
+                     "    <TetrahedronSetTopologyModifier/>"
+                     "    <TetrahedronSetGeometryAlgorithms template='Vec3d'/>"
+                     "    <Hexa2TetraTopologicalMapping input='@grid' output='@topology'/>"
+                     "    <" << component << " name='FEM' materialName='" << materialName << "' ParameterSet='" << parameterSet << "'/>"
+                     "  </Node>";
+        }
+        scene << "</Node>";
+
+        root = simulation::SceneLoaderXML::loadFromMemory("testscene", scene.str().c_str());
+        ASSERT_NE(root, nullptr);
+        sofa::simulation::node::initRoot(root.get());
+    }
+
+    TetrahedronHyperelasticityFEMForceField3* getForceField(const std::string& nodeName) const
+    {
+        const auto node = root->getChild(nodeName);
+        return node ? dynamic_cast<TetrahedronHyperelasticityFEMForceField3*>(node->getObject("FEM")) : nullptr;
+    }
+
+    static void expectEqual(const VecDeriv& expected, const VecDeriv& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                EXPECT_NEAR(expected[i][c], actual[i][c], 1e-9 * (1 + std::abs(expected[i][c]))) << "vertex " << i;
+            }
+        }
+    }
+
+    static void computeForces(TetrahedronHyperelasticityFEMForceField3& forceField, const VecCoord& x, const VecDeriv& dx,
+                              VecDeriv& f, VecDeriv& df)
+    {
+        core::MechanicalParams mparams;
+        mparams.setKFactor(1.5);
+
+        Data<VecCoord> dataX(x);
+        Data<VecDeriv> dataV(VecDeriv(x.size()));
+        Data<VecDeriv> dataDx(dx);
+        Data<VecDeriv> dataF(VecDeriv(x.size()));
+        Data<VecDeriv> dataDf(VecDeriv(x.size()));
+
+        forceField.addForce(&mparams, dataF, dataX, dataV);
+        forceField.addDForce(&mparams, dataDf, dataDx);
+
+        f = dataF.getValue();
+        df = dataDf.getValue();
+    }
+
+    void checkSameForces(const std::string& materialName, const std::string& parameterSet)
+    {
+        createScene(materialName, parameterSet);
+
+        auto* sequential = getForceField("TetrahedronHyperelasticityFEMForceField");
+        auto* parallel = getForceField("ParallelTetrahedronHyperelasticityFEMForceField");
+        ASSERT_NE(sequential, nullptr);
+        ASSERT_NE(parallel, nullptr);
+        ASSERT_NE(dynamic_cast<ParallelTetrahedronHyperelasticityFEMForceField3*>(parallel), nullptr);
+
+        const auto* dofs = dynamic_cast<MechanicalObject3*>(root->getChild("TetrahedronHyperelasticityFEMForceField")->getObject("dofs"));
+        ASSERT_NE(dofs, nullptr);
+
+        // a twisted and stretched configuration of the beam
+        VecCoord x = dofs->read(core::ConstVecCoordId::restPosition())->getValue();
+        VecDeriv dx(x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const SReal angle = 0.1 * x[i][2];
+            const SReal px = x[i][0] - 0.5, py = x[i][1] - 0.5;
+            x[i] = { 0.5 + std::cos(angle) * px - std::sin(angle) * py,
+                     0.5 + std::sin(angle) * px + std::cos(angle) * py,
+                     1.1 * x[i][2] + 0.01 * std::sin(static_cast<SReal>(i)) };
+            dx[i] = { 0.01 * std::cos(static_cast<SReal>(i)), -0.02 * x[i][2], 0.01 * std::sin(3. * i) };
+        }
+
+        VecDeriv expectedForce, expectedDForce, actualForce, actualDForce;
+        computeForces(*sequential, x, dx, expectedForce, expectedDForce);
+        computeForces(*parallel, x, dx, actualForce, actualDForce);
+
+        expectEqual(expectedForce, actualForce);
+        expectEqual(expectedDForce, actualDForce);
+    }
+};
+
+TEST_F(ParallelTetrahedronHyperelasticityFEMForceField_test, sameForcesAsSequential_NeoHookean)
+{
+    checkSameForces("NeoHookean", "344.8 3103.4");
+}
+
+TEST_F(ParallelTetrahedronHyperelasticityFEMForceField_test, sameForcesAsSequential_StVenantKirchhoff)
+{
+    checkSameForces("StVenantKirchhoff", "344.8 3103.4");
+}
+
+TEST_F(ParallelTetrahedronHyperelasticityFEMForceField_test, sameForcesAsSequential_MooneyRivlin)
+{
+    checkSameForces("MooneyRivlin", "151065.460 101709.668 1e07");
+}
+
+}
@@ -21,6 +21,7 @@
 ******************************************************************************/
 #include <sofa/helper/system/FileRepository.h>
 #include <SofaCarving/CarvingManager.h>
+#include <sofa/gui/component/performer/TopologicalChangeManager.h>
 #include <sofa/simpleapi/SimpleApi.h>
 #include <sofa/core/topology/BaseMeshTopology.h>
 #include <sofa/testing/BaseSimulationTest.h>
@@ -59,6 +60,8 @@ public:
     void doCarving();
     /// Test carving process with penetration parameters. Will check topology after carving.
     void doCarvingWithPenetration();
+    /// Test the removal of elements collected from several collision models sharing the same topology.
+    void doBatchedRemoval();
 
     /// Unload the scene
     void TearDown() override
@@ -473,6 +476,83 @@ void SofaCarving_test::doCarvingWithPenetration()
 }
 
 
+void SofaCarving_test::doBatchedRemoval()
+{
+    bool res = createScene("0.0");
+    EXPECT_TRUE(res);
+
+    EXPECT_MSG_NOEMIT(Error);
+    EXPECT_MSG_NOEMIT(Warning);
+    sofa::simulation::node::initRoot(m_root.get());
+
+    sofa::simulation::Node* cylinder = m_root->getChild("cylinder");
+    ASSERT_NE(cylinder, nullptr);
+    sofa::core::topology::BaseMeshTopology* topo = cylinder->getMeshTopology();
+    ASSERT_NE(topo, nullptr);
+
+    sofa::simulation::Node* surface = cylinder->getChild("Surface");
+    ASSERT_NE(surface, nullptr);
+    auto* triangleModel = dynamic_cast<sofa::core::CollisionModel*>(surface->getObject("Triangle Model"));
+    auto* pointModel = dynamic_cast<sofa::core::CollisionModel*>(surface->getObject("Point Model"));
+    ASSERT_NE(triangleModel, nullptr);
+    ASSERT_NE(pointModel, nullptr);
+
+    // the elements of both models are converted to the tetrahedra of the volume, and merged
+    sofa::gui::component::performer::TopologicalChangeManager manager;
+    sofa::gui::component::performer::TopologicalChangeManager::RemovalBatch batch;
+    EXPECT_GT(manager.collectItemsFromCollisionModel(triangleModel, { 0, 1, 2, 3 }, batch), 0u);
+    const auto& firstTriangle = surface->getMeshTopology()->getTriangle(0);
+    EXPECT_GT(manager.collectItemsFromCollisionModel(pointModel, { firstTriangle[0], firstTriangle[1] }, batch), 0u);
+    EXPECT_GT(manager.collectItemsFromCollisionModel(triangleModel, { 0, 1 }, batch), 0u);
+    ASSERT_EQ(batch.size(), 1u);
+
+    const auto nbTetrahedraToRemove = batch.begin()->second.size();
+    const auto nbTetrahedra = topo->getNbTetrahedra();
+
+    // the topology is not modified before the batch is applied
+    EXPECT_EQ(nbTetrahedra, 2430);
+
+    EXPECT_EQ(manager.removeCollectedItems(batch), nbTetrahedraToRemove);
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(topo->getNbTetrahedra(), nbTetrahedra - nbTetrahedraToRemove);
+}
+
+
+TEST(TopologicalChangeManager, removalBatchKeepsCollectionOrder)
+{
+    using sofa::core::topology::TopologyModifier;
+
+    std::vector<TopologyModifier::SPtr> modifiers;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        modifiers.push_back(sofa::core::objectmodel::New<TopologyModifier>());
+    }
+
+    // collect in the reverse order of the addresses, so that the order of the batch differs from the pointer order
+    std::sort(modifiers.begin(), modifiers.end(), [](const auto& a, const auto& b) { return a.get() > b.get(); });
+
+    sofa::gui::component::performer::TopologicalChangeManager::RemovalBatch batch;
+    for (unsigned int i = 0; i < modifiers.size(); ++i)
+    {
+        batch[modifiers[i].get()].insert(i);
+    }
+    // collecting again for a modifier does not change its position
+    batch[modifiers[1].get()].insert(10);
+    batch[modifiers[0].get()].insert(11);
+
+    ASSERT_EQ(batch.size(), modifiers.size());
+    unsigned int i = 0;
+    for (const auto& [modifier, items] : batch)
+    {
+        EXPECT_EQ(modifier, modifiers[i].get());
+        EXPECT_EQ(items.count(i), 1u);
+        ++i;
+    }
+    EXPECT_EQ(batch[modifiers[1].get()], std::set<sofa::Index>({ 1, 10 }));
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+}
 
 TEST_F(SofaCarving_test, testManagerEmpty)
 {
@@ -510,4 +590,7 @@ TEST_F(SofaCarving_test, testdoCarvingWithPenetration)
     doCarvingWithPenetration();
 }
 
-
+TEST_F(SofaCarving_test, testBatchedRemoval)
+{
+    doBatchedRemoval();
+}
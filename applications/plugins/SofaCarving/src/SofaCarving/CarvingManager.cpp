@@ -123,6 +123,14 @@ void CarvingManager::doCarve()
 
     SCOPED_TIMER("CarvingElems");
 
+    // The elements to remove are gathered from all the contacts of the step before modifying any topology:
+    // the contact indices refer to the topologies as they were during the collision detection, and several
+    // surface models can share the same topology. The topological changes are then applied and propagated
+    // once per topology.
+    static sofa::gui::component::performer::TopologicalChangeManager manager;
+    sofa::gui::component::performer::TopologicalChangeManager::RemovalBatch batch;
+    std::size_t nbSelectedElems = 0;
+
     // loop on the contact to get the one between the CarvingSurface and the CarvingTool collision model
     const SReal& carvDist = d_carvingDistance.getValue();
     auto toolCollisionModel = l_toolModel.get();
@@ -172,14 +180,25 @@ void CarvingManager::doCarve()
 
         if (!elemsToRemove.empty())
         {
-            static sofa::gui::component::performer::TopologicalChangeManager manager;
-            int nbElems = manager.removeItemsFromCollisionModel(targetModel, elemsToRemove);
-            if (nbElems == 0)
-            {
-                msg_warning() << "Carving failed, " << elemsToRemove.size() << " elements were selected for carving, but none were removed.";
-            }
+            SCOPED_TIMER("CarvingCollectElems");
+            nbSelectedElems += elemsToRemove.size();
+            manager.collectItemsFromCollisionModel(targetModel, elemsToRemove, batch);
         }
     }
+
+    if (nbSelectedElems == 0)
+        return;
+
+    Index nbElems = 0;
+    {
+        SCOPED_TIMER("CarvingRemoveElems");
+        nbElems = manager.removeCollectedItems(batch);
+    }
+
+    if (nbElems == 0)
+    {
+        msg_warning() << "Carving failed, " << nbSelectedElems << " elements were selected for carving, but none were removed.";
+    }
 }
 
 void CarvingManager::handleEvent(sofa::core::objectmodel::Event* event)
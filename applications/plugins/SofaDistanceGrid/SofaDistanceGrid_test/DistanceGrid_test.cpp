@@ -21,6 +21,11 @@
 ******************************************************************************/
 #include <sofa/testing/NumericTest.h>
 #include <sofa/type/Vec.h>
+#include <sofa/helper/io/Mesh.h>
+#include <sofa/helper/system/FileRepository.h>
+#include <sofa/helper/system/FileSystem.h>
+
+#include <fstream>
 
 #include <SofaDistanceGrid/DistanceGrid.h>
 using sofa::component::container::DistanceGrid ;
@@ -72,6 +77,51 @@ struct DistanceGrid_test : public sofa::testing::NumericTest<SReal>
                           DistanceGrid::Coord(mx,my,mz),
                           DistanceGrid::Coord(ex,ey,ez)) ;
     }
+
+    /// Closed cube of the given half-size, with outward facing quads
+    static void createCubeMesh(helper::io::Mesh& mesh, SReal halfSize)
+    {
+        auto& vertices = mesh.getVertices();
+        for (int i=0; i<8; i++)
+            vertices.emplace_back((i&1) ? halfSize : -halfSize, (i&2) ? halfSize : -halfSize, (i&4) ? halfSize : -halfSize);
+        const int quads[6][4] = { {0,2,3,1}, {4,5,7,6}, {0,1,5,4}, {2,6,7,3}, {0,4,6,2}, {1,3,7,5} };
+        for (const auto& quad : quads)
+        {
+            mesh.getFacets().push_back({ { static_cast<helper::io::Mesh::PointID>(quad[0]), static_cast<helper::io::Mesh::PointID>(quad[1]),
+                                           static_cast<helper::io::Mesh::PointID>(quad[2]), static_cast<helper::io::Mesh::PointID>(quad[3]) }, {}, {} });
+        }
+    }
+
+    static SReal cubeDistance(const Vec3& p, SReal halfSize)
+    {
+        Vec3 q;
+        SReal inside = -halfSize;
+        for (int c=0; c<3; c++)
+        {
+            q[c] = std::max(std::abs(p[c]) - halfSize, SReal(0));
+            inside = std::max(inside, std::abs(p[c]) - halfSize);
+        }
+        return q.norm() + std::min(inside, SReal(0));
+    }
+
+    void checkSweepingCube(const DistanceGrid::ParallelForRange& parallelFor)
+    {
+        EXPECT_MSG_NOEMIT(Warning, Error) ;
+
+        helper::io::Mesh mesh;
+        createCubeMesh(mesh, 0.5);
+
+        DistanceGrid grid(25, 25, 25, DistanceGrid::Coord(-1.2,-1.2,-1.2), DistanceGrid::Coord(1.2,1.2,1.2)) ;
+        grid.calcDistanceSweeping(&mesh, 2.0, parallelFor);
+
+        for (int z=0; z<grid.getNz(); z++)
+            for (int y=0; y<grid.getNy(); y++)
+                for (int x=0; x<grid.getNx(); x++)
+                {
+                    const Vec3 p = grid.coord(x,y,z);
+                    EXPECT_NEAR(grid[grid.index(x,y,z)], cubeDistance(p, 1.0), 1e-10) << "at " << p;
+                }
+    }
 };
 
 TEST_F(DistanceGrid_test, chekcValidConstructorsCube) {
@@ -95,6 +145,79 @@ TEST_F(DistanceGrid_test, chekcInvalidConstructorsCube) {
     }
 }
 
+TEST_F(DistanceGrid_test, sweepingCube) {
+    this->checkSweepingCube({});
+}
+
+TEST_F(DistanceGrid_test, sweepingCubeParallel) {
+    const DistanceGrid::ParallelForRange chunkedLoop = [](std::size_t size, const DistanceGrid::RangeTask& task)
+    {
+        for (std::size_t begin = 0; begin < size; begin += 3)
+            task(begin, std::min(begin + 3, size));
+    };
+    this->checkSweepingCube(chunkedLoop);
+}
+
+TEST_F(DistanceGrid_test, loadSharedCache) {
+    using helper::system::FileSystem;
+    const std::string directory = FileSystem::append(helper::system::FileRepository().getTempPath(), "DistanceGrid_test_cache");
+    FileSystem::removeAll(directory);
+    const std::string filename = FileSystem::append(directory, "cube.obj");
+    FileSystem::createDirectory(directory);
+    {
+        std::ofstream out(filename.c_str());
+        out << "v -1 -1 -1\nv 1 -1 -1\nv -1 1 -1\nv 1 1 -1\nv -1 -1 1\nv 1 -1 1\nv -1 1 1\nv 1 1 1\n"
+            << "f 1 3 4 2\nf 5 6 8 7\nf 1 2 6 5\nf 3 7 8 4\nf 1 5 7 3\nf 2 4 8 6\n";
+    }
+
+    const std::string previousDirectory = DistanceGrid::getCacheDirectory();
+    DistanceGrid::setCacheDirectory(directory);
+
+    // the cache is not used by default
+    DistanceGrid* notCached = DistanceGrid::loadShared(filename, 1.0, 0.0, 16, 16, 16);
+    ASSERT_NE(notCached, nullptr);
+    EXPECT_TRUE(notCached->release());
+    std::vector<std::string> files;
+    FileSystem::listDirectory(directory, files, "dgrid");
+    EXPECT_TRUE(files.empty());
+
+    DistanceGrid* computed = DistanceGrid::loadShared(filename, 1.0, 0.0, 16, 16, 16, {}, {}, false, true);
+    ASSERT_NE(computed, nullptr);
+    FileSystem::listDirectory(directory, files, "dgrid");
+    EXPECT_EQ(files.size(), 1u);
+    std::vector<SReal> dists(computed->size());
+    for (int i=0; i<computed->size(); i++)
+        dists[i] = (*computed)[i];
+    const auto pmin = computed->getPMin(), pmax = computed->getPMax();
+    const auto nbMeshPts = computed->meshPts.size();
+    EXPECT_TRUE(computed->release());
+
+    // the grid is not shared anymore, it is read back from the cache file
+    DistanceGrid* cached = DistanceGrid::loadShared(filename, 1.0, 0.0, 16, 16, 16, {}, {}, false, true);
+    ASSERT_NE(cached, nullptr);
+    ASSERT_EQ(cached->size(), static_cast<int>(dists.size()));
+    for (int i=0; i<cached->size(); i++)
+        EXPECT_EQ((*cached)[i], dists[i]);
+    EXPECT_EQ(cached->getPMin(), pmin);
+    EXPECT_EQ(cached->getPMax(), pmax);
+    EXPECT_EQ(cached->meshPts.size(), nbMeshPts);
+    EXPECT_TRUE(cached->release());
+
+    // other parameters, or another distance computation method, give another cache file
+    DistanceGrid* other = DistanceGrid::loadShared(filename, 1.0, 0.0, 8, 8, 8, {}, {}, false, true);
+    ASSERT_NE(other, nullptr);
+    EXPECT_EQ(other->getNx(), 8);
+    EXPECT_TRUE(other->release());
+    DistanceGrid* sweeping = DistanceGrid::loadShared(filename, 1.0, 0.0, 16, 16, 16, {}, {}, true, true);
+    ASSERT_NE(sweeping, nullptr);
+    EXPECT_TRUE(sweeping->release());
+    files.clear();
+    FileSystem::listDirectory(directory, files, "dgrid");
+    EXPECT_EQ(files.size(), 3u);
+
+    DistanceGrid::setCacheDirectory(previousDirectory);
+    FileSystem::removeAll(directory);
+}
 
 } // __distance_grid__
 } // container
@@ -25,12 +25,18 @@
 #include <sofa/core/visual/VisualParams.h>
 
 #include <sofa/helper/io/Mesh.h>
+#include <sofa/helper/system/FileSystem.h>
+#include <sofa/helper/Utils.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 #if SOFADISTANCEGRID_HAVE_MINIFLOWVR
 #include <flowvr/render/mesh.h>
 #endif
 
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 
 #include <sofa/helper/logging/Messaging.h>
@@ -120,7 +126,8 @@ bool DistanceGrid::release()
 //todo(dmarchal) we should make a loader for that...
 DistanceGrid* DistanceGrid::load(const std::string& filename,
                                  double scale, double sampling,
-                                 int nx, int ny, int nz, Coord pmin, Coord pmax)
+                                 int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                 bool sweeping)
 {
     double absscale=fabs(scale);
     if (filename == "#cube")
@@ -270,7 +277,27 @@ DistanceGrid* DistanceGrid::load(const std::string& filename,
             }
         }
         DistanceGrid* grid = new DistanceGrid(nx, ny, nz, pmin, pmax);
-        grid->calcDistance(mesh, scale);
+        if (sweeping)
+        {
+            auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+            if (taskScheduler->getThreadCount() < 1)
+            {
+                taskScheduler->init(0);
+            }
+            const ParallelForRange parallelFor = [taskScheduler](std::size_t size, const RangeTask& task)
+            {
+                simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+                    [&task](const auto& range)
+                    {
+                        task(range.start, range.end);
+                    });
+            };
+            grid->calcDistanceSweeping(mesh, scale, parallelFor);
+        }
+        else
+        {
+            grid->calcDistance(mesh, scale);
+        }
         if (sampling)
             grid->sampleSurface(sampling);
         else
@@ -1141,6 +1168,241 @@ void DistanceGrid::fmm_push(int index)
     }
 }
 
+/// Closest point of the triangle (a,b,c) to p.
+/// feature is set to 0 if this point is inside the triangle, 1+i if it is its vertex i,
+/// and 4+i if it is on its edge i (the edges being (a,b), (b,c) and (c,a)).
+static Coord closestPointOnTriangle(const Coord& p, const Coord& a, const Coord& b, const Coord& c, int& feature)
+{
+    const Coord ab = b-a, ac = c-a, ap = p-a;
+    const SReal d1 = ab*ap, d2 = ac*ap;
+    if (d1 <= 0 && d2 <= 0) { feature = 1; return a; }
+
+    const Coord bp = p-b;
+    const SReal d3 = ab*bp, d4 = ac*bp;
+    if (d3 >= 0 && d4 <= d3) { feature = 2; return b; }
+
+    const SReal vc = d1*d4 - d3*d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) { feature = 4; return a + ab*(d1/(d1-d3)); }
+
+    const Coord cp = p-c;
+    const SReal d5 = ab*cp, d6 = ac*cp;
+    if (d6 >= 0 && d5 <= d6) { feature = 3; return c; }
+
+    const SReal vb = d5*d2 - d1*d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) { feature = 6; return a + ac*(d2/(d2-d6)); }
+
+    const SReal va = d3*d6 - d5*d4;
+    if (va <= 0 && (d4-d3) >= 0 && (d5-d6) >= 0) { feature = 5; return b + (c-b)*((d4-d3)/((d4-d3)+(d5-d6))); }
+
+    const SReal sum = va+vb+vc;
+    if (sum == 0) { feature = 1; return a; } // degenerated triangle
+    feature = 0;
+    return a + ab*(vb/sum) + ac*(vc/sum);
+}
+
+/// Compute distance field from given mesh, using exact distances around the surface and sweeping elsewhere
+void DistanceGrid::calcDistanceSweeping(sofa::helper::io::Mesh* mesh, double scale, const ParallelForRange& parallelFor)
+{
+    const auto forEach = [&parallelFor](int size, const RangeTask& task)
+    {
+        if (parallelFor)
+            parallelFor(static_cast<std::size_t>(size), task);
+        else
+            task(0, static_cast<std::size_t>(size));
+    };
+
+    const auto& vertices = mesh->getVertices();
+    const auto& facets = mesh->getFacets();
+
+    // Triangulate the facets
+    VecCoord points(vertices.size());
+    for (std::size_t i=0; i<vertices.size(); i++)
+        points[i] = vertices[i]*scale;
+    type::vector<type::Vec3i> triangles;
+    for (const auto& facet : facets)
+    {
+        const auto& pts = facet[0];
+        for (std::size_t pt2=2; pt2<pts.size(); pt2++)
+            triangles.emplace_back(pts[0], pts[pt2-1], pts[pt2]);
+    }
+    const int nbTriangles = static_cast<int>(triangles.size());
+
+    // Angle-weighted pseudo-normals of the faces, edges and vertices, used to compute the sign
+    VecCoord faceNormals(nbTriangles);
+    VecCoord edgeNormals(3*nbTriangles);
+    VecCoord vertexNormals(points.size());
+    std::vector<std::pair<std::uint64_t, int> > edges(3*nbTriangles);
+    for (int t=0; t<nbTriangles; t++)
+    {
+        const type::Vec3i& tri = triangles[t];
+        Coord normal = (points[tri[1]]-points[tri[0]]).cross(points[tri[2]]-points[tri[0]]);
+        const SReal norm = normal.norm();
+        if (norm > 0)
+            normal /= norm;
+        faceNormals[t] = normal;
+        for (int k=0; k<3; k++)
+        {
+            const int v0 = tri[k], v1 = tri[(k+1)%3], v2 = tri[(k+2)%3];
+            Coord e1 = points[v1]-points[v0], e2 = points[v2]-points[v0];
+            const SReal n1 = e1.norm(), n2 = e2.norm();
+            if (n1 > 0 && n2 > 0)
+                vertexNormals[v0] += normal * acos(std::clamp((e1*e2)/(n1*n2), SReal(-1), SReal(1)));
+            const std::uint64_t key = (static_cast<std::uint64_t>(std::min(v0, v1)) << 32) | static_cast<std::uint32_t>(std::max(v0, v1));
+            edges[3*t+k] = { key, 3*t+k };
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (std::size_t b=0, e=0; b<edges.size(); b=e)
+    {
+        Coord normal;
+        for (e=b; e<edges.size() && edges[e].first == edges[b].first; ++e)
+            normal += faceNormals[edges[e].second/3];
+        for (std::size_t i=b; i<e; ++i)
+            edgeNormals[edges[i].second] = normal;
+    }
+
+    const auto squaredDistance = [&](const Coord& pos, int t)
+    {
+        const type::Vec3i& tri = triangles[t];
+        int feature;
+        return (pos - closestPointOnTriangle(pos, points[tri[0]], points[tri[1]], points[tri[2]], feature)).norm2();
+    };
+
+    // Exact distances around the surface: the triangles are bucketed by slice, so that each
+    // slice is only written by the task processing it
+    dmsg_info("DistanceGrid")<< "Sweeping: Initialize distances around the triangles.";
+    type::vector<int> closest(m_nxnynz, -1);
+    std::fill(m_dists.begin(), m_dists.end(), maxDist()); // squared distances until the sign is computed
+
+    type::vector<type::Vec<6,int> > triangleRanges(nbTriangles);
+    type::vector<int> sliceBegin(m_nz+1, 0);
+    for (int t=0; t<nbTriangles; t++)
+    {
+        const type::Vec3i& tri = triangles[t];
+        Coord bbmin = points[tri[0]], bbmax = bbmin;
+        for (int k=1; k<3; k++)
+            for (int c=0; c<3; c++)
+            {
+                bbmin[c] = std::min(bbmin[c], points[tri[k]][c]);
+                bbmax[c] = std::max(bbmax[c], points[tri[k]][c]);
+            }
+        type::Vec<6,int>& r = triangleRanges[t];
+        r[0] = std::max(ix(bbmin)-1, 0); r[3] = std::min(ix(bbmax)+2, m_nx-1);
+        r[1] = std::max(iy(bbmin)-1, 0); r[4] = std::min(iy(bbmax)+2, m_ny-1);
+        r[2] = std::max(iz(bbmin)-1, 0); r[5] = std::min(iz(bbmax)+2, m_nz-1);
+        for (int z=r[2]; z<=r[5]; z++)
+            ++sliceBegin[z+1];
+    }
+    for (int z=0; z<m_nz; z++)
+        sliceBegin[z+1] += sliceBegin[z];
+    type::vector<int> sliceTriangles(sliceBegin[m_nz]);
+    {
+        type::vector<int> sliceEnd(sliceBegin.begin(), sliceBegin.end()-1);
+        for (int t=0; t<nbTriangles; t++)
+            for (int z=triangleRanges[t][2]; z<=triangleRanges[t][5]; z++)
+                sliceTriangles[sliceEnd[z]++] = t;
+    }
+
+    forEach(m_nz, [&](std::size_t zBegin, std::size_t zEnd)
+    {
+        for (int z=static_cast<int>(zBegin); z<static_cast<int>(zEnd); z++)
+            for (int i=sliceBegin[z]; i<sliceBegin[z+1]; i++)
+            {
+                const int t = sliceTriangles[i];
+                const type::Vec<6,int>& r = triangleRanges[t];
+                for (int y=r[1]; y<=r[4]; y++)
+                    for (int x=r[0]; x<=r[3]; x++)
+                    {
+                        const int ind = index(x,y,z);
+                        const SReal d2 = squaredDistance(coord(x,y,z), t);
+                        if (d2 < m_dists[ind])
+                        {
+                            m_dists[ind] = d2;
+                            closest[ind] = t;
+                        }
+                    }
+            }
+    });
+
+    // Propagate the closest triangles by sweeping the grid lines of each axis in both directions.
+    // Each sweep only compares a cell with the triangle of its predecessor, and the lines are
+    // independent so they are processed in parallel. Far from the surface, the region of a triangle
+    // may be thinner than a cell and never reached, giving an error of about one cell.
+    dmsg_info("DistanceGrid")<< "Sweeping: Propagate closest triangles.";
+    const auto sweepLine = [&](int first, int n, int stride)
+    {
+        for (int dir = 1; dir >= -1; dir -= 2)
+        {
+            int prev = (dir > 0) ? first : first + (n-1)*stride;
+            for (int i=1; i<n; i++)
+            {
+                const int ind = prev + dir*stride;
+                const int t = closest[prev];
+                if (t >= 0 && t != closest[ind])
+                {
+                    const int x = ind%m_nx, y = (ind/m_nx)%m_ny, z = ind/m_nxny;
+                    const SReal d2 = squaredDistance(coord(x,y,z), t);
+                    if (d2 < m_dists[ind])
+                    {
+                        m_dists[ind] = d2;
+                        closest[ind] = t;
+                    }
+                }
+                prev = ind;
+            }
+        }
+    };
+    for (int iteration=0; iteration<2; iteration++)
+    {
+        forEach(m_nz, [&](std::size_t zBegin, std::size_t zEnd)
+        {
+            for (int z=static_cast<int>(zBegin); z<static_cast<int>(zEnd); z++)
+            {
+                for (int y=0; y<m_ny; y++)
+                    sweepLine(index(0,y,z), m_nx, 1);
+                for (int x=0; x<m_nx; x++)
+                    sweepLine(index(x,0,z), m_ny, m_nx);
+            }
+        });
+        forEach(m_ny, [&](std::size_t yBegin, std::size_t yEnd)
+        {
+            for (int y=static_cast<int>(yBegin); y<static_cast<int>(yEnd); y++)
+                for (int x=0; x<m_nx; x++)
+                    sweepLine(index(x,y,0), m_nz, m_nxny);
+        });
+    }
+
+
+    // Finalize distances, using the pseudo-normal of the closest feature to know if a cell is inside
+    forEach(m_nz, [&](std::size_t zBegin, std::size_t zEnd)
+    {
+        for (int z=static_cast<int>(zBegin); z<static_cast<int>(zEnd); z++)
+            for (int y=0; y<m_ny; y++)
+                for (int x=0; x<m_nx; x++)
+                {
+                    const int ind = index(x,y,z);
+                    const int t = closest[ind];
+                    if (t < 0)
+                        continue;
+                    const type::Vec3i& tri = triangles[t];
+                    const Coord pos = coord(x,y,z);
+                    int feature;
+                    const Coord p = closestPointOnTriangle(pos, points[tri[0]], points[tri[1]], points[tri[2]], feature);
+                    const Coord& normal = (feature == 0) ? faceNormals[t]
+                                        : (feature <= 3) ? vertexNormals[tri[feature-1]]
+                                        : edgeNormals[3*t+feature-4];
+                    const SReal dist = (pos-p).norm();
+                    m_dists[ind] = ((pos-p)*normal < 0) ? -dist : dist;
+                }
+    });
+
+    int nbin = 0;
+    for (int ind=0; ind<m_nxnynz; ind++)
+        if (m_dists[ind] < 0)
+            ++nbin;
+    msg_info("DistanceGrid")<< "Sweeping: DONE. "<< nbin << " points inside ( " << (m_nxnynz ? (nbin*100)/size() : 0) <<" % )";
+}
+
 /// Sample the surface with points approximately separated by the given sampling distance (expressed in voxels if the value is negative)
 void DistanceGrid::sampleSurface(double sampling)
 {
@@ -1235,8 +1497,164 @@ void DistanceGrid::sampleSurface(double sampling)
 }
 
 
+namespace
+{
+
+/// FNV-1a hash, used to key the cached grids
+std::uint64_t hashBytes(const char* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull)
+{
+    for (std::size_t i=0; i<size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hashFile(const std::string& filename, std::uint64_t& hash)
+{
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+    hash = hashBytes(nullptr, 0);
+    std::vector<char> buffer(1 << 16);
+    while (in)
+    {
+        in.read(buffer.data(), buffer.size());
+        hash = hashBytes(buffer.data(), static_cast<std::size_t>(in.gcount()), hash);
+    }
+    return true;
+}
+
+/// Header of the cache files, followed by the distances and the mesh points
+struct CacheHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t realSize;
+    std::uint64_t meshHash;
+    double scale, sampling;
+    std::int32_t nx, ny, nz, sweeping;
+    double requestedPMin[3], requestedPMax[3];
+    double pmin[3], pmax[3], bbmin[3], bbmax[3];
+    std::uint64_t nbMeshPts;
+};
+
+constexpr char CacheMagic[8] = { 'S','O','F','A','D','G','R','D' };
+constexpr std::uint32_t CacheVersion = 2;
+
+void fillCacheHeader(CacheHeader& header, const std::uint64_t meshHash, const double scale, const double sampling,
+                     const int nx, const int ny, const int nz, const Coord& pmin, const Coord& pmax, const bool sweeping)
+{
+    header = CacheHeader();
+    std::copy(CacheMagic, CacheMagic+8, header.magic);
+    header.version = CacheVersion;
+    header.realSize = sizeof(SReal);
+    header.meshHash = meshHash;
+    header.scale = scale;
+    header.sampling = sampling;
+    header.nx = nx;
+    header.ny = ny;
+    header.nz = nz;
+    header.sweeping = sweeping ? 1 : 0;
+    for (int c=0; c<3; c++)
+    {
+        header.requestedPMin[c] = pmin[c];
+        header.requestedPMax[c] = pmax[c];
+    }
+}
+
+} // namespace
+
+std::string& DistanceGrid::cacheDirectory()
+{
+    static std::string directory = helper::system::FileSystem::append(helper::Utils::getSofaUserLocalDirectory(), "DistanceGridCache");
+    return directory;
+}
+
+void DistanceGrid::setCacheDirectory(const std::string& directory)
+{
+    cacheDirectory() = directory;
+}
+
+const std::string& DistanceGrid::getCacheDirectory()
+{
+    return cacheDirectory();
+}
+
+DistanceGrid* DistanceGrid::loadCache(const std::string& cacheFile, const DistanceGridParams& params, std::uint64_t meshHash)
+{
+    std::ifstream in(cacheFile.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+        return nullptr;
+
+    CacheHeader expected, header;
+    fillCacheHeader(expected, meshHash, params.scale, params.sampling, params.nx, params.ny, params.nz, params.pmin, params.pmax, params.sweeping);
+    in.read(reinterpret_cast<char*>(&header), sizeof(CacheHeader));
+    if (!in
+        || !std::equal(header.magic, header.magic+8, expected.magic)
+        || header.version != expected.version || header.realSize != expected.realSize
+        || header.meshHash != expected.meshHash
+        || header.scale != expected.scale || header.sampling != expected.sampling
+        || header.nx != expected.nx || header.ny != expected.ny || header.nz != expected.nz
+        || header.sweeping != expected.sweeping
+        || !std::equal(header.requestedPMin, header.requestedPMin+3, expected.requestedPMin)
+        || !std::equal(header.requestedPMax, header.requestedPMax+3, expected.requestedPMax))
+    {
+        return nullptr;
+    }
+
+    DistanceGrid* grid = new DistanceGrid(header.nx, header.ny, header.nz,
+                                          Coord(header.pmin[0], header.pmin[1], header.pmin[2]),
+                                          Coord(header.pmax[0], header.pmax[1], header.pmax[2]));
+    grid->m_bbmin = Coord(header.bbmin[0], header.bbmin[1], header.bbmin[2]);
+    grid->m_bbmax = Coord(header.bbmax[0], header.bbmax[1], header.bbmax[2]);
+    grid->meshPts.resize(header.nbMeshPts);
+    in.read(reinterpret_cast<char*>(grid->m_dists.data()), grid->m_dists.size()*sizeof(SReal));
+    in.read(reinterpret_cast<char*>(grid->meshPts.data()), grid->meshPts.size()*sizeof(Coord));
+    if (!in)
+    {
+        msg_warning("DistanceGrid") << "Ignoring truncated cache file " << cacheFile;
+        delete grid;
+        return nullptr;
+    }
+    return grid;
+}
+
+bool DistanceGrid::saveCache(const std::string& cacheFile, const DistanceGridParams& params, std::uint64_t meshHash) const
+{
+    CacheHeader header;
+    fillCacheHeader(header, meshHash, params.scale, params.sampling, params.nx, params.ny, params.nz, params.pmin, params.pmax, params.sweeping);
+    for (int c=0; c<3; c++)
+    {
+        header.pmin[c] = m_pmin[c];
+        header.pmax[c] = m_pmax[c];
+        header.bbmin[c] = m_bbmin[c];
+        header.bbmax[c] = m_bbmax[c];
+    }
+    header.nbMeshPts = meshPts.size();
+
+    // write to a temporary file first, so that a concurrent run never reads a partial grid
+    const std::string tmpFile = cacheFile + ".tmp";
+    {
+        std::ofstream out(tmpFile.c_str(), std::ios::out | std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        out.write(reinterpret_cast<const char*>(m_dists.data()), m_dists.size()*sizeof(SReal));
+        out.write(reinterpret_cast<const char*>(meshPts.data()), meshPts.size()*sizeof(Coord));
+        if (!out)
+        {
+            out.close();
+            std::remove(tmpFile.c_str());
+            return false;
+        }
+    }
+    std::remove(cacheFile.c_str());
+    return std::rename(tmpFile.c_str(), cacheFile.c_str()) == 0;
+}
+
 DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
-                                       double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax)
+                                       double scale, double sampling, int nx, int ny, int nz, Coord pmin, Coord pmax,
+                                       bool sweeping, bool cache)
 {
     DistanceGridParams params;
     params.filename = filename;
@@ -1247,14 +1665,43 @@ DistanceGrid* DistanceGrid::loadShared(const std::string& filename,
     params.nz = nz;
     params.pmin = pmin;
     params.pmax = pmax;
+    params.sweeping = sweeping;
     std::map<DistanceGridParams, DistanceGrid*>& shared = getShared();
     std::map<DistanceGridParams, DistanceGrid*>::iterator it = shared.find(params);
     if (it != shared.end())
         return it->second->addRef();
-    else
+
+    // Only the grids computed from a mesh are worth caching
+    std::uint64_t meshHash = 0;
+    const std::string& directory = getCacheDirectory();
+    if (!cache || directory.empty() || helper::system::FileSystem::getExtension(filename) != "obj" || !hashFile(filename, meshHash))
+    {
+        return shared[params] = load(filename, scale, sampling, nx, ny, nz, pmin, pmax, sweeping);
+    }
+
+    CacheHeader key;
+    fillCacheHeader(key, meshHash, scale, sampling, nx, ny, nz, pmin, pmax, sweeping);
+    std::ostringstream cacheName;
+    cacheName << std::hex << std::setw(16) << std::setfill('0') << hashBytes(reinterpret_cast<const char*>(&key), sizeof(CacheHeader)) << ".dgrid";
+    const std::string cacheFile = helper::system::FileSystem::append(directory, cacheName.str());
+
+    DistanceGrid* grid = loadCache(cacheFile, params, meshHash);
+    if (grid)
+    {
+        msg_info("DistanceGrid") << "Loaded the grid of " << filename << " from cache file " << cacheFile;
+        return shared[params] = grid;
+    }
+
+    grid = load(filename, scale, sampling, nx, ny, nz, pmin, pmax, sweeping);
+    if (grid)
     {
-        return shared[params] = load(filename, scale, sampling, nx, ny, nz, pmin, pmax);
+        if ((!helper::system::FileSystem::isDirectory(directory) && helper::system::FileSystem::createDirectory(directory))
+            || !grid->saveCache(cacheFile, params, meshHash))
+        {
+            msg_warning("DistanceGrid") << "Unable to write cache file " << cacheFile;
+        }
     }
+    return shared[params] = grid;
 }
 
 
@@ -1389,6 +1836,7 @@ bool DistanceGrid::DistanceGridParams::operator==(const DistanceGridParams& v) c
     if (!(pmax[0]  == v.pmax[0] )) return false;
     if (!(pmax[1]  == v.pmax[1] )) return false;
     if (!(pmax[2]  == v.pmax[2] )) return false;
+    if (!(sweeping == v.sweeping)) return false;
     return true;
 }
 
@@ -1418,6 +1866,8 @@ bool DistanceGrid::DistanceGridParams::operator<(const DistanceGridParams& v) co
     if (pmax[1]  > v.pmax[1] ) return true;
     if (pmax[2]  < v.pmax[2] ) return false;
     if (pmax[2]  > v.pmax[2] ) return true;
+    if (sweeping < v.sweeping) return false;
+    if (sweeping > v.sweeping) return true;
     return false;
 }
 
@@ -1447,6 +1897,8 @@ bool DistanceGrid::DistanceGridParams::operator>(const DistanceGridParams& v) co
     if (pmax[1]  < v.pmax[1] ) return true;
     if (pmax[2]  > v.pmax[2] ) return false;
     if (pmax[2]  < v.pmax[2] ) return true;
+    if (sweeping > v.sweeping) return false;
+    if (sweeping < v.sweeping) return true;
     return false;
 }
 
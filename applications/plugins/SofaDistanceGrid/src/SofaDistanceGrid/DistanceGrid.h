@@ -23,6 +23,8 @@
 #define SOFA_SOFADISTANCEGRID_DISTANCEGRID_H
 #include <SofaDistanceGrid/config.h>
 
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <sofa/defaulttype/VecTypes.h>
 #include <sofa/helper/rmath.h>
@@ -60,25 +62,41 @@ public:
     typedef type::vector<SReal> VecSReal;
     typedef type::vector<Coord> VecCoord;
 
+    /// Task processing the items [begin,end) of a loop
+    using RangeTask = std::function<void(std::size_t begin, std::size_t end)>;
+    /// Run a RangeTask over [0,size), possibly splitting it into several ranges executed concurrently
+    using ParallelForRange = std::function<void(std::size_t size, const RangeTask& task)>;
+
     DistanceGrid(int m_nx, int m_ny, int m_nz, Coord m_pmin, Coord m_pmax);
 
     ~DistanceGrid();
 
 public:
-    /// Load a distance grid
+    /// Load a distance grid.
+    /// The distances to a mesh are computed with the fast marching method, or with calcDistanceSweeping if
+    /// sweeping is set.
     static DistanceGrid* load(const std::string& filename,
                               double scale=1.0, double sampling=0.0,
                               int m_nx=64, int m_ny=64, int m_nz=64,
-                              Coord m_pmin = Coord(), Coord m_pmax = Coord());
+                              Coord m_pmin = Coord(), Coord m_pmax = Coord(),
+                              bool sweeping = false);
 
     static DistanceGrid* loadVTKFile(const std::string& filename,
                                      double scale=1.0, double sampling=0.0);
 
-    /// Load or reuse a distance grid
+    /// Load or reuse a distance grid.
+    /// If cache is set, grids computed from a mesh are also stored in the cache directory, and read back
+    /// from it as long as the content of the mesh file and the grid parameters are unchanged.
     static DistanceGrid* loadShared(const std::string& filename,
                                     double scale=1.0, double sampling=0.0,
                                     int m_nx=64, int m_ny=64, int m_nz=64,
-                                    Coord m_pmin = Coord(), Coord m_pmax = Coord());
+                                    Coord m_pmin = Coord(), Coord m_pmax = Coord(),
+                                    bool sweeping = false, bool cache = false);
+
+    /// Directory where the grids computed from meshes are cached, when loadShared is asked to.
+    /// An empty string disables the cache.
+    static void setCacheDirectory(const std::string& directory);
+    static const std::string& getCacheDirectory();
 
     /// Add one reference to this grid. Note that loadShared already does this.
     DistanceGrid* addRef();
@@ -89,9 +107,17 @@ public:
     /// Save current grid
     bool save(const std::string& filename);
 
-    /// Compute distance field from given mesh
+    /// Compute distance field from given mesh, using the fast marching method
     void calcDistance(Mesh* mesh, double scale=1.0);
 
+    /// Compute distance field from given mesh.
+    /// Distances are exact around the surface, and the closest triangle of the other cells is
+    /// propagated by sweeping the grid along each axis (error of about one cell far from the surface).
+    /// The sign is given by the angle-weighted pseudo-normal of the closest feature, so the mesh
+    /// must be closed and consistently oriented.
+    /// The grid slices are processed in parallel if parallelFor is provided.
+    void calcDistanceSweeping(Mesh* mesh, double scale=1.0, const ParallelForRange& parallelFor = {});
+
     /// Compute distance field for a cube of the given half-size.
     /// Also create a mesh of points using np points per axis
     void calcCubeDistance(SReal dim=1, int np=5);
@@ -250,12 +276,18 @@ protected:
         double sampling;
         int nx,ny,nz;
         Coord pmin,pmax;
+        bool sweeping;
         bool operator==(const DistanceGridParams& v) const ;
         bool operator<(const DistanceGridParams& v) const ;
         bool operator>(const DistanceGridParams& v) const ;
     };
 
     static std::map<DistanceGridParams, DistanceGrid*>& getShared();
+
+    /// Persistent cache of the grids computed from meshes
+    static std::string& cacheDirectory();
+    static DistanceGrid* loadCache(const std::string& cacheFile, const DistanceGridParams& params, std::uint64_t meshHash);
+    bool saveCache(const std::string& cacheFile, const DistanceGridParams& params, std::uint64_t meshHash) const;
 };
 
 } // namespace _distancegrid
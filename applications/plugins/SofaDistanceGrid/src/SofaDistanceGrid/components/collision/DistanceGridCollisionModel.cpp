@@ -79,6 +79,8 @@ RigidDistanceGridCollisionModel::RigidDistanceGridCollisionModel()
     , nx( initData( &nx, 64, "nx", "number of values on X axis") )
     , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
     , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
+    , useSweeping( initData( &useSweeping, false, "useSweeping", "compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented") )
+    , useCache( initData( &useCache, false, "useCache", "store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs") )
     , dumpfilename( initData( &dumpfilename, "dumpfilename","write distance grid to specified file"))
     , usePoints( initData( &usePoints, true, "usePoints", "use mesh vertices for collision detection"))
     , flipNormals( initData( &flipNormals, false, "flipNormals", "reverse surface direction, i.e. points are considered in collision if they move outside of the object instead of inside"))
@@ -119,7 +121,7 @@ void RigidDistanceGridCollisionModel::init()
     if (sampling.getValue()!=0.0) msg_info()<<" sampling="<<sampling.getValue();
     if (box.getValue()[0][0]<box.getValue()[1][0]) msg_info()<<" bbox=<"<<box.getValue()[0]<<">-<"<<box.getValue()[0]<<">";
 
-    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1]);
+    grid = DistanceGrid::loadShared(fileRigidDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1], useSweeping.getValue(), useCache.getValue());
     if (grid->getNx() != this->nx.getValue())
         this->nx.setValue(grid->getNx());
     if (grid->getNy() != this->ny.getValue())
@@ -441,6 +443,8 @@ FFDDistanceGridCollisionModel::FFDDistanceGridCollisionModel()
     , nx( initData( &nx, 64, "nx", "number of values on X axis") )
     , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
     , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
+    , useSweeping( initData( &useSweeping, false, "useSweeping", "compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented") )
+    , useCache( initData( &useCache, false, "useCache", "store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs") )
     , dumpfilename( initData( &dumpfilename, "dumpfilename","write distance grid to specified file"))
     , usePoints( initData( &usePoints, true, "usePoints", "use mesh vertices for collision detection"))
     , singleContact( initData( &singleContact, false, "singleContact", "keep only the deepest contact in each cell"))
@@ -482,7 +486,7 @@ void FFDDistanceGridCollisionModel::init()
     if (sampling.getValue()!=0.0) msg_info()<<" sampling="<<sampling.getValue();
     if (box.getValue()[0][0]<box.getValue()[1][0]) msg_info()<<" bbox=<"<<box.getValue()[0]<<">-<"<<box.getValue()[0]<<">";
 
-    grid = DistanceGrid::loadShared(fileFFDDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1]);
+    grid = DistanceGrid::loadShared(fileFFDDistanceGrid.getFullPath(), scale.getValue(), sampling.getValue(), nx.getValue(),ny.getValue(),nz.getValue(),box.getValue()[0],box.getValue()[1], useSweeping.getValue(), useCache.getValue());
     if (!dumpfilename.getValue().empty())
     {
         msg_info() << "Dump grid to "<<dumpfilename.getValue();
@@ -133,6 +133,8 @@ public:
     Data< int > nx; ///< number of values on X axis
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
+    Data< bool > useSweeping; ///< compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented
+    Data< bool > useCache; ///< store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs
     sofa::core::objectmodel::DataFileName dumpfilename;
 
     Data< bool > usePoints; ///< use mesh vertices for collision detection
@@ -435,6 +437,8 @@ protected:
     Data< int > nx; ///< number of values on X axis
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
+    Data< bool > useSweeping; ///< compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented
+    Data< bool > useCache; ///< store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs
     sofa::core::objectmodel::DataFileName dumpfilename;
 
     core::behavior::MechanicalState<defaulttype::Vec3Types>* ffd;
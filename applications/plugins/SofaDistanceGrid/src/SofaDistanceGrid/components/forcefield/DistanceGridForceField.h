@@ -150,6 +150,8 @@ public:
     Data< int > nx; ///< number of values on X axis
     Data< int > ny; ///< number of values on Y axis
     Data< int > nz; ///< number of values on Z axis
+    Data< bool > useSweeping; ///< compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented
+    Data< bool > useCache; ///< store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs
 
     Data<Real> stiffnessIn; ///< force stiffness when inside of the object
     Data<Real> stiffnessOut; ///< force stiffness when outside of the object
@@ -177,6 +179,8 @@ protected:
         , nx( initData( &nx, 64, "nx", "number of values on X axis") )
         , ny( initData( &ny, 64, "ny", "number of values on Y axis") )
         , nz( initData( &nz, 64, "nz", "number of values on Z axis") )
+        , useSweeping( initData( &useSweeping, false, "useSweeping", "compute the distances to the mesh by sweeping (in parallel) instead of the fast marching method. The mesh must be closed and consistently oriented") )
+        , useCache( initData( &useCache, false, "useCache", "store the grid computed from the mesh in the distance grid cache directory, and read it back from there on later runs") )
         , stiffnessIn(initData(&stiffnessIn, (Real)500, "stiffnessIn", "force stiffness when inside of the object"))
         , stiffnessOut(initData(&stiffnessOut, (Real)0, "stiffnessOut", "force stiffness when outside of the object"))
         , damping(initData(&damping, (Real)0.01, "damping", "force damping coefficient"))
@@ -65,7 +65,8 @@ void DistanceGridForceField<DataTypes>::init()
 
     grid = DistanceGrid::loadShared(fileDistanceGrid.getFullPath(), scale.getValue(), 0.0,
                                     nx.getValue(),ny.getValue(),nz.getValue(),
-                                    box.getValue()[0],box.getValue()[1]);
+                                    box.getValue()[0],box.getValue()[1],
+                                    useSweeping.getValue(), useCache.getValue());
 
     if (grid == nullptr)
     {
@@ -26,6 +26,8 @@
 #include <iostream>
 #include <cstring>
 #include <sofa/type/BoundingBox.h>
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
 
 namespace sofa
 {
@@ -58,7 +60,8 @@ Fluid3D::Fluid3D():
     f_height ( initData(&f_height, 5.0f, "height", "initial fluid height") ),
     f_dir ( initData(&f_dir, vec3(0,1,0), "dir", "initial fluid surface normal") ),
     f_tstart ( initData(&f_tstart, 0.0f, "tstart", "starting time for fluid source") ),
-    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") )
+    f_tstop ( initData(&f_tstop, 60.0f, "tstop", "stopping time for fluid source") ),
+    d_parallel ( initData(&d_parallel, false, "parallel", "If true, compute the fluid steps in parallel, slices of the grid being processed by the task scheduler") )
 {
     fluid = new Grid3D;
     fnext = new Grid3D;
@@ -90,6 +93,28 @@ void Fluid3D::init()
     fluid->t = -f_tstart.getValue();
     fluid->tend = f_tstop.getValue() - f_tstart.getValue();
 
+    Grid3D::ParallelForRange parallelFor;
+    if (d_parallel.getValue())
+    {
+        auto* taskScheduler = simulation::MainTaskSchedulerFactory::createInRegistry();
+        assert(taskScheduler != nullptr);
+        if (taskScheduler->getThreadCount() < 1)
+        {
+            taskScheduler->init(0);
+        }
+        parallelFor = [taskScheduler](std::size_t size, const Grid3D::RangeTask& task)
+        {
+            simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+                [&task](const auto& range)
+                {
+                    task(range.start, range.end);
+                });
+        };
+    }
+    fluid->parallelFor = parallelFor;
+    fnext->parallelFor = parallelFor;
+    ftemp->parallelFor = parallelFor;
+
     f_nx.endEdit();
     f_ny.endEdit();
     f_nz.endEdit();
@@ -148,7 +173,7 @@ void Fluid3D::draw(const core::visual::VisualParams* vparams)
             for (int y=0; y<ny; y++)
                 for (int x=0; x<nx; x++)
                 {
-                    vec3 u = fluid->get(x,y,z)->u;
+                    vec3 u = fluid->getu(x,y,z);
                     real r;
                     r = u[0]*s;
                     if (std::abs(r) > 0.001f)
@@ -23,6 +23,8 @@
 #include <SofaEulerianFluid/Grid3D.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <cstring>
+#include <numeric>
+#include <vector>
 
 // set to true/false to activate extra verbose FMM.
 #define EMIT_EXTRA_FMM_MESSAGE false
@@ -59,7 +61,7 @@ const unsigned long* Grid3D::obstacles = NULL;
       }                                         \
 }
 
-#define FOR_READ_INNER_CELLS(cmd)               \
+#define FOR_INNER_CELLS(grid,cmd)               \
 {                                               \
   int ind = index(1,1,1);                       \
   for (int z=1;z<nz-1;z++,ind+=index(0,2,0))    \
@@ -70,15 +72,72 @@ const unsigned long* Grid3D::obstacles = NULL;
       }                                         \
 }
 
-#define FOR_INNER_CELLS(grid,cmd)               \
-{                                               \
-  int ind = index(1,1,1);                       \
-  for (int z=1;z<nz-1;z++,ind+=index(0,2,0))    \
-    for (int y=1;y<ny-1;y++,ind+=index(2,0,0))  \
-      for (int x=1;x<nx-1;x++,ind+=index(1,0,0))\
-      {                                         \
-    cmd;                                    \
-      }                                         \
+// Parallel versions, processing slabs of z slices concurrently.
+// cmd must only write to the cells of the current slice.
+
+#define PARALLEL_FOR_ALL_CELLS(...)                             \
+forEachSlice(0, nz, [&](std::size_t z0, std::size_t z1)         \
+{                                                               \
+  int ind = index(0,0,(int)z0);                                 \
+  for (int z=(int)z0;z<(int)z1;z++)                             \
+    for (int y=0;y<ny;y++)                                      \
+      for (int x=0;x<nx;x++,ind+=index(1,0,0))                  \
+      {                                                         \
+    __VA_ARGS__;                                                \
+      }                                                         \
+})
+
+#define PARALLEL_FOR_INNER_CELLS(...)                           \
+forEachSlice(1, nz-1, [&](std::size_t z0, std::size_t z1)       \
+{                                                               \
+  int ind = index(1,1,(int)z0);                                 \
+  for (int z=(int)z0;z<(int)z1;z++,ind+=index(0,2,0))           \
+    for (int y=1;y<ny-1;y++,ind+=index(2,0,0))                  \
+      for (int x=1;x<nx-1;x++,ind+=index(1,0,0))                \
+      {                                                         \
+    __VA_ARGS__;                                                \
+      }                                                         \
+})
+
+// Same as PARALLEL_FOR_INNER_CELLS, cmd accumulating values into the
+// double variable "sum". Without parallelFor, a single running sum is
+// used, as in the sequential loops. Otherwise the sums are computed per
+// slice and added in order, so that the result does not depend on the
+// number of threads (but differs from the sequential result).
+
+#define PARALLEL_SUM_INNER_CELLS(result,...)                    \
+{                                                               \
+  if (!parallelFor)                                             \
+  {                                                             \
+    double sum = 0.0;                                           \
+    int ind = index(1,1,1);                                     \
+    for (int z=1;z<nz-1;z++,ind+=index(0,2,0))                  \
+      for (int y=1;y<ny-1;y++,ind+=index(2,0,0))                \
+        for (int x=1;x<nx-1;x++,ind+=index(1,0,0))              \
+        {                                                       \
+      __VA_ARGS__;                                              \
+        }                                                       \
+    result = sum;                                               \
+  }                                                             \
+  else                                                          \
+  {                                                             \
+    std::vector<double> sliceSums(nz, 0.0);                     \
+    forEachSlice(1, nz-1, [&](std::size_t z0, std::size_t z1)   \
+    {                                                           \
+      int ind = index(1,1,(int)z0);                             \
+      for (int z=(int)z0;z<(int)z1;z++,ind+=index(0,2,0))       \
+      {                                                         \
+        double sum = 0.0;                                       \
+        for (int y=1;y<ny-1;y++,ind+=index(2,0,0))              \
+          for (int x=1;x<nx-1;x++,ind+=index(1,0,0))            \
+          {                                                     \
+        __VA_ARGS__;                                            \
+          }                                                     \
+        sliceSums[z] = sum;                                     \
+      }                                                         \
+    });                                                         \
+    result = std::accumulate(sliceSums.begin(), sliceSums.end(), 0.0); \
+  }                                                             \
 }
 
 // Surface cells  are inner  cells and borders  between a  fluid inner
@@ -97,7 +156,7 @@ const unsigned long* Grid3D::obstacles = NULL;
 
 Grid3D::Grid3D()
     : nx(0), ny(0), nz(0), nxny(0), ncell(0),
-      fdata(NULL), pressure(NULL), levelset(NULL),
+      type(NULL), pressure(NULL), levelset(NULL),
       t(0), tend(60),
       max_pressure(0.0),
       gravity(0,-5,0),
@@ -105,13 +164,14 @@ Grid3D::Grid3D()
       fmm_heap(NULL),
       fmm_heap_size(0)
 {
-    bcell.u.clear();
-    bcell.type=-1;
+    u[0] = u[1] = u[2] = NULL;
 }
 
 Grid3D::~Grid3D()
 {
-    if (fdata!=NULL) delete[] fdata;
+    for (int c=0; c<3; c++)
+        if (u[c]!=NULL) delete[] u[c];
+    if (type!=NULL) delete[] type;
     if (pressure!=NULL) delete[] pressure;
     if (levelset!=NULL) delete[] levelset;
     if (fmm_status!=NULL) delete[] fmm_status;
@@ -129,9 +189,15 @@ void Grid3D::clear(int _nx, int _ny, int _nz)
 
     if (ncell != old_ncell)
     {
-        if (fdata!=NULL) delete[] fdata;
-        if (ncell>0)  fdata = new Cell[ncell];
-        else          fdata = NULL;
+        for (int c=0; c<3; c++)
+        {
+            if (u[c]!=NULL) delete[] u[c];
+            if (ncell>0)  u[c] = new real[ncell];
+            else          u[c] = NULL;
+        }
+        if (type!=NULL) delete[] type;
+        if (ncell>0)  type = new int[ncell];
+        else          type = NULL;
         if (pressure!=NULL) delete[] pressure;
         if (ncell>0)  pressure = new real[ncell];
         else          pressure = NULL;
@@ -146,7 +212,11 @@ void Grid3D::clear(int _nx, int _ny, int _nz)
         else          fmm_heap = NULL;
     }
     if (ncell>0)
-        memset(fdata,0,ncell*sizeof(Cell));
+    {
+        for (int c=0; c<3; c++)
+            memset(u[c],0,ncell*sizeof(real));
+        memset(type,0,ncell*sizeof(int));
+    }
     if (ncell>0)
         memset(pressure,0,ncell*sizeof(real));
     if (ncell>0)
@@ -156,7 +226,7 @@ void Grid3D::clear(int _nx, int _ny, int _nz)
 void Grid3D::seed(real height)
 {
     //seed(vec3(0,0,0), vec3(nx,height,nz));
-    FOR_ALL_CELLS(fdata,
+    FOR_ALL_CELLS(levelset,
     {
         real d = y - height;
         levelset[ind] = d;
@@ -166,7 +236,7 @@ void Grid3D::seed(real height)
 void Grid3D::seed(real height, vec3 normal)
 {
     normal.normalize();
-    FOR_ALL_CELLS(fdata,
+    FOR_ALL_CELLS(levelset,
     {
         real d = vec3((real)x,(real)y,(real)z)*normal - height;
         levelset[ind] = d;
@@ -187,7 +257,7 @@ void Grid3D::seed(vec3 p0, vec3 p1, vec3 velocity)
     msg_info("Grid3D") << "p0="<<p0<<" p1="<<p1;
     vec3 center = (p0+p1)*0.5f;
     vec3 dim = (p1-p0)*0.5f;
-    FOR_ALL_CELLS(fdata,
+    FOR_ALL_CELLS(levelset,
     {
         vec3 v ((real)x,(real)y,(real)z);
         v -= center;
@@ -198,7 +268,9 @@ void Grid3D::seed(vec3 p0, vec3 p1, vec3 velocity)
         if (v[0] <= 0 && v[1] <= 0 && v[2] <= 0)
         {
             d = rmax(v[0],rmax(v[1],v[2]));
-            fdata[ind].u = velocity;
+            u[0][ind] = velocity[0];
+            u[1][ind] = velocity[1];
+            u[2][ind] = velocity[2];
         }
         else
         {
@@ -211,6 +283,20 @@ void Grid3D::seed(vec3 p0, vec3 p1, vec3 velocity)
     });
 }
 
+void Grid3D::forEachSlice(int z0, int z1, const RangeTask& task) const
+{
+    if (z1 <= z0) return;
+    if (parallelFor)
+    {
+        parallelFor(z1-z0, [z0, &task](std::size_t begin, std::size_t end)
+        {
+            task(z0+begin, z0+end);
+        });
+    }
+    else
+        task(z0, z1);
+}
+
 void Grid3D::step(Grid3D* prev, Grid3D* temp, real dt, real diff)
 {
     t = prev->t+dt;
@@ -241,7 +327,7 @@ void Grid3D::step_init(const Grid3D* prev, Grid3D* /*temp*/, real /*dt*/, real /
     int lnsize = (nx+7)/8;
     int plsize = lnsize*ny;
 
-    FOR_ALL_CELLS(fdata,
+    PARALLEL_FOR_ALL_CELLS(
     {
         //levelset[ind] = 5;
         levelset[ind] = prev->levelset[ind];
@@ -250,14 +336,14 @@ void Grid3D::step_init(const Grid3D* prev, Grid3D* /*temp*/, real /*dt*/, real /
         || (obs!=NULL && ((obs[(z)*plsize+(y)*lnsize+((x)>>3)])&(1<<((x)&7))))
            ) // || z==nz-1)
         {
-            fdata[ind].type = PART_WALL;
+            type[ind] = PART_WALL;
         }
         else
         {
             if (levelset[ind] < LEVELSET_MARGIN)
-                fdata[ind].type = PART_FULL;
+                type[ind] = PART_FULL;
             else
-                fdata[ind].type = PART_EMPTY;
+                type[ind] = PART_EMPTY;
         }
     });
 }
@@ -274,9 +360,9 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
     // Modified Eulerian / Midpoint method
     // Carlson Thesis page 22
 
-    FOR_INNER_CELLS(levelset,
+    PARALLEL_FOR_INNER_CELLS(
     {
-        //if (prev->fdata[ind].type != PART_WALL && rabs(prev->levelset[ind]) < 5)
+        //if (prev->type[ind] != PART_WALL && rabs(prev->levelset[ind]) < 5)
         if (rabs(prev->levelset[ind]) < 5)
         {
             vec3 xn ( (real)x, (real)y, (real)z );
@@ -297,10 +383,10 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
 
     // fill border levelset using neighbors
 
-    FOR_ALL_CELLS(fmm_status,
+    PARALLEL_FOR_ALL_CELLS(
     {
         fmm_status[ind] = FMM_FAR;
-        if (fdata[ind].type == PART_WALL)
+        if (type[ind] == PART_WALL)
         {
             // find a neighbor cell
             real phi = 0;
@@ -313,7 +399,7 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
                                 if ((unsigned)(x+dx)<(unsigned)nx)
                                 {
                                     int ind2 = ind+index(dx,dy,dz);
-                                    if (fdata[ind2].type != PART_WALL)
+                                    if (type[ind2] != PART_WALL)
                                     {
                                         phi += temp->levelset[ind2];
                                         ++n;
@@ -331,7 +417,7 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
     const int dind[3] = { 1, nx, nxny };
 
     // Compute all known points
-    FOR_ALL_CELLS(fdata,
+    PARALLEL_FOR_ALL_CELLS(
     {
         int c[3]; c[0] = x; c[1] = y; c[2] = z;
         bool known = false;
@@ -378,7 +464,7 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
     });
 
     // Update known points neighbors
-    FOR_ALL_CELLS(fdata,
+    FOR_ALL_CELLS(levelset,
     {
         if (fmm_status[ind] == FMM_KNOWN)
         {
@@ -454,7 +540,7 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
         }
     }
 
-    FOR_ALL_CELLS(levelset,
+    PARALLEL_FOR_ALL_CELLS(
     {
         if(temp->levelset[ind] < 0)
         {
@@ -462,13 +548,13 @@ void Grid3D::step_levelset(Grid3D* prev, Grid3D* temp, real dt, real /*diff*/)
         }
         if (levelset[ind] < LEVELSET_MARGIN)
         {
-            if (fdata[ind].type == PART_EMPTY)
-                fdata[ind].type = PART_FULL;
+            if (type[ind] == PART_EMPTY)
+                type[ind] = PART_FULL;
         }
         else
         {
-            if (fdata[ind].type == PART_FULL)
-                fdata[ind].type = PART_EMPTY;
+            if (type[ind] == PART_FULL)
+                type[ind] = PART_EMPTY;
         }
     });
 }
@@ -607,51 +693,53 @@ void Grid3D::step_forces(const Grid3D* prev, Grid3D* /*temp*/, real dt, real /*d
     //vec3 f(0,0,-9.81*dt/scale);
     vec3 f = gravity * dt; //(0,-5*dt,0);
 
-    FOR_INNER_CELLS(fdata,
+    PARALLEL_FOR_INNER_CELLS(
     {
-        vec3 u = f;
-        int p0 = fdata[ind].type;
+        vec3 uf = f;
+        int p0 = type[ind];
         if (p0 < 0)
-            u.clear();
+            uf.clear();
         else
         {
             // not an obstacle
             int p1;
             // X Axis
-            p1 = fdata[ind+index(-1,0,0)].type;
+            p1 = type[ind+index(-1,0,0)];
             if (p1>=0 && p0+p1>0) // this face is now in the fluid
             {
-                //if (prev->fdata[ind].type>0 && prev->fdata[ind+index(-1,0,0)].type>0)
-                u[0] += prev->fdata[ind].u[0]; // was in the fluid in previous step
+                //if (prev->type[ind]>0 && prev->type[ind+index(-1,0,0)]>0)
+                uf[0] += prev->u[0][ind]; // was in the fluid in previous step
                 //else // find the best velocity from particles
-                //  u[0] += find_velocity<0>(x,y,z,ind,ind+index(-1,0,0),prev,temp);
+                //  uf[0] += find_velocity<0>(x,y,z,ind,ind+index(-1,0,0),prev,temp);
             }
             else //if (p1<0)
-                u[0] = 0; // Obstacle
+                uf[0] = 0; // Obstacle
             // Y Axis
-            p1 = fdata[ind+index(0,-1,0)].type;
+            p1 = type[ind+index(0,-1,0)];
             if (p1>=0 && p0+p1>0) // this face is now in the fluid
             {
-                //if (prev->fdata[ind].type>0 && prev->fdata[ind+index(0,-1,0)].type>0)
-                u[1] += prev->fdata[ind].u[1]; // was in the fluid in previous step
+                //if (prev->type[ind]>0 && prev->type[ind+index(0,-1,0)]>0)
+                uf[1] += prev->u[1][ind]; // was in the fluid in previous step
                 //else // find the best velocity from particles
-                //  u[1] += find_velocity<1>(x,y,z,ind,ind+index(0,-1,0),prev,temp);
+                //  uf[1] += find_velocity<1>(x,y,z,ind,ind+index(0,-1,0),prev,temp);
             }
             else //if (p1<0)
-                u[1] = 0; // Obstacle
+                uf[1] = 0; // Obstacle
             // Z Axis
-            p1 = fdata[ind+index(0,0,-1)].type;
+            p1 = type[ind+index(0,0,-1)];
             if (p1>=0 && p0+p1>0) // this face is now in the fluid
             {
-                //if (prev->fdata[ind].type>0 && prev->fdata[ind+index(0,0,-1)].type>0)
-                u[2] += prev->fdata[ind].u[2]; // was in the fluid in previous step
+                //if (prev->type[ind]>0 && prev->type[ind+index(0,0,-1)]>0)
+                uf[2] += prev->u[2][ind]; // was in the fluid in previous step
                 //else // find the best velocity from particles
-                //  u[2] += find_velocity<2>(x,y,z,ind,ind+index(0,0,-1),prev,temp);
+                //  uf[2] += find_velocity<2>(x,y,z,ind,ind+index(0,0,-1),prev,temp);
             }
             else //if (p1<0)
-                u[2] = 0; // Obstacle
+                uf[2] = 0; // Obstacle
         }
-        fdata[ind].u = u;
+        u[0][ind] = uf[0];
+        u[1][ind] = uf[1];
+        u[2][ind] = uf[2];
     });
 
     if (t > 0 && t < tend)
@@ -682,9 +770,11 @@ void Grid3D::step_forces(const Grid3D* prev, Grid3D* /*temp*/, real dt, real /*d
                             int ind = index(x,y,z);
                             if (d < LEVELSET_MARGIN)
                             {
-                                fdata[ind].u = v;
-                                if (fdata[ind].type == PART_EMPTY)
-                                    fdata[ind].type = PART_FULL;
+                                u[0][ind] = v[0];
+                                u[1][ind] = v[1];
+                                u[2][ind] = v[2];
+                                if (type[ind] == PART_EMPTY)
+                                    type[ind] = PART_FULL;
                             }
                             if (d < levelset[ind])
                                 levelset[ind] = d;
@@ -709,26 +799,27 @@ void Grid3D::step_surface(const Grid3D* /*prev*/, Grid3D* /*temp*/, real /*dt*/,
         FACE_Z1=1<<5,
     };
 
-    FOR_SURFACE_CELLS(fdata,
+    // sequential: the faces of the +1 neighbours are also modified
+    FOR_SURFACE_CELLS(u,
     {
-        if (fdata[ind].type>0)
+        if (type[ind]>0)
         {
             // get face air bitmask
             int mask = 0;
-            if (fdata[ind+index(-1,0,0)].type==0) mask|=FACE_X0;
-            if (fdata[ind+index( 1,0,0)].type==0) mask|=FACE_X1;
-            if (fdata[ind+index(0,-1,0)].type==0) mask|=FACE_Y0;
-            if (fdata[ind+index(0, 1,0)].type==0) mask|=FACE_Y1;
-            if (fdata[ind+index(0,0,-1)].type==0) mask|=FACE_Z0;
-            if (fdata[ind+index(0,0, 1)].type==0) mask|=FACE_Z1;
+            if (type[ind+index(-1,0,0)]==0) mask|=FACE_X0;
+            if (type[ind+index( 1,0,0)]==0) mask|=FACE_X1;
+            if (type[ind+index(0,-1,0)]==0) mask|=FACE_Y0;
+            if (type[ind+index(0, 1,0)]==0) mask|=FACE_Y1;
+            if (type[ind+index(0,0,-1)]==0) mask|=FACE_Z0;
+            if (type[ind+index(0,0, 1)]==0) mask|=FACE_Z1;
             if (mask!=0)
             {
-                real& x0 = fdata[ind].u[0];
-                real& y0 = fdata[ind].u[1];
-                real& z0 = fdata[ind].u[2];
-                real& x1 = fdata[ind+index( 1,0,0)].u[0];
-                real& y1 = fdata[ind+index(0, 1,0)].u[1];
-                real& z1 = fdata[ind+index(0,0, 1)].u[2];
+                real& x0 = u[0][ind];
+                real& y0 = u[1][ind];
+                real& z0 = u[2][ind];
+                real& x1 = u[0][ind+index( 1,0,0)];
+                real& y1 = u[1][ind+index(0, 1,0)];
+                real& z1 = u[2][ind+index(0,0, 1)];
                 real r;
                 // Continuity condition: x1-x0+y1-y0+z1-z0 = 0
                 switch (mask)
@@ -831,27 +922,36 @@ void Grid3D::step_advect(const Grid3D* /*prev*/, Grid3D* temp, real dt, real /*d
     // Calculate advection using a semi-lagrangian technique
     // Stam
 
-    // not much optimized for now...
+    // each velocity component is read and written from its own array,
+    // the slices being advected in parallel
+
+    const real* ux = u[0];
+    const real* uy = u[1];
+    const real* uz = u[2];
+    real* tx = temp->u[0];
+    real* ty = temp->u[1];
+    real* tz = temp->u[2];
 
-    memset(temp->fdata,0,temp->ncell*sizeof(Cell));
+    for (int c=0; c<3; c++)
+        memset(temp->u[c],0,temp->ncell*sizeof(real));
 
-    FOR_INNER_CELLS(temp->fdata,
+    PARALLEL_FOR_INNER_CELLS(
     {
         // X Axis
-        vec3 px( x-0.5f - dt*(fdata[ind].u[0]),
-        y      - dt*0.25f*(fdata[ind].u[1]+fdata[ind+index(-1,0,0)].u[1]+fdata[ind+index(0,1,0)].u[1]+fdata[ind+index(-1,1,0)].u[1]),
-        z      - dt*(fdata[ind].u[2]+fdata[ind+index(-1,0,0)].u[2]+fdata[ind+index(0,0,1)].u[2]+fdata[ind+index(-1,0,1)].u[2]));
-        temp->fdata[ind].u[0] = interp<0>(px);
+        vec3 px( x-0.5f - dt*(ux[ind]),
+        y      - dt*0.25f*(uy[ind]+uy[ind+index(-1,0,0)]+uy[ind+index(0,1,0)]+uy[ind+index(-1,1,0)]),
+        z      - dt*(uz[ind]+uz[ind+index(-1,0,0)]+uz[ind+index(0,0,1)]+uz[ind+index(-1,0,1)]));
+        tx[ind] = interp<0>(px);
         // Y Axis
-        vec3 py( x      - dt*0.25f*(fdata[ind].u[0]+fdata[ind+index(0,-1,0)].u[0]+fdata[ind+index(1,0,0)].u[0]+fdata[ind+index(1,-1,0)].u[0]),
-        y-0.5f - dt*(fdata[ind].u[1]),
-        z      - dt*(fdata[ind].u[2]+fdata[ind+index(0,-1,0)].u[2]+fdata[ind+index(0,0,1)].u[2]+fdata[ind+index(0,-1,1)].u[2]));
-        temp->fdata[ind].u[1] = interp<1>(py);
+        vec3 py( x      - dt*0.25f*(ux[ind]+ux[ind+index(0,-1,0)]+ux[ind+index(1,0,0)]+ux[ind+index(1,-1,0)]),
+        y-0.5f - dt*(uy[ind]),
+        z      - dt*(uz[ind]+uz[ind+index(0,-1,0)]+uz[ind+index(0,0,1)]+uz[ind+index(0,-1,1)]));
+        ty[ind] = interp<1>(py);
         // Z Axis
-        vec3 pz( x      - dt*(fdata[ind].u[0]+fdata[ind+index(0,0,-1)].u[0]+fdata[ind+index(1,0,0)].u[0]+fdata[ind+index(1,0,-1)].u[0]),
-        y      - dt*0.25f*(fdata[ind].u[1]+fdata[ind+index(0,0,-1)].u[1]+fdata[ind+index(0,1,0)].u[1]+fdata[ind+index(0,1,-1)].u[1]),
-        z-0.5f - dt*(fdata[ind].u[2]));
-        temp->fdata[ind].u[2] = interp<2>(pz);
+        vec3 pz( x      - dt*(ux[ind]+ux[ind+index(0,0,-1)]+ux[ind+index(1,0,0)]+ux[ind+index(1,0,-1)]),
+        y      - dt*0.25f*(uy[ind]+uy[ind+index(0,0,-1)]+uy[ind+index(0,1,0)]+uy[ind+index(0,1,-1)]),
+        z-0.5f - dt*(uz[ind]));
+        tz[ind] = interp<2>(pz);
     });
     // Result is now is temp
 }
@@ -863,22 +963,28 @@ void Grid3D::step_diffuse(const Grid3D* /*prev*/, Grid3D* temp, real /*dt*/, rea
     // TODO: Check boundary conditions
     if (diff==0.0f)
     {
-        for (int ind=0; ind<ncell; ind++)
-            fdata[ind].u = temp->fdata[ind].u;
+        for (int c=0; c<3; c++)
+            memcpy(u[c],temp->u[c],ncell*sizeof(real));
         return;
     }
 
     real a = diff;
     real inv_c = 1.0f / (1.0001f + 6*a);
 
-    FOR_INNER_CELLS(fdata,
+    // one component at a time, so that the stencil reads contiguous values
+    for (int c=0; c<3; c++)
     {
-        fdata[ind].u = (temp->fdata[ind].u +
-        (temp->fdata[ind+index(-1,0,0)].u+temp->fdata[ind+index(1,0,0)].u+
-        temp->fdata[ind+index(0,-1,0)].u+temp->fdata[ind+index(0,1,0)].u+
-        temp->fdata[ind+index(0,0,-1)].u+temp->fdata[ind+index(0,0,1)].u
-        )*a)*inv_c;
-    });
+        real* uc = u[c];
+        const real* tc = temp->u[c];
+        PARALLEL_FOR_INNER_CELLS(
+        {
+            uc[ind] = (tc[ind] +
+            (tc[ind+index(-1,0,0)]+tc[ind+index(1,0,0)]+
+            tc[ind+index(0,-1,0)]+tc[ind+index(0,1,0)]+
+            tc[ind+index(0,0,-1)]+tc[ind+index(0,0,1)]
+            )*a)*inv_c;
+        });
+    }
 }
 
 
@@ -891,50 +997,54 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     //   where  -dxDp = 6p(i,j,k)-p(i-1,j,k)-p(i,j-1,k)-p(i,j,k-1)-p(i+1,j,k)-p(i,j+1,k)-p(i,j,k+1)
     //     and  -P/dt dxD.u~ = -P/dt dx ( u~(i+1,j,k) - u~(i,j,k) + v~(i,j+1,k) - v~(i,j,k) + w~(i,j,k+1) - w~(i,j,k) )
     // Ap = b where A is a diagonal matrix plus neighbour coefficients at -1
-    memset(temp->fdata,0,temp->ncell*sizeof(Cell));
-    memset(temp->pressure,0,temp->ncell*sizeof(real));
-
-    real* diag = (real*)temp->fdata;
-    real* b = diag+ncell;
-    real* r = b+ncell;
-    real* g = r+ncell;
+    // The arrays of temp are used as scalar fields. temp->levelset is
+    // overwritten here but is recomputed from scratch by step_levelset.
+    real* diag = temp->u[0];
+    real* b = temp->u[1];
+    real* r = temp->u[2];
+    real* g = temp->levelset;
     real* q = temp->pressure;
 
+    memset(diag,0,temp->ncell*sizeof(real));
+    memset(b,0,temp->ncell*sizeof(real));
+    memset(r,0,temp->ncell*sizeof(real));
+    memset(q,0,temp->ncell*sizeof(real));
+
     real a = -1.0f/dt;
 
     double b_norm2 = 0.0;
 
     //  int nbdiag[7]={0,0,0,0,0,0,0};
 
-    FOR_INNER_CELLS(diag,
+    PARALLEL_FOR_INNER_CELLS(
     {
-        if (fdata[ind].type>0)
+        if (type[ind]>0)
         {
             real d = 6; // count air/fluid neighbours
-            d -= ((unsigned int)fdata[ind+index(-1,0,0)].type)>>31;
-            d -= ((unsigned int)fdata[ind+index(0,-1,0)].type)>>31;
-            d -= ((unsigned int)fdata[ind+index(0,0,-1)].type)>>31;
-            d -= ((unsigned int)fdata[ind+index( 1,0,0)].type)>>31;
-            d -= ((unsigned int)fdata[ind+index(0, 1,0)].type)>>31;
-            d -= ((unsigned int)fdata[ind+index(0,0, 1)].type)>>31;
+            d -= ((unsigned int)type[ind+index(-1,0,0)])>>31;
+            d -= ((unsigned int)type[ind+index(0,-1,0)])>>31;
+            d -= ((unsigned int)type[ind+index(0,0,-1)])>>31;
+            d -= ((unsigned int)type[ind+index( 1,0,0)])>>31;
+            d -= ((unsigned int)type[ind+index(0, 1,0)])>>31;
+            d -= ((unsigned int)type[ind+index(0,0, 1)])>>31;
             //  nbdiag[(int)d]++;
             diag[ind] = d;
         }
     });
 
-    FOR_INNER_CELLS(b,
+    PARALLEL_SUM_INNER_CELLS(b_norm2,
     {
-        if (fdata[ind].type>0)
+        if (type[ind]>0)
         {
-            real bi = a*(fdata[ind+index(1,0,0)].u[0]-fdata[ind].u[0] + fdata[ind+index(0,1,0)].u[1]-fdata[ind].u[1] + fdata[ind+index(0,0,1)].u[2]-fdata[ind].u[2]);
+            real bi = a*(u[0][ind+index(1,0,0)]-u[0][ind] + u[1][ind+index(0,1,0)]-u[1][ind] + u[2][ind+index(0,0,1)]-u[2][ind]);
             b[ind] = bi;
-            b_norm2 += bi*bi;
+            sum += bi*bi;
         }
     });
 
-    FOR_ALL_CELLS(pressure,
+    PARALLEL_FOR_ALL_CELLS(
     {
-        if (fdata[ind].type>0)
+        if (type[ind]>0)
             pressure[ind] = prev->pressure[ind]; // use previous pressure as initial estimate
         else pressure[ind] = 0;
     });
@@ -942,7 +1052,7 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     double err = 0.0;
 
     // r = b - Ax
-    FOR_INNER_CELLS(r,
+    PARALLEL_FOR_INNER_CELLS(
     {
         if (diag[ind] != 0)
         {
@@ -952,7 +1062,7 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
         }
     });
 
-    FOR_ALL_CELLS(g,
+    PARALLEL_FOR_ALL_CELLS(
     {
         g[ind] = r[ind]; // first direction is r
     });
@@ -963,10 +1073,9 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     for (step=0; step<100; step++)
     {
         double err_old = err;
-        err = 0.0;
-        FOR_READ_INNER_CELLS(
+        PARALLEL_SUM_INNER_CELLS(err,
         {
-            err += r[ind]*r[ind];
+            sum += r[ind]*r[ind];
         });
 
         if (err<=min_err) break;
@@ -974,14 +1083,14 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
         {
             real beta = (real)(err/err_old);
             // g = g*beta + r
-            FOR_ALL_CELLS(g,
+            PARALLEL_FOR_ALL_CELLS(
             {
                 g[ind] = g[ind]*beta + r[ind];
             });
         }
         double g_q = 0.0;
         // q = Ag
-        FOR_INNER_CELLS(q,
+        PARALLEL_SUM_INNER_CELLS(g_q,
         {
             if (diag[ind] != 0)
             {
@@ -989,13 +1098,13 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
                 -g[ind+index(-1,0,0)]-g[ind+index(0,-1,0)]-g[ind+index(0,0,-1)]
                 -g[ind+index( 1,0,0)]-g[ind+index(0, 1,0)]-g[ind+index(0,0, 1)]);
                 q[ind] = Ag;
-                g_q += g[ind]*Ag;
+                sum += g[ind]*Ag;
             }
         });
 
         real alpha = (real)(err/g_q);
 
-        FOR_ALL_CELLS(pressure,
+        PARALLEL_FOR_ALL_CELLS(
         {
             pressure[ind] += alpha*g[ind];
             r[ind] -= alpha*q[ind];
@@ -1010,28 +1119,23 @@ void Grid3D::step_project(const Grid3D* prev, Grid3D* temp, real dt, real /*diff
     //max_pressure = 0.0;
     max_pressure = prev->max_pressure;
 
-    FOR_INNER_CELLS(fdata,
+    const int dind[3] = { index(1,0,0), index(0,1,0), index(0,0,1) };
+
+    PARALLEL_FOR_INNER_CELLS(
     {
-        if (fdata[ind].type>=PART_EMPTY)
+        if (type[ind]>=PART_EMPTY)
         {
-            if (fdata[ind+index(-1,0,0)].type>=PART_EMPTY)
-            {
-                fdata[ind].u[0] -= a*(pressure[ind] - pressure[ind+index(-1,0,0)]);
-                // safety check
-                if (fdata[ind].u[0] >  max_speed) fdata[ind].u[0] =  max_speed;
-                else if (fdata[ind].u[0] < -max_speed) fdata[ind].u[0] = -max_speed;
-            }
-            if (fdata[ind+index(0,-1,0)].type>=PART_EMPTY)
-            {
-                fdata[ind].u[1] -= a*(pressure[ind] - pressure[ind+index(0,-1,0)]);
-                if (fdata[ind].u[1] >  max_speed) fdata[ind].u[1] =  max_speed;
-                else if (fdata[ind].u[1] < -max_speed) fdata[ind].u[1] = -max_speed;
-            }
-            if (fdata[ind+index(0,0,-1)].type>=PART_EMPTY)
+            for (int c=0; c<3; c++)
             {
-                fdata[ind].u[2] -= a*(pressure[ind] - pressure[ind+index(0,0,-1)]);
-                if (fdata[ind].u[2] >  max_speed) fdata[ind].u[2] =  max_speed;
-                else if (fdata[ind].u[2] < -max_speed) fdata[ind].u[2] = -max_speed;
+                const int ind2 = ind-dind[c];
+                if (type[ind2]>=PART_EMPTY)
+                {
+                    real& uc = u[c][ind];
+                    uc -= a*(pressure[ind] - pressure[ind2]);
+                    // safety check
+                    if (uc >  max_speed) uc =  max_speed;
+                    else if (uc < -max_speed) uc = -max_speed;
+                }
             }
         }
     });
@@ -27,6 +27,7 @@
 #include <sofa/type/Mat.h>
 #include <sofa/helper/rmath.h>
 #include <sofa/helper/logging/Messaging.h>
+#include <functional>
 #include <iostream>
 
 
@@ -53,22 +54,18 @@ public:
     typedef float real;
     typedef sofa::type::Vec<3,real> vec3;
 
-    struct Cell
-    {
-        vec3 u; ///< velocity (unit = cell width)
-        int type; ///< First particle (or 0 for non-fluid cell)
-        void clear()
-        {
-            u.clear();
-            type = 0;
-        }
-    };
+    /// Task processing the slices [zBegin,zEnd) of the grid
+    using RangeTask = std::function<void(std::size_t zBegin, std::size_t zEnd)>;
+    /// Run a RangeTask over [0,size), possibly splitting it into several ranges executed concurrently
+    using ParallelForRange = std::function<void(std::size_t size, const RangeTask& task)>;
 
     int nx,ny,nz,nxny,ncell;
 
     enum { PART_EMPTY=0, PART_WALL=-1, PART_FULL=1 };
 
-    Cell* fdata;
+    /// The cell fields are stored in separate arrays, so that the loops over the cells access contiguous values
+    real* u[3]; ///< velocity components (unit = cell width), on the faces x-1/2, y-1/2 and z-1/2 of the cells
+    int* type; ///< First particle (or 0 for non-fluid cell)
     real* pressure;
     real* levelset;
     //char* distance;
@@ -77,10 +74,12 @@ public:
     real tend;
 
     real max_pressure;
-    Cell bcell;
 
     vec3 gravity;
 
+    /// Loop used to process the slices of the grid in parallel. The steps are sequential if it is empty.
+    ParallelForRange parallelFor;
+
     static const unsigned long* obstacles;
 
     Grid3D();
@@ -131,56 +130,31 @@ public:
         return index(sofa::helper::rnear(p[0]), sofa::helper::rnear(p[1]), sofa::helper::rnear(p[2]));
     }
 
-    Cell* get(int x, int y, int z, Cell* base) const
-    {
-        return base+index(x,y,z);
-    }
-
-    const Cell* get(int x, int y, int z, const Cell* base) const
-    {
-        return base+index(x,y,z);
-    }
-
-    Cell* get(int x, int y, int z)
+    vec3 getu(int x, int y, int z) const
     {
 #ifdef DEBUGGRID
         if (((unsigned)x>=(unsigned)nx) || ((unsigned)y>=(unsigned)ny) || ((unsigned)z>=(unsigned)nz))
         {
             msg_info("Grid3D")<<"INVALID CELL "<<x<<','<<y<<','<<z;
-            return &bcell;
+            return vec3();
         }
 #endif
-        return get(x,y,z,fdata);
+        const int ind = index(x,y,z);
+        return vec3(u[0][ind], u[1][ind], u[2][ind]);
     }
 
-    const Cell* get(int x, int y, int z) const
+    vec3 getu(const vec3& p) const
     {
-#ifdef DEBUGGRID
-        if (((unsigned)x>=(unsigned)nx) || ((unsigned)y>=(unsigned)ny) || ((unsigned)z>=(unsigned)nz))
-        {
-            msg_info("Grid3D")<<"INVALID CELL "<<x<<','<<y<<','<<z;
-            return &bcell;
-        }
-#endif
-        return get(x,y,z,fdata);
+        return getu(sofa::helper::rnear(p[0]),sofa::helper::rnear(p[1]),sofa::helper::rnear(p[2]));
     }
 
-    Cell* get(const vec3& p)
+    /// Trilinear interpolation of the values of a field, base being the value of the lower corner
+    real interp(const real* base, real fx, real fy, real fz) const
     {
-        return get(sofa::helper::rnear(p[0]),sofa::helper::rnear(p[1]),sofa::helper::rnear(p[2]));
-    }
-
-    const Cell* get(const vec3& p) const
-    {
-        return get(sofa::helper::rnear(p[0]),sofa::helper::rnear(p[1]),sofa::helper::rnear(p[2]));
-    }
-
-    template<int C> real interp(const Cell* base, real fx, real fy, real fz) const
-    {
-        return lerp( lerp( lerp(get(0,0,0,base)->u[C],get(1,0,0,base)->u[C],fx),
-                lerp(get(0,1,0,base)->u[C],get(1,1,0,base)->u[C],fx), fy ),
-                lerp( lerp(get(0,0,1,base)->u[C],get(1,0,1,base)->u[C],fx),
-                        lerp(get(0,1,1,base)->u[C],get(1,1,1,base)->u[C],fx), fy ),
+        return lerp( lerp( lerp(base[index(0,0,0)],base[index(1,0,0)],fx),
+                lerp(base[index(0,1,0)],base[index(1,1,0)],fx), fy ),
+                lerp( lerp(base[index(0,0,1)],base[index(1,0,1)],fx),
+                        lerp(base[index(0,1,1)],base[index(1,1,1)],fx), fy ),
                 fz );
     }
 
@@ -190,8 +164,14 @@ public:
         int ix = sofa::helper::rfloor(p[0]);
         int iy = sofa::helper::rfloor(p[1]);
         int iz = sofa::helper::rfloor(p[2]);
-        const Cell* base = get(ix,iy,iz);
-        return interp<C>(base, p[0]-ix, p[1]-iy,p[2]-iz);
+#ifdef DEBUGGRID
+        if (((unsigned)ix>=(unsigned)(nx-1)) || ((unsigned)iy>=(unsigned)(ny-1)) || ((unsigned)iz>=(unsigned)(nz-1)))
+        {
+            msg_info("Grid3D")<<"INVALID CELL "<<ix<<','<<iy<<','<<iz;
+            return 0;
+        }
+#endif
+        return interp(u[C]+index(ix,iy,iz), p[0]-ix, p[1]-iy,p[2]-iz);
     }
 
     vec3 interp(vec3 p) const
@@ -199,16 +179,16 @@ public:
         return vec3( interp<0>(p), interp<1>(p), interp<2>(p) );
     }
 
-    template<int C> void impulse(Cell* base, real fx, real fy, real fz, real i)
+    void impulse(real* base, real fx, real fy, real fz, real i)
     {
-        get(0,0,0,base)->u[C] += i*(1-fx)*(1-fy)*(1-fz);
-        get(1,0,0,base)->u[C] += i*(  fx)*(1-fy)*(1-fz);
-        get(0,1,0,base)->u[C] += i*(1-fx)*(  fy)*(1-fz);
-        get(1,1,0,base)->u[C] += i*(  fx)*(  fy)*(1-fz);
-        get(0,0,1,base)->u[C] += i*(1-fx)*(1-fy)*(  fz);
-        get(1,0,1,base)->u[C] += i*(  fx)*(1-fy)*(  fz);
-        get(0,1,1,base)->u[C] += i*(1-fx)*(  fy)*(  fz);
-        get(1,1,1,base)->u[C] += i*(  fx)*(  fy)*(  fz);
+        base[index(0,0,0)] += i*(1-fx)*(1-fy)*(1-fz);
+        base[index(1,0,0)] += i*(  fx)*(1-fy)*(1-fz);
+        base[index(0,1,0)] += i*(1-fx)*(  fy)*(1-fz);
+        base[index(1,1,0)] += i*(  fx)*(  fy)*(1-fz);
+        base[index(0,0,1)] += i*(1-fx)*(1-fy)*(  fz);
+        base[index(1,0,1)] += i*(  fx)*(1-fy)*(  fz);
+        base[index(0,1,1)] += i*(1-fx)*(  fy)*(  fz);
+        base[index(1,1,1)] += i*(  fx)*(  fy)*(  fz);
     }
 
     template<int C> void impulse(vec3 p, real i)
@@ -217,8 +197,7 @@ public:
         int ix = sofa::helper::rfloor(p[0]);
         int iy = sofa::helper::rfloor(p[1]);
         int iz = sofa::helper::rfloor(p[2]);
-        Cell* base = get(ix,iy,iz);
-        impulse<C>(base, p[0]-ix, p[1]-iy,p[2]-iz, i);
+        impulse(u[C]+index(ix,iy,iz), p[0]-ix, p[1]-iy,p[2]-iz, i);
     }
 
     void impulse(const vec3& p, const vec3& i)
@@ -241,12 +220,7 @@ public:
         real fx = p[0]-ix;
         real fy = p[1]-iy;
         real fz = p[2]-iz;
-        real* base = getpressure(ix,iy,iz);
-        return lerp( lerp( lerp(base[index(0,0,0)],base[index(1,0,0)],fx),
-                lerp(base[index(0,1,0)],base[index(1,1,0)],fx), fy ),
-                lerp( lerp(base[index(0,0,1)],base[index(1,0,1)],fx),
-                        lerp(base[index(0,1,1)],base[index(1,1,1)],fx), fy ),
-                fz );
+        return interp(getpressure(ix,iy,iz), fx, fy, fz);
     }
 
     real* getlevelset(int x, int y, int z)
@@ -262,12 +236,7 @@ public:
         real fx = p[0]-ix;
         real fy = p[1]-iy;
         real fz = p[2]-iz;
-        real* base = getlevelset(ix,iy,iz);
-        return lerp( lerp( lerp(base[index(0,0,0)],base[index(1,0,0)],fx),
-                lerp(base[index(0,1,0)],base[index(1,1,0)],fx), fy ),
-                lerp( lerp(base[index(0,0,1)],base[index(1,0,1)],fx),
-                        lerp(base[index(0,1,1)],base[index(1,1,1)],fx), fy ),
-                fz );
+        return interp(getlevelset(ix,iy,iz), fx, fy, fz);
     }
 
     void seed(real height);
@@ -287,6 +256,9 @@ public:
     void step_project(const Grid3D* prev, Grid3D* temp, real dt, real diff);
     void step_color(const Grid3D* prev, Grid3D* temp, real dt, real diff);
 
+    /// Run task over the slices [z0,z1), split between threads if parallelFor is set
+    void forEachSlice(int z0, int z1, const RangeTask& task) const;
+
     // internal helper function
     //  template<int C> inline real find_velocity(int x, int y, int z, int ind, int ind2, const Grid3D* prev, const Grid3D* temp);
 
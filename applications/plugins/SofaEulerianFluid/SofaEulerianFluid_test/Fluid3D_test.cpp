@@ -0,0 +1,108 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaEulerianFluid/Fluid3D.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/simulation/Simulation.h>
+#include <sofa/testing/BaseSimulationTest.h>
+
+#include <cmath>
+
+namespace sofa
+{
+
+using sofa::component::behaviormodel::eulerianfluid::Fluid3D;
+using sofa::component::behaviormodel::eulerianfluid::Grid3D;
+
+/// Gives access to the current grid of the fluid
+class Fluid3DTester : public Fluid3D
+{
+public:
+    SOFA_CLASS(Fluid3DTester, Fluid3D);
+
+    const Grid3D& getGrid() const { return *fluid; }
+};
+
+struct Fluid3D_test : public sofa::testing::BaseSimulationTest
+{
+    simulation::Node::SPtr root;
+
+    void onTearDown() override
+    {
+        if (root != nullptr)
+        {
+            sofa::simulation::node::unload(root);
+        }
+    }
+
+    static void expectNear(const Grid3D::real* expected, const Grid3D::real* actual, int size, const char* field)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            EXPECT_NEAR(expected[i], actual[i], 1e-4 * (1 + std::abs(expected[i]))) << field << " in cell " << i;
+        }
+    }
+};
+
+/// The parallel steps give the same fluid as the sequential steps, up to the order of the sums in the reductions
+TEST_F(Fluid3D_test, parallelStepsSameAsSequential)
+{
+    root = simulation::getSimulation()->createNewGraph("root");
+
+    std::array<Fluid3DTester::SPtr, 2> fluids;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        fluids[i] = core::objectmodel::New<Fluid3DTester>();
+        fluids[i]->setNx(12);
+        fluids[i]->setNy(10);
+        fluids[i]->setNz(14);
+        fluids[i]->f_height.setValue(4);
+        fluids[i]->f_dir.setValue(Fluid3D::vec3(0.2f, 1.f, 0.1f));
+        fluids[i]->d_parallel.setValue(i == 1);
+        root->addObject(fluids[i]);
+    }
+
+    sofa::simulation::node::initRoot(root.get());
+
+    for (unsigned int step = 0; step < 10; ++step)
+    {
+        for (const auto& fluid : fluids)
+        {
+            fluid->updatePosition(0.04);
+        }
+    }
+
+    const Grid3D& sequential = fluids[0]->getGrid();
+    const Grid3D& parallel = fluids[1]->getGrid();
+    ASSERT_EQ(sequential.ncell, parallel.ncell);
+
+    for (int i = 0; i < sequential.ncell; ++i)
+    {
+        EXPECT_EQ(sequential.type[i], parallel.type[i]) << "type of cell " << i;
+    }
+    expectNear(sequential.u[0], parallel.u[0], sequential.ncell, "u[0]");
+    expectNear(sequential.u[1], parallel.u[1], sequential.ncell, "u[1]");
+    expectNear(sequential.u[2], parallel.u[2], sequential.ncell, "u[2]");
+    expectNear(sequential.pressure, parallel.pressure, sequential.ncell, "pressure");
+    expectNear(sequential.levelset, parallel.levelset, sequential.ncell, "levelset");
+}
+
+}
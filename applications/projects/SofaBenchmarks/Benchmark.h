@@ -0,0 +1,101 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <sofa/simulation/MainTaskSchedulerFactory.h>
+#include <sofa/simulation/ParallelForEach.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace sofabenchmarks
+{
+
+/// Runs f nbRepetitions times, prints and returns the average duration of a repetition (in ms)
+template<class F>
+double measure(const std::string& name, const unsigned int nbRepetitions, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nbRepetitions; ++i)
+    {
+        f();
+    }
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    const double ms = duration.count() / nbRepetitions;
+    std::cout << "  " << name << ": " << ms << " ms" << std::endl;
+    return ms;
+}
+
+/// Runs f nbRepetitions times, f performing nbOperations operations,
+/// prints and returns the average duration of an operation (in ns)
+template<class F>
+double measurePerOperation(const std::string& name, const unsigned int nbRepetitions, const std::size_t nbOperations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nbRepetitions; ++i)
+    {
+        f();
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    const double ns = duration.count() / (nbRepetitions * nbOperations);
+    std::cout << "  " << name << ": " << ns << " ns" << std::endl;
+    return ns;
+}
+
+/// The main task scheduler, initialized with one thread per core if it is not yet
+inline sofa::simulation::TaskScheduler* initTaskScheduler()
+{
+    auto* taskScheduler = sofa::simulation::MainTaskSchedulerFactory::createInRegistry();
+    if (taskScheduler->getThreadCount() < 1)
+    {
+        taskScheduler->init(0);
+    }
+    std::cout << taskScheduler->getThreadCount() << " threads" << std::endl;
+    return taskScheduler;
+}
+
+/// Parallel-for callback, as expected by kdTree and Grid3D, splitting [0, size) over the task scheduler
+template<class ParallelForRange>
+ParallelForRange makeParallelForRange(sofa::simulation::TaskScheduler* taskScheduler)
+{
+    return [taskScheduler](std::size_t size, const auto& task)
+    {
+        sofa::simulation::parallelForEachRange(*taskScheduler, static_cast<std::size_t>(0), size,
+            [&task](const auto& range)
+            {
+                task(range.start, range.end);
+            });
+    };
+}
+
+/// The benchmarks, called with the command-line arguments following the benchmark name
+int kdTreeBenchmark(int argc, char** argv);
+int smallMatrixBenchmark(int argc, char** argv);
+#if SOFABENCHMARKS_HAVE_SOFAEULERIANFLUID
+int eulerianFluidBenchmark(int argc, char** argv);
+#endif
+#if SOFABENCHMARKS_HAVE_COLLISIONOBBCAPSULE
+int collisionOBBCapsuleBenchmark(int argc, char** argv);
+#endif
+
+}
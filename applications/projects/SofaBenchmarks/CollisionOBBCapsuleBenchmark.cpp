@@ -0,0 +1,137 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <CollisionOBBCapsule/detection/intersection/OBBBatchIntTool.h>
+#include <sofa/component/statecontainer/MechanicalObject.h>
+#include <sofa/simulation/graph/DAGNode.h>
+#include <sofa/helper/random.h>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// ---------------------------------------------------------------------
+// Compares the narrow phase of the OBB-OBB candidate pairs of a grid of
+// randomly rotated cubes (as in the benchmark_cubes scene of the
+// CollisionOBBCapsule plugin):
+//  - pair by pair, as done through the intersector dispatch
+//  - by packets, with OBBBatchIntTool
+// ---------------------------------------------------------------------
+
+namespace obbgeometry = collisionobbcapsule::geometry;
+namespace obbintersection = collisionobbcapsule::detection::intersection;
+
+using sofa::type::Vec3;
+using OBBModel = obbgeometry::OBBCollisionModel<sofa::defaulttype::Rigid3Types>;
+using MechanicalObjectRigid3 = sofa::component::statecontainer::MechanicalObject<sofa::defaulttype::Rigid3Types>;
+using OutputVector = obbintersection::OBBBatchIntTool::OutputVector;
+
+namespace sofabenchmarks
+{
+
+int collisionOBBCapsuleBenchmark(int argc, char** argv)
+{
+    const unsigned int dim = (argc > 1) ? static_cast<unsigned int>(std::stoul(argv[1])) : 20;
+    const SReal spacing = (argc > 2) ? std::stod(argv[2]) : 2.2;
+    const SReal alarmDist = 0.2;
+    const SReal contactDist = 0.09;
+    const unsigned int nbRepetitions = 10;
+
+    std::cout << "Usage: SofaBenchmarks CollisionOBBCapsule [dim] [spacing]" << std::endl;
+    std::cout << dim << "^3 cubes of extent 1, spaced by " << spacing << std::endl;
+
+    const sofa::simulation::Node::SPtr root = sofa::core::objectmodel::New<sofa::simulation::graph::DAGNode>();
+
+    const MechanicalObjectRigid3::SPtr dofs = sofa::core::objectmodel::New<MechanicalObjectRigid3>();
+    const unsigned int nbCubes = dim * dim * dim;
+    dofs->resize(nbCubes);
+    {
+        auto positions = sofa::helper::getWriteOnlyAccessor(*dofs->write(sofa::core::VecId::position()));
+        for (unsigned int i = 0; i < nbCubes; ++i)
+        {
+            const Vec3 center(spacing * (i % dim), spacing * ((i / dim) % dim), spacing * (i / (dim * dim)));
+            Vec3 axis(sofa::helper::drand(1), sofa::helper::drand(1), sofa::helper::drand(1));
+            axis.normalize();
+            positions[i] = sofa::defaulttype::Rigid3Types::Coord(center, sofa::type::Quat<SReal>(axis, sofa::helper::drand(M_PI)));
+        }
+    }
+    root->addObject(dofs);
+
+    const OBBModel::SPtr model = sofa::core::objectmodel::New<OBBModel>();
+    root->addObject(model);
+    model->init();
+
+    // candidate pairs: overlapping bounding spheres, enlarged by the alarm distance
+    const SReal boundingRadius = model->extents(0).norm();
+    OBBModel::VecCoord centers(nbCubes);
+    for (unsigned int i = 0; i < nbCubes; ++i)
+    {
+        centers[i] = model->center(i);
+    }
+    std::vector<std::pair<unsigned int, unsigned int> > candidates;
+    for (unsigned int i = 0; i < nbCubes; ++i)
+    {
+        for (unsigned int j = i + 1; j < nbCubes; ++j)
+        {
+            const SReal r = 2 * boundingRadius + alarmDist;
+            if ((centers[i] - centers[j]).norm2() < r * r)
+            {
+                candidates.emplace_back(i, j);
+            }
+        }
+    }
+    std::cout << candidates.size() << " candidate pairs" << std::endl;
+
+    OutputVector contacts;
+    contacts.reserve(candidates.size());
+
+    measure("pair by pair", nbRepetitions, [&]()
+    {
+        contacts.clear();
+        for (const auto& [i, j] : candidates)
+        {
+            obbgeometry::OBB box0(model.get(), i);
+            obbgeometry::OBB box1(model.get(), j);
+            obbintersection::OBBIntTool::computeIntersection(box0, box1, alarmDist, contactDist, &contacts);
+        }
+    });
+    const std::size_t nbContacts = contacts.size();
+
+    obbintersection::OBBPairBatch batch;
+    measure("by packets (including the gathering of the pairs)", nbRepetitions, [&]()
+    {
+        contacts.clear();
+        batch.clear();
+        for (const auto& [i, j] : candidates)
+        {
+            batch.add(obbgeometry::OBB(model.get(), i), obbgeometry::OBB(model.get(), j));
+        }
+        obbintersection::OBBBatchIntTool::computeIntersection(batch, alarmDist, contactDist, &contacts);
+    });
+
+    std::cout << nbContacts << " contacts pair by pair, " << contacts.size() << " contacts by packets" << std::endl;
+
+    return 0;
+}
+
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <SofaEulerianFluid/Grid3D.h>
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+// ---------------------------------------------------------------------
+// Measures the cost of a time step of the Eulerian fluid solver
+// (eulerianfluid::Grid3D) on cubic grids, from 64^3 to 256^3 cells,
+// with the steps computed sequentially and in parallel
+// ---------------------------------------------------------------------
+
+using sofa::component::behaviormodel::eulerianfluid::Grid3D;
+
+namespace sofabenchmarks
+{
+
+namespace
+{
+
+/// The three grids used by the solver, as in Fluid3D
+struct Simulation
+{
+    Grid3D grids[3];
+    Grid3D* fluid = &grids[0];
+    Grid3D* fnext = &grids[1];
+    Grid3D* ftemp = &grids[2];
+
+    Simulation(const int n, const Grid3D::ParallelForRange& parallelFor)
+    {
+        for (auto& g : grids)
+        {
+            g.clear(n, n, n);
+            g.parallelFor = parallelFor;
+        }
+        // half-filled tank, with a moving block of fluid
+        fluid->seed(n * 0.5f, Grid3D::vec3(0, 1, 0));
+        fluid->seed(Grid3D::vec3(n * 0.2f, n * 0.5f, n * 0.2f), Grid3D::vec3(n * 0.5f, n * 0.8f, n * 0.5f), Grid3D::vec3(1, 0, 0));
+    }
+
+    void step(const Grid3D::real dt)
+    {
+        fnext->step(fluid, ftemp, dt);
+        std::swap(fluid, fnext);
+    }
+};
+
+}
+
+int eulerianFluidBenchmark(int argc, char** argv)
+{
+    const unsigned int nbSteps = (argc > 1) ? static_cast<unsigned int>(std::stoul(argv[1])) : 10;
+    const int maxSize = (argc > 2) ? std::stoi(argv[2]) : 256;
+    const Grid3D::real dt = 0.04f;
+
+    std::cout << "Usage: SofaBenchmarks EulerianFluid [nbSteps] [maxSize]" << std::endl;
+    std::cout << "Average duration of a time step over " << nbSteps << " steps" << std::endl;
+
+    auto* taskScheduler = initTaskScheduler();
+    const Grid3D::ParallelForRange parallelFor = makeParallelForRange<Grid3D::ParallelForRange>(taskScheduler);
+
+    for (int n = 64; n <= maxSize; n *= 2)
+    {
+        std::cout << n << "^3 cells" << std::endl;
+
+        Simulation sequential(n, {});
+        const double sequentialTime = measure("sequential", nbSteps, [&]() { sequential.step(dt); });
+
+        Simulation parallel(n, parallelFor);
+        const double parallelTime = measure("parallel", nbSteps, [&]() { parallel.step(dt); });
+
+        std::cout << "  speedup: " << sequentialTime / parallelTime << std::endl;
+    }
+
+    taskScheduler->stop();
+
+    return 0;
+}
+
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+
+// ---------------------------------------------------------------------
+// Performance benchmarks of some SOFA kernels, selected by name:
+//   SofaBenchmarks <benchmark> [arguments of the benchmark]
+// The benchmarks depending on optional plugins are only available if
+// these plugins were found at configuration time.
+// ---------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const std::map<std::string, std::function<int(int, char**)> > benchmarks {
+        { "kdTree", sofabenchmarks::kdTreeBenchmark },
+        { "SmallMatrix", sofabenchmarks::smallMatrixBenchmark },
+#if SOFABENCHMARKS_HAVE_SOFAEULERIANFLUID
+        { "EulerianFluid", sofabenchmarks::eulerianFluidBenchmark },
+#endif
+#if SOFABENCHMARKS_HAVE_COLLISIONOBBCAPSULE
+        { "CollisionOBBCapsule", sofabenchmarks::collisionOBBCapsuleBenchmark },
+#endif
+    };
+
+    const auto it = (argc > 1) ? benchmarks.find(argv[1]) : benchmarks.end();
+    if (it == benchmarks.end())
+    {
+        std::cout << "Usage: SofaBenchmarks <benchmark> [arguments]" << std::endl;
+        std::cout << "Available benchmarks:";
+        for (const auto& [name, benchmark] : benchmarks)
+        {
+            std::cout << " " << name;
+        }
+        std::cout << std::endl;
+        return (argc > 1) ? 1 : 0;
+    }
+
+    // the benchmark sees its name as argv[0]
+    return it->second(argc - 1, argv + 1);
+}
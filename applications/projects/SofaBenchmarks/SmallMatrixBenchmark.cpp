@@ -0,0 +1,144 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <sofa/type/Mat.h>
+#include <sofa/helper/decompose.h>
+#include <sofa/helper/random.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------
+// Timings of the small fixed-size matrix kernels of sofa::type::Mat
+// used in the FEM force fields and the mappings:
+//  - 3x3 products, transposed products, inversion and polar decomposition
+//  - 12x12 matrix-vector products (element stiffness times displacement)
+//  - 12x6 and 12x12 matrix products (strain-displacement and stiffness)
+// ---------------------------------------------------------------------
+
+using sofa::type::Mat;
+using sofa::type::Vec;
+
+namespace sofabenchmarks
+{
+
+namespace
+{
+
+template<sofa::Size L, sofa::Size C>
+std::vector<Mat<L, C, SReal> > randomMatrices(const std::size_t n)
+{
+    std::vector<Mat<L, C, SReal> > matrices(n);
+    for (auto& m : matrices)
+    {
+        for (sofa::Size i = 0; i < L; ++i)
+        {
+            for (sofa::Size j = 0; j < C; ++j)
+            {
+                m[i][j] = sofa::helper::drand(1) + (i == j ? 2 : 0);
+            }
+        }
+    }
+    return matrices;
+}
+
+}
+
+int smallMatrixBenchmark(int argc, char** argv)
+{
+    const std::size_t n = (argc > 1) ? static_cast<std::size_t>(std::stoul(argv[1])) : 10000;
+    const unsigned int nbRepetitions = 100;
+
+    std::cout << "Usage: SofaBenchmarks SmallMatrix [nbMatrices]" << std::endl;
+    std::cout << n << " matrices, time per operation" << std::endl;
+
+    const auto a3 = randomMatrices<3, 3>(n);
+    const auto b3 = randomMatrices<3, 3>(n);
+    const auto a12 = randomMatrices<12, 12>(n);
+    const auto b12 = randomMatrices<12, 12>(n);
+    const auto j12 = randomMatrices<12, 6>(n);
+    const auto v12 = randomMatrices<1, 12>(n);
+
+    // accumulated to keep the results alive
+    SReal checksum = 0;
+
+    measurePerOperation("3x3 * 3x3", nbRepetitions, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += (a3[i] * b3[i])[1][1];
+    });
+
+    measurePerOperation("3x3^T * 3x3", nbRepetitions, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += a3[i].multTranspose(b3[i])[1][1];
+    });
+
+    measurePerOperation("3x3 inversion", nbRepetitions, n, [&]()
+    {
+        Mat<3, 3, SReal> inv;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (sofa::type::invertMatrix(inv, a3[i]))
+                checksum += inv[1][1];
+        }
+    });
+
+    measurePerOperation("3x3 polar decomposition", nbRepetitions, n, [&]()
+    {
+        Mat<3, 3, SReal> q;
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += sofa::helper::Decompose<SReal>::polarDecomposition(a3[i], q);
+    });
+
+    measurePerOperation("12x12 * 12", nbRepetitions, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += (a12[i] * v12[i][0])[5];
+    });
+
+    measurePerOperation("12x12^T * 12", nbRepetitions, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += a12[i].multTranspose(v12[i][0])[5];
+    });
+
+    measurePerOperation("12x6^T * 12x12 * 12x6", nbRepetitions / 10, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += (j12[i].multTranspose(a12[i]) * j12[i])[2][3];
+    });
+
+    measurePerOperation("12x12 * 12x12", nbRepetitions / 10, n, [&]()
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            checksum += (a12[i] * b12[i])[5][7];
+    });
+
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return 0;
+}
+
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU Lesser General Public License as published by    *
+* the Free Software Foundation; either version 2.1 of the License, or (at     *
+* your option) any later version.                                             *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License *
+* for more details.                                                           *
+*                                                                             *
+* You should have received a copy of the GNU Lesser General Public License    *
+* along with this program. If not, see <http://www.gnu.org/licenses/>.        *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include "Benchmark.h"
+
+#include <sofa/helper/kdTree.h>
+#include <sofa/helper/random.h>
+
+#include <iostream>
+#include <string>
+
+// ---------------------------------------------------------------------
+// Compares the costs of the construction and of the nearest neighbors
+// queries of helper::kdTree:
+//  - queries one point at a time (legacy API) / batched / batched in parallel / brute force
+//  - sequential construction / parallel construction / refit
+// ---------------------------------------------------------------------
+
+using Coord = sofa::type::Vec3;
+using KdTree = sofa::helper::kdTree<Coord>;
+
+namespace sofabenchmarks
+{
+
+namespace
+{
+
+KdTree::VecCoord generateRandomPoints(const unsigned int nbp, const SReal range)
+{
+    KdTree::VecCoord points(nbp);
+    for (auto& p : points)
+    {
+        p = Coord(sofa::helper::drand(range), sofa::helper::drand(range), sofa::helper::drand(range));
+    }
+    return points;
+}
+
+}
+
+int kdTreeBenchmark(int argc, char** argv)
+{
+    const unsigned int nbPoints = (argc > 1) ? static_cast<unsigned int>(std::stoul(argv[1])) : 100000;
+    const unsigned int nbQueries = (argc > 2) ? static_cast<unsigned int>(std::stoul(argv[2])) : 100000;
+    const unsigned int N = (argc > 3) ? static_cast<unsigned int>(std::stoul(argv[3])) : 8;
+    const unsigned int nbRepetitions = 5;
+
+    std::cout << "Usage: SofaBenchmarks kdTree [nbPoints] [nbQueries] [N]" << std::endl;
+    std::cout << nbPoints << " points, " << nbQueries << " queries, " << N << " closest points" << std::endl;
+
+    auto* taskScheduler = initTaskScheduler();
+    const KdTree::ParallelForRange parallelFor = makeParallelForRange<KdTree::ParallelForRange>(taskScheduler);
+
+    KdTree::VecCoord points = generateRandomPoints(nbPoints, 1);
+    const KdTree::VecCoord queries = generateRandomPoints(nbQueries, 1);
+
+    KdTree tree;
+
+    std::cout << "Construction" << std::endl;
+    measure("sequential build", nbRepetitions, [&]() { tree.build(points); });
+    measure("parallel build", nbRepetitions, [&]() { tree.build(points, parallelFor); });
+
+    const KdTree::VecCoord displacements = generateRandomPoints(nbPoints, 1e-3);
+    for (unsigned int i = 0; i < nbPoints; ++i)
+    {
+        points[i] += displacements[i];
+    }
+    measure("refit", nbRepetitions, [&]() { tree.refit(points); });
+    measure("parallel refit", nbRepetitions, [&]() { tree.refit(points, parallelFor); });
+
+    std::cout << "Queries" << std::endl;
+    KdTree::distanceSet closestSet;
+    measure("one query at a time", nbRepetitions, [&]()
+    {
+        for (const auto& q : queries)
+        {
+            tree.getNClosest(closestSet, q, N);
+        }
+    });
+
+    sofa::type::vector<KdTree::distanceToPoint> closest;
+    measure("batched", nbRepetitions, [&]() { tree.getNClosest(closest, queries, N); });
+    measure("batched parallel", nbRepetitions, [&]() { tree.getNClosest(closest, queries, N, parallelFor); });
+
+    // the brute force is quadratic: it is only evaluated on a subset of the queries, and extrapolated
+    const unsigned int nbBruteForceQueries = std::min(nbQueries, 1000u);
+    const double bruteForce = measure("brute force (" + std::to_string(nbBruteForceQueries) + " queries)", 1, [&]()
+    {
+        for (unsigned int q = 0; q < nbBruteForceQueries; ++q)
+        {
+            KdTree::distanceSet cl;
+            for (unsigned int i = 0; i < nbPoints; ++i)
+            {
+                cl.insert(KdTree::distanceToPoint((queries[q] - points[i]).norm2(), i));
+                if (cl.size() > N) cl.erase(std::prev(cl.end()));
+            }
+        }
+    });
+    std::cout << "  brute force (extrapolated): " << bruteForce * nbQueries / nbBruteForceQueries << " ms" << std::endl;
+
+    taskScheduler->stop();
+
+    return 0;
+}
+
+}